@@ -1,11 +1,15 @@
 #include "advanced-scene-switcher.hpp"
 #include "backup.hpp"
 #include "curl-helper.hpp"
+#include "file-watcher.hpp"
+#include "file-writer.hpp"
 #include "log-helper.hpp"
 #include "macro-helpers.hpp"
+#include "macro-settings.hpp"
 #include "obs-module-helper.hpp"
 #include "path-helpers.hpp"
 #include "platform-funcs.hpp"
+#include "remote-file.hpp"
 #include "scene-switch-helpers.hpp"
 #include "source-helpers.hpp"
 #include "status-control.hpp"
@@ -15,6 +19,7 @@
 #include "utility.hpp"
 #include "version.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <obs-frontend-api.h>
 #include <QAction>
@@ -183,7 +188,8 @@ static void SaveSceneSwitcher(obs_data_t *save_data, bool saving, void *)
 		std::lock_guard<std::mutex> lock(switcher->m);
 		switcher->Prune();
 		OBSDataAutoRelease data = obs_data_create();
-		switcher->SaveSettings(data);
+		switcher->SaveSettings(
+			data, GetGlobalMacroSettings()._saveToSeparateFile);
 		obs_data_set_obj(save_data, "advanced-scene-switcher", data);
 	} else {
 		// Stop the scene switcher at least once to
@@ -264,7 +270,7 @@ void SwitcherData::Thread()
 		vblog(LOG_INFO, "try to sleep for %ld",
 		      (long int)duration.count());
 		SetWaitScene();
-		cv.wait_for(lock, duration);
+		WaitForNextInterval(lock, duration);
 
 		startTime = std::chrono::high_resolution_clock::now();
 		sleep = 0;
@@ -328,6 +334,114 @@ void SwitcherData::Thread()
 	blog(LOG_INFO, "stopped");
 }
 
+void SwitcherData::RequestMacroCheck(Macro *macro,
+				     const std::chrono::milliseconds &delay)
+{
+	{
+		std::lock_guard<std::mutex> lock(macroCheckRequestMutex);
+		if (requestedMacroChecks.empty()) {
+			// Further requests arriving within the delay will be
+			// handled together with this one
+			macroCheckRequestDue =
+				std::chrono::steady_clock::now() + delay;
+		}
+		if (std::find(requestedMacroChecks.begin(),
+			      requestedMacroChecks.end(),
+			      macro) == requestedMacroChecks.end()) {
+			requestedMacroChecks.emplace_back(macro);
+		}
+	}
+
+	// The main lock is not acquired here as it might be held for a long
+	// time while macros are checked or run.
+	// A request arriving just before the switcher thread starts waiting
+	// will thus only be handled once the next interval starts.
+	cv.notify_one();
+}
+
+void SwitcherData::WaitForNextInterval(
+	std::unique_lock<std::mutex> &lock,
+	const std::chrono::milliseconds &duration)
+{
+	const auto deadline = std::chrono::steady_clock::now() + duration;
+	while (true) {
+		auto wakeup = deadline;
+		{
+			std::lock_guard<std::mutex> requestLock(
+				macroCheckRequestMutex);
+			if (!requestedMacroChecks.empty()) {
+				wakeup = std::min(wakeup, macroCheckRequestDue);
+			}
+		}
+
+		const bool notified = cv.wait_until(lock, wakeup) ==
+				      std::cv_status::no_timeout;
+		const auto now = std::chrono::steady_clock::now();
+		if (stop || now >= deadline) {
+			return;
+		}
+
+		bool checkRequested = false;
+		bool checkDue = false;
+		{
+			std::lock_guard<std::mutex> requestLock(
+				macroCheckRequestMutex);
+			checkRequested = !requestedMacroChecks.empty();
+			checkDue = checkRequested &&
+				   now >= macroCheckRequestDue;
+		}
+
+		if (checkDue) {
+			CheckRequestedMacros();
+			continue;
+		}
+		if (checkRequested) {
+			continue;
+		}
+
+		// Woken up for another reason, e.g. a scene change, so start
+		// the next interval right away
+		if (notified) {
+			return;
+		}
+	}
+}
+
+void SwitcherData::CheckRequestedMacros()
+{
+	std::vector<Macro *> requested;
+	{
+		std::lock_guard<std::mutex> lock(macroCheckRequestMutex);
+		requested.swap(requestedMacroChecks);
+	}
+
+	// Legacy pause entries and startup handling are only taken care of by
+	// the regular interval
+	if (firstInterval || checkPause()) {
+		return;
+	}
+
+	// The requests might refer to macros which were deleted in the meantime
+	// so only the pointers of existing macros are used
+	std::deque<std::shared_ptr<Macro>> macros;
+	for (const auto &macro : GetMacros()) {
+		if (std::find(requested.begin(), requested.end(),
+			      macro.get()) != requested.end()) {
+			macros.emplace_back(macro);
+		}
+	}
+	if (macros.empty()) {
+		return;
+	}
+
+	vblog(LOG_INFO, "checking %d macro(s) before next interval",
+	      (int)macros.size());
+	if (CheckMacros(macros)) {
+		RunMacros(macros);
+	}
+	SetMacroSwitchedScene(false);
+}
+
 void SwitcherData::SetPreconditions()
 {
 	// Window title
@@ -536,13 +650,29 @@ bool SwitcherData::AnySceneTransitionStarted()
 /******************************************************************************
  * OBS module setup
  ******************************************************************************/
-extern "C" EXPORT void FreeSceneSwitcher()
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
 {
-	PlatformCleanup();
-	RunPluginCleanupSteps();
+	AddPluginCleanupStep([]() {
+		RemoteFilePoller::Stop();
+		CurlHelper::StopAsyncRequests();
+		FileWatcher::Stop();
+		FileWriter::Stop();
+	});
+	return true;
+}
 
+extern "C" EXPORT void FreeSceneSwitcher()
+{
+	// Stopping the switcher might still make use of the services stopped
+	// by the cleanup steps, e.g. to write to the status file
 	delete switcher;
 	switcher = nullptr;
+
+	PlatformCleanup();
+	RunPluginCleanupSteps();
 }
 
 static void handleSceneChange()
@@ -469,14 +469,18 @@ void SwitcherData::LoadSettings(obs_data_t *obj)
 	startupLoadDone = true;
 }
 
-void SwitcherData::SaveSettings(obs_data_t *obj)
+void SwitcherData::SaveSettings(obs_data_t *obj, bool separateMacroFile)
 {
 	if (!obj) {
 		return;
 	}
 
 	saveSceneGroups(obj);
-	SaveMacros(obj);
+	if (separateMacroFile) {
+		SaveMacrosToSeparateFile(obj);
+	} else {
+		SaveMacros(obj);
+	}
 	SaveGlobalMacroSettings(obj);
 	SaveVariables(obj);
 	saveWindowTitleSwitches(obj);
@@ -1,5 +1,6 @@
 #include "advanced-scene-switcher.hpp"
 #include "layout-helpers.hpp"
+#include "macro-segment.hpp"
 #include "name-dialog.hpp"
 #include "selection-helpers.hpp"
 #include "source-helpers.hpp"
@@ -274,6 +275,7 @@ void AdvSceneSwitcher::on_sceneGroupName_editingFinished()
 		std::lock_guard<std::mutex> lock(switcher->m);
 		if (nameValid) {
 			currentSG->name = newName.toUtf8().constData();
+			MarkAllMacroSegmentsDirty();
 			QListWidgetItem *sgItem =
 				ui->sceneGroups->currentItem();
 			sgItem->setData(Qt::UserRole, newName);
@@ -1,5 +1,6 @@
 #include "advanced-scene-switcher.hpp"
 #include "curl-helper.hpp"
+#include "file-writer.hpp"
 #include "layout-helpers.hpp"
 #include "source-helpers.hpp"
 #include "switcher-data.hpp"
@@ -19,7 +20,6 @@ namespace advss {
 
 bool FileSwitch::pause = false;
 static QObject *addPulse = nullptr;
-static std::hash<std::string> strHash;
 
 void AdvSceneSwitcher::on_browseButton_clicked()
 {
@@ -101,16 +101,18 @@ void SwitcherData::writeSceneInfoToFile()
 		return;
 	}
 
-	QFile file(QString::fromStdString(fileIO.writePath));
-	if (file.open(QIODevice::WriteOnly)) {
-		// switcher->currentScene cannot be used here as scene might
-		// have changed already
-		obs_source_t *source = obs_frontend_get_current_scene();
-		auto msg = obs_source_get_name(source);
-		obs_source_release(source);
-		file.write(msg, qstrlen(msg));
-		file.close();
+	// switcher->currentScene cannot be used here as scene might
+	// have changed already
+	OBSSourceAutoRelease source = obs_frontend_get_current_scene();
+	const char *name = obs_source_get_name(source);
+	std::string sceneName = name ? name : "";
+	if (sceneName == fileIO.lastWrittenData &&
+	    fileIO.writePath == fileIO.lastWrittenPath) {
+		return;
 	}
+	FileWriter::Write(fileIO.writePath, sceneName);
+	fileIO.lastWrittenPath = fileIO.writePath;
+	fileIO.lastWrittenData = std::move(sceneName);
 }
 
 void SwitcherData::writeToStatusFile(const QString &msg)
@@ -119,16 +121,10 @@ void SwitcherData::writeToStatusFile(const QString &msg)
 		return;
 	}
 
-	QFile file(QString::fromStdString(fileIO.writePath));
-	if (file.open(QIODevice::ReadWrite)) {
-		QTextStream stream(&file);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-		stream << msg << "\n";
-#else
-		stream << msg << Qt::endl;
-#endif
-	}
-	file.close();
+	std::string data = msg.toStdString() + "\n";
+	FileWriter::Write(fileIO.writePath, data);
+	fileIO.lastWrittenPath = fileIO.writePath;
+	fileIO.lastWrittenData = std::move(data);
 }
 
 bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
@@ -170,83 +166,57 @@ bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
 	return match;
 }
 
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
-{
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
-}
-
-static std::string getRemoteData(std::string &url)
-{
-	std::string readBuffer;
-
-	CurlHelper::SetOpt(CURLOPT_URL, url.c_str());
-	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCallback);
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &readBuffer);
-
-	// Set timeout to at least one second
-	int timeout = switcher->interval / 1000;
-	if (timeout == 0) {
-		timeout = 1;
-	}
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT, 1);
-	CurlHelper::Perform();
-
-	return readBuffer;
-}
-
-bool matchFileContent(QString &filedata, FileSwitch &s)
+bool matchFileContent(const std::string &filedata, uint64_t hash,
+		      FileSwitch &s)
 {
 	if (s.onlyMatchIfChanged) {
-		size_t newHash = strHash(filedata.toUtf8().constData());
-		if (newHash == s.lastHash) {
+		if (hash == s.lastHash) {
 			return false;
 		}
-		s.lastHash = newHash;
+		s.lastHash = hash;
 	}
 
 	if (s.useRegex) {
 		try {
 			std::regex expr(s.text);
-			return std::regex_match(filedata.toStdString(), expr);
+			return std::regex_match(filedata, expr);
 		} catch (const std::regex_error &) {
 			return false;
 		}
 	}
 
-	QString text = QString::fromStdString(s.text);
-	return CompareIgnoringLineEnding(text, filedata);
+	return CompareIgnoringLineEnding(filedata, s.text);
 }
 
 bool checkRemoteFileContent(FileSwitch &s)
 {
-	std::string data = getRemoteData(s.file);
-	QString qdata = QString::fromStdString(data);
-	return matchFileContent(qdata, s);
+	// The remote file is polled in the background once per interval
+	const auto interval = std::chrono::milliseconds(switcher->interval);
+	if (!s.remoteFile.Update(s.file, interval)) {
+		return false;
+	}
+	return matchFileContent(s.remoteFile.GetContent(),
+				s.remoteFile.GetHash(), s);
 }
 
 bool checkLocalFileContent(FileSwitch &s)
 {
-	QString t = QString::fromStdString(s.text);
-	QFile file(QString::fromStdString(s.file));
-	if (!file.open(QIODevice::ReadOnly)) {
+	// The file is only read again once it was modified
+	if (s.watchedFile.Update(s.file) == WatchedFile::State::UNAVAILABLE) {
 		return false;
 	}
 
 	if (s.useTime) {
-		QDateTime newLastMod = QFileInfo(file).lastModified();
+		const auto path = QString::fromStdString(s.file);
+		QDateTime newLastMod = QFileInfo(path).lastModified();
 		if (s.lastMod == newLastMod) {
 			return false;
 		}
 		s.lastMod = newLastMod;
 	}
 
-	QString filedata = QTextStream(&file).readAll();
-	bool match = matchFileContent(filedata, s);
-
-	file.close();
-	return match;
+	return matchFileContent(s.watchedFile.GetContent(),
+				s.watchedFile.GetHash(), s);
 }
 
 bool SwitcherData::checkFileContent(OBSWeakSource &scene,
@@ -7,7 +7,9 @@
 ******************************************************************************/
 #pragma once
 #include "switch-generic.hpp"
+#include "file-watcher.hpp"
 #include "obs-module-helper.hpp"
+#include "remote-file.hpp"
 
 #include <QPlainTextEdit>
 #include <QDateTime>
@@ -30,7 +32,11 @@ struct FileSwitch : SceneSwitcherEntry {
 	bool useTime = false;
 	bool onlyMatchIfChanged = false;
 	QDateTime lastMod;
-	size_t lastHash = 0;
+	uint64_t lastHash = 0;
+	// Kept separately by each copy, so copies do not consume each other's
+	// change notifications
+	WatchedFile watchedFile;
+	RemoteFile remoteFile;
 
 	const char *getType() { return "file"; }
 	void save(obs_data_t *obj);
@@ -74,6 +80,9 @@ struct FileIOData {
 	std::string readPath;
 	bool writeEnabled = false;
 	std::string writePath;
+	// Used to skip writing the same data to the same file again
+	std::string lastWrittenPath;
+	std::string lastWrittenData;
 };
 
 } // namespace advss
@@ -100,6 +100,9 @@ bool SwitcherData::checkMediaSwitch(OBSWeakSource &scene,
 			continue;
 		}
 
+		// Events occurring while the conditions are checked are picked
+		// up by the next check
+		const auto checkTime = std::chrono::high_resolution_clock::now();
 		obs_source_t *source =
 			obs_weak_source_get_source(mediaSwitch.source);
 		auto duration = obs_source_media_get_duration(source);
@@ -107,9 +110,12 @@ bool SwitcherData::checkMediaSwitch(OBSWeakSource &scene,
 		obs_media_state state = obs_source_media_get_state(source);
 		obs_source_release(source);
 
-		bool matchedStopped = mediaSwitch.state ==
-					      OBS_MEDIA_STATE_STOPPED &&
-				      mediaSwitch.stopped;
+		bool matchedStopped =
+			mediaSwitch.state == OBS_MEDIA_STATE_STOPPED &&
+			mediaSwitch.tracker &&
+			mediaSwitch.tracker->OccurredSince(
+				MediaStateTracker::Event::STOPPED,
+				mediaSwitch.lastCheck);
 
 		// The signal for the state ended is intentionally not used here
 		// so matchedEnded can be used to specify the end of a VLC playlist
@@ -155,9 +161,7 @@ bool SwitcherData::checkMediaSwitch(OBSWeakSource &scene,
 			mediaSwitch.playedToEnd = false;
 		}
 
-		// reset for next check
-		mediaSwitch.stopped = false;
-		mediaSwitch.ended = false;
+		mediaSwitch.lastCheck = checkTime;
 
 		bool matchedState = ((state == mediaSwitch.state) ||
 				     mediaSwitch.anyState) ||
@@ -295,119 +299,13 @@ void MediaSwitch::load(obs_data_t *obj)
 	time = obs_data_get_int(obj, "time");
 
 	anyState = state == media_any_idx;
-	obs_source_t *mediasource = obs_weak_source_get_source(source);
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	signal_handler_connect(sh, "media_stopped", MediaStopped, this);
-	signal_handler_connect(sh, "media_ended", MediaEnded, this);
-	obs_source_release(mediasource);
+	resetTracker();
 }
 
-void MediaSwitch::clearSignalHandler()
+void MediaSwitch::resetTracker()
 {
-	obs_source_t *mediasource = obs_weak_source_get_source(source);
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	signal_handler_disconnect(sh, "media_stopped", MediaStopped, this);
-	signal_handler_disconnect(sh, "media_ended", MediaEnded, this);
-	obs_source_release(mediasource);
-}
-
-void MediaSwitch::resetSignalHandler()
-{
-	obs_source_t *mediasource = obs_weak_source_get_source(source);
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	signal_handler_disconnect(sh, "media_stopped", MediaStopped, this);
-	signal_handler_disconnect(sh, "media_ended", MediaEnded, this);
-	signal_handler_connect(sh, "media_stopped", MediaStopped, this);
-	signal_handler_connect(sh, "media_ended", MediaEnded, this);
-	obs_source_release(mediasource);
-}
-
-void MediaSwitch::MediaStopped(void *data, calldata_t *)
-{
-	MediaSwitch *media = static_cast<MediaSwitch *>(data);
-	media->stopped = true;
-}
-
-void MediaSwitch::MediaEnded(void *data, calldata_t *)
-{
-	MediaSwitch *media = static_cast<MediaSwitch *>(data);
-	media->ended = true;
-}
-
-MediaSwitch::MediaSwitch(const MediaSwitch &other)
-	: SceneSwitcherEntry(other.targetType, other.group, other.scene,
-			     other.transition, other.usePreviousScene),
-	  source(other.source),
-	  state(other.state),
-	  restriction(other.restriction),
-	  time(other.time)
-{
-	anyState = state == media_any_idx;
-	obs_source_t *mediasource = obs_weak_source_get_source(source);
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	signal_handler_connect(sh, "media_stopped", MediaStopped, this);
-	signal_handler_connect(sh, "media_ended", MediaEnded, this);
-	obs_source_release(mediasource);
-}
-
-MediaSwitch::MediaSwitch(MediaSwitch &&other) noexcept
-	: SceneSwitcherEntry(other.targetType, other.group, other.scene,
-			     other.transition, other.usePreviousScene),
-	  source(other.source),
-	  state(other.state),
-	  anyState(other.anyState),
-	  restriction(other.restriction),
-	  time(other.time)
-{
-}
-
-MediaSwitch::~MediaSwitch()
-{
-	obs_source_t *mediasource = obs_weak_source_get_source(source);
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	signal_handler_disconnect(sh, "media_stopped", MediaStopped, this);
-	signal_handler_disconnect(sh, "media_ended", MediaEnded, this);
-	obs_source_release(mediasource);
-}
-
-MediaSwitch &MediaSwitch::operator=(const MediaSwitch &other)
-{
-	MediaSwitch t(other);
-	swap(*this, t);
-	return *this = MediaSwitch(other);
-}
-
-MediaSwitch &MediaSwitch::operator=(MediaSwitch &&other) noexcept
-{
-	if (this == &other) {
-		return *this;
-	}
-
-	swap(*this, other);
-
-	obs_source_t *mediasource = obs_weak_source_get_source(other.source);
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	signal_handler_disconnect(sh, "media_stopped", MediaStopped, &other);
-	signal_handler_disconnect(sh, "media_ended", MediaEnded, &other);
-	obs_source_release(mediasource);
-
-	return *this;
-}
-
-void swap(MediaSwitch &first, MediaSwitch &second)
-{
-	std::swap(first.targetType, second.targetType);
-	std::swap(first.group, second.group);
-	std::swap(first.scene, second.scene);
-	std::swap(first.transition, second.transition);
-	std::swap(first.usePreviousScene, second.usePreviousScene);
-	std::swap(first.source, second.source);
-	std::swap(first.state, second.state);
-	std::swap(first.restriction, second.restriction);
-	std::swap(first.time, second.time);
-	std::swap(first.anyState, second.anyState);
-	first.resetSignalHandler();
-	second.resetSignalHandler();
+	tracker = MediaStateTracker::Get(source);
+	lastCheck = std::chrono::high_resolution_clock::now();
 }
 
 static void populateMediaStates(QComboBox *list)
@@ -527,9 +425,8 @@ void MediaSwitchWidget::SourceChanged(const QString &text)
 	}
 
 	std::lock_guard<std::mutex> lock(switcher->m);
-	switchData->clearSignalHandler();
 	switchData->source = GetWeakSourceByQString(text);
-	switchData->resetSignalHandler();
+	switchData->resetTracker();
 }
 
 void MediaSwitchWidget::StateChanged(int index)
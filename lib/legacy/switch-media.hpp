@@ -7,6 +7,7 @@
 ******************************************************************************/
 #pragma once
 #include "switch-generic.hpp"
+#include "media-state-tracker.hpp"
 
 namespace advss {
 
@@ -31,8 +32,9 @@ struct MediaSwitch : SceneSwitcherEntry {
 	// Trigger scene change only once even if media state might trigger repeatedly
 	bool matched = false;
 
-	std::atomic_bool stopped = {false};
-	std::atomic_bool ended = {false};
+	std::shared_ptr<MediaStateTracker> tracker;
+	std::chrono::high_resolution_clock::time_point lastCheck =
+		std::chrono::high_resolution_clock::now();
 
 	// Workaround to enable use of "ended" to specify end of VLC playlist
 	bool previousStateEnded = false;
@@ -45,19 +47,7 @@ struct MediaSwitch : SceneSwitcherEntry {
 	void save(obs_data_t *obj);
 	void load(obs_data_t *obj);
 
-	void clearSignalHandler();
-	void resetSignalHandler();
-	static void MediaStopped(void *data, calldata_t *);
-	static void MediaEnded(void *data, calldata_t *);
-
-	inline MediaSwitch(){};
-
-	MediaSwitch(const MediaSwitch &other);
-	MediaSwitch(MediaSwitch &&other) noexcept;
-	~MediaSwitch();
-	MediaSwitch &operator=(const MediaSwitch &other);
-	MediaSwitch &operator=(MediaSwitch &&other) noexcept;
-	friend void swap(MediaSwitch &first, MediaSwitch &second);
+	void resetTracker();
 };
 
 class MediaSwitchWidget : public SwitchWidget {
@@ -88,11 +88,7 @@ void MacroActionEdit::ActionSelectionChanged(const QString &text)
 		(*_entryData)->PostLoad();
 		RunPostLoadSteps();
 	}
-	auto widget = MacroActionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
-	_section->SetContent(widget);
-	SetFocusPolicyOfWidgets();
+	SetContent(CreateContentWidget());
 }
 
 void MacroActionEdit::UpdateEntryData(const std::string &id)
@@ -102,15 +98,21 @@ void MacroActionEdit::UpdateEntryData(const std::string &id)
 	const bool enabled = (*_entryData)->Enabled();
 	_enable->setChecked(enabled);
 	SetDisableEffect(!enabled);
-	auto widget = MacroActionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
 	HeaderInfoChanged(
 		QString::fromStdString((*_entryData)->GetShortDesc()));
-	_section->SetContent(widget, (*_entryData)->GetCollapsed());
+	SetPlaceholderContent((*_entryData)->GetCollapsed());
 	SetFocusPolicyOfWidgets();
 }
 
+QWidget *MacroActionEdit::CreateContentWidget()
+{
+	auto widget = MacroActionFactory::CreateWidget((*_entryData)->GetId(),
+						       this, *_entryData);
+	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
+			 this, SLOT(HeaderInfoChanged(const QString &)));
+	return widget;
+}
+
 void MacroActionEdit::SetEntryData(std::shared_ptr<MacroAction> *data)
 {
 	_entryData = data;
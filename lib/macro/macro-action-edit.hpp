@@ -27,6 +27,7 @@ private slots:
 
 private:
 	std::shared_ptr<MacroSegment> Data() const;
+	QWidget *CreateContentWidget();
 	void SetDisableEffect(bool);
 	void SetEnableAppearance(bool);
 
@@ -30,8 +30,12 @@ QWidget *MacroActionFactory::CreateWidget(const std::string &id,
 					  QWidget *parent,
 					  std::shared_ptr<MacroAction> action)
 {
-	if (auto it = GetMap().find(id); it != GetMap().end())
+	if (auto it = GetMap().find(id); it != GetMap().end()) {
+		if (action) {
+			action->EnsureResourcesSetup();
+		}
 		return it->second._createWidget(parent, action);
+	}
 
 	return nullptr;
 }
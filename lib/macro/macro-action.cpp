@@ -31,6 +31,7 @@ void MacroAction::LogAction() const
 void MacroAction::SetEnabled(bool value)
 {
 	_enabled = value;
+	MarkDirty();
 }
 
 bool MacroAction::Enabled() const
@@ -179,14 +179,10 @@ void MacroConditionEdit::UpdateEntryData(const std::string &id)
 {
 	_conditionSelection->setCurrentText(obs_module_text(
 		MacroConditionFactory::GetConditionName(id).c_str()));
-	auto widget =
-		MacroConditionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
 	HeaderInfoChanged(
 		QString::fromStdString((*_entryData)->GetShortDesc()));
 	SetLogicSelection();
-	_section->SetContent(widget, (*_entryData)->GetCollapsed());
+	SetPlaceholderContent((*_entryData)->GetCollapsed());
 
 	_dur->setVisible(MacroConditionFactory::UsesDurationModifier(id));
 	auto modifier = (*_entryData)->GetDurationModifier();
@@ -194,6 +190,15 @@ void MacroConditionEdit::UpdateEntryData(const std::string &id)
 	SetFocusPolicyOfWidgets();
 }
 
+QWidget *MacroConditionEdit::CreateContentWidget()
+{
+	auto widget = MacroConditionFactory::CreateWidget(
+		(*_entryData)->GetId(), this, *_entryData);
+	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
+			 this, SLOT(HeaderInfoChanged(const QString &)));
+	return widget;
+}
+
 void MacroConditionEdit::SetEntryData(std::shared_ptr<MacroCondition> *data)
 {
 	_entryData = data;
@@ -225,13 +230,8 @@ void MacroConditionEdit::ConditionSelectionChanged(const QString &text)
 		(*_entryData)->PostLoad();
 		RunPostLoadSteps();
 	}
-	auto widget =
-		MacroConditionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
-	_section->SetContent(widget);
+	SetContent(CreateContentWidget());
 	_dur->setVisible(MacroConditionFactory::UsesDurationModifier(id));
-	SetFocusPolicyOfWidgets();
 }
 
 void MacroConditionEdit::DurationChanged(const Duration &seconds)
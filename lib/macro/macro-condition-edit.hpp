@@ -53,6 +53,7 @@ private slots:
 private:
 	void SetLogicSelection();
 	std::shared_ptr<MacroSegment> Data() const;
+	QWidget *CreateContentWidget();
 
 	QComboBox *_logicSelection;
 	FilterComboBox *_conditionSelection;
@@ -32,6 +32,9 @@ MacroConditionFactory::CreateWidget(const std::string &id, QWidget *parent,
 				    std::shared_ptr<MacroCondition> cond)
 {
 	if (auto it = GetMap().find(id); it != GetMap().end()) {
+		if (cond) {
+			cond->EnsureResourcesSetup();
+		}
 		return it->second._createWidget(parent, cond);
 	}
 	return nullptr;
@@ -1,6 +1,8 @@
 #include "macro-helpers.hpp"
 #include "macro.hpp"
+#include "macro-settings.hpp"
 #include "plugin-state-helpers.hpp"
+#include "switcher-data.hpp"
 
 namespace advss {
 
@@ -120,6 +122,15 @@ bool RunMacroActions(Macro *macro)
 	return macro && macro->PerformActions(true);
 }
 
+void RequestMacroCheck(Macro *macro)
+{
+	auto switcherData = GetSwitcher();
+	if (!macro || !switcherData || !CheckMacrosOnNewMessages()) {
+		return;
+	}
+	switcherData->RequestMacroCheck(macro, GetNewMessageCheckDelay());
+}
+
 void ResetMacroConditionTimers(Macro *macro)
 {
 	if (!macro) {
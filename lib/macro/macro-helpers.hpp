@@ -54,9 +54,27 @@ MacroWasPausedSince(Macro *,
 EXPORT void AddMacroHelperThread(Macro *, std::thread &&);
 
 EXPORT bool CheckMacros();
+EXPORT bool CheckMacros(const std::deque<std::shared_ptr<Macro>> &);
 
 EXPORT bool RunMacroActions(Macro *);
 EXPORT bool RunMacros();
+EXPORT bool RunMacros(std::deque<std::shared_ptr<Macro>>);
+
+// Requests the given macro to be checked as soon as possible instead of
+// waiting for the next interval, e.g. when a message it is waiting for has
+// arrived. Can be called from any thread.
+EXPORT void RequestMacroCheck(Macro *);
+// Requests a check of the given macro whenever a message is appended to the
+// message buffer
+template<class MessageBuffer>
+void CheckMacroOnNewMessages(Macro *macro, const MessageBuffer &buffer)
+{
+	if (!buffer) {
+		return;
+	}
+	buffer->SetAppendCallback([macro]() { RequestMacroCheck(macro); });
+}
+
 void StopAllMacros();
 
 EXPORT void LoadMacros(obs_data_t *obj);
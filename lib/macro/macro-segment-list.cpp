@@ -2,6 +2,7 @@
 #include "layout-helpers.hpp"
 #include "ui-helpers.hpp"
 
+#include <QApplication>
 #include <QEvent>
 #include <QDrag>
 #include <QGridLayout>
@@ -35,6 +36,9 @@ MacroSegmentList::MacroSegmentList(QWidget *parent)
 	setWidget(wrapper);
 	setWidgetResizable(true);
 	setAcceptDrops(true);
+
+	QWidget::connect(verticalScrollBar(), &QScrollBar::valueChanged, this,
+			 [this]() { ScheduleContentUpdate(); });
 }
 
 MacroSegmentList::~MacroSegmentList()
@@ -102,12 +106,14 @@ void MacroSegmentList::Insert(int idx, MacroSegmentEdit *widget)
 {
 	widget->installEventFilter(this);
 	_contentLayout->insertWidget(idx, widget);
+	ScheduleContentUpdate();
 }
 
 void MacroSegmentList::Add(QWidget *widget)
 {
 	widget->installEventFilter(this);
 	_contentLayout->addWidget(widget);
+	ScheduleContentUpdate();
 }
 
 void MacroSegmentList::Remove(int idx)
@@ -168,12 +174,76 @@ bool MacroSegmentList::eventFilter(QObject *object, QEvent *event)
 	case QEvent::MouseButtonRelease:
 		mouseReleaseEvent(static_cast<QMouseEvent *>(event));
 		break;
+	case QEvent::Resize:
+		// Segments were collapsed, expanded or their content changed
+		ScheduleContentUpdate();
+		break;
 	default:
 		break;
 	}
 	return QWidget::eventFilter(object, event);
 }
 
+void MacroSegmentList::showEvent(QShowEvent *event)
+{
+	QScrollArea::showEvent(event);
+	ScheduleContentUpdate();
+}
+
+void MacroSegmentList::resizeEvent(QResizeEvent *event)
+{
+	QScrollArea::resizeEvent(event);
+	ScheduleContentUpdate();
+}
+
+void MacroSegmentList::ScheduleContentUpdate()
+{
+	// Might be called from the auto scroll thread
+	if (_contentUpdatePending.exchange(true)) {
+		return;
+	}
+	QMetaObject::invokeMethod(
+		this, [this]() { UpdateContent(); }, Qt::QueuedConnection);
+}
+
+void MacroSegmentList::UpdateContent()
+{
+	_contentUpdatePending = false;
+	if (!isVisible()) {
+		return;
+	}
+
+	// The editor widgets of segments close to the visible area are created
+	// and the ones far away from it are released again.
+	// The positions are calculated from the size hints, as the geometry of
+	// segments which were just added is not known yet.
+	const int viewportHeight = viewport()->height();
+	const int visibleTop = verticalScrollBar()->value();
+	const int createTop = visibleTop - viewportHeight;
+	const int createBottom = visibleTop + 2 * viewportHeight;
+	const int keepTop = visibleTop - 3 * viewportHeight;
+	const int keepBottom = visibleTop + 4 * viewportHeight;
+	const auto focusWidget = QApplication::focusWidget();
+
+	int top = _contentLayout->geometry().top();
+	for (int idx = 0; idx < _contentLayout->count(); ++idx) {
+		auto item = _contentLayout->itemAt(idx);
+		const int bottom = top + item->sizeHint().height();
+		auto segment = dynamic_cast<MacroSegmentEdit *>(item->widget());
+		if (!segment) {
+			top = bottom + _contentLayout->spacing();
+			continue;
+		}
+		if (bottom >= createTop && top <= createBottom) {
+			segment->CreateContent();
+		} else if ((bottom < keepTop || top > keepBottom) &&
+			   !segment->isAncestorOf(focusWidget)) {
+			segment->ReleaseContent();
+		}
+		top = bottom + _contentLayout->spacing();
+	}
+}
+
 void MacroSegmentList::mousePressEvent(QMouseEvent *event)
 {
 	if (event->button() == Qt::LeftButton ||
@@ -34,6 +34,8 @@ signals:
 
 protected:
 	bool eventFilter(QObject *object, QEvent *event);
+	void showEvent(QShowEvent *event);
+	void resizeEvent(QResizeEvent *event);
 	void mousePressEvent(QMouseEvent *event);
 	void mouseMoveEvent(QMouseEvent *event);
 	void mouseReleaseEvent(QMouseEvent *event);
@@ -51,12 +53,15 @@ private:
 	bool IsInListArea(const QPoint &);
 	QRect GetContentItemRectWithPadding(int idx);
 	void HideLastDropLine();
+	void ScheduleContentUpdate();
+	void UpdateContent();
 
 	int _dragPosition = -1;
 	int _dropLineIdx = -1;
 	QPoint _dragCursorPos;
 	std::thread _autoScrollThread;
 	std::atomic_bool _autoScroll{false};
+	std::atomic_bool _contentUpdatePending{false};
 
 	QVBoxLayout *_layout;
 	QVBoxLayout *_contentLayout;
@@ -1,9 +1,11 @@
 #include "macro-segment.hpp"
 #include "macro.hpp"
 #include "mouse-wheel-guard.hpp"
+#include "plugin-state-helpers.hpp"
 #include "section.hpp"
 #include "ui-helpers.hpp"
 
+#include <algorithm>
 #include <QApplication>
 #include <QEvent>
 #include <QLabel>
@@ -12,12 +14,106 @@
 
 namespace advss {
 
+static std::atomic<uint64_t> savedSettingsEpoch{0};
+
+static void sourceRenamed(void *, calldata_t *)
+{
+	MarkAllMacroSegmentsDirty();
+}
+
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	AddPluginInitStep([]() {
+		signal_handler_connect(obs_get_signal_handler(),
+				       "source_rename", sourceRenamed, nullptr);
+	});
+	AddPluginCleanupStep([]() {
+		signal_handler_disconnect(obs_get_signal_handler(),
+					  "source_rename", sourceRenamed,
+					  nullptr);
+	});
+	return true;
+}
+
 MacroSegment::MacroSegment(Macro *m, bool supportsVariableValue)
 	: _macro(m),
 	  _supportsVariableValue(supportsVariableValue)
 {
 }
 
+void MacroSegment::SetCollapsed(bool collapsed)
+{
+	_collapsed = collapsed;
+	MarkDirty();
+}
+
+void MacroSegment::SetUseCustomLabel(bool enable)
+{
+	_useCustomLabel = enable;
+	MarkDirty();
+}
+
+void MacroSegment::SetCustomLabel(const std::string &label)
+{
+	_customLabel = label;
+	MarkDirty();
+}
+
+void MacroSegment::UpdateSaveCache(bool force) const
+{
+	const uint64_t generation = _saveCache.generation;
+	const uint64_t epoch = savedSettingsEpoch;
+	if (!force && _saveCache.data &&
+	    _saveCache.savedGeneration == generation &&
+	    _saveCache.savedEpoch == epoch) {
+		return;
+	}
+
+	OBSDataAutoRelease data = obs_data_create();
+	Save(data);
+	_saveCache.data = data.Get();
+	_saveCache.json.clear();
+	_saveCache.savedGeneration = generation;
+	_saveCache.savedEpoch = epoch;
+}
+
+OBSData MacroSegment::GetSavedSettings(bool reuse) const
+{
+	if (!reuse || !CanReuseSavedSettings()) {
+		// The settings might be modified by the caller, so they cannot
+		// be reused
+		OBSDataAutoRelease data = obs_data_create();
+		Save(data);
+		return data.Get();
+	}
+	UpdateSaveCache(false);
+	return _saveCache.data;
+}
+
+const std::string &MacroSegment::GetSavedSettingsJson(bool reuse) const
+{
+	UpdateSaveCache(!reuse || !CanReuseSavedSettings());
+	if (!_saveCache.json.empty()) {
+		return _saveCache.json;
+	}
+
+	auto json = obs_data_get_json(_saveCache.data);
+	_saveCache.json = json ? json : "{}";
+	// Line breaks can only be part of the formatting, as they are escaped
+	// within strings
+	std::replace(_saveCache.json.begin(), _saveCache.json.end(), '\n',
+		     ' ');
+	return _saveCache.json;
+}
+
+void MarkAllMacroSegmentsDirty()
+{
+	++savedSettingsEpoch;
+}
+
 bool MacroSegment::Save(obs_data_t *obj) const
 {
 	OBSDataAutoRelease data = obs_data_create();
@@ -30,6 +126,11 @@ bool MacroSegment::Save(obs_data_t *obj) const
 
 bool MacroSegment::Load(obs_data_t *obj)
 {
+	MarkDirty();
+	{
+		std::lock_guard<std::mutex> lock(_resources.mutex);
+		_resources.setupDone = false;
+	}
 	// TODO: remove this fallback at some point
 	if (obs_data_has_user_value(obj, "segmentSettings")) {
 		OBSDataAutoRelease data =
@@ -54,6 +155,16 @@ bool MacroSegment::PostLoad()
 	return true;
 }
 
+void MacroSegment::EnsureResourcesSetup()
+{
+	std::lock_guard<std::mutex> lock(_resources.mutex);
+	if (_resources.setupDone) {
+		return;
+	}
+	SetupResources();
+	_resources.setupDone = true;
+}
+
 std::string MacroSegment::GetShortDesc() const
 {
 	return "";
@@ -338,6 +449,53 @@ void MacroSegmentEdit::SetCollapsed(bool collapsed)
 	_section->SetCollapsed(collapsed);
 }
 
+static QWidget *createPlaceholder(int height)
+{
+	auto placeholder = new QWidget();
+	auto layout = new QVBoxLayout();
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addSpacerItem(new QSpacerItem(0, height, QSizePolicy::Minimum,
+					      QSizePolicy::Fixed));
+	placeholder->setLayout(layout);
+	return placeholder;
+}
+
+void MacroSegmentEdit::CreateContent()
+{
+	if (_hasContent || !Data()) {
+		return;
+	}
+	SetContent(CreateContentWidget());
+}
+
+void MacroSegmentEdit::ReleaseContent()
+{
+	if (!_hasContent) {
+		return;
+	}
+	if (_content) {
+		_contentHeight = _content->sizeHint().height();
+	}
+	_section->SetContent(createPlaceholder(_contentHeight));
+	_content = nullptr;
+	_hasContent = false;
+}
+
+void MacroSegmentEdit::SetContent(QWidget *widget)
+{
+	_section->SetContent(widget);
+	_content = widget;
+	_hasContent = true;
+	SetFocusPolicyOfWidgets();
+}
+
+void MacroSegmentEdit::SetPlaceholderContent(bool collapsed)
+{
+	_section->SetContent(createPlaceholder(_contentHeight), collapsed);
+	_content = nullptr;
+	_hasContent = false;
+}
+
 void MacroSegmentEdit::SetSelected(bool selected)
 {
 	_borderFrame->setVisible(selected);
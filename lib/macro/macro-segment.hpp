@@ -11,7 +11,9 @@
 #include <QFrame>
 #include <QVBoxLayout>
 #include <QTimer>
-#include <obs-data.h>
+#include <atomic>
+#include <mutex>
+#include <obs.hpp>
 
 class QLabel;
 
@@ -26,15 +28,24 @@ public:
 	Macro *GetMacro() const { return _macro; }
 	void SetIndex(int idx) { _idx = idx; }
 	int GetIndex() const { return _idx; }
-	void SetCollapsed(bool collapsed) { _collapsed = collapsed; }
+	void SetCollapsed(bool collapsed);
 	bool GetCollapsed() const { return _collapsed; }
-	void SetUseCustomLabel(bool enable) { _useCustomLabel = enable; }
+	void SetUseCustomLabel(bool enable);
 	bool GetUseCustomLabel() const { return _useCustomLabel; }
-	void SetCustomLabel(const std::string &label) { _customLabel = label; }
+	void SetCustomLabel(const std::string &label);
 	std::string GetCustomLabel() const { return _customLabel; }
 	virtual bool Save(obs_data_t *obj) const = 0;
 	virtual bool Load(obs_data_t *obj) = 0;
+	// The settings of unmodified segments are not serialized again when
+	// saving the macros.
+	// Changes made using the edit widgets are always saved, but changes
+	// of the saved settings made elsewhere, e.g. by other macros, have to
+	// be reported using this function.
+	void MarkDirty() { ++_saveCache.generation; }
 	virtual bool PostLoad();
+	// Sets up the resources of the segment once it is checked, performed,
+	// or displayed for the first time after loading
+	void EnsureResourcesSetup();
 	virtual std::string GetShortDesc() const;
 	virtual std::string GetId() const = 0;
 	void EnableHighlight();
@@ -48,12 +59,26 @@ protected:
 	void SetVariableValue(const std::string &value);
 	bool IsReferencedInVars() { return _variableRefs != 0; }
 
+	// Segments whose saved settings change on their own, e.g. because they
+	// contain the time remaining of a timer, are always serialized again
+	virtual bool CanReuseSavedSettings() const { return true; }
+
+	// Resources which are expensive to set up, e.g. volume meters or signal
+	// handlers, should be set up here instead of in Load(), so macros which
+	// never run do not slow down loading the plugin
+	virtual void SetupResources() {}
+
 	virtual void SetupTempVars();
 	void AddTempvar(const std::string &id, const std::string &name,
 			const std::string &description = "");
 	void SetTempVarValue(const std::string &id, const std::string &value);
 
 private:
+	// Only call Save() again if the segment was modified since
+	void UpdateSaveCache(bool force) const;
+	OBSData GetSavedSettings(bool reuse) const;
+	const std::string &GetSavedSettingsJson(bool reuse) const;
+
 	void ClearAvailableTempvars();
 	std::optional<const TempVariable>
 	GetTempVar(const std::string &id) const;
@@ -78,9 +103,51 @@ private:
 	std::string _variableValue;
 	std::vector<TempVariable> _tempVariables;
 
+	// Saving helpers
+	struct SaveCache {
+		SaveCache() = default;
+		// Copies of segments are serialized on their own
+		SaveCache(const SaveCache &) {}
+		SaveCache &operator=(const SaveCache &)
+		{
+			data = nullptr;
+			json.clear();
+			++generation;
+			return *this;
+		}
+
+		std::atomic<uint64_t> generation{0};
+		OBSData data;
+		std::string json;
+		uint64_t savedGeneration = 0;
+		uint64_t savedEpoch = 0;
+	};
+	mutable SaveCache _saveCache;
+
+	// Resource helpers
+	struct ResourceState {
+		ResourceState() = default;
+		// Copies of segments set up their own resources
+		ResourceState(const ResourceState &) {}
+		ResourceState &operator=(const ResourceState &)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			setupDone = false;
+			return *this;
+		}
+
+		std::mutex mutex;
+		bool setupDone = false;
+	};
+	ResourceState _resources;
+
 	friend class Macro;
 };
 
+// The saved settings of segments can refer to other objects by name, so
+// they all have to be serialized again once any of these are renamed
+EXPORT void MarkAllMacroSegmentsDirty();
+
 class Section;
 
 class MacroSegmentEdit : public QWidget {
@@ -95,6 +162,14 @@ public:
 	void SetSelected(bool);
 	virtual std::shared_ptr<MacroSegment> Data() const = 0;
 
+	// Creating the editor widgets of all segments of large macros is slow,
+	// so they are only created once the segment is scrolled into view.
+	// Until then, or once released again, a placeholder of the last known
+	// height is shown instead.
+	void CreateContent();
+	void ReleaseContent();
+	bool HasContent() const { return _hasContent; }
+
 public slots:
 	void HeaderInfoChanged(const QString &);
 
@@ -110,6 +185,9 @@ signals:
 
 protected:
 	bool eventFilter(QObject *obj, QEvent *ev) override;
+	virtual QWidget *CreateContentWidget() = 0;
+	void SetContent(QWidget *);
+	void SetPlaceholderContent(bool collapsed);
 
 	Section *_section;
 	QLabel *_headerInfo;
@@ -141,6 +219,11 @@ private:
 	QFrame *_dropLineAbove;
 	QFrame *_dropLineBelow;
 
+	QWidget *_content = nullptr;
+	bool _hasContent = false;
+	// Rough estimate used until the editor widget was created once
+	int _contentHeight = 100;
+
 	friend class MacroSegmentList;
 };
 
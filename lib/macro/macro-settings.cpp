@@ -4,6 +4,7 @@
 #include "macro.hpp"
 
 #include <QDialogButtonBox>
+#include <QHBoxLayout>
 #include <QScrollArea>
 #include <QScrollBar>
 #include <QVBoxLayout>
@@ -11,6 +12,9 @@
 namespace advss {
 
 static GlobalMacroSettings macroSettings;
+// Copies of the settings which are read from other threads
+static std::atomic_bool checkOnNewMessages = {true};
+static std::atomic_int newMessageCheckDelay = {10};
 
 void GlobalMacroSettings::Save(obs_data_t *obj) const
 {
@@ -20,6 +24,9 @@ void GlobalMacroSettings::Save(obs_data_t *obj) const
 	obs_data_set_bool(data, "highlightActions", _highlightActions);
 	obs_data_set_bool(data, "newMacroRegisterHotkey",
 			  _newMacroRegisterHotkeys);
+	obs_data_set_bool(data, "checkOnNewMessages", _checkOnNewMessages);
+	obs_data_set_int(data, "newMessageCheckDelay", _newMessageCheckDelay);
+	obs_data_set_bool(data, "saveToSeparateFile", _saveToSeparateFile);
 	obs_data_set_obj(obj, "macroSettings", data);
 	obs_data_release(data);
 }
@@ -33,11 +40,16 @@ void GlobalMacroSettings::Load(obs_data_t *obj)
 	obs_data_set_default_bool(data, "highlightExecuted", true);
 	obs_data_set_default_bool(data, "highlightConditions", true);
 	obs_data_set_default_bool(data, "highlightActions", true);
+	obs_data_set_default_bool(data, "checkOnNewMessages", true);
+	obs_data_set_default_int(data, "newMessageCheckDelay", 10);
 	_highlightExecuted = obs_data_get_bool(data, "highlightExecuted");
 	_highlightConditions = obs_data_get_bool(data, "highlightConditions");
 	_highlightActions = obs_data_get_bool(data, "highlightActions");
 	_newMacroRegisterHotkeys =
 		obs_data_get_bool(data, "newMacroRegisterHotkey");
+	_checkOnNewMessages = obs_data_get_bool(data, "checkOnNewMessages");
+	_newMessageCheckDelay = obs_data_get_int(data, "newMessageCheckDelay");
+	_saveToSeparateFile = obs_data_get_bool(data, "saveToSeparateFile");
 	obs_data_release(data);
 }
 
@@ -53,6 +65,11 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 		  "AdvSceneSwitcher.macroTab.highlightPerformedActions"))),
 	  _newMacroRegisterHotkeys(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.macroTab.newMacroRegisterHotkey"))),
+	  _checkOnNewMessages(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.macroTab.checkOnNewMessages"))),
+	  _newMessageCheckDelay(new QSpinBox()),
+	  _saveToSeparateFile(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.macroTab.saveToSeparateFile"))),
 	  _currentMacroRegisterHotkeys(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.macroTab.currentDisableHotkeys"))),
 	  _currentSkipOnStartup(new QCheckBox(obs_module_text(
@@ -98,6 +115,32 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 	hotkeyLayout->addWidget(_currentMacroRegisterHotkeys);
 	hotkeyOptions->setLayout(hotkeyLayout);
 
+	_newMessageCheckDelay->setMinimum(0);
+	_newMessageCheckDelay->setMaximum(1000);
+	_newMessageCheckDelay->setSuffix("ms");
+	_newMessageCheckDelay->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.macroTab.newMessageCheckDelay.tooltip"));
+	_checkOnNewMessages->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.macroTab.checkOnNewMessages.tooltip"));
+	auto messageOptions = new QGroupBox(
+		obs_module_text("AdvSceneSwitcher.macroTab.messageSettings"));
+	auto messageDelayLayout = new QHBoxLayout;
+	PlaceWidgets(
+		obs_module_text("AdvSceneSwitcher.macroTab.newMessageCheckDelay"),
+		messageDelayLayout, {{"{{delay}}", _newMessageCheckDelay}});
+	auto messageLayout = new QVBoxLayout;
+	messageLayout->addWidget(_checkOnNewMessages);
+	messageLayout->addLayout(messageDelayLayout);
+	messageOptions->setLayout(messageLayout);
+
+	_saveToSeparateFile->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.macroTab.saveToSeparateFile.tooltip"));
+	auto storageOptions = new QGroupBox(
+		obs_module_text("AdvSceneSwitcher.macroTab.storageSettings"));
+	auto storageLayout = new QVBoxLayout;
+	storageLayout->addWidget(_saveToSeparateFile);
+	storageOptions->setLayout(storageLayout);
+
 	auto generalOptions = new QGroupBox(
 		obs_module_text("AdvSceneSwitcher.macroTab.generalSettings"));
 	auto generalLayout = new QVBoxLayout;
@@ -186,6 +229,8 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 	auto contentWidget = new QWidget(scrollArea);
 	auto layout = new QVBoxLayout(contentWidget);
 	layout->addWidget(highlightOptions);
+	layout->addWidget(messageOptions);
+	layout->addWidget(storageOptions);
 	layout->addWidget(hotkeyOptions);
 	layout->addWidget(generalOptions);
 	layout->addWidget(inputOptions);
@@ -202,6 +247,12 @@ MacroSettingsDialog::MacroSettingsDialog(QWidget *parent,
 	_conditions->setChecked(settings._highlightConditions);
 	_actions->setChecked(settings._highlightActions);
 	_newMacroRegisterHotkeys->setChecked(settings._newMacroRegisterHotkeys);
+	_checkOnNewMessages->setChecked(settings._checkOnNewMessages);
+	_newMessageCheckDelay->setValue(settings._newMessageCheckDelay);
+	_newMessageCheckDelay->setEnabled(settings._checkOnNewMessages);
+	_saveToSeparateFile->setChecked(settings._saveToSeparateFile);
+	connect(_checkOnNewMessages, &QCheckBox::stateChanged,
+		_newMessageCheckDelay, &QSpinBox::setEnabled);
 
 	if (!macro || macro->IsGroup()) {
 		hotkeyOptions->hide();
@@ -327,6 +378,9 @@ bool MacroSettingsDialog::AskForSettings(QWidget *parent,
 	userInput._highlightActions = dialog._actions->isChecked();
 	userInput._newMacroRegisterHotkeys =
 		dialog._newMacroRegisterHotkeys->isChecked();
+	userInput._checkOnNewMessages = dialog._checkOnNewMessages->isChecked();
+	userInput._newMessageCheckDelay = dialog._newMessageCheckDelay->value();
+	userInput._saveToSeparateFile = dialog._saveToSeparateFile->isChecked();
 	if (!macro) {
 		return true;
 	}
@@ -358,11 +412,23 @@ bool MacroSettingsDialog::AskForSettings(QWidget *parent,
 	return true;
 }
 
-GlobalMacroSettings &GetGlobalMacroSettings()
+static void updateThreadSafeSettings()
+{
+	checkOnNewMessages = macroSettings._checkOnNewMessages;
+	newMessageCheckDelay = macroSettings._newMessageCheckDelay;
+}
+
+const GlobalMacroSettings &GetGlobalMacroSettings()
 {
 	return macroSettings;
 }
 
+void SetGlobalMacroSettings(const GlobalMacroSettings &settings)
+{
+	macroSettings = settings;
+	updateThreadSafeSettings();
+}
+
 void SaveGlobalMacroSettings(obs_data_t *obj)
 {
 	macroSettings.Save(obj);
@@ -371,6 +437,17 @@ void SaveGlobalMacroSettings(obs_data_t *obj)
 void LoadGlobalMacroSettings(obs_data_t *obj)
 {
 	macroSettings.Load(obj);
+	updateThreadSafeSettings();
+}
+
+bool CheckMacrosOnNewMessages()
+{
+	return checkOnNewMessages;
+}
+
+std::chrono::milliseconds GetNewMessageCheckDelay()
+{
+	return std::chrono::milliseconds(newMessageCheckDelay);
 }
 
 } // namespace advss
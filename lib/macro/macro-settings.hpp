@@ -8,8 +8,12 @@
 #include <QGroupBox>
 #include <QLineEdit>
 #include <QGridLayout>
+#include <QSpinBox>
 #include <obs-data.h>
 
+#include <atomic>
+#include <chrono>
+
 namespace advss {
 
 class Macro;
@@ -23,6 +27,9 @@ public:
 	bool _highlightConditions = false;
 	bool _highlightActions = false;
 	bool _newMacroRegisterHotkeys = true;
+	bool _checkOnNewMessages = true;
+	int _newMessageCheckDelay = 10; // in ms
+	bool _saveToSeparateFile = false;
 };
 
 // Dialog for configuring global and individual macro specific settings
@@ -48,6 +55,9 @@ private:
 	QCheckBox *_conditions;
 	QCheckBox *_actions;
 	QCheckBox *_newMacroRegisterHotkeys;
+	QCheckBox *_checkOnNewMessages;
+	QSpinBox *_newMessageCheckDelay;
+	QCheckBox *_saveToSeparateFile;
 	// Current macro specific settings
 	QCheckBox *_currentMacroRegisterHotkeys;
 	QCheckBox *_currentSkipOnStartup;
@@ -73,8 +83,12 @@ private:
 	int _conditionsFalseTextRow = -1;
 };
 
-GlobalMacroSettings &GetGlobalMacroSettings();
+const GlobalMacroSettings &GetGlobalMacroSettings();
+void SetGlobalMacroSettings(const GlobalMacroSettings &);
 void SaveGlobalMacroSettings(obs_data_t *obj);
 void LoadGlobalMacroSettings(obs_data_t *obj);
+// Can be called from any thread
+bool CheckMacrosOnNewMessages();
+std::chrono::milliseconds GetNewMessageCheckDelay();
 
 } // namespace advss
@@ -622,6 +622,7 @@ void AdvSceneSwitcher::SetEditMacro(Macro &m)
 	ui->elseActionsList->Clear();
 
 	m.ResetUIHelpers();
+	m.SetEditing(true);
 
 	PopulateMacroConditions(m);
 	PopulateMacroActions(m);
@@ -704,6 +705,7 @@ void AdvSceneSwitcher::MacroSelectionAboutToChange()
 		return;
 	}
 
+	macro->SetEditing(false);
 	macro->SetActionConditionSplitterPosition(
 		ui->macroActionConditionSplitter->sizes());
 
@@ -768,7 +770,7 @@ void AdvSceneSwitcher::on_macroSettings_clicked()
 	if (!accepted) {
 		return;
 	}
-	GetGlobalMacroSettings() = prop;
+	SetGlobalMacroSettings(prop);
 	emit HighlightMacrosChanged(prop._highlightExecuted);
 }
 
@@ -804,7 +806,10 @@ static void runSegmentHighligtChecksHelper(MacroSegmentList *list)
 {
 	MacroSegmentEdit *widget = nullptr;
 	for (int i = 0; (widget = list->WidgetAt(i)); i++) {
-		if (widget->Data() && widget->Data()->GetHighlightAndReset()) {
+		// Highlighting segments far outside of the visible area of the
+		// list is pointless, but the highlight state is still reset
+		if (widget->Data() && widget->Data()->GetHighlightAndReset() &&
+		    widget->HasContent()) {
 			list->Highlight(i);
 		}
 	}
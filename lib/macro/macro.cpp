@@ -3,15 +3,25 @@
 #include "macro-condition-factory.hpp"
 #include "macro-dock.hpp"
 #include "macro-helpers.hpp"
+#include "file-writer.hpp"
 #include "plugin-state-helpers.hpp"
 #include "splitter-helpers.hpp"
 #include "sync-helpers.hpp"
+#include "ui-helpers.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <limits>
+#include <map>
+#include <set>
+#include <thread>
 #undef max
 #include <obs-frontend-api.h>
 #include <QAction>
+#include <QCryptographicHash>
 #include <QMainWindow>
 #include <unordered_map>
 
@@ -105,6 +115,7 @@ static bool checkCondition(const std::shared_ptr<MacroCondition> &condition)
 	using namespace std::chrono_literals;
 	static constexpr auto perfLogThreshold = 300ms;
 
+	condition->EnsureResourcesSetup();
 	const auto startTime = std::chrono::high_resolution_clock::now();
 	const bool conditionMatched = condition->CheckCondition();
 	const auto endTime = std::chrono::high_resolution_clock::now();
@@ -259,6 +270,8 @@ int64_t Macro::MsSinceLastCheck() const
 void Macro::SetName(const std::string &name)
 {
 	_name = name;
+	// Segments might refer to this macro by name
+	MarkAllMacroSegmentsDirty();
 	SetHotkeysDesc();
 	SetDockWidgetName();
 }
@@ -284,6 +297,7 @@ bool Macro::RunActionsHelper(
 	for (auto &action : actions) {
 		if (action->Enabled()) {
 			action->LogAction();
+			action->EnsureResourcesSetup();
 			actionsExecutedSuccessfully =
 				actionsExecutedSuccessfully &&
 				action->PerformAction();
@@ -550,7 +564,7 @@ std::shared_ptr<Macro> Macro::Parent() const
 	return _parent.lock();
 }
 
-bool Macro::Save(obs_data_t *obj) const
+void Macro::SaveCommonSettings(obs_data_t *obj) const
 {
 	obs_data_set_string(obj, "name", _name.c_str());
 	obs_data_set_bool(obj, "pause", _paused);
@@ -565,7 +579,7 @@ bool Macro::Save(obs_data_t *obj) const
 		obs_data_set_bool(groupData, "collapsed", _isCollapsed);
 		obs_data_set_int(groupData, "size", _groupSize);
 		obs_data_set_obj(obj, "groupData", groupData);
-		return true;
+		return;
 	}
 
 	SaveDockSettings(obj);
@@ -584,33 +598,99 @@ bool Macro::Save(obs_data_t *obj) const
 		obs_hotkey_save(_togglePauseHotkey);
 	obs_data_set_array(obj, "togglePauseHotkey", togglePauseHotkey);
 
-	OBSDataArrayAutoRelease conditions = obs_data_array_create();
-	for (auto &c : _conditions) {
-		OBSDataAutoRelease arrayObj = obs_data_create();
-		c->Save(arrayObj);
-		obs_data_array_push_back(conditions, arrayObj);
+	_inputVariables.Save(obj);
+}
+
+template<class T, class SaveFunc>
+static void saveSegments(obs_data_t *obj, const char *name,
+			 const std::deque<std::shared_ptr<T>> &segments,
+			 const SaveFunc &save)
+{
+	OBSDataArrayAutoRelease array = obs_data_array_create();
+	for (const auto &segment : segments) {
+		obs_data_array_push_back(array, save(*segment));
 	}
-	obs_data_set_array(obj, "conditions", conditions);
+	obs_data_set_array(obj, name, array);
+}
 
-	OBSDataArrayAutoRelease actions = obs_data_array_create();
-	for (auto &a : _actions) {
-		OBSDataAutoRelease arrayObj = obs_data_create();
-		a->Save(arrayObj);
-		obs_data_array_push_back(actions, arrayObj);
+bool Macro::Save(obs_data_t *obj, bool reuseSavedSegmentSettings) const
+{
+	SaveCommonSettings(obj);
+	if (_isGroup) {
+		return true;
 	}
-	obs_data_set_array(obj, "actions", actions);
 
-	OBSDataArrayAutoRelease elseActions = obs_data_array_create();
-	for (auto &a : _elseActions) {
-		OBSDataAutoRelease arrayObj = obs_data_create();
-		a->Save(arrayObj);
-		obs_data_array_push_back(elseActions, arrayObj);
+	const bool reuse = reuseSavedSegmentSettings && !_editing;
+	auto save = [reuse](const MacroSegment &segment) {
+		return segment.GetSavedSettings(reuse);
+	};
+	saveSegments(obj, "conditions", _conditions, save);
+	saveSegments(obj, "actions", _actions, save);
+	saveSegments(obj, "elseActions", _elseActions, save);
+	return true;
+}
+
+template<class T, class GetJsonFunc>
+static void appendSegmentsJson(std::string &json, const char *name,
+			       const std::deque<std::shared_ptr<T>> &segments,
+			       const GetJsonFunc &getJson)
+{
+	json += std::string(",\"") + name + "\":[";
+	bool first = true;
+	for (const auto &segment : segments) {
+		if (!first) {
+			json += ",";
+		}
+		json += getJson(*segment);
+		first = false;
 	}
-	obs_data_set_array(obj, "elseActions", elseActions);
+	json += "]";
+}
 
-	_inputVariables.Save(obj);
+std::string Macro::SaveToJson() const
+{
+	OBSDataAutoRelease data = obs_data_create();
+	SaveCommonSettings(data);
+	auto json = obs_data_get_json(data);
+	std::string result = json ? json : "{}";
+	// Line breaks can only be part of the formatting, as they are escaped
+	// within strings
+	std::replace(result.begin(), result.end(), '\n', ' ');
+	if (_isGroup) {
+		return result;
+	}
 
-	return true;
+	// The settings of the segments are inserted into the object as is, as
+	// they usually were not modified since the last time they were saved.
+	// The object is never empty, as it contains the name of the macro.
+	result.erase(result.rfind('}'));
+	auto getJson = [this](const MacroSegment &segment)
+		-> const std::string & {
+		return segment.GetSavedSettingsJson(!_editing);
+	};
+	appendSegmentsJson(result, "conditions", _conditions, getJson);
+	appendSegmentsJson(result, "actions", _actions, getJson);
+	appendSegmentsJson(result, "elseActions", _elseActions, getJson);
+	result += "}";
+	return result;
+}
+
+// Time spent loading each type of macro segment since the macros were last
+// loaded, which is reported once loading is done
+struct SegmentLoadTime {
+	std::chrono::nanoseconds duration{0};
+	int count = 0;
+};
+static std::map<std::string, SegmentLoadTime> segmentLoadTimes;
+
+static void loadSegment(MacroSegment &segment, obs_data_t *data)
+{
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	segment.Load(data);
+	auto &loadTime = segmentLoadTimes[segment.GetId()];
+	loadTime.duration += std::chrono::high_resolution_clock::now() -
+			     startTime;
+	++loadTime.count;
 }
 
 bool Macro::Load(obs_data_t *obj)
@@ -667,7 +747,7 @@ bool Macro::Load(obs_data_t *obj)
 		if (newEntry) {
 			_conditions.emplace_back(newEntry);
 			auto c = _conditions.back().get();
-			c->Load(arrayObj);
+			loadSegment(*c, arrayObj);
 			c->ValidateLogicSelection(root, Name().c_str());
 		} else {
 			blog(LOG_WARNING,
@@ -686,7 +766,7 @@ bool Macro::Load(obs_data_t *obj)
 		auto newEntry = MacroActionFactory::Create(id, this);
 		if (newEntry) {
 			_actions.emplace_back(newEntry);
-			_actions.back()->Load(array_obj);
+			loadSegment(*_actions.back(), array_obj);
 		} else {
 			blog(LOG_WARNING,
 			     "discarding action entry with unknown id (%s) for macro %s",
@@ -705,7 +785,7 @@ bool Macro::Load(obs_data_t *obj)
 		auto newEntry = MacroActionFactory::Create(id, this);
 		if (newEntry) {
 			_elseActions.emplace_back(newEntry);
-			_elseActions.back()->Load(array_obj);
+			loadSegment(*_elseActions.back(), array_obj);
 		} else {
 			blog(LOG_WARNING,
 			     "discarding elseAction entry with unknown id (%s) for macro %s",
@@ -783,6 +863,25 @@ bool Macro::OnChangePreventedActionsRecently()
 	return false;
 }
 
+void Macro::SetEditing(bool editing)
+{
+	_editing = editing;
+	if (editing) {
+		return;
+	}
+
+	// Modifications made since the macro was last saved must not be lost
+	for (const auto &c : _conditions) {
+		c->MarkDirty();
+	}
+	for (const auto &a : _actions) {
+		a->MarkDirty();
+	}
+	for (const auto &a : _elseActions) {
+		a->MarkDirty();
+	}
+}
+
 void Macro::ResetUIHelpers()
 {
 	_onPreventedActionExecution = false;
@@ -1159,7 +1258,7 @@ void SaveMacros(obs_data_t *obj)
 	for (const auto &m : macros) {
 		obs_data_t *array_obj = obs_data_create();
 
-		m->Save(array_obj);
+		m->Save(array_obj, true);
 		obs_data_array_push_back(macroArray, array_obj);
 
 		obs_data_release(array_obj);
@@ -1168,19 +1267,269 @@ void SaveMacros(obs_data_t *obj)
 	obs_data_array_release(macroArray);
 }
 
+static std::string getMacroFilePath(const std::string &fileName)
+{
+	auto path = obs_module_config_path(fileName.c_str());
+	if (!path) {
+		return "";
+	}
+	std::string result = path;
+	bfree(path);
+	return result;
+}
+
+static std::string getMacroFileName()
+{
+	auto sceneCollectionName = obs_frontend_get_current_scene_collection();
+	std::string name = sceneCollectionName ? sceneCollectionName : "";
+	bfree(sceneCollectionName);
+
+	// Different names might map to the same file name once invalid
+	// characters are replaced, or on case insensitive file systems, so a
+	// hash of the original name is added
+	const auto hash =
+		QCryptographicHash::hash(QByteArray::fromStdString(name),
+					 QCryptographicHash::Md5)
+			.toHex()
+			.left(8)
+			.toStdString();
+
+	// Scene collection names might contain characters not allowed in paths
+	for (auto &c : name) {
+		if (static_cast<unsigned char>(c) < 32 ||
+		    std::string("<>:\"/\\|?*").find(c) != std::string::npos) {
+			c = '_';
+		}
+	}
+	return "macros-" + name + "-" + hash + ".jsonl";
+}
+
+// Macro files which could not be loaded completely are never overwritten, so
+// temporary read errors do not cause the macros missing in them to be lost
+static std::set<std::string> macroFilesFailedToLoad;
+
+void SaveMacrosToSeparateFile(obs_data_t *obj)
+{
+	const auto fileName = getMacroFileName();
+	const auto path = getMacroFilePath(fileName);
+	if (path.empty()) {
+		blog(LOG_WARNING, "failed to determine path of macro file");
+		SaveMacros(obj);
+		return;
+	}
+	if (macroFilesFailedToLoad.count(fileName) > 0) {
+		blog(LOG_WARNING,
+		     "not overwriting macro file \"%s\" which failed to load",
+		     path.c_str());
+		SaveMacros(obj);
+		return;
+	}
+
+	// Each macro is stored on a line of its own
+	std::string content;
+	for (const auto &m : macros) {
+		content += m->SaveToJson() + "\n";
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(
+		std::filesystem::u8path(path).parent_path(), ec);
+	FileWriter::Replace(path, content, FileWriter::SyncPolicy::ON_FLUSH);
+	obs_data_set_string(obj, "macroFile", fileName.c_str());
+}
+
+static std::vector<OBSData>
+parseMacroLines(const std::vector<std::string> &lines)
+{
+	// Parsing is independent of any OBS or plugin state, so it is split
+	// across multiple threads, while loading has to happen in order on the
+	// calling thread
+	static constexpr size_t minLinesPerThread = 16;
+
+	std::vector<OBSData> result(lines.size());
+	std::atomic_size_t next{0};
+	auto parse = [&lines, &result, &next]() {
+		for (size_t i = next++; i < lines.size(); i = next++) {
+			OBSDataAutoRelease data =
+				obs_data_create_from_json(lines[i].c_str());
+			result[i] = data.Get();
+		}
+	};
+
+	const size_t maxThreadCount =
+		std::max(std::thread::hardware_concurrency(), 1u);
+	const size_t threadCount = std::min(
+		maxThreadCount, lines.size() / minLinesPerThread + 1);
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; ++i) {
+		threads.emplace_back(parse);
+	}
+	parse();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	return result;
+}
+
+static bool parseMacroFile(const std::string &path,
+			   std::vector<OBSData> &result)
+{
+	// The file might still be written
+	FileWriter::Flush();
+
+	std::ifstream file(std::filesystem::u8path(path));
+	if (!file) {
+		blog(LOG_ERROR, "failed to open macro file \"%s\"",
+		     path.c_str());
+		return false;
+	}
+
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (!line.empty()) {
+			lines.emplace_back(std::move(line));
+		}
+	}
+
+	if (file.bad()) {
+		blog(LOG_ERROR, "failed to read macro file \"%s\"",
+		     path.c_str());
+		return false;
+	}
+
+	result = parseMacroLines(lines);
+	auto isInvalid = [](const OBSData &data) {
+		return !data;
+	};
+	const auto invalidCount =
+		std::count_if(result.begin(), result.end(), isInvalid);
+	if (invalidCount == 0) {
+		return true;
+	}
+	blog(LOG_ERROR, "skipping %d invalid macros in \"%s\"",
+	     static_cast<int>(invalidCount), path.c_str());
+	result.erase(std::remove_if(result.begin(), result.end(), isInvalid),
+		     result.end());
+	return false;
+}
+
+static void showMacroFileLoadFailure(void *param)
+{
+	auto message = static_cast<QString *>(param);
+	DisplayMessage(*message, false, false);
+	delete message;
+}
+
+static void handleMacroFileLoadFailure(const std::string &fileName,
+				       const std::string &path)
+{
+	// The file the macros of this scene collection would be saved to might
+	// differ, e.g. if it was created by an older version of the plugin
+	macroFilesFailedToLoad.insert(fileName);
+	macroFilesFailedToLoad.insert(getMacroFileName());
+
+	std::error_code ec;
+	const auto backupPath = path + ".bak";
+	const bool backupCreated =
+		std::filesystem::exists(std::filesystem::u8path(path), ec) &&
+		std::filesystem::copy_file(
+			std::filesystem::u8path(path),
+			std::filesystem::u8path(backupPath),
+			std::filesystem::copy_options::overwrite_existing, ec);
+	QString message;
+	if (backupCreated) {
+		blog(LOG_WARNING, "kept copy of macro file at \"%s\"",
+		     backupPath.c_str());
+		message = obs_module_text(
+			"AdvSceneSwitcher.macroTab.macroFileLoadFailed");
+		message = message.arg(QString::fromStdString(path),
+				      QString::fromStdString(backupPath));
+	} else {
+		message = obs_module_text(
+			"AdvSceneSwitcher.macroTab.macroFileReadFailed");
+		message = message.arg(QString::fromStdString(path));
+	}
+	QeueUITask(showMacroFileLoadFailure, new QString(message));
+}
+
+static std::vector<OBSData> loadMacroFile(const std::string &fileName)
+{
+	const auto path = getMacroFilePath(fileName);
+	std::vector<OBSData> result;
+	if (!parseMacroFile(path, result)) {
+		handleMacroFileLoadFailure(fileName, path);
+	}
+	return result;
+}
+
+static std::vector<OBSData> getMacroArray(obs_data_t *obj)
+{
+	std::vector<OBSData> result;
+	OBSDataArrayAutoRelease macroArray = obs_data_get_array(obj, "macros");
+	size_t count = obs_data_array_count(macroArray);
+	for (size_t i = 0; i < count; i++) {
+		OBSDataAutoRelease data = obs_data_array_item(macroArray, i);
+		result.emplace_back(data.Get());
+	}
+	return result;
+}
+
+static long long toMs(std::chrono::nanoseconds duration)
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+		.count();
+}
+
+static void loadMacro(obs_data_t *data)
+{
+	using namespace std::chrono_literals;
+	static constexpr auto perfLogThreshold = 100ms;
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	auto macro = std::make_shared<Macro>();
+	macro->Load(data);
+	macros.emplace_back(macro);
+	const auto timeSpent =
+		std::chrono::high_resolution_clock::now() - startTime;
+
+	if (timeSpent >= perfLogThreshold) {
+		blog(LOG_WARNING, "spent %lld ms loading macro '%s'!",
+		     toMs(timeSpent), macro->Name().c_str());
+	} else {
+		vblog(LOG_INFO, "spent %lld ms loading macro '%s'",
+		      toMs(timeSpent), macro->Name().c_str());
+	}
+}
+
+static void logSegmentLoadTimes()
+{
+	std::vector<std::pair<std::string, SegmentLoadTime>> loadTimes(
+		segmentLoadTimes.begin(), segmentLoadTimes.end());
+	std::sort(loadTimes.begin(), loadTimes.end(),
+		  [](const auto &a, const auto &b) {
+			  return a.second.duration > b.second.duration;
+		  });
+	for (const auto &[id, loadTime] : loadTimes) {
+		vblog(LOG_INFO, "spent %lld ms loading %d '%s' segments",
+		      toMs(loadTime.duration), loadTime.count, id.c_str());
+	}
+}
+
 void LoadMacros(obs_data_t *obj)
 {
+	const auto startTime = std::chrono::high_resolution_clock::now();
 	macros.clear();
-	obs_data_array_t *macroArray = obs_data_get_array(obj, "macros");
-	size_t count = obs_data_array_count(macroArray);
+	segmentLoadTimes.clear();
 
-	for (size_t i = 0; i < count; i++) {
-		obs_data_t *array_obj = obs_data_array_item(macroArray, i);
-		macros.emplace_back(std::make_shared<Macro>());
-		macros.back()->Load(array_obj);
-		obs_data_release(array_obj);
+	const auto macroData =
+		obs_data_has_user_value(obj, "macroFile")
+			? loadMacroFile(obs_data_get_string(obj, "macroFile"))
+			: getMacroArray(obj);
+	const auto parseEndTime = std::chrono::high_resolution_clock::now();
+	for (const auto &data : macroData) {
+		loadMacro(data);
 	}
-	obs_data_array_release(macroArray);
 
 	int groupCount = 0;
 	std::shared_ptr<Macro> group;
@@ -1218,6 +1567,12 @@ void LoadMacros(obs_data_t *obj)
 		}
 		macros.erase(it);
 	}
+
+	const auto endTime = std::chrono::high_resolution_clock::now();
+	blog(LOG_INFO, "loaded %d macros in %lld ms (%lld ms parsing)",
+	     static_cast<int>(macros.size()), toMs(endTime - startTime),
+	     toMs(parseEndTime - startTime));
+	logSegmentLoadTimes();
 }
 
 std::deque<std::shared_ptr<Macro>> &GetMacros()
@@ -1226,9 +1581,14 @@ std::deque<std::shared_ptr<Macro>> &GetMacros()
 }
 
 bool CheckMacros()
+{
+	return CheckMacros(macros);
+}
+
+bool CheckMacros(const std::deque<std::shared_ptr<Macro>> &macrosToCheck)
 {
 	bool matchFound = false;
-	for (const auto &m : macros) {
+	for (const auto &m : macrosToCheck) {
 		if (m->CeckMatch() || m->ElseActions().size() > 0) {
 			matchFound = true;
 			// This has to be performed here for now as actions are
@@ -1247,8 +1607,11 @@ bool RunMacros()
 	// reordered while macros are currently being executed.
 	// For example, this can happen if a macro is performing a wait action,
 	// as the main lock will be unlocked during this time.
-	auto runPhaseMacros = macros;
+	return RunMacros(macros);
+}
 
+bool RunMacros(std::deque<std::shared_ptr<Macro>> runPhaseMacros)
+{
 	// Avoid deadlocks when opening settings window and calling frontend
 	// API functions at the same time.
 	//
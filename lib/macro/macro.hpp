@@ -98,7 +98,9 @@ public:
 	std::shared_ptr<Macro> Parent() const;
 
 	// Saving and loading
-	bool Save(obs_data_t *obj) const;
+	bool Save(obs_data_t *obj, bool reuseSavedSegmentSettings = false) const;
+	// Returns the same settings as Save() in compact JSON form
+	std::string SaveToJson() const;
 	bool Load(obs_data_t *obj);
 	// Some macros can refer to other macros, which are not yet loaded.
 	// Use this function to set these references after loading is complete.
@@ -117,6 +119,9 @@ public:
 		const std::chrono::high_resolution_clock::time_point &) const;
 	bool OnChangePreventedActionsRecently();
 	void ResetUIHelpers();
+	// The edit widgets of the macro tab modify the segments directly, so
+	// their saved settings cannot be reused while being edited
+	void SetEditing(bool);
 
 	// Hotkeys
 	void EnablePauseHotkeys(bool);
@@ -149,6 +154,8 @@ private:
 	void ClearHotkeys() const;
 	void SetHotkeysDesc() const;
 
+	void SaveCommonSettings(obs_data_t *obj) const;
+
 	bool RunActionsHelper(
 		const std::deque<std::shared_ptr<MacroAction>> &actions,
 		bool ignorePause);
@@ -188,6 +195,7 @@ private:
 	bool _skipExecOnStart = false;
 	bool _stopActionsIfNotDone = false;
 	bool _paused = false;
+	bool _editing = false;
 	int _runCount = 0;
 	bool _registerHotkeys = true;
 	obs_hotkey_id _pauseHotkey = OBS_INVALID_HOTKEY_ID;
@@ -227,9 +235,14 @@ private:
 
 void LoadMacros(obs_data_t *obj);
 void SaveMacros(obs_data_t *obj);
+// Writes the macros to a file of their own instead of the settings object,
+// which only refers to that file
+void SaveMacrosToSeparateFile(obs_data_t *obj);
 std::deque<std::shared_ptr<Macro>> &GetMacros();
 bool CheckMacros();
+bool CheckMacros(const std::deque<std::shared_ptr<Macro>> &);
 bool RunMacros();
+bool RunMacros(std::deque<std::shared_ptr<Macro>>);
 void StopAllMacros();
 Macro *GetMacroByName(const char *name);
 Macro *GetMacroByQString(const QString &name);
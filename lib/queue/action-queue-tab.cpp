@@ -1,6 +1,7 @@
 #include "action-queue-tab.hpp"
 #include "action-queue.hpp"
 #include "log-helper.hpp"
+#include "macro-segment.hpp"
 #include "obs-module-helper.hpp"
 #include "plugin-state-helpers.hpp"
 #include "sync-helpers.hpp"
@@ -117,6 +118,7 @@ static void openSettingsDialog()
 	bool accepted = ActionQueueSettingsDialog::AskForSettings(
 		tabWidget->Table(), *queue.get());
 	if (accepted && oldName != queue->Name()) {
+		MarkAllMacroSegmentsDirty();
 		ActionQueueSignalManager::Instance()->Rename(
 			QString::fromStdString(oldName),
 			QString::fromStdString(queue->Name()));
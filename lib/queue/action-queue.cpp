@@ -156,6 +156,7 @@ void ActionQueue::RunActions()
 			     action->GetId().c_str(), _name.c_str());
 			action->LogAction();
 		}
+		action->EnsureResourcesSetup();
 		action->PerformAction();
 	}
 }
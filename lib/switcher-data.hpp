@@ -21,6 +21,7 @@
 #include "priority-helper.hpp"
 #include "plugin-state-helpers.hpp"
 
+#include <chrono>
 #include <condition_variable>
 #include <vector>
 #include <deque>
@@ -70,10 +71,14 @@ public:
 			   bool &macroMatch);
 	void CheckNoMatchSwitch(bool &match, OBSWeakSource &scene,
 				OBSWeakSource &transition, int &sleep);
+	void RequestMacroCheck(Macro *, const std::chrono::milliseconds &delay);
+	void WaitForNextInterval(std::unique_lock<std::mutex> &,
+				 const std::chrono::milliseconds &duration);
+	void CheckRequestedMacros();
 
 	/* --- Start of saving / loading section --- */
 
-	void SaveSettings(obs_data_t *obj);
+	void SaveSettings(obs_data_t *obj, bool separateMacroFile = false);
 	void SaveGeneralSettings(obs_data_t *obj);
 	void SaveHotkeys(obs_data_t *obj);
 	void SaveUISettings(obs_data_t *obj);
@@ -99,6 +104,12 @@ public:
 	bool stop = false;
 	std::condition_variable cv;
 
+	// Macros which requested to be checked before the next interval, for
+	// example because a message they are waiting for has arrived
+	std::mutex macroCheckRequestMutex;
+	std::vector<Macro *> requestedMacroChecks;
+	std::chrono::steady_clock::time_point macroCheckRequestDue;
+
 	std::vector<std::function<void(obs_data_t *)>> saveSteps;
 	std::vector<std::function<void(obs_data_t *)>> loadSteps;
 	std::vector<std::function<void()>> postLoadSteps;
@@ -3,7 +3,10 @@
 
 #include <QDir>
 #include <QFileInfo>
+#include <algorithm>
+#include <cctype>
 #include <curl/curl.h>
+#include <string_view>
 
 namespace advss {
 
@@ -15,16 +18,49 @@ constexpr auto curl_library_name = "libcurl.4.dylib";
 constexpr auto curl_library_name = "libcurl.so.4";
 #endif
 
+// Limits for the connection cache of the multi handle used for asynchronous
+// requests, which keeps connections alive between requests
+constexpr long maxConnectionsPerHost = 6;
+constexpr long maxCachedConnections = 32;
+
+struct CurlHelper::Transfer {
+	CurlRequest request;
+	CurlResponse response;
+	std::promise<CurlResponse> promise;
+	std::function<void(CurlResponse &&)> callback;
+	struct curl_slist *headers = nullptr;
+	char error[CURL_ERROR_SIZE] = {};
+
+	void Finish(CurlResponse response)
+	{
+		if (callback) {
+			callback(std::move(response));
+		} else {
+			promise.set_value(std::move(response));
+		}
+	}
+};
+
+static CurlResponse abortedResponse()
+{
+	CurlResponse response;
+	response.result = CURLE_ABORTED_BY_CALLBACK;
+	response.error = "request was aborted";
+	return response;
+}
+
 CurlHelper::CurlHelper()
 {
 	if (LoadLib()) {
 		_curl = _init();
 		_initialized = true;
+		_multiAvailable = ResolveMulti();
 	}
 }
 
 CurlHelper::~CurlHelper()
 {
+	StopAsync();
 	if (_lib) {
 		if (_cleanup) {
 			_cleanup(_curl);
@@ -73,6 +109,302 @@ char *CurlHelper::GetError(CURLcode code)
 	return curl._error(code);
 }
 
+std::future<CurlResponse> CurlHelper::PerformAsync(const CurlRequest &request)
+{
+	auto transfer = std::make_unique<Transfer>();
+	transfer->request = request;
+	auto future = transfer->promise.get_future();
+	GetInstance().QueueTransfer(std::move(transfer));
+	return future;
+}
+
+void CurlHelper::PerformAsync(
+	const CurlRequest &request,
+	const std::function<void(CurlResponse &&)> &callback)
+{
+	auto transfer = std::make_unique<Transfer>();
+	transfer->request = request;
+	transfer->callback = callback;
+	GetInstance().QueueTransfer(std::move(transfer));
+}
+
+void CurlHelper::QueueTransfer(std::unique_ptr<Transfer> transfer)
+{
+	if (!_initialized || !_multiAvailable) {
+		transfer->response.error = "CURL initialization failed";
+		transfer->Finish(transfer->response);
+		return;
+	}
+
+	// Transfers which cannot be queued are finished without holding the
+	// async mutex, as their callbacks might queue new transfers
+	bool stopped = false;
+	{
+		std::lock_guard<std::mutex> lock(_asyncMutex);
+		stopped = _stopAsync;
+		if (!stopped &&
+		    (_asyncThread.joinable() || StartAsyncWorker())) {
+			_pendingTransfers.emplace_back(std::move(transfer));
+			WakeUpAsyncWorker();
+		}
+	}
+	if (!transfer) {
+		_asyncCv.notify_one();
+		return;
+	}
+	if (stopped) {
+		transfer->Finish(abortedResponse());
+		return;
+	}
+	transfer->response.error = "failed to create curl multi handle";
+	transfer->Finish(transfer->response);
+}
+
+void CurlHelper::StopAsyncRequests()
+{
+	GetInstance().StopAsync();
+}
+
+void CurlHelper::StopAsync()
+{
+	std::thread thread;
+	{
+		std::lock_guard<std::mutex> lock(_asyncMutex);
+		_stopAsync = true;
+		thread.swap(_asyncThread);
+		WakeUpAsyncWorker();
+	}
+	_asyncCv.notify_all();
+	if (thread.joinable()) {
+		thread.join();
+	}
+
+	std::deque<std::unique_ptr<Transfer>> aborted;
+	{
+		std::lock_guard<std::mutex> lock(_asyncMutex);
+		aborted.swap(_pendingTransfers);
+		_stopAsync = false;
+	}
+	for (auto &transfer : aborted) {
+		transfer->Finish(abortedResponse());
+	}
+}
+
+void CurlHelper::WakeUpAsyncWorker()
+{
+	// The multi handle is only cleaned up while holding the async mutex,
+	// so it is safe to use here, if the caller holds it
+	if (_multiWakeup && _multi) {
+		_multiWakeup(_multi);
+	}
+}
+
+static size_t writeResponse(char *ptr, size_t size, size_t nmemb,
+			    CurlResponse *response)
+{
+	response->body.append(ptr, size * nmemb);
+	return size * nmemb;
+}
+
+static size_t dropResponse(char *, size_t size, size_t nmemb, void *)
+{
+	return size * nmemb;
+}
+
+static size_t storeHeader(char *ptr, size_t size, size_t nmemb,
+			  CurlResponse *response)
+{
+	const size_t length = size * nmemb;
+	const std::string_view line(ptr, length);
+	// Only the headers of the final response are kept, e.g. if redirects
+	// were followed
+	if (line.rfind("HTTP/", 0) == 0) {
+		response->headers.clear();
+		return length;
+	}
+
+	const auto separator = line.find(':');
+	if (separator == std::string_view::npos) {
+		return length;
+	}
+	std::string name(line.substr(0, separator));
+	std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+		return static_cast<char>(
+			std::tolower(static_cast<unsigned char>(c)));
+	});
+	auto value = line.substr(separator + 1);
+	const auto begin = value.find_first_not_of(" \t");
+	const auto end = value.find_last_not_of(" \t\r\n");
+	value = begin == std::string_view::npos
+			? std::string_view()
+			: value.substr(begin, end - begin + 1);
+	response->headers[name] = std::string(value);
+	return length;
+}
+
+void CurlHelper::StartTransfer(std::unique_ptr<Transfer> transfer)
+{
+	CURL *handle = nullptr;
+	if (_idleHandles.empty()) {
+		handle = _init();
+	} else {
+		// Reset handles keep their DNS cache
+		handle = _idleHandles.back();
+		_idleHandles.pop_back();
+		_reset(handle);
+	}
+	if (!handle) {
+		transfer->response.error = "failed to create curl handle";
+		transfer->Finish(transfer->response);
+		return;
+	}
+
+	const auto &request = transfer->request;
+	_setopt(handle, CURLOPT_URL, request.url.c_str());
+	_setopt(handle, CURLOPT_TIMEOUT_MS,
+		static_cast<long>(request.timeout.count()));
+	_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+	_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+	_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+	_setopt(handle, CURLOPT_ERRORBUFFER, transfer->error);
+	if (request.method == CurlRequest::Method::POST) {
+		_setopt(handle, CURLOPT_POSTFIELDSIZE,
+			static_cast<long>(request.data.size()));
+		_setopt(handle, CURLOPT_POSTFIELDS, request.data.c_str());
+	} else {
+		_setopt(handle, CURLOPT_HTTPGET, 1L);
+	}
+	for (const auto &header : request.headers) {
+		transfer->headers =
+			_slistAppend(transfer->headers, header.c_str());
+	}
+	if (transfer->headers) {
+		_setopt(handle, CURLOPT_HTTPHEADER, transfer->headers);
+	}
+	if (request.storeResponse) {
+		_setopt(handle, CURLOPT_WRITEFUNCTION, writeResponse);
+		_setopt(handle, CURLOPT_WRITEDATA, &transfer->response);
+	} else {
+		_setopt(handle, CURLOPT_WRITEFUNCTION, dropResponse);
+	}
+	_setopt(handle, CURLOPT_HEADERFUNCTION, storeHeader);
+	_setopt(handle, CURLOPT_HEADERDATA, &transfer->response);
+
+	_multiAddHandle(_multi, handle);
+	_activeTransfers[handle] = std::move(transfer);
+}
+
+void CurlHelper::FinishTransfers()
+{
+	int remaining = 0;
+	while (CURLMsg *msg = _multiInfoRead(_multi, &remaining)) {
+		if (msg->msg != CURLMSG_DONE) {
+			continue;
+		}
+		auto handle = msg->easy_handle;
+		const auto result = msg->data.result;
+		_multiRemoveHandle(_multi, handle);
+
+		auto it = _activeTransfers.find(handle);
+		if (it == _activeTransfers.end()) {
+			_cleanup(handle);
+			continue;
+		}
+		auto transfer = std::move(it->second);
+		_activeTransfers.erase(it);
+
+		auto &response = transfer->response;
+		response.result = result;
+		_getInfo(handle, CURLINFO_RESPONSE_CODE, &response.status);
+		if (result != CURLE_OK) {
+			response.error = transfer->error[0] != '\0'
+						 ? transfer->error
+						 : _error(result);
+		}
+		_slistFreeAll(transfer->headers);
+		transfer->Finish(std::move(response));
+
+		_idleHandles.emplace_back(handle);
+	}
+}
+
+void CurlHelper::AbortTransfers()
+{
+	for (auto &[handle, transfer] : _activeTransfers) {
+		_multiRemoveHandle(_multi, handle);
+		_cleanup(handle);
+		_slistFreeAll(transfer->headers);
+		transfer->Finish(abortedResponse());
+	}
+	_activeTransfers.clear();
+	for (auto handle : _idleHandles) {
+		_cleanup(handle);
+	}
+	_idleHandles.clear();
+}
+
+bool CurlHelper::StartAsyncWorker()
+{
+	_multi = _multiInit();
+	if (!_multi) {
+		blog(LOG_WARNING, "failed to create curl multi handle");
+		return false;
+	}
+	_multiSetOpt(_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+	_multiSetOpt(_multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+		     maxConnectionsPerHost);
+	_multiSetOpt(_multi, CURLMOPT_MAXCONNECTS, maxCachedConnections);
+	_asyncThread = std::thread(&CurlHelper::AsyncWorker, this);
+	return true;
+}
+
+void CurlHelper::AsyncWorker()
+{
+	int running = 0;
+	std::deque<std::unique_ptr<Transfer>> queued;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_asyncMutex);
+			if (running == 0) {
+				_asyncCv.wait(lock, [this]() {
+					return _stopAsync ||
+					       !_pendingTransfers.empty();
+				});
+			}
+			if (_stopAsync) {
+				break;
+			}
+			queued.swap(_pendingTransfers);
+		}
+
+		// Failing to start a transfer finishes it right away, which
+		// must not happen while holding the async mutex
+		for (auto &transfer : queued) {
+			StartTransfer(std::move(transfer));
+		}
+		queued.clear();
+
+		_multiPerform(_multi, &running);
+		FinishTransfers();
+		if (running == 0) {
+			continue;
+		}
+
+		// Without curl_multi_wakeup() new requests can only be
+		// picked up once the wait times out
+		if (_multiPoll && _multiWakeup) {
+			_multiPoll(_multi, nullptr, 0, 1000, nullptr);
+		} else {
+			_multiWait(_multi, nullptr, 0, 10, nullptr);
+		}
+	}
+
+	AbortTransfers();
+	std::lock_guard<std::mutex> lock(_asyncMutex);
+	_multiCleanup(_multi);
+	_multi = nullptr;
+}
+
 bool CurlHelper::LoadLib()
 {
 	_lib = new QLibrary(curl_library_name, nullptr);
@@ -134,4 +466,38 @@ bool CurlHelper::Resolve()
 	return false;
 }
 
+bool CurlHelper::ResolveMulti()
+{
+	_getInfo = (getInfoFunction)_lib->resolve("curl_easy_getinfo");
+	_reset = (resetFunction)_lib->resolve("curl_easy_reset");
+	_slistFreeAll =
+		(slistFreeAllFunction)_lib->resolve("curl_slist_free_all");
+	_multiInit = (multiInitFunction)_lib->resolve("curl_multi_init");
+	_multiCleanup =
+		(multiCleanupFunction)_lib->resolve("curl_multi_cleanup");
+	_multiSetOpt = (multiSetOptFunction)_lib->resolve("curl_multi_setopt");
+	_multiAddHandle =
+		(multiAddHandleFunction)_lib->resolve("curl_multi_add_handle");
+	_multiRemoveHandle = (multiRemoveHandleFunction)_lib->resolve(
+		"curl_multi_remove_handle");
+	_multiPerform =
+		(multiPerformFunction)_lib->resolve("curl_multi_perform");
+	_multiWait = (multiWaitFunction)_lib->resolve("curl_multi_wait");
+	_multiPoll = (multiWaitFunction)_lib->resolve("curl_multi_poll");
+	_multiWakeup = (multiWakeupFunction)_lib->resolve("curl_multi_wakeup");
+	_multiInfoRead =
+		(multiInfoReadFunction)_lib->resolve("curl_multi_info_read");
+
+	if (_getInfo && _reset && _slistFreeAll && _multiInit &&
+	    _multiCleanup && _multiSetOpt && _multiAddHandle &&
+	    _multiRemoveHandle && _multiPerform && _multiWait &&
+	    _multiInfoRead) {
+		return true;
+	}
+
+	blog(LOG_INFO, "curl multi interface symbols not resolved - "
+		       "asynchronous requests will not be available");
+	return false;
+}
+
 } // namespace advss
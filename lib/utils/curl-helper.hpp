@@ -4,9 +4,48 @@
 #include <curl/curl.h>
 #include <QLibrary>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace advss {
 
+struct CurlRequest {
+	enum class Method {
+		GET,
+		POST,
+	};
+
+	std::string url;
+	Method method = Method::GET;
+	// Only used for POST requests
+	std::string data;
+	std::vector<std::string> headers;
+	std::chrono::milliseconds timeout = std::chrono::seconds(1);
+	// Discard the response body if it is not needed
+	bool storeResponse = true;
+};
+
+struct CurlResponse {
+	bool Succeeded() const { return result == CURLE_OK; }
+
+	CURLcode result = CURLE_FAILED_INIT;
+	long status = 0;
+	std::string body;
+	// Header names are converted to lower case
+	std::map<std::string, std::string> headers;
+	std::string error;
+};
+
 class CurlHelper {
 public:
 	EXPORT static bool Initialized();
@@ -16,7 +55,26 @@ public:
 	EXPORT static CURLcode Perform();
 	EXPORT static char *GetError(CURLcode code);
 
+	// Performs the request on a background thread instead of blocking the
+	// caller.
+	// All asynchronous requests share a single curl multi handle, so
+	// connections to the same host are kept alive and reused by later
+	// requests and HTTP/2 requests are multiplexed over one connection.
+	// The returned future can be discarded if the result is not needed.
+	EXPORT static std::future<CurlResponse>
+	PerformAsync(const CurlRequest &);
+	// Passes the response to the callback instead, which is called on the
+	// background thread and must neither block nor start new requests
+	EXPORT static void
+	PerformAsync(const CurlRequest &,
+		     const std::function<void(CurlResponse &&)> &callback);
+	// Aborts all pending asynchronous requests and stops the background
+	// thread, which is started again by the next call to PerformAsync()
+	EXPORT static void StopAsyncRequests();
+
 private:
+	struct Transfer;
+
 	CurlHelper();
 	CurlHelper(const CurlHelper &) = delete;
 	CurlHelper &operator=(const CurlHelper &) = delete;
@@ -29,11 +87,34 @@ private:
 	typedef CURLcode (*performFunction)(CURL *);
 	typedef void (*cleanupFunction)(CURL *);
 	typedef char *(*errorFunction)(CURLcode);
+	typedef CURLcode (*getInfoFunction)(CURL *, CURLINFO, ...);
+	typedef void (*resetFunction)(CURL *);
+	typedef void (*slistFreeAllFunction)(struct curl_slist *);
+	typedef CURLM *(*multiInitFunction)(void);
+	typedef CURLMcode (*multiCleanupFunction)(CURLM *);
+	typedef CURLMcode (*multiSetOptFunction)(CURLM *, CURLMoption, ...);
+	typedef CURLMcode (*multiAddHandleFunction)(CURLM *, CURL *);
+	typedef CURLMcode (*multiRemoveHandleFunction)(CURLM *, CURL *);
+	typedef CURLMcode (*multiPerformFunction)(CURLM *, int *);
+	typedef CURLMcode (*multiWaitFunction)(CURLM *, struct curl_waitfd[],
+					       unsigned int, int, int *);
+	typedef CURLMcode (*multiWakeupFunction)(CURLM *);
+	typedef CURLMsg *(*multiInfoReadFunction)(CURLM *, int *);
 
 	EXPORT static CurlHelper &GetInstance();
 
 	bool LoadLib();
 	bool Resolve();
+	bool ResolveMulti();
+
+	void QueueTransfer(std::unique_ptr<Transfer>);
+	void StartTransfer(std::unique_ptr<Transfer>);
+	void FinishTransfers();
+	void AbortTransfers();
+	bool StartAsyncWorker();
+	void AsyncWorker();
+	void WakeUpAsyncWorker();
+	void StopAsync();
 
 	initFunction _init = nullptr;
 	setOptFunction _setopt = nullptr;
@@ -41,9 +122,36 @@ private:
 	performFunction _perform = nullptr;
 	cleanupFunction _cleanup = nullptr;
 	errorFunction _error = nullptr;
+	getInfoFunction _getInfo = nullptr;
+	resetFunction _reset = nullptr;
+	slistFreeAllFunction _slistFreeAll = nullptr;
+	multiInitFunction _multiInit = nullptr;
+	multiCleanupFunction _multiCleanup = nullptr;
+	multiSetOptFunction _multiSetOpt = nullptr;
+	multiAddHandleFunction _multiAddHandle = nullptr;
+	multiRemoveHandleFunction _multiRemoveHandle = nullptr;
+	multiPerformFunction _multiPerform = nullptr;
+	multiWaitFunction _multiWait = nullptr;
+	// Optional, as they require curl 7.66 and 7.68
+	multiWaitFunction _multiPoll = nullptr;
+	multiWakeupFunction _multiWakeup = nullptr;
+	multiInfoReadFunction _multiInfoRead = nullptr;
 	CURL *_curl = nullptr;
 	QLibrary *_lib;
 	std::atomic_bool _initialized = {false};
+	bool _multiAvailable = false;
+
+	// Only accessed by the async worker thread
+	std::unordered_map<CURL *, std::unique_ptr<Transfer>> _activeTransfers;
+	std::vector<CURL *> _idleHandles;
+
+	std::mutex _asyncMutex;
+	// Only created and cleaned up while holding _asyncMutex
+	CURLM *_multi = nullptr;
+	std::condition_variable _asyncCv;
+	std::deque<std::unique_ptr<Transfer>> _pendingTransfers;
+	std::thread _asyncThread;
+	bool _stopAsync = false;
 };
 
 template<typename... Args>
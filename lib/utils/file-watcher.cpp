@@ -0,0 +1,1093 @@
+#include "file-watcher.hpp"
+#include "log-helper.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace advss {
+
+// Amount of data compared to detect if a file was only appended to
+static constexpr size_t compareSize = 64;
+static constexpr size_t readChunkSize = 64 * 1024;
+// Longer lines are split to limit the memory used to follow files
+static constexpr size_t maxLineLength = 1024 * 1024;
+
+// Changes of more files are dropped until the changes are requested again
+static constexpr size_t maxPendingChanges = 10000;
+// Folders are scanned at most this often if no notifications are available
+static constexpr auto folderScanInterval = std::chrono::seconds(1);
+
+// FNV-1a, which can be calculated incrementally while reading the file
+static constexpr uint64_t hashOffsetBasis = 14695981039346656037ULL;
+static constexpr uint64_t hashPrime = 1099511628211ULL;
+
+struct FileWatcher::Directory {
+	// Watches by file name
+	std::multimap<std::string, Watch *> watches;
+	// Folder watches and the path relative to the watched folder
+	std::vector<std::pair<FolderWatch *, std::string>> folders;
+};
+
+std::mutex FileWatcher::_mutex;
+std::map<int, FileWatcher::Directory> FileWatcher::_directories;
+
+#ifdef __linux__
+static int inotifyFd = -1;
+static int stopPipe[2] = {-1, -1};
+static std::thread notifyThread;
+static constexpr uint32_t watchMask =
+	IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_DELETE_SELF |
+	IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+#endif
+
+static std::string joinPath(const std::string &dir, const std::string &name)
+{
+	return dir.empty() ? name : dir + "/" + name;
+}
+
+FileWatcher::Watch::~Watch()
+{
+	FileWatcher::Unregister(this);
+}
+
+bool FileWatcher::Watch::Changed()
+{
+	if (_notified) {
+		return _changed.exchange(false);
+	}
+
+	std::error_code ec;
+	const auto path = std::filesystem::u8path(_path);
+	const auto writeTime = std::filesystem::last_write_time(path, ec);
+	const auto size = std::filesystem::file_size(path, ec);
+	const bool changed = _changed.exchange(false) ||
+			     writeTime != _lastWriteTime || size != _lastSize;
+	_lastWriteTime = writeTime;
+	_lastSize = size;
+	return changed;
+}
+
+std::shared_ptr<FileWatcher::Watch>
+FileWatcher::Register(const std::string &path)
+{
+	auto watch = std::make_shared<Watch>(path);
+#ifdef __linux__
+	std::error_code ec;
+	auto file = std::filesystem::weakly_canonical(
+		std::filesystem::u8path(path), ec);
+	if (ec) {
+		file = std::filesystem::u8path(path);
+	}
+	auto dir = file.parent_path();
+	if (dir.empty()) {
+		dir = ".";
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!StartThread()) {
+		return watch;
+	}
+
+	const int wd = inotify_add_watch(inotifyFd, dir.c_str(), watchMask);
+	if (wd < 0) {
+		vblog(LOG_INFO, "cannot watch \"%s\" for changes: %s",
+		      path.c_str(), strerror(errno));
+		return watch;
+	}
+
+	// The same descriptor is returned for directories already watched
+	_directories[wd].watches.emplace(file.filename().string(),
+					 watch.get());
+	watch->_directory = wd;
+	watch->_notified = true;
+#endif
+	return watch;
+}
+
+void FileWatcher::Unregister(Watch *watch)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _directories.find(watch->_directory);
+	if (it == _directories.end()) {
+		return;
+	}
+
+	auto &watches = it->second.watches;
+	for (auto entry = watches.begin(); entry != watches.end(); ++entry) {
+		if (entry->second == watch) {
+			watches.erase(entry);
+			break;
+		}
+	}
+	RemoveIfUnused(it);
+}
+
+void FileWatcher::RemoveIfUnused(std::map<int, Directory>::iterator it)
+{
+	if (!it->second.watches.empty() || !it->second.folders.empty()) {
+		return;
+	}
+
+#ifdef __linux__
+	inotify_rm_watch(inotifyFd, it->first);
+#endif
+	_directories.erase(it);
+}
+
+FileWatcher::FolderWatch::FolderWatch(const std::string &path, bool recursive)
+	: _path(path),
+	  _root(std::filesystem::u8path(path)),
+	  _recursive(recursive)
+{
+}
+
+FileWatcher::FolderWatch::~FolderWatch()
+{
+	FileWatcher::Unregister(this);
+}
+
+std::shared_ptr<FileWatcher::FolderWatch>
+FileWatcher::RegisterFolder(const std::string &path, bool recursive)
+{
+	auto watch = std::make_shared<FolderWatch>(path, recursive);
+	// The content the changes are compared to, which is kept up to date by
+	// the notifications in case they stop working later on
+	watch->Scan();
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (StartThread()) {
+		watch->_notified = WatchFolder(watch.get(), "", false);
+	}
+	return watch;
+}
+
+void FileWatcher::Unregister(FolderWatch *watch)
+{
+	auto isWatch = [watch](const std::pair<FolderWatch *, std::string> &e) {
+		return e.first == watch;
+	};
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const int wd : watch->_directories) {
+		auto it = _directories.find(wd);
+		if (it == _directories.end()) {
+			continue;
+		}
+		auto &folders = it->second.folders;
+		folders.erase(std::remove_if(folders.begin(), folders.end(),
+					     isWatch),
+			      folders.end());
+		RemoveIfUnused(it);
+	}
+	watch->_directories.clear();
+}
+
+void FileWatcher::UnwatchFolder(FolderWatch *watch,
+				const std::string &relativePath)
+{
+	const auto prefix = relativePath + "/";
+	auto isAffected = [&](const std::pair<FolderWatch *, std::string> &e) {
+		return e.first == watch &&
+		       (e.second == relativePath ||
+			e.second.compare(0, prefix.size(), prefix) == 0);
+	};
+
+	auto &wds = watch->_directories;
+	for (auto wd = wds.begin(); wd != wds.end();) {
+		auto it = _directories.find(*wd);
+		if (it == _directories.end()) {
+			wd = wds.erase(wd);
+			continue;
+		}
+		auto &folders = it->second.folders;
+		const auto size = folders.size();
+		folders.erase(std::remove_if(folders.begin(), folders.end(),
+					     isAffected),
+			      folders.end());
+		if (folders.size() == size) {
+			++wd;
+			continue;
+		}
+		RemoveIfUnused(it);
+		wd = wds.erase(wd);
+	}
+}
+
+#ifdef __linux__
+
+bool FileWatcher::StartThread()
+{
+	if (inotifyFd >= 0) {
+		return true;
+	}
+
+	inotifyFd = inotify_init1(IN_CLOEXEC);
+	if (inotifyFd < 0) {
+		blog(LOG_WARNING, "failed to initialize inotify: %s",
+		     strerror(errno));
+		return false;
+	}
+	if (pipe(stopPipe) != 0) {
+		blog(LOG_WARNING, "failed to create pipe: %s", strerror(errno));
+		close(inotifyFd);
+		inotifyFd = -1;
+		return false;
+	}
+
+	notifyThread = std::thread(Run, inotifyFd, stopPipe[0]);
+	return true;
+}
+
+void FileWatcher::Run(int fd, int stopFd)
+{
+	alignas(inotify_event) char buffer[4096];
+	pollfd fds[2] = {{fd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+	while (true) {
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			blog(LOG_WARNING, "failed to wait for file changes: %s",
+			     strerror(errno));
+			return;
+		}
+		if (fds[1].revents) {
+			return;
+		}
+
+		const auto size = read(fd, buffer, sizeof(buffer));
+		if (size > 0) {
+			HandleEvents(buffer, size);
+		}
+	}
+}
+
+void FileWatcher::HandleEvents(const char *data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (size_t offset = 0; offset < size;) {
+		const auto event =
+			reinterpret_cast<const inotify_event *>(data + offset);
+		offset += sizeof(inotify_event) + event->len;
+
+		if (event->mask & IN_Q_OVERFLOW) {
+			// Events were lost, so any file might have changed
+			for (auto &directory : _directories) {
+				for (auto &entry : directory.second.watches) {
+					entry.second->_changed = true;
+				}
+				for (auto &entry : directory.second.folders) {
+					entry.first->_overflow = true;
+				}
+			}
+			continue;
+		}
+
+		auto it = _directories.find(event->wd);
+		if (it == _directories.end()) {
+			continue;
+		}
+
+		auto &watches = it->second.watches;
+		auto &folders = it->second.folders;
+		const auto dirGone = IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED;
+		if (event->mask & dirGone) {
+			// The directory itself is gone, so fall back to
+			// comparing the modification time
+			for (auto &entry : watches) {
+				entry.second->_changed = true;
+				entry.second->_notified = false;
+				entry.second->_directory = -1;
+			}
+			watches.clear();
+			HandleFolderGone(event->wd, event->mask, folders);
+			if (folders.empty()) {
+				if (!(event->mask & IN_IGNORED)) {
+					inotify_rm_watch(inotifyFd, event->wd);
+				}
+				_directories.erase(it);
+			}
+			continue;
+		}
+
+		if (event->len == 0) {
+			continue;
+		}
+		const auto range = watches.equal_range(event->name);
+		for (auto entry = range.first; entry != range.second; ++entry) {
+			entry->second->_changed = true;
+		}
+		// Handling the event might watch further directories
+		const auto folderEntries = folders;
+		for (const auto &[folder, relativePath] : folderEntries) {
+			folder->HandleEvent(relativePath, event->name,
+					    event->mask);
+		}
+	}
+}
+
+void FileWatcher::HandleFolderGone(
+	int wd, uint32_t mask,
+	std::vector<std::pair<FolderWatch *, std::string>> &folders)
+{
+	for (auto entry = folders.begin(); entry != folders.end();) {
+		auto folder = entry->first;
+		const bool isRoot = entry->second.empty();
+		// Moved subfolders are handled with the event of their parent
+		if ((mask & IN_MOVE_SELF) && !isRoot) {
+			++entry;
+			continue;
+		}
+		if (isRoot) {
+			// Fall back to scanning the folder
+			folder->_notified = false;
+		}
+		auto &wds = folder->_directories;
+		wds.erase(std::remove(wds.begin(), wds.end(), wd), wds.end());
+		entry = folders.erase(entry);
+	}
+}
+
+bool FileWatcher::WatchFolder(FolderWatch *folder,
+			      const std::string &relativePath,
+			      bool reportContent)
+{
+	const auto dir = relativePath.empty()
+				 ? folder->_root
+				 : folder->_root / std::filesystem::u8path(
+							   relativePath);
+	const int wd = inotify_add_watch(inotifyFd, dir.c_str(), watchMask);
+	if (wd < 0) {
+		vblog(LOG_INFO, "cannot watch \"%s\" for changes: %s",
+		      dir.u8string().c_str(), strerror(errno));
+		return false;
+	}
+
+	// The same descriptor is returned for directories already watched,
+	// e.g. if a subfolder was moved within the watched folder
+	auto &folders = _directories[wd].folders;
+	auto it = std::find_if(folders.begin(), folders.end(),
+			       [folder](const auto &entry) {
+				       return entry.first == folder;
+			       });
+	if (it == folders.end()) {
+		folders.emplace_back(folder, relativePath);
+		folder->_directories.emplace_back(wd);
+	} else {
+		it->second = relativePath;
+	}
+
+	if (!folder->_recursive) {
+		return true;
+	}
+
+	// Changes in subfolders which cannot be watched would be missed, so
+	// the whole folder has to be scanned instead
+	bool success = true;
+	std::error_code ec;
+	for (std::filesystem::directory_iterator
+		     entry(dir,
+			   std::filesystem::directory_options::
+				   skip_permission_denied,
+			   ec),
+		     end;
+	     !ec && entry != end; entry.increment(ec)) {
+		std::error_code typeEc;
+		const bool isDir = entry->is_directory(typeEc) &&
+				   !entry->is_symlink(typeEc);
+		const auto path = joinPath(
+			relativePath, entry->path().filename().u8string());
+		// Files might have been created before the folder was watched
+		if (reportContent) {
+			folder->Record(path, isDir, FolderWatch::ADDED);
+			folder->UpdateEntry(path, isDir, FolderWatch::ADDED);
+		}
+		if (isDir && !WatchFolder(folder, path, reportContent)) {
+			success = false;
+		}
+	}
+	return success && !ec;
+}
+
+void FileWatcher::FolderWatch::HandleEvent(const std::string &relativePath,
+					   const char *name, uint32_t mask)
+{
+	// The changes are detected by scanning once notifications failed
+	if (!_notified) {
+		return;
+	}
+
+	const auto path = joinPath(relativePath, name);
+	const bool dir = mask & IN_ISDIR;
+	if (mask & (IN_CREATE | IN_MOVED_TO)) {
+		Record(path, dir, ADDED);
+		UpdateEntry(path, dir, ADDED);
+		if (dir && _recursive &&
+		    !FileWatcher::WatchFolder(this, path, true)) {
+			_notified = false;
+		}
+	}
+	if (mask & (IN_DELETE | IN_MOVED_FROM)) {
+		Record(path, dir, REMOVED);
+		UpdateEntry(path, dir, REMOVED);
+		if (dir && _recursive) {
+			FileWatcher::UnwatchFolder(this, path);
+		}
+	}
+	if ((mask & IN_MODIFY) && !dir) {
+		Record(path, dir, CHANGED);
+		UpdateEntry(path, dir, CHANGED);
+	}
+}
+
+void FileWatcher::Stop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (inotifyFd < 0) {
+		return;
+	}
+
+	// Closing the write end of the pipe wakes up the thread
+	close(stopPipe[1]);
+	lock.unlock();
+	notifyThread.join();
+	lock.lock();
+
+	for (auto &directory : _directories) {
+		for (auto &entry : directory.second.watches) {
+			entry.second->_changed = true;
+			entry.second->_notified = false;
+			entry.second->_directory = -1;
+		}
+		for (auto &entry : directory.second.folders) {
+			entry.first->_notified = false;
+			entry.first->_directories.clear();
+		}
+	}
+	_directories.clear();
+	close(stopPipe[0]);
+	close(inotifyFd);
+	inotifyFd = -1;
+}
+
+#else
+
+bool FileWatcher::StartThread()
+{
+	return false;
+}
+
+bool FileWatcher::WatchFolder(FolderWatch *, const std::string &, bool)
+{
+	return false;
+}
+
+void FileWatcher::Stop() {}
+
+#endif
+
+void FileWatcher::FolderWatch::Record(const std::string &path, bool dir,
+				      Flag change)
+{
+	const uint8_t type = dir ? DIRECTORY : 0;
+	auto it = _pending.find(path);
+	if (it == _pending.end()) {
+		if (_pending.size() >= maxPendingChanges) {
+			_overflow = true;
+			return;
+		}
+		_pending.emplace(path, change | type);
+		return;
+	}
+
+	// Bursts of changes of the same path are combined
+	auto &flags = it->second;
+	const bool sameType = (flags & DIRECTORY) == type;
+	switch (change) {
+	case ADDED:
+		if (!(flags & REMOVED) || !sameType) {
+			flags = ADDED | type;
+		} else if (dir) {
+			flags = REMOVED | ADDED | type;
+		} else {
+			// Replaced files are reported as changed
+			flags = CHANGED;
+		}
+		break;
+	case CHANGED:
+		// Changes of new files are part of adding them
+		if (!(flags & ADDED)) {
+			flags |= CHANGED;
+		}
+		break;
+	case REMOVED:
+		// Files which only existed in between are not reported
+		if ((flags & ADDED) && !(flags & REMOVED) && sameType) {
+			_pending.erase(it);
+		} else {
+			flags = REMOVED | type;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void FileWatcher::FolderWatch::UpdateEntry(const std::string &path, bool dir,
+					   Flag change)
+{
+	if (change == REMOVED) {
+		_entries.erase(path);
+		if (!dir) {
+			return;
+		}
+		const auto prefix = path + "/";
+		for (auto it = _entries.begin(); it != _entries.end();) {
+			if (it->first.compare(0, prefix.size(), prefix) == 0) {
+				it = _entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+		return;
+	}
+
+	Entry entry;
+	entry.dir = dir;
+	if (!dir) {
+		std::error_code ec;
+		const auto file = _root / std::filesystem::u8path(path);
+		entry.writeTime = std::filesystem::last_write_time(file, ec);
+		entry.size = std::filesystem::file_size(file, ec);
+	}
+	_entries[path] = entry;
+}
+
+FileWatcher::FolderWatch::Changes FileWatcher::FolderWatch::TakeChanges()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_notified) {
+		// The folder is scanned without holding the lock, which is
+		// only required to record the changes
+		lock.unlock();
+		Scan();
+		lock.lock();
+	}
+
+	Changes changes;
+	for (const auto &[path, flags] : _pending) {
+		const bool dir = flags & DIRECTORY;
+		if (flags & ADDED) {
+			(dir ? changes.newDirs : changes.newFiles)
+				.emplace_back(path);
+		}
+		if (flags & CHANGED) {
+			changes.changedFiles.emplace_back(path);
+		}
+		if (flags & REMOVED) {
+			(dir ? changes.removedDirs : changes.removedFiles)
+				.emplace_back(path);
+		}
+	}
+	changes.overflow = _overflow;
+	_pending.clear();
+	_overflow = false;
+	lock.unlock();
+
+	for (auto list : {&changes.newFiles, &changes.changedFiles,
+			  &changes.removedFiles, &changes.newDirs,
+			  &changes.removedDirs}) {
+		std::sort(list->begin(), list->end());
+	}
+	return changes;
+}
+
+void FileWatcher::FolderWatch::Scan()
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (_scanned && now - _lastScan < folderScanInterval) {
+		return;
+	}
+	_lastScan = now;
+
+	std::unordered_map<std::string, Entry> entries;
+	std::error_code ec;
+	const auto options =
+		std::filesystem::directory_options::skip_permission_denied;
+	auto addEntry = [&entries](const std::filesystem::directory_entry &e,
+				   const std::string &path) {
+		std::error_code ec;
+		Entry entry;
+		entry.dir = e.is_directory(ec);
+		if (!entry.dir) {
+			entry.writeTime = e.last_write_time(ec);
+			entry.size = e.file_size(ec);
+		}
+		entries.emplace(path, entry);
+	};
+	if (_recursive) {
+		for (std::filesystem::recursive_directory_iterator it(
+			     _root, options, ec),
+		     end;
+		     !ec && it != end; it.increment(ec)) {
+			const auto relative =
+				it->path().lexically_relative(_root);
+			addEntry(*it, relative.generic_u8string());
+		}
+	} else {
+		for (std::filesystem::directory_iterator it(_root, options, ec),
+		     end;
+		     !ec && it != end; it.increment(ec)) {
+			addEntry(*it, it->path().filename().u8string());
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_scanned) {
+		_entries = std::move(entries);
+		_scanned = true;
+		return;
+	}
+
+	for (const auto &[path, entry] : entries) {
+		auto it = _entries.find(path);
+		if (it == _entries.end()) {
+			Record(path, entry.dir, ADDED);
+		} else if (!entry.dir &&
+			   (it->second.writeTime != entry.writeTime ||
+			    it->second.size != entry.size)) {
+			Record(path, entry.dir, CHANGED);
+		}
+	}
+	for (const auto &[path, entry] : _entries) {
+		if (entries.find(path) == entries.end()) {
+			Record(path, entry.dir, REMOVED);
+		}
+	}
+	_entries = std::move(entries);
+}
+
+static uint64_t updateHash(uint64_t hash, const char *data, size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= hashPrime;
+	}
+	return hash;
+}
+
+// Converts "\r\n" to "\n" starting at the given offset
+static void convertLineEndings(std::string &content, size_t offset)
+{
+	// The previous read might have ended in between "\r" and "\n"
+	if (offset > 0 && content[offset - 1] == '\r') {
+		--offset;
+	}
+	if (content.find('\r', offset) == std::string::npos) {
+		return;
+	}
+
+	size_t end = offset;
+	for (size_t pos = offset; pos < content.size(); ++pos) {
+		if (content[pos] == '\r' && pos + 1 < content.size() &&
+		    content[pos + 1] == '\n') {
+			continue;
+		}
+		content[end++] = content[pos];
+	}
+	content.resize(end);
+}
+
+static void appendUtf8(std::string &out, uint32_t codePoint)
+{
+	if (codePoint < 0x80) {
+		out += static_cast<char>(codePoint);
+	} else if (codePoint < 0x800) {
+		out += static_cast<char>(0xC0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else if (codePoint < 0x10000) {
+		out += static_cast<char>(0xE0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+
+// Appends the UTF-16 data converted to UTF-8 and returns the size of the data
+// converted, which excludes an incomplete character at its end
+static size_t appendUtf16AsUtf8(std::string &out, const std::string &data,
+				bool bigEndian)
+{
+	const auto unitAt = [&data, bigEndian](size_t pos) -> uint32_t {
+		const auto first = static_cast<unsigned char>(data[pos]);
+		const auto second = static_cast<unsigned char>(data[pos + 1]);
+		return bigEndian ? (first << 8) | second
+				 : (second << 8) | first;
+	};
+	static constexpr uint32_t replacementCharacter = 0xFFFD;
+
+	size_t pos = 0;
+	while (pos + 1 < data.size()) {
+		uint32_t codePoint = unitAt(pos);
+		size_t size = 2;
+		if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+			if (pos + 3 >= data.size()) {
+				break;
+			}
+			const auto low = unitAt(pos + 2);
+			if (low >= 0xDC00 && low <= 0xDFFF) {
+				codePoint = 0x10000 +
+					    ((codePoint - 0xD800) << 10) +
+					    (low - 0xDC00);
+				size = 4;
+			} else {
+				codePoint = replacementCharacter;
+			}
+		} else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+			codePoint = replacementCharacter;
+		}
+		appendUtf8(out, codePoint);
+		pos += size;
+	}
+	return pos;
+}
+
+WatchedFile::WatchedFile(const WatchedFile &other)
+	: _lineEndings(other._lineEndings)
+{
+	Reset();
+}
+
+WatchedFile &WatchedFile::operator=(const WatchedFile &other)
+{
+	if (this != &other) {
+		_lineEndings = other._lineEndings;
+		_watch.reset();
+		Reset();
+	}
+	return *this;
+}
+
+void WatchedFile::Reset()
+{
+	_available = false;
+	_content.clear();
+	_hash = hashOffsetBasis;
+	_size = 0;
+	_head.clear();
+	_tail.clear();
+	_encoding = Encoding::UTF8;
+	_undecoded.clear();
+}
+
+WatchedFile::State WatchedFile::Update(const std::string &path)
+{
+	if (!_watch || _watch->GetPath() != path) {
+		Reset();
+		_watch = FileWatcher::Register(path);
+	}
+
+	if (!_watch->Changed()) {
+		return _available ? State::UNCHANGED : State::UNAVAILABLE;
+	}
+
+	const auto filePath = std::filesystem::u8path(path);
+	std::ifstream file(filePath, std::ios::binary);
+	std::error_code ec;
+	const auto size = std::filesystem::file_size(filePath, ec);
+	if (!file || ec) {
+		Reset();
+		return State::UNAVAILABLE;
+	}
+
+	if (_available && WasAppendedTo(file, size)) {
+		Read(file, size);
+		return State::APPENDED;
+	}
+
+	const bool wasAvailable = _available;
+	const auto previousHash = _hash;
+	Reset();
+	if (!Read(file, size)) {
+		Reset();
+		return State::UNAVAILABLE;
+	}
+	_available = true;
+	return wasAvailable && _hash == previousHash ? State::UNCHANGED
+						     : State::MODIFIED;
+}
+
+bool WatchedFile::WasAppendedTo(std::istream &file, uintmax_t size)
+{
+	if (size <= _size) {
+		return false;
+	}
+
+	char data[compareSize];
+	file.seekg(0);
+	file.read(data, _head.size());
+	if (!file || memcmp(data, _head.data(), _head.size()) != 0) {
+		return false;
+	}
+	file.seekg(static_cast<std::streamoff>(_size - _tail.size()));
+	file.read(data, _tail.size());
+	return file && memcmp(data, _tail.data(), _tail.size()) == 0;
+}
+
+bool WatchedFile::Read(std::istream &file, uintmax_t size)
+{
+	file.clear();
+	file.seekg(static_cast<std::streamoff>(_size));
+	if (!file) {
+		return false;
+	}
+
+	const size_t contentOffset = _content.size();
+	_content.reserve(contentOffset + static_cast<size_t>(size - _size));
+	std::string chunk;
+	while (_size < size) {
+		const auto chunkSize = static_cast<size_t>(
+			std::min<uintmax_t>(readChunkSize, size - _size));
+		chunk.resize(chunkSize);
+		file.read(chunk.data(), chunkSize);
+		const auto readSize = static_cast<size_t>(file.gcount());
+		chunk.resize(readSize);
+		if (readSize == 0) {
+			// The file was truncated while reading
+			break;
+		}
+
+		const char *data = chunk.data();
+		_hash = updateHash(_hash, data, readSize);
+		const bool atStart = _size == 0;
+		_size += readSize;
+		if (_head.size() < compareSize) {
+			_head.append(data, std::min(compareSize - _head.size(),
+						    readSize));
+		}
+		if (readSize >= compareSize) {
+			_tail.assign(data + readSize - compareSize,
+				     compareSize);
+		} else {
+			_tail.append(data, readSize);
+			if (_tail.size() > compareSize) {
+				_tail.erase(0, _tail.size() - compareSize);
+			}
+		}
+		AppendContent(chunk, atStart);
+	}
+
+	if (_lineEndings == LineEndings::CONVERT) {
+		convertLineEndings(_content, contentOffset);
+	}
+	return true;
+}
+
+void WatchedFile::AppendContent(std::string &data, bool atStart)
+{
+	if (atStart) {
+		static constexpr std::string_view utf8Bom = "\xEF\xBB\xBF";
+		static constexpr std::string_view utf16LEBom = "\xFF\xFE";
+		static constexpr std::string_view utf16BEBom = "\xFE\xFF";
+		const std::string_view start(data);
+		if (start.substr(0, utf8Bom.size()) == utf8Bom) {
+			data.erase(0, utf8Bom.size());
+		} else if (start.substr(0, utf16LEBom.size()) == utf16LEBom) {
+			_encoding = Encoding::UTF16LE;
+			data.erase(0, utf16LEBom.size());
+		} else if (start.substr(0, utf16BEBom.size()) == utf16BEBom) {
+			_encoding = Encoding::UTF16BE;
+			data.erase(0, utf16BEBom.size());
+		}
+	}
+
+	if (_encoding == Encoding::UTF8) {
+		_content.append(data);
+		return;
+	}
+
+	_undecoded.append(data);
+	const auto converted = appendUtf16AsUtf8(
+		_content, _undecoded, _encoding == Encoding::UTF16BE);
+	_undecoded.erase(0, converted);
+}
+
+// Identifies the file a path refers to, so files which were replaced by a
+// different one can be told apart from files which were written to
+static bool getFileId(const std::filesystem::path &path,
+		      std::pair<uint64_t, uint64_t> &id)
+{
+#ifdef _WIN32
+	HANDLE handle = CreateFileW(path.c_str(), 0,
+				    FILE_SHARE_READ | FILE_SHARE_WRITE |
+					    FILE_SHARE_DELETE,
+				    nullptr, OPEN_EXISTING,
+				    FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	BY_HANDLE_FILE_INFORMATION info;
+	const bool success = GetFileInformationByHandle(handle, &info);
+	CloseHandle(handle);
+	if (!success) {
+		return false;
+	}
+	id = {info.dwVolumeSerialNumber,
+	      (static_cast<uint64_t>(info.nFileIndexHigh) << 32) |
+		      info.nFileIndexLow};
+	return true;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) {
+		return false;
+	}
+	id = {static_cast<uint64_t>(info.st_dev),
+	      static_cast<uint64_t>(info.st_ino)};
+	return true;
+#endif
+}
+
+void FileTail::Reset()
+{
+	_started = false;
+	_pendingData = false;
+	_offset = 0;
+	_hasFileId = false;
+	_head.clear();
+	_buffer.clear();
+	_bufferPos = 0;
+}
+
+bool FileTail::FindLine(const std::string &path,
+			const std::function<bool(std::string_view)> &matches)
+{
+	if (!_watch || _watch->GetPath() != path) {
+		Reset();
+		_watch = FileWatcher::Register(path);
+	}
+
+	if (FindBufferedLine(matches)) {
+		return true;
+	}
+	if (!_watch->Changed() && !_pendingData) {
+		return false;
+	}
+
+	const auto filePath = std::filesystem::u8path(path);
+	std::ifstream file(filePath, std::ios::binary);
+	std::error_code ec;
+	const auto size = std::filesystem::file_size(filePath, ec);
+	if (!file || ec) {
+		// Follow the file from its start once it is created again
+		_started = true;
+		_pendingData = false;
+		_offset = 0;
+		_hasFileId = false;
+		_head.clear();
+		return false;
+	}
+
+	if (!_started) {
+		_started = true;
+		_offset = size;
+	}
+	CheckForReplacedFile(filePath, file, size);
+
+	file.seekg(static_cast<std::streamoff>(_offset));
+	while (_offset < size && file) {
+		// Only keep the incomplete line at the end of the buffer
+		_buffer.erase(0, _bufferPos);
+		_bufferPos = 0;
+
+		const auto bufferSize = _buffer.size();
+		const auto chunkSize = static_cast<size_t>(
+			std::min<uintmax_t>(readChunkSize, size - _offset));
+		_buffer.resize(bufferSize + chunkSize);
+		file.read(&_buffer[bufferSize], chunkSize);
+		const auto readSize = static_cast<size_t>(file.gcount());
+		_buffer.resize(bufferSize + readSize);
+		_offset += readSize;
+
+		if (FindBufferedLine(matches)) {
+			_pendingData = _offset < size;
+			return true;
+		}
+	}
+	_pendingData = false;
+	return false;
+}
+
+bool FileTail::FindBufferedLine(
+	const std::function<bool(std::string_view)> &matches)
+{
+	while (_bufferPos < _buffer.size()) {
+		auto end = _buffer.find('\n', _bufferPos);
+		if (end == std::string::npos) {
+			if (_buffer.size() - _bufferPos < maxLineLength) {
+				return false;
+			}
+			end = _buffer.size();
+		}
+
+		std::string_view line(_buffer.data() + _bufferPos,
+				      end - _bufferPos);
+		_bufferPos = std::min(end + 1, _buffer.size());
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+		if (matches(line)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FileTail::CheckForReplacedFile(const std::filesystem::path &path,
+				    std::istream &file, uintmax_t size)
+{
+	// Rotated files are replaced by a different file which might start
+	// with the same data and be larger than the previous one
+	std::pair<uint64_t, uint64_t> fileId;
+	const bool hasFileId = getFileId(path, fileId);
+	const bool fileIdChanged = hasFileId && _hasFileId &&
+				   fileId != _fileId;
+	_hasFileId = hasFileId;
+	_fileId = fileId;
+
+	// Files which are rewritten in place keep their identity
+	char data[compareSize];
+	file.seekg(0);
+	file.read(data, compareSize);
+	const auto readSize = static_cast<size_t>(file.gcount());
+	file.clear();
+
+	const bool replaced =
+		fileIdChanged || size < _offset || readSize < _head.size() ||
+		memcmp(data, _head.data(), _head.size()) != 0;
+	if (replaced) {
+		_offset = 0;
+		_buffer.clear();
+		_bufferPos = 0;
+	}
+	_head.assign(data, readSize);
+}
+
+} // namespace advss
@@ -0,0 +1,257 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace advss {
+
+// Notifies about modifications of files, so their content only has to be
+// read again once they actually changed.
+//
+// On Linux all watched files are monitored by a single inotify instance
+// served by a dedicated thread.
+// The directories containing the files are watched instead of the files
+// themselves, so files which are replaced, rotated or created only later on
+// are noticed as well.
+// If no change notifications are available the modification time and size of
+// the file are compared instead, which is still considerably cheaper than
+// reading the file.
+class FileWatcher {
+public:
+	class Watch;
+	class FolderWatch;
+
+	// The file does not have to exist yet
+	[[nodiscard]] EXPORT static std::shared_ptr<Watch>
+	Register(const std::string &path);
+	[[nodiscard]] EXPORT static std::shared_ptr<FolderWatch>
+	RegisterFolder(const std::string &path, bool recursive);
+	// Stops the notification thread
+	EXPORT static void Stop();
+
+private:
+	struct Directory;
+
+	static bool StartThread();
+	static void Run(int fd, int stopFd);
+	static void Unregister(Watch *);
+	static void Unregister(FolderWatch *);
+	static bool WatchFolder(FolderWatch *, const std::string &relativePath,
+				bool reportContent);
+	static void UnwatchFolder(FolderWatch *,
+				  const std::string &relativePath);
+	static void RemoveIfUnused(std::map<int, Directory>::iterator);
+	static void HandleEvents(const char *data, size_t size);
+	static void HandleFolderGone(
+		int wd, uint32_t mask,
+		std::vector<std::pair<FolderWatch *, std::string>> &folders);
+
+	static std::mutex _mutex;
+	static std::map<int, Directory> _directories;
+};
+
+class FileWatcher::Watch {
+public:
+	Watch(const std::string &path) : _path(path) {}
+	~Watch();
+
+	// Returns true if the file might have changed since the last call and
+	// always for the first call
+	EXPORT bool Changed();
+	const std::string &GetPath() const { return _path; }
+
+private:
+	const std::string _path;
+	std::atomic_bool _changed = {true};
+	// Set while change notifications are received for this file
+	std::atomic_bool _notified = {false};
+	int _directory = -1;
+
+	std::filesystem::file_time_type _lastWriteTime;
+	uintmax_t _lastSize = 0;
+
+	friend FileWatcher;
+};
+
+// Collects the changes of the files and folders within a folder.
+//
+// With change notifications the cost of each change does not depend on the
+// number of files in the folder.
+// Otherwise the folder is scanned at most once per second when the changes
+// are requested.
+class FileWatcher::FolderWatch {
+public:
+	FolderWatch(const std::string &path, bool recursive);
+	~FolderWatch();
+
+	struct Changes {
+		std::vector<std::string> newFiles;
+		std::vector<std::string> changedFiles;
+		std::vector<std::string> removedFiles;
+		std::vector<std::string> newDirs;
+		std::vector<std::string> removedDirs;
+		// Set if changes were dropped as too many happened at once
+		bool overflow = false;
+	};
+	// Returns the changes since the last call.
+	// Paths are relative to the watched folder and use "/" as separator.
+	EXPORT Changes TakeChanges();
+	const std::string &GetPath() const { return _path; }
+	bool IsRecursive() const { return _recursive; }
+
+private:
+	enum Flag : uint8_t {
+		ADDED = 1,
+		CHANGED = 2,
+		REMOVED = 4,
+		DIRECTORY = 8,
+	};
+	struct Entry {
+		bool dir = false;
+		std::filesystem::file_time_type writeTime;
+		uintmax_t size = 0;
+	};
+
+	void Record(const std::string &path, bool dir, Flag);
+	void UpdateEntry(const std::string &path, bool dir, Flag);
+	void HandleEvent(const std::string &relativePath, const char *name,
+			 uint32_t mask);
+	void Scan();
+
+	const std::string _path;
+	const std::filesystem::path _root;
+	const bool _recursive;
+
+	// Only accessed while holding FileWatcher::_mutex
+	std::unordered_map<std::string, uint8_t> _pending;
+	bool _overflow = false;
+	bool _notified = false;
+	std::vector<int> _directories;
+
+	// The content of the folder, which is compared to when scanning it.
+	// It is kept up to date by the change notifications, so no changes are
+	// missed if they stop working.
+	// Only accessed while holding FileWatcher::_mutex.
+	std::unordered_map<std::string, Entry> _entries;
+	bool _scanned = false;
+	std::chrono::steady_clock::time_point _lastScan;
+
+	friend FileWatcher;
+};
+
+// Caches the content of a file and only reads it again once it was modified.
+// If data was only appended to the file since it was last read, only the
+// appended data is read.
+//
+// The content is provided as UTF-8 without byte order mark. Files starting
+// with a UTF-16 byte order mark are converted.
+// Line endings are only converted to "\n", like files opened in text mode,
+// if requested.
+class WatchedFile {
+public:
+	enum class State {
+		UNCHANGED,
+		APPENDED,
+		MODIFIED,
+		UNAVAILABLE,
+	};
+	enum class LineEndings {
+		KEEP,
+		CONVERT,
+	};
+
+	explicit WatchedFile(LineEndings lineEndings = LineEndings::KEEP)
+		: _lineEndings(lineEndings)
+	{
+	}
+	// Copies watch the file on their own, as each change notification is
+	// only passed on to a single watch
+	EXPORT WatchedFile(const WatchedFile &);
+	EXPORT WatchedFile &operator=(const WatchedFile &);
+	WatchedFile(WatchedFile &&) = default;
+	WatchedFile &operator=(WatchedFile &&) = default;
+
+	// Starts watching a different file if the path changed
+	EXPORT State Update(const std::string &path);
+	const std::string &GetContent() const { return _content; }
+	// Hash of the raw file content, which is calculated while reading
+	uint64_t GetHash() const { return _hash; }
+
+private:
+	void Reset();
+	bool WasAppendedTo(std::istream &, uintmax_t size);
+	bool Read(std::istream &, uintmax_t size);
+	void AppendContent(std::string &data, bool atStart);
+
+	enum class Encoding {
+		UTF8,
+		UTF16LE,
+		UTF16BE,
+	};
+
+	LineEndings _lineEndings;
+	std::shared_ptr<FileWatcher::Watch> _watch;
+	bool _available = false;
+	std::string _content;
+	uint64_t _hash = 0;
+	// Raw file size read so far and the raw data at its start and end to
+	// detect if the file was only appended to
+	uintmax_t _size = 0;
+	std::string _head;
+	std::string _tail;
+	Encoding _encoding = Encoding::UTF8;
+	// Incomplete UTF-16 characters at the end of the data read so far
+	std::string _undecoded;
+};
+
+// Follows the lines appended to a file without keeping its content in memory,
+// so the cost of each call only depends on the amount of new data.
+//
+// Lines which were already in the file once following it started are skipped.
+// If the file is truncated or replaced, e.g. due to log rotation, the new file
+// is followed from its start.
+class FileTail {
+public:
+	// Passes the new lines without line ending to matches until it returns
+	// true for one of them.
+	// The lines following the matching line are kept for the next call.
+	// Starts following a different file if the path changed.
+	EXPORT bool
+	FindLine(const std::string &path,
+		 const std::function<bool(std::string_view)> &matches);
+
+private:
+	void Reset();
+	bool FindBufferedLine(
+		const std::function<bool(std::string_view)> &matches);
+	void CheckForReplacedFile(const std::filesystem::path &,
+				  std::istream &, uintmax_t size);
+
+	std::shared_ptr<FileWatcher::Watch> _watch;
+	bool _started = false;
+	// Set while not all data of the file was read
+	bool _pendingData = false;
+	uintmax_t _offset = 0;
+	// Device and inode, or volume and file index on Windows, of the file
+	bool _hasFileId = false;
+	std::pair<uint64_t, uint64_t> _fileId;
+	// Data at the start of the file to detect if it was rewritten
+	std::string _head;
+	// Data read, but not yet passed on, which is reused between calls
+	std::string _buffer;
+	size_t _bufferPos = 0;
+};
+
+} // namespace advss
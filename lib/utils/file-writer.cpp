@@ -0,0 +1,276 @@
+#include "file-writer.hpp"
+#include "log-helper.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace advss {
+
+// Files which are appended to are closed once unused for this long, so they
+// can be moved or deleted by others
+static constexpr auto idleTimeout = std::chrono::seconds(1);
+// Paths which could not be written to are remembered for this long, so the
+// failure is not logged again for each write
+static constexpr auto failureTimeout = std::chrono::minutes(1);
+
+std::mutex FileWriter::_mutex;
+std::condition_variable FileWriter::_cv;
+std::condition_variable FileWriter::_flushed;
+std::map<std::string, FileWriter::File> FileWriter::_files;
+std::thread FileWriter::_thread;
+bool FileWriter::_stop = false;
+bool FileWriter::_writing = false;
+
+static FILE *openFile(const std::string &path, bool truncate)
+{
+#ifdef _WIN32
+	return _wfopen(std::filesystem::u8path(path).c_str(),
+		       truncate ? L"wb" : L"ab");
+#else
+	return fopen(path.c_str(), truncate ? "wb" : "ab");
+#endif
+}
+
+static bool syncFile(FILE *file)
+{
+#ifdef _WIN32
+	return _commit(_fileno(file)) == 0;
+#else
+	return fsync(fileno(file)) == 0;
+#endif
+}
+
+void FileWriter::Write(const std::string &path, const std::string &data,
+		       SyncPolicy sync)
+{
+	Queue(path, data, true, false, sync);
+}
+
+void FileWriter::Append(const std::string &path, const std::string &data,
+			SyncPolicy sync)
+{
+	Queue(path, data, false, false, sync);
+}
+
+void FileWriter::Replace(const std::string &path, const std::string &data,
+			 SyncPolicy sync)
+{
+	Queue(path, data, true, true, sync);
+}
+
+void FileWriter::Queue(const std::string &path, const std::string &data,
+		       bool truncate, bool replace, SyncPolicy sync)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_thread.joinable()) {
+		_thread = std::thread(Run);
+	}
+
+	auto &file = _files[path];
+	if (truncate) {
+		file.data = data;
+		file.truncate = true;
+		file.replace = replace;
+	} else {
+		file.data += data;
+	}
+	file.pending = true;
+	file.sync = file.sync || sync == SyncPolicy::ON_FLUSH;
+	_cv.notify_one();
+}
+
+void FileWriter::Flush()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_flushed.wait(lock, []() {
+		return !_thread.joinable() || (!_writing && !HasPendingData());
+	});
+}
+
+void FileWriter::Stop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_thread.joinable()) {
+		return;
+	}
+	_stop = true;
+	_cv.notify_one();
+	lock.unlock();
+	_thread.join();
+	lock.lock();
+	_thread = std::thread();
+	_stop = false;
+	_flushed.notify_all();
+}
+
+bool FileWriter::HasPendingData()
+{
+	for (const auto &[_, file] : _files) {
+		if (file.pending) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FileWriter::Run()
+{
+	struct Request {
+		const std::string &path;
+		File &file;
+		std::string data;
+		bool truncate;
+		bool replace;
+		bool sync;
+	};
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	bool filesOpen = false;
+	while (true) {
+		auto wakeUp = []() {
+			return _stop || HasPendingData();
+		};
+		if (filesOpen) {
+			_cv.wait_for(lock, idleTimeout, wakeUp);
+		} else {
+			_cv.wait(lock, wakeUp);
+		}
+
+		// Everything queued while the previous requests were written
+		// is written at once
+		std::vector<Request> requests;
+		for (auto &[path, file] : _files) {
+			if (!file.pending) {
+				continue;
+			}
+			requests.push_back({path, file, std::move(file.data),
+					    file.truncate, file.replace,
+					    file.sync});
+			file.data.clear();
+			file.pending = false;
+			file.truncate = false;
+			file.replace = false;
+			file.sync = false;
+		}
+		if (requests.empty() && _stop) {
+			break;
+		}
+
+		_writing = true;
+		lock.unlock();
+		for (const auto &request : requests) {
+			if (request.replace) {
+				ReplaceFile(request.path, request.file,
+					    request.data, request.sync);
+				continue;
+			}
+			WriteFile(request.path, request.file, request.data,
+				  request.truncate, request.sync);
+		}
+		lock.lock();
+		_writing = false;
+		filesOpen = CloseIdleFiles(false);
+		_flushed.notify_all();
+	}
+	CloseIdleFiles(true);
+}
+
+void FileWriter::WriteFile(const std::string &path, File &file,
+			   const std::string &data, bool truncate, bool sync)
+{
+	if (truncate && file.handle) {
+		fclose(file.handle);
+		file.handle = nullptr;
+	}
+	if (!file.handle) {
+		file.handle = openFile(path, truncate);
+	}
+
+	bool success = file.handle &&
+		       fwrite(data.data(), 1, data.size(), file.handle) ==
+			       data.size() &&
+		       fflush(file.handle) == 0;
+	if (success && sync) {
+		success = syncFile(file.handle);
+	}
+	if (!success && !file.failed) {
+		blog(LOG_WARNING, "failed to write to file \"%s\": %s",
+		     path.c_str(), strerror(errno));
+	}
+	file.failed = !success;
+
+	// Files which were written are usually written again as a whole, so
+	// there is no point in keeping them open
+	if (file.handle && (truncate || !success)) {
+		fclose(file.handle);
+		file.handle = nullptr;
+	}
+	file.lastUse = std::chrono::steady_clock::now();
+}
+
+void FileWriter::ReplaceFile(const std::string &path, File &file,
+			     const std::string &data, bool sync)
+{
+	if (file.handle) {
+		fclose(file.handle);
+		file.handle = nullptr;
+	}
+
+	const auto tempPath = path + ".tmp";
+	auto handle = openFile(tempPath, true);
+	bool success = handle &&
+		       fwrite(data.data(), 1, data.size(), handle) ==
+			       data.size() &&
+		       fflush(handle) == 0 && (!sync || syncFile(handle));
+	if (handle) {
+		success = fclose(handle) == 0 && success;
+	}
+	std::error_code ec;
+	if (success) {
+		std::filesystem::rename(std::filesystem::u8path(tempPath),
+					std::filesystem::u8path(path), ec);
+		success = !ec;
+	}
+	if (!success) {
+		if (!file.failed) {
+			blog(LOG_WARNING, "failed to replace file \"%s\": %s",
+			     path.c_str(),
+			     ec ? ec.message().c_str() : strerror(errno));
+		}
+		std::filesystem::remove(std::filesystem::u8path(tempPath), ec);
+	}
+	file.failed = !success;
+	file.lastUse = std::chrono::steady_clock::now();
+}
+
+bool FileWriter::CloseIdleFiles(bool all)
+{
+	const auto now = std::chrono::steady_clock::now();
+	bool filesOpen = false;
+	for (auto it = _files.begin(); it != _files.end();) {
+		auto &file = it->second;
+		if (file.handle && (all || now - file.lastUse >= idleTimeout)) {
+			fclose(file.handle);
+			file.handle = nullptr;
+		}
+		if (file.handle) {
+			filesOpen = true;
+		}
+		if (!file.handle && !file.pending &&
+		    (!file.failed || now - file.lastUse >= failureTimeout)) {
+			it = _files.erase(it);
+		} else {
+			++it;
+		}
+	}
+	return filesOpen;
+}
+
+} // namespace advss
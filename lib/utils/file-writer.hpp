@@ -0,0 +1,81 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace advss {
+
+// Writes files on a dedicated thread, so slow storage like network shares
+// does not block the calling thread.
+//
+// The requests for a path are combined until the thread gets to them:
+// Writing a file discards the data queued for it so far, while appended data
+// is written at once.
+// Files which are appended to are kept open for a while, as they are
+// usually appended to repeatedly.
+class FileWriter {
+public:
+	enum class SyncPolicy {
+		// Leave it to the operating system when data is stored
+		NONE,
+		// Wait until the data was stored after each flush
+		ON_FLUSH,
+	};
+
+	EXPORT static void Write(const std::string &path,
+				 const std::string &data,
+				 SyncPolicy = SyncPolicy::NONE);
+	EXPORT static void Append(const std::string &path,
+				  const std::string &data,
+				  SyncPolicy = SyncPolicy::NONE);
+	// Like Write(), but the data is written to a temporary file first,
+	// which then replaces the file, so it is never left partially written
+	EXPORT static void Replace(const std::string &path,
+				   const std::string &data,
+				   SyncPolicy = SyncPolicy::NONE);
+	// Blocks until all data queued so far was written
+	EXPORT static void Flush();
+	// Writes the remaining data and stops the thread
+	EXPORT static void Stop();
+
+private:
+	struct File {
+		std::string data;
+		bool pending = false;
+		bool truncate = false;
+		bool replace = false;
+		bool sync = false;
+		// Only accessed by the writer thread
+		FILE *handle = nullptr;
+		bool failed = false;
+		std::chrono::steady_clock::time_point lastUse;
+	};
+
+	static void Queue(const std::string &path, const std::string &data,
+			  bool truncate, bool replace, SyncPolicy);
+	static void Run();
+	static bool HasPendingData();
+	static void WriteFile(const std::string &path, File &,
+			      const std::string &data, bool truncate,
+			      bool sync);
+	static void ReplaceFile(const std::string &path, File &,
+				const std::string &data, bool sync);
+	// Returns true if any files are still open
+	static bool CloseIdleFiles(bool all);
+
+	static std::mutex _mutex;
+	static std::condition_variable _cv;
+	static std::condition_variable _flushed;
+	static std::map<std::string, File> _files;
+	static std::thread _thread;
+	static bool _stop;
+	static bool _writing;
+};
+
+} // namespace advss
@@ -1,4 +1,5 @@
 #include "item-selection-helpers.hpp"
+#include "macro-segment.hpp"
 #include "name-dialog.hpp"
 #include "obs-module-helper.hpp"
 #include "ui-helpers.hpp"
@@ -142,6 +143,7 @@ void ItemSelection::ModifyButtonClicked()
 			return;
 		}
 		if (oldName != item->_name) {
+			MarkAllMacroSegmentsDirty();
 			emit ItemRenamed(QString::fromStdString(oldName),
 					 QString::fromStdString(item->_name));
 		}
@@ -198,6 +200,7 @@ void ItemSelection::RenameItem()
 	const auto oldName = item->_name;
 	item->_name = name;
 	SetItem(name);
+	MarkAllMacroSegmentsDirty();
 	emit ItemRenamed(QString::fromStdString(oldName),
 			 QString::fromStdString(name));
 }
@@ -0,0 +1,133 @@
+#include "media-state-tracker.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace advss {
+
+static std::mutex trackerMutex;
+static std::unordered_map<obs_weak_source_t *, std::weak_ptr<MediaStateTracker>>
+	trackers;
+
+struct MediaStateTracker::SignalInfo {
+	const char *name;
+	signal_callback_t callback;
+};
+
+const std::vector<MediaStateTracker::SignalInfo> &
+MediaStateTracker::GetSignals()
+{
+	static const std::vector<SignalInfo> signals = {
+		{"media_play", MediaSignal<Event::PLAY>},
+		{"media_pause", MediaSignal<Event::PAUSE>},
+		{"media_restart", MediaSignal<Event::RESTART>},
+		{"media_stopped", MediaSignal<Event::STOPPED>},
+		{"media_next", MediaSignal<Event::NEXT>},
+		{"media_previous", MediaSignal<Event::PREVIOUS>},
+		{"media_started", MediaSignal<Event::STARTED>},
+		{"media_ended", MediaSignal<Event::ENDED>},
+		{"remove", SourceRemoved},
+		{"destroy", SourceRemoved},
+	};
+	return signals;
+}
+
+MediaStateTracker::MediaStateTracker(const OBSWeakSource &source)
+	: _source(source)
+{
+	OBSSourceAutoRelease mediaSource = obs_weak_source_get_source(source);
+	auto sh = obs_source_get_signal_handler(mediaSource);
+	for (const auto &signal : GetSignals()) {
+		signal_handler_connect(sh, signal.name, signal.callback, this);
+	}
+}
+
+MediaStateTracker::~MediaStateTracker()
+{
+	// Already disconnected in SourceRemoved() if the source is gone
+	OBSSourceAutoRelease source = obs_weak_source_get_source(_source);
+	Disconnect(source);
+}
+
+std::shared_ptr<MediaStateTracker>
+MediaStateTracker::Get(const OBSWeakSource &source)
+{
+	if (!source) {
+		return {};
+	}
+
+	std::lock_guard<std::mutex> lock(trackerMutex);
+	for (auto it = trackers.begin(); it != trackers.end();) {
+		if (it->second.expired()) {
+			it = trackers.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto it = trackers.find(source.Get());
+	if (it != trackers.end()) {
+		return it->second.lock();
+	}
+
+	// Constructor is private so std::make_shared cannot be used
+	auto tracker = std::shared_ptr<MediaStateTracker>(
+		new MediaStateTracker(source));
+	trackers[source.Get()] = tracker;
+	return tracker;
+}
+
+void MediaStateTracker::Disconnect(obs_source_t *source)
+{
+	if (!source) {
+		return;
+	}
+	auto sh = obs_source_get_signal_handler(source);
+	for (const auto &signal : GetSignals()) {
+		signal_handler_disconnect(sh, signal.name, signal.callback,
+					  this);
+	}
+}
+
+template<MediaStateTracker::Event event>
+void MediaStateTracker::MediaSignal(void *data, calldata_t *)
+{
+	auto &info = static_cast<MediaStateTracker *>(data)
+			     ->_events[static_cast<size_t>(event)];
+	info.lastOccurrence = Clock::now().time_since_epoch().count();
+	++info.count;
+}
+
+void MediaStateTracker::SourceRemoved(void *data, calldata_t *cd)
+{
+	// Disconnect right away as the signal handler will no longer be
+	// available once the source is destroyed
+	auto source = static_cast<obs_source_t *>(calldata_ptr(cd, "source"));
+	static_cast<MediaStateTracker *>(data)->Disconnect(source);
+}
+
+bool MediaStateTracker::OccurredSince(Event event,
+				      const Clock::time_point &time) const
+{
+	return GetLastOccurrence(event) > time;
+}
+
+MediaStateTracker::Clock::time_point
+MediaStateTracker::GetLastOccurrence(Event event) const
+{
+	if (event >= Event::LAST_EVENT) {
+		return {};
+	}
+	const auto &info = _events[static_cast<size_t>(event)];
+	return Clock::time_point(Clock::duration(info.lastOccurrence.load()));
+}
+
+uint64_t MediaStateTracker::GetCount(Event event) const
+{
+	if (event >= Event::LAST_EVENT) {
+		return 0;
+	}
+	return _events[static_cast<size_t>(event)].count;
+}
+
+} // namespace advss
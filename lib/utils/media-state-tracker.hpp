@@ -0,0 +1,59 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <obs.hpp>
+#include <vector>
+
+namespace advss {
+
+// Connects once to the media signals of a media source and keeps track of
+// when each of them was last emitted and how often it was emitted, so that
+// any number of users can check for media events which happened in between
+// their checks in constant time without each of them having to connect to the
+// source's signals on their own.
+// Instances are shared by all users of the same source.
+class EXPORT MediaStateTracker {
+public:
+	~MediaStateTracker();
+	static std::shared_ptr<MediaStateTracker> Get(const OBSWeakSource &);
+
+	enum class Event {
+		PLAY,
+		PAUSE,
+		RESTART,
+		STOPPED,
+		NEXT,
+		PREVIOUS,
+		STARTED,
+		ENDED,
+		LAST_EVENT,
+	};
+	using Clock = std::chrono::high_resolution_clock;
+
+	bool OccurredSince(Event, const Clock::time_point &) const;
+	Clock::time_point GetLastOccurrence(Event) const;
+	uint64_t GetCount(Event) const;
+	OBSWeakSource GetSource() const { return _source; }
+
+private:
+	struct SignalInfo;
+	struct EventInfo {
+		std::atomic<Clock::rep> lastOccurrence = {0};
+		std::atomic_uint64_t count = {0};
+	};
+
+	MediaStateTracker(const OBSWeakSource &);
+	static const std::vector<SignalInfo> &GetSignals();
+	template<Event> static void MediaSignal(void *data, calldata_t *);
+	static void SourceRemoved(void *data, calldata_t *);
+	void Disconnect(obs_source_t *);
+
+	OBSWeakSource _source;
+	std::array<EventInfo, static_cast<size_t>(Event::LAST_EVENT)> _events;
+};
+
+} // namespace advss
@@ -1,49 +1,231 @@
 #pragma once
-#include <deque>
-#include <mutex>
-#include <optional>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
 
 namespace advss {
 
+enum class MessageBufferOverflowPolicy {
+	// Discard the oldest buffered message to make room for the new one
+	DROP_OLDEST,
+	// Discard the new message and keep the buffered ones
+	DROP_NEWEST,
+};
+
+// Bounded lock-free queue of shared immutable messages.
+//
+// Messages are stored as std::shared_ptr<const T> so that a message can be
+// handed to any number of buffers without being copied.
+// The capacity is rounded up to the next power of two.
+// Once the buffer is full messages are dropped according to the configured
+// overflow policy, so that a client which stopped consuming messages cannot
+// cause the memory usage to grow without limit.
+//
+// The implementation is based on Dmitry Vyukov's bounded MPMC queue, which
+// allows the producer to drop the oldest message while the consumer might be
+// accessing the buffer at the same time.
 template<class T> class MessageBuffer {
 public:
-	bool Empty();
+	using Message = std::shared_ptr<const T>;
+	static constexpr size_t defaultCapacity = 1024;
+
+	MessageBuffer(size_t capacity = defaultCapacity,
+		      MessageBufferOverflowPolicy policy =
+			      MessageBufferOverflowPolicy::DROP_OLDEST);
+
+	bool Empty() const;
+	size_t Size() const;
+	size_t Capacity() const { return _slots.size(); }
 	void Clear();
-	void AppendMessage(const T &);
-	std::optional<T> ConsumeMessage();
+
+	// Returns false if the message was dropped due to the buffer being
+	// full and the overflow policy being DROP_NEWEST
+	bool AppendMessage(const Message &);
+	bool AppendMessage(const T &);
+	// Returns nullptr if the buffer is empty
+	Message ConsumeMessage();
+	std::vector<Message> ConsumeMessages(size_t max = SIZE_MAX);
+
+	uint64_t GetDroppedCount() const { return _dropped; }
+
+	// The callback is invoked in the context of the producer whenever a
+	// message was appended, e.g. to have the consumer check the buffer
+	// right away instead of polling it
+	void SetAppendCallback(const std::function<void()> &);
 
 private:
-	std::deque<T> _buffer;
-	std::mutex _mutex;
+	struct Slot {
+		std::atomic_size_t sequence = {0};
+		Message message;
+	};
+
+	static size_t GetSlotCount(size_t capacity);
+	bool TryPush(const Message &);
+	Message TryPop();
+
+	std::vector<Slot> _slots;
+	const size_t _mask;
+	const MessageBufferOverflowPolicy _policy;
+
+	// Keep the producer and consumer positions on separate cache lines
+	alignas(64) std::atomic_size_t _enqueuePos = {0};
+	alignas(64) std::atomic_size_t _dequeuePos = {0};
+	std::atomic_uint64_t _dropped = {0};
+	// Only accessed using std::atomic_load() and std::atomic_store()
+	std::shared_ptr<const std::function<void()>> _appendCallback;
 };
 
-template<class T> inline bool MessageBuffer<T>::Empty()
+template<class T>
+inline MessageBuffer<T>::MessageBuffer(size_t capacity,
+				       MessageBufferOverflowPolicy policy)
+	: _slots(GetSlotCount(capacity)),
+	  _mask(_slots.size() - 1),
+	  _policy(policy)
+{
+	for (size_t i = 0; i < _slots.size(); i++) {
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template<class T> inline size_t MessageBuffer<T>::GetSlotCount(size_t capacity)
+{
+	// The number of slots has to be a power of two
+	size_t count = 2;
+	while (count < capacity) {
+		count <<= 1;
+	}
+	return count;
+}
+
+template<class T> inline bool MessageBuffer<T>::Empty() const
+{
+	return Size() == 0;
+}
+
+template<class T> inline size_t MessageBuffer<T>::Size() const
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	return _buffer.empty();
+	const auto dequeuePos = _dequeuePos.load(std::memory_order_acquire);
+	const auto enqueuePos = _enqueuePos.load(std::memory_order_acquire);
+	return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
 }
 
 template<class T> inline void MessageBuffer<T>::Clear()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_buffer.clear();
+	while (TryPop()) {
+	}
+}
+
+template<class T>
+inline bool MessageBuffer<T>::AppendMessage(const Message &message)
+{
+	while (!TryPush(message)) {
+		if (_policy == MessageBufferOverflowPolicy::DROP_NEWEST) {
+			++_dropped;
+			return false;
+		}
+		if (TryPop()) {
+			++_dropped;
+		}
+	}
+	if (const auto callback = std::atomic_load(&_appendCallback)) {
+		(*callback)();
+	}
+	return true;
 }
 
-template<class T> inline void MessageBuffer<T>::AppendMessage(const T &message)
+template<class T> inline bool MessageBuffer<T>::AppendMessage(const T &message)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_buffer.emplace_back(message);
+	return AppendMessage(std::make_shared<const T>(message));
+}
+
+template<class T>
+inline void
+MessageBuffer<T>::SetAppendCallback(const std::function<void()> &callback)
+{
+	std::shared_ptr<const std::function<void()>> ptr;
+	if (callback) {
+		ptr = std::make_shared<const std::function<void()>>(callback);
+	}
+	std::atomic_store(&_appendCallback, ptr);
+}
+
+template<class T>
+inline typename MessageBuffer<T>::Message MessageBuffer<T>::ConsumeMessage()
+{
+	return TryPop();
+}
+
+template<class T>
+inline std::vector<typename MessageBuffer<T>::Message>
+MessageBuffer<T>::ConsumeMessages(size_t max)
+{
+	std::vector<Message> messages;
+	messages.reserve(std::min(max, Size()));
+	while (messages.size() < max) {
+		auto message = TryPop();
+		if (!message) {
+			break;
+		}
+		messages.emplace_back(std::move(message));
+	}
+	return messages;
+}
+
+template<class T> inline bool MessageBuffer<T>::TryPush(const Message &message)
+{
+	auto pos = _enqueuePos.load(std::memory_order_relaxed);
+	for (;;) {
+		auto &slot = _slots[pos & _mask];
+		const auto sequence =
+			slot.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<intptr_t>(sequence) -
+				  static_cast<intptr_t>(pos);
+		if (diff == 0) {
+			if (_enqueuePos.compare_exchange_weak(
+				    pos, pos + 1, std::memory_order_relaxed)) {
+				slot.message = message;
+				slot.sequence.store(pos + 1,
+						    std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// Buffer is full
+			return false;
+		} else {
+			pos = _enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
 }
 
-template<class T> inline std::optional<T> MessageBuffer<T>::ConsumeMessage()
+template<class T>
+inline typename MessageBuffer<T>::Message MessageBuffer<T>::TryPop()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	if (_buffer.empty()) {
-		return {};
+	auto pos = _dequeuePos.load(std::memory_order_relaxed);
+	for (;;) {
+		auto &slot = _slots[pos & _mask];
+		const auto sequence =
+			slot.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<intptr_t>(sequence) -
+				  static_cast<intptr_t>(pos + 1);
+		if (diff == 0) {
+			if (_dequeuePos.compare_exchange_weak(
+				    pos, pos + 1, std::memory_order_relaxed)) {
+				auto message = std::move(slot.message);
+				slot.message.reset();
+				slot.sequence.store(pos + _mask + 1,
+						    std::memory_order_release);
+				return message;
+			}
+		} else if (diff < 0) {
+			// Buffer is empty
+			return {};
+		} else {
+			pos = _dequeuePos.load(std::memory_order_relaxed);
+		}
 	}
-	T message = _buffer.at(0);
-	_buffer.pop_front();
-	return message;
 }
 
 } // namespace advss
@@ -3,14 +3,22 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace advss {
 
 template<class T> class MessageDispatcher {
 public:
-	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient();
+	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient(
+		size_t capacity = MessageBuffer<T>::defaultCapacity,
+		MessageBufferOverflowPolicy policy =
+			MessageBufferOverflowPolicy::DROP_OLDEST);
 	void DispatchMessage(const T &message);
+	void DispatchMessage(const typename MessageBuffer<T>::Message &message);
+	uint64_t GetDroppedCount();
+	// Returns false once all client buffers were released
+	bool HasClients();
 
 private:
 	std::vector<std::weak_ptr<MessageBuffer<T>>> _clients;
@@ -18,7 +26,9 @@ private:
 };
 
 template<class T>
-inline std::shared_ptr<MessageBuffer<T>> MessageDispatcher<T>::RegisterClient()
+inline std::shared_ptr<MessageBuffer<T>>
+MessageDispatcher<T>::RegisterClient(size_t capacity,
+				     MessageBufferOverflowPolicy policy)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
 	// Clear expired client buffers
@@ -29,13 +39,21 @@ inline std::shared_ptr<MessageBuffer<T>> MessageDispatcher<T>::RegisterClient()
 				      isExpired),
 		       _clients.end());
 	// Prepare new buffer for client
-	auto buffer = std::make_shared<MessageBuffer<T>>();
+	auto buffer = std::make_shared<MessageBuffer<T>>(capacity, policy);
 	_clients.emplace_back(buffer);
 	return buffer;
 }
 
 template<class T>
 inline void MessageDispatcher<T>::DispatchMessage(const T &message)
+{
+	// The message is shared by all clients instead of being copied
+	DispatchMessage(std::make_shared<const T>(message));
+}
+
+template<class T>
+inline void MessageDispatcher<T>::DispatchMessage(
+	const typename MessageBuffer<T>::Message &message)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
 	for (auto &client_ : _clients) {
@@ -47,4 +65,27 @@ inline void MessageDispatcher<T>::DispatchMessage(const T &message)
 	}
 }
 
+template<class T> inline uint64_t MessageDispatcher<T>::GetDroppedCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	uint64_t count = 0;
+	for (auto &client_ : _clients) {
+		auto client = client_.lock();
+		if (!client) {
+			continue;
+		}
+		count += client->GetDroppedCount();
+	}
+	return count;
+}
+
+template<class T> inline bool MessageDispatcher<T>::HasClients()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return std::any_of(_clients.begin(), _clients.end(),
+			   [](const std::weak_ptr<MessageBuffer<T>> &client) {
+				   return !client.expired();
+			   });
+}
+
 } // namespace advss
@@ -0,0 +1,213 @@
+#include "remote-file.hpp"
+#include "curl-helper.hpp"
+#include "log-helper.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace advss {
+
+// Requests are sent in the background, so they can be given more time than
+// a single interval of the macro thread
+static constexpr auto requestTimeout = std::chrono::seconds(10);
+static constexpr auto never = std::chrono::steady_clock::time_point::max();
+
+std::mutex RemoteFilePoller::_mutex;
+std::condition_variable RemoteFilePoller::_cv;
+std::vector<std::weak_ptr<RemoteFilePoller::Poll>> RemoteFilePoller::_polls;
+std::thread RemoteFilePoller::_thread;
+bool RemoteFilePoller::_stop = false;
+
+std::shared_ptr<RemoteFilePoller::Poll>
+RemoteFilePoller::Register(const std::string &url,
+			   std::chrono::milliseconds interval)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto &weakPoll : _polls) {
+		auto poll = weakPoll.lock();
+		if (poll && poll->_url == url && poll->_interval == interval) {
+			return poll;
+		}
+	}
+
+	auto poll = std::make_shared<Poll>(url, interval);
+	_polls.emplace_back(poll);
+	if (!_thread.joinable()) {
+		_thread = std::thread(Run);
+	}
+	_cv.notify_one();
+	return poll;
+}
+
+void RemoteFilePoller::Stop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (!_thread.joinable()) {
+		return;
+	}
+	_stop = true;
+	_cv.notify_one();
+	lock.unlock();
+	_thread.join();
+	lock.lock();
+	_thread = std::thread();
+	_stop = false;
+}
+
+void RemoteFilePoller::Run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stop) {
+		_polls.erase(std::remove_if(_polls.begin(), _polls.end(),
+					    [](const std::weak_ptr<Poll> &p) {
+						    return p.expired();
+					    }),
+			     _polls.end());
+
+		const auto now = std::chrono::steady_clock::now();
+		auto nextRequest = never;
+		std::vector<std::shared_ptr<Poll>> duePolls;
+		for (const auto &weakPoll : _polls) {
+			auto poll = weakPoll.lock();
+			if (!poll || poll->_requestPending) {
+				continue;
+			}
+			if (poll->_nextRequest <= now) {
+				poll->_requestPending = true;
+				duePolls.emplace_back(poll);
+			} else {
+				nextRequest = std::min(nextRequest,
+						       poll->_nextRequest);
+			}
+		}
+
+		if (!duePolls.empty()) {
+			// The response callback might be called right away
+			// and requires the lock
+			lock.unlock();
+			for (const auto &poll : duePolls) {
+				StartRequest(poll);
+			}
+			duePolls.clear();
+			lock.lock();
+			continue;
+		}
+
+		if (nextRequest == never) {
+			_cv.wait(lock);
+		} else {
+			_cv.wait_until(lock, nextRequest);
+		}
+	}
+}
+
+void RemoteFilePoller::StartRequest(const std::shared_ptr<Poll> &poll)
+{
+	CurlRequest request;
+	request.url = poll->_url;
+	request.timeout = requestTimeout;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!poll->_etag.empty()) {
+			request.headers.emplace_back("If-None-Match: " +
+						     poll->_etag);
+		}
+		if (!poll->_lastModified.empty()) {
+			request.headers.emplace_back("If-Modified-Since: " +
+						     poll->_lastModified);
+		}
+	}
+
+	std::weak_ptr<Poll> weakPoll = poll;
+	CurlHelper::PerformAsync(request,
+				 [weakPoll](CurlResponse &&response) {
+					 HandleResponse(weakPoll,
+							std::move(response));
+				 });
+}
+
+static const std::string &getHeader(const CurlResponse &response,
+				    const std::string &name)
+{
+	static const std::string empty;
+	auto it = response.headers.find(name);
+	return it == response.headers.end() ? empty : it->second;
+}
+
+void RemoteFilePoller::HandleResponse(const std::weak_ptr<Poll> &weakPoll,
+				      CurlResponse &&response)
+{
+	auto poll = weakPoll.lock();
+	if (!poll) {
+		return;
+	}
+
+	// The content is kept if the file is unchanged or unavailable
+	const bool received = response.Succeeded() &&
+			      response.status >= 200 && response.status < 300;
+	if (received) {
+		const auto hash = std::hash<std::string>{}(response.body);
+		std::lock_guard<std::mutex> lock(poll->_contentMutex);
+		auto &content = poll->_content;
+		if (content.version == 0 || content.hash != hash) {
+			content.data = std::make_shared<const std::string>(
+				std::move(response.body));
+			content.hash = hash;
+			++content.version;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	const bool failed = !received && response.status != 304;
+	if (failed && !poll->_failed) {
+		const auto error =
+			response.Succeeded()
+				? "status " + std::to_string(response.status)
+				: response.error;
+		blog(LOG_WARNING, "failed to fetch \"%s\": %s",
+		     poll->_url.c_str(), error.c_str());
+	}
+	poll->_failed = failed;
+	if (received) {
+		poll->_etag = getHeader(response, "etag");
+		poll->_lastModified = getHeader(response, "last-modified");
+	}
+	poll->_requestPending = false;
+	poll->_nextRequest = std::chrono::steady_clock::now() + poll->_interval;
+	_cv.notify_one();
+}
+
+RemoteFilePoller::Poll::Content RemoteFilePoller::Poll::GetContent() const
+{
+	std::lock_guard<std::mutex> lock(_contentMutex);
+	return _content;
+}
+
+bool RemoteFile::Update(const std::string &url,
+			std::chrono::milliseconds interval)
+{
+	if (!_poll || _poll->GetUrl() != url ||
+	    _poll->GetInterval() != interval) {
+		// The content of the same URL stays valid until the new poll
+		// received it, if only the interval changed
+		if (!_poll || _poll->GetUrl() != url) {
+			_content = {};
+		}
+		_poll = RemoteFilePoller::Register(url, interval);
+	}
+
+	// Only the reference to the content is copied
+	auto content = _poll->GetContent();
+	if (content.version != 0) {
+		_content = std::move(content);
+	}
+	return _content.version != 0;
+}
+
+const std::string &RemoteFile::GetContent() const
+{
+	static const std::string empty;
+	return _content.data ? *_content.data : empty;
+}
+
+} // namespace advss
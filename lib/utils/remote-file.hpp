@@ -0,0 +1,99 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+struct CurlResponse;
+
+// Polls remote files in the background, so checking their content never
+// waits for the network.
+//
+// Conditional requests using the "ETag" and "Last-Modified" headers of the
+// previous response are sent, so the content of unchanged files is not
+// transferred again.
+// Files polled with the same URL and interval share their requests.
+class RemoteFilePoller {
+public:
+	class Poll;
+
+	[[nodiscard]] EXPORT static std::shared_ptr<Poll>
+	Register(const std::string &url, std::chrono::milliseconds interval);
+	// Stops the polling thread
+	EXPORT static void Stop();
+
+private:
+	static void Run();
+	static void StartRequest(const std::shared_ptr<Poll> &);
+	static void HandleResponse(const std::weak_ptr<Poll> &,
+				   CurlResponse &&);
+
+	static std::mutex _mutex;
+	static std::condition_variable _cv;
+	static std::vector<std::weak_ptr<Poll>> _polls;
+	static std::thread _thread;
+	static bool _stop;
+};
+
+class RemoteFilePoller::Poll {
+public:
+	Poll(const std::string &url, std::chrono::milliseconds interval)
+		: _url(url),
+		  _interval(interval)
+	{
+	}
+
+	struct Content {
+		std::shared_ptr<const std::string> data;
+		uint64_t hash = 0;
+		// Incremented each time the content changed and zero until
+		// the content was received for the first time
+		uint64_t version = 0;
+	};
+	EXPORT Content GetContent() const;
+	const std::string &GetUrl() const { return _url; }
+	std::chrono::milliseconds GetInterval() const { return _interval; }
+
+private:
+	const std::string _url;
+	const std::chrono::milliseconds _interval;
+
+	// Only accessed while holding RemoteFilePoller::_mutex
+	bool _requestPending = false;
+	std::chrono::steady_clock::time_point _nextRequest;
+	std::string _etag;
+	std::string _lastModified;
+	bool _failed = false;
+
+	mutable std::mutex _contentMutex;
+	Content _content;
+
+	friend RemoteFilePoller;
+};
+
+// Provides the latest content received for a remote file.
+class RemoteFile {
+public:
+	// Starts polling a different file if the URL or interval changed.
+	// Returns false as long as no content was received.
+	// If only the interval changed, the previous content is kept until
+	// the content is received again.
+	EXPORT bool Update(const std::string &url,
+			   std::chrono::milliseconds interval);
+	EXPORT const std::string &GetContent() const;
+	uint64_t GetHash() const { return _content.hash; }
+
+private:
+	std::shared_ptr<RemoteFilePoller::Poll> _poll;
+	RemoteFilePoller::Poll::Content _content;
+};
+
+} // namespace advss
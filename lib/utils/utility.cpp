@@ -68,6 +68,36 @@ bool CompareIgnoringLineEnding(QString &s1, QString &s2)
 	return true;
 }
 
+// Returns the next line and removes it including its line ending from text
+static std::string_view consumeLine(std::string_view &text)
+{
+	const auto end = text.find_first_of("\r\n");
+	const auto line = text.substr(0, end);
+	if (end == std::string_view::npos) {
+		text = {};
+		return line;
+	}
+
+	auto next = end + 1;
+	if (text[end] == '\r' && next < text.size() && text[next] == '\n') {
+		++next;
+	}
+	text.remove_prefix(next);
+	return line;
+}
+
+bool CompareIgnoringLineEnding(std::string_view s1, std::string_view s2)
+{
+	// Compares the same way as the QString overload without having to
+	// convert the text
+	while (!s1.empty() || !s2.empty()) {
+		if (consumeLine(s1) != consumeLine(s2)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 std::string ToString(double value)
 {
 	std::stringstream stream;
@@ -8,6 +8,7 @@
 #include <QString>
 #include <QWidget>
 #include <string>
+#include <string_view>
 
 namespace advss {
 
@@ -18,6 +19,7 @@ bool ReplaceAll(std::string &str, const std::string &from,
 EXPORT std::optional<std::string> GetJsonField(const std::string &json,
 					       const std::string &id);
 EXPORT bool CompareIgnoringLineEnding(QString &s1, QString &s2);
+EXPORT bool CompareIgnoringLineEnding(std::string_view s1, std::string_view s2);
 std::string ToString(double value);
 
 /* Legacy helpers */
@@ -1,5 +1,6 @@
 #include "variable-tab.hpp"
 #include "log-helper.hpp"
+#include "macro-segment.hpp"
 #include "obs-module-helper.hpp"
 #include "plugin-state-helpers.hpp"
 #include "sync-helpers.hpp"
@@ -189,6 +190,7 @@ static void openSettingsDialog()
 	bool accepted = VariableSettingsDialog::AskForSettings(
 		tabWidget->Table(), *variable.get());
 	if (accepted && oldName != variable->Name()) {
+		MarkAllMacroSegmentsDirty();
 		VariableSignalManager::Instance()->Rename(
 			QString::fromStdString(oldName),
 			QString::fromStdString(variable->Name()));
@@ -1,9 +1,8 @@
 #include "macro-action-file.hpp"
+#include "file-writer.hpp"
 #include "layout-helpers.hpp"
 
 #include <QFileDialog>
-#include <QFile>
-#include <QTextStream>
 
 namespace advss {
 
@@ -23,23 +22,18 @@ static const std::map<MacroActionFile::Action, std::string> actionTypes = {
 
 bool MacroActionFile::PerformAction()
 {
-	QString path = QString::fromStdString(_file);
-	QFile file(path);
-	bool open = false;
+	const auto sync = _sync ? FileWriter::SyncPolicy::ON_FLUSH
+				: FileWriter::SyncPolicy::NONE;
 	switch (_action) {
 	case Action::WRITE:
-		open = file.open(QIODevice::WriteOnly);
+		FileWriter::Write(_file, _text, sync);
 		break;
 	case Action::APPEND:
-		open = file.open(QIODevice::WriteOnly | QIODevice::Append);
+		FileWriter::Append(_file, _text, sync);
 		break;
 	default:
 		break;
 	}
-	if (open) {
-		QTextStream out(&file);
-		out << QString::fromStdString(_text);
-	}
 	return true;
 }
 
@@ -61,6 +55,7 @@ bool MacroActionFile::Save(obs_data_t *obj) const
 	_file.Save(obj, "file");
 	_text.Save(obj, "text");
 	obs_data_set_int(obj, "action", static_cast<int>(_action));
+	obs_data_set_bool(obj, "sync", _sync);
 	return true;
 }
 
@@ -70,6 +65,7 @@ bool MacroActionFile::Load(obs_data_t *obj)
 	_file.Load(obj, "file");
 	_text.Load(obj, "text");
 	_action = static_cast<Action>(obs_data_get_int(obj, "action"));
+	_sync = obs_data_get_bool(obj, "sync");
 	return true;
 }
 
@@ -106,7 +102,9 @@ MacroActionFileEdit::MacroActionFileEdit(
 	: QWidget(parent),
 	  _filePath(new FileSelection(FileSelection::Type::WRITE)),
 	  _text(new VariableTextEdit(this)),
-	  _actions(new QComboBox())
+	  _actions(new QComboBox()),
+	  _sync(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.action.file.sync")))
 {
 	populateActionSelection(_actions);
 
@@ -116,6 +114,8 @@ MacroActionFileEdit::MacroActionFileEdit(
 			 SLOT(PathChanged(const QString &)));
 	QWidget::connect(_text, SIGNAL(textChanged()), this,
 			 SLOT(TextChanged()));
+	QWidget::connect(_sync, SIGNAL(stateChanged(int)), this,
+			 SLOT(SyncChanged(int)));
 	;
 
 	QHBoxLayout *entryLayout = new QHBoxLayout;
@@ -130,6 +130,7 @@ MacroActionFileEdit::MacroActionFileEdit(
 	QVBoxLayout *mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(entryLayout);
 	mainLayout->addWidget(_text);
+	mainLayout->addWidget(_sync);
 	setLayout(mainLayout);
 
 	_entryData = entryData;
@@ -146,6 +147,7 @@ void MacroActionFileEdit::UpdateEntryData()
 	_actions->setCurrentIndex(static_cast<int>(_entryData->_action));
 	_filePath->SetPath(QString::fromStdString(_entryData->_file));
 	_text->setPlainText(_entryData->_text);
+	_sync->setChecked(_entryData->_sync);
 
 	adjustSize();
 	updateGeometry();
@@ -186,4 +188,14 @@ void MacroActionFileEdit::ActionChanged(int value)
 	_entryData->_action = static_cast<MacroActionFile::Action>(value);
 }
 
+void MacroActionFileEdit::SyncChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_sync = value;
+}
+
 } // namespace advss
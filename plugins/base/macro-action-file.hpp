@@ -3,6 +3,7 @@
 #include "file-selection.hpp"
 #include "variable-text-edit.hpp"
 
+#include <QCheckBox>
 #include <QSpinBox>
 
 namespace advss {
@@ -28,6 +29,9 @@ public:
 		APPEND,
 	};
 	Action _action = Action::WRITE;
+	// Have the writer thread sync the file to disk after writing it.
+	// The action itself only queues the data and does not wait for this.
+	bool _sync = false;
 
 private:
 	static bool _registered;
@@ -54,6 +58,7 @@ private slots:
 	void PathChanged(const QString &text);
 	void TextChanged();
 	void ActionChanged(int value);
+	void SyncChanged(int value);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -61,6 +66,7 @@ private:
 	FileSelection *_filePath;
 	VariableTextEdit *_text;
 	QComboBox *_actions;
+	QCheckBox *_sync;
 
 	std::shared_ptr<MacroActionFile> _entryData;
 	bool _loading = true;
@@ -1,5 +1,4 @@
 #include "macro-action-http.hpp"
-#include "curl-helper.hpp"
 #include "layout-helpers.hpp"
 
 namespace advss {
@@ -17,78 +16,62 @@ const static std::map<MacroActionHttp::Method, std::string> methods = {
 	 "AdvSceneSwitcher.action.http.type.post"},
 };
 
-static size_t DropCB(void *, size_t size, size_t nmemb, std::string *)
-{
-	return size * nmemb;
-}
-
-static size_t WriteCB(void *ptr, size_t size, size_t nmemb, std::string *buffer)
-{
-	buffer->append((char *)ptr, nmemb);
-	return size * nmemb;
-}
-
-void MacroActionHttp::SetupHeaders()
+bool MacroActionHttp::PerformAction()
 {
-	if (!_setHeaders) {
-		return;
-	}
-	struct curl_slist *headers = nullptr;
-	for (auto &header : _headers) {
-		headers = CurlHelper::SlistAppend(headers, header.c_str());
+	if (!CurlHelper::Initialized()) {
+		blog(LOG_WARNING,
+		     "cannot perform http action (curl not found)");
+		return true;
 	}
-	if (!_headers.empty()) {
-		CurlHelper::SetOpt(CURLOPT_HTTPHEADER, headers);
+
+	CurlRequest request;
+	request.url = _url;
+	request.method = _method == Method::POST ? CurlRequest::Method::POST
+						 : CurlRequest::Method::GET;
+	request.data = _data;
+	if (_setHeaders) {
+		request.headers = {_headers.begin(), _headers.end()};
 	}
-}
+	request.timeout = std::chrono::milliseconds(_timeout.Milliseconds());
+	request.storeResponse = _waitForResponse;
 
-void MacroActionHttp::Get()
-{
-	CurlHelper::SetOpt(CURLOPT_URL, _url.c_str());
-	CurlHelper::SetOpt(CURLOPT_HTTPGET, 1L);
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT_MS, _timeout.Milliseconds());
-	SetupHeaders();
-
-	std::string response;
-	if (IsReferencedInVars()) {
-		CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCB);
-	} else {
-		CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, DropCB);
+	auto future = CurlHelper::PerformAsync(request);
+	if (!_waitForResponse) {
+		return true;
 	}
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &response);
-	CurlHelper::Perform();
 
-	SetVariableValue(response);
+	const auto response = future.get();
+	if (!response.Succeeded()) {
+		blog(LOG_WARNING, "http request to \"%s\" failed: %s",
+		     _url.c_str(), response.error.c_str());
+	}
+	SetTempVarValues(response);
+	if (_method == Method::GET) {
+		SetVariableValue(response.body);
+	}
+	return true;
 }
 
-void MacroActionHttp::Post()
+void MacroActionHttp::SetupTempVars()
 {
-	CurlHelper::SetOpt(CURLOPT_URL, _url.c_str());
-	CurlHelper::SetOpt(CURLOPT_POSTFIELDS, _data.c_str());
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT_MS, _timeout.Milliseconds());
-	SetupHeaders();
-	CurlHelper::Perform();
+	MacroAction::SetupTempVars();
+	AddTempvar(
+		"response.status",
+		obs_module_text(
+			"AdvSceneSwitcher.tempVar.http.response.status"),
+		obs_module_text(
+			"AdvSceneSwitcher.tempVar.http.response.status.description"));
+	AddTempvar(
+		"response.body",
+		obs_module_text("AdvSceneSwitcher.tempVar.http.response.body"),
+		obs_module_text(
+			"AdvSceneSwitcher.tempVar.http.response.body.description"));
 }
 
-bool MacroActionHttp::PerformAction()
+void MacroActionHttp::SetTempVarValues(const CurlResponse &response)
 {
-	if (!CurlHelper::Initialized()) {
-		blog(LOG_WARNING,
-		     "cannot perform http action (curl not found)");
-		return true;
-	}
-
-	switch (_method) {
-	case MacroActionHttp::Method::GET:
-		Get();
-		break;
-	case MacroActionHttp::Method::POST:
-		Post();
-		break;
-	default:
-		break;
-	}
-	return true;
+	SetTempVarValue("response.status", std::to_string(response.status));
+	SetTempVarValue("response.body", response.body);
 }
 
 void MacroActionHttp::LogAction() const
@@ -113,6 +96,7 @@ bool MacroActionHttp::Save(obs_data_t *obj) const
 	_headers.Save(obj, "headers", "header");
 	obs_data_set_int(obj, "method", static_cast<int>(_method));
 	_timeout.Save(obj);
+	obs_data_set_bool(obj, "waitForResponse", _waitForResponse);
 	return true;
 }
 
@@ -125,6 +109,10 @@ bool MacroActionHttp::Load(obs_data_t *obj)
 	_headers.Load(obj, "headers", "header");
 	_method = static_cast<Method>(obs_data_get_int(obj, "method"));
 	_timeout.Load(obj);
+	// Requests used to always block until the response was received
+	if (obs_data_has_user_value(obj, "waitForResponse")) {
+		_waitForResponse = obs_data_get_bool(obj, "waitForResponse");
+	}
 	return true;
 }
 
@@ -170,7 +158,9 @@ MacroActionHttpEdit::MacroActionHttpEdit(
 	  _headerList(new StringListEdit(
 		  this, obs_module_text("AdvSceneSwitcher.action.http.headers"),
 		  obs_module_text("AdvSceneSwitcher.action.http.addHeader"))),
-	  _timeout(new DurationSelection(this, false))
+	  _timeout(new DurationSelection(this, false)),
+	  _waitForResponse(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.action.http.wait")))
 {
 	populateMethodSelection(_methods);
 	_headerList->SetMaxStringSize(4096);
@@ -188,6 +178,8 @@ MacroActionHttpEdit::MacroActionHttpEdit(
 			 SLOT(HeadersChanged(const StringList &)));
 	QWidget::connect(_timeout, SIGNAL(DurationChanged(const Duration &)),
 			 this, SLOT(TimeoutChanged(const Duration &)));
+	QWidget::connect(_waitForResponse, SIGNAL(stateChanged(int)), this,
+			 SLOT(WaitForResponseChanged(int)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{url}}", _url},
@@ -214,6 +206,7 @@ MacroActionHttpEdit::MacroActionHttpEdit(
 	mainLayout->addLayout(_headerListLayout);
 	mainLayout->addWidget(_data);
 	mainLayout->addLayout(timeoutLayout);
+	mainLayout->addWidget(_waitForResponse);
 	setLayout(mainLayout);
 
 	_entryData = entryData;
@@ -233,6 +226,7 @@ void MacroActionHttpEdit::UpdateEntryData()
 	_headerList->SetStringList(_entryData->_headers);
 	_methods->setCurrentIndex(static_cast<int>(_entryData->_method));
 	_timeout->SetDuration(_entryData->_timeout);
+	_waitForResponse->setChecked(_entryData->_waitForResponse);
 	SetWidgetVisibility();
 }
 
@@ -291,6 +285,16 @@ void MacroActionHttpEdit::HeadersChanged(const StringList &headers)
 	updateGeometry();
 }
 
+void MacroActionHttpEdit::WaitForResponseChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_waitForResponse = value;
+}
+
 void MacroActionHttpEdit::SetWidgetVisibility()
 {
 	_data->setVisible(_entryData->_method == MacroActionHttp::Method::POST);
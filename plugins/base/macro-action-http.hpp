@@ -5,6 +5,8 @@
 #include "duration-control.hpp"
 #include "string-list.hpp"
 
+#include <curl-helper.hpp>
+
 #include <QLineEdit>
 #include <QComboBox>
 #include <QCheckBox>
@@ -35,11 +37,11 @@ public:
 	StringList _headers;
 	Method _method = Method::GET;
 	Duration _timeout = Duration(1.0);
+	bool _waitForResponse = true;
 
 private:
-	void SetupHeaders();
-	void Get();
-	void Post();
+	void SetupTempVars();
+	void SetTempVarValues(const CurlResponse &);
 
 	static bool _registered;
 	static const std::string id;
@@ -68,6 +70,7 @@ private slots:
 	void TimeoutChanged(const Duration &seconds);
 	void SetHeadersChanged(int);
 	void HeadersChanged(const StringList &);
+	void WaitForResponseChanged(int);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -84,6 +87,7 @@ private:
 	QVBoxLayout *_headerListLayout;
 	StringListEdit *_headerList;
 	DurationSelection *_timeout;
+	QCheckBox *_waitForResponse;
 	bool _loading = true;
 };
 
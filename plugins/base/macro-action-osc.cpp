@@ -1,8 +1,10 @@
 #include "macro-action-osc.hpp"
+#include "osc-encoder.hpp"
 
 #include <obs.hpp>
 #include <QGroupBox>
-#include <system_error>
+#include <QToolButton>
+#include <algorithm>
 
 namespace advss {
 
@@ -12,143 +14,51 @@ bool MacroActionOSC::_registered = MacroActionFactory::Register(
 	MacroActionOSC::id, {MacroActionOSC::Create, MacroActionOSCEdit::Create,
 			     "AdvSceneSwitcher.action.osc"});
 
-MacroActionOSC::MacroActionOSC(Macro *m)
-	: MacroAction(m),
-	  _ctx(asio::io_context()),
-	  _tcpSocket(asio::ip::tcp::socket(_ctx)),
-	  _udpSocket(asio::ip::udp::socket(_ctx))
-{
-}
-
-void MacroActionOSC::SendOSCTCPMessage(const asio::mutable_buffer &buffer)
-{
-	try {
-		asio::write(_tcpSocket, asio::buffer(buffer));
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING,
-		     "failed to send OSC message \"%s\" via TCP %s %d: %s",
-		     _message.ToString().c_str(), _ip.c_str(), _port.GetValue(),
-		     e.what());
-	}
-}
-
-void MacroActionOSC::SendOSCUDPMessage(const asio::mutable_buffer &buffer)
-{
-	try {
-		_udpSocket.send_to(buffer, _updEndpoint);
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING,
-		     "failed to send OSC message \"%s\" via UDP %s %d: %s",
-		     _message.ToString().c_str(), _ip.c_str(), _port.GetValue(),
-		     e.what());
-	}
-}
-
-void MacroActionOSC::UDPReconnect()
-{
-	asio::error_code ec;
-	asio::ip::udp::resolver resolver(_ctx);
-	auto endpoints = resolver.resolve(asio::ip::udp::v4(), _ip.c_str(),
-					  std::to_string(_port.GetValue()), ec);
-	if (ec) {
-		endpoints = resolver.resolve(asio::ip::udp::v6(), _ip.c_str(),
-					     std::to_string(_port.GetValue()),
-					     ec);
-	}
-	if (ec) {
-		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
-		     _ip.c_str(), ec.message().c_str());
-		return;
-	}
-
-	try {
-		_updEndpoint = endpoints.begin()->endpoint();
-		_udpSocket = asio::ip::udp::socket(_ctx);
-		_udpSocket.open(endpoints.begin()->endpoint().protocol());
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING, "failed to connect to UDP %s %d: %s",
-		     _ip.c_str(), _port.GetValue(), e.what());
-	}
-}
+MacroActionOSC::MacroActionOSC(Macro *m) : MacroAction(m) {}
 
-void MacroActionOSC::TCPReconnect()
+bool MacroActionOSC::PerformAction()
 {
-	asio::error_code ec;
-	asio::ip::tcp::resolver resolver(_ctx);
-	auto endpoints = resolver.resolve(asio::ip::tcp::v4(), _ip.c_str(),
-					  std::to_string(_port.GetValue()), ec);
-	if (ec) {
-		endpoints = resolver.resolve(asio::ip::tcp::v6(), _ip.c_str(),
-					     std::to_string(_port.GetValue()),
-					     ec);
-	}
-	if (ec) {
-		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
-		     _ip.c_str(), ec.message().c_str());
-		return;
+	// The same action might be performed by multiple threads at once, so
+	// the messages are encoded into local buffers
+	std::vector<std::vector<char>> encodedMessages(_messages.size());
+	for (size_t i = 0; i < _messages.size(); i++) {
+		if (!_messages[i].Encode(encodedMessages[i])) {
+			blog(LOG_WARNING,
+			     "failed to create or fill OSC buffer!");
+			return true;
+		}
 	}
-	try {
-		_tcpSocket = asio::ip::tcp::socket(_ctx);
-		_tcpSocket.connect(endpoints.begin()->endpoint());
-	} catch (const std::exception &e) {
-		blog(LOG_WARNING, "failed to connect to TCP %s %d: %s",
-		     _ip.c_str(), _port.GetValue(), e.what());
-	}
-}
 
-void MacroActionOSC::CheckReconnect()
-{
-	if (_protocol == Protocol::TCP &&
-	    (_reconnect || !_tcpSocket.is_open())) {
-		TCPReconnect();
+	const std::vector<char> *packet = &encodedMessages.front();
+	std::vector<char> bundle;
+	if (encodedMessages.size() > 1) {
+		EncodeOSCBundle(encodedMessages, bundle);
+		packet = &bundle;
 	}
 
-	if (_protocol == Protocol::UDP &&
-	    (_reconnect || !_udpSocket.is_open())) {
-		UDPReconnect();
+	if (!OSCTransport::Send(_protocol, _ip, _port, *packet)) {
+		blog(LOG_WARNING, "failed to send OSC message \"%s\"",
+		     GetMessagesString().c_str());
 	}
+	return true;
 }
 
-bool MacroActionOSC::PerformAction()
+std::string MacroActionOSC::GetMessagesString() const
 {
-	auto buffer = _message.GetBuffer();
-	if (!buffer.has_value()) {
-		blog(LOG_WARNING, "failed to create or fill OSC buffer!");
-		return true;
-	}
-
-	CheckReconnect();
-
-	if (_protocol == Protocol::TCP &&
-	    (_reconnect || !_tcpSocket.is_open())) {
-		TCPReconnect();
+	std::string result;
+	for (const auto &message : _messages) {
+		if (!result.empty()) {
+			result += ", ";
+		}
+		result += message.ToString();
 	}
-
-	if (_protocol == Protocol::UDP &&
-	    (_reconnect || !_udpSocket.is_open())) {
-		UDPReconnect();
-	}
-
-	auto rawMessage = asio::buffer(*buffer);
-
-	switch (_protocol) {
-	case MacroActionOSC::Protocol::TCP:
-		SendOSCTCPMessage(rawMessage);
-		break;
-	case MacroActionOSC::Protocol::UDP:
-		SendOSCUDPMessage(rawMessage);
-		break;
-	default:
-		break;
-	}
-
-	return true;
+	return result;
 }
 
 void MacroActionOSC::LogAction() const
 {
 	ablog(LOG_INFO, "sending OSC message '%s' to %s %s %d",
-	      _message.ToString().c_str(),
+	      GetMessagesString().c_str(),
 	      _protocol == Protocol::UDP ? "UDP" : "TCP", _ip.c_str(),
 	      _port.GetValue());
 }
@@ -159,7 +69,15 @@ bool MacroActionOSC::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "protocol", static_cast<int>(_protocol));
 	_ip.Save(obj, "ip");
 	_port.Save(obj, "port");
-	_message.Save(obj);
+	_messages.front().Save(obj);
+	OBSDataArrayAutoRelease additionalMessages = obs_data_array_create();
+	for (auto it = std::next(_messages.begin()); it != _messages.end();
+	     ++it) {
+		OBSDataAutoRelease data = obs_data_create();
+		it->Save(data);
+		obs_data_array_push_back(additionalMessages, data);
+	}
+	obs_data_set_array(obj, "additionalMessages", additionalMessages);
 	return true;
 }
 
@@ -169,7 +87,18 @@ bool MacroActionOSC::Load(obs_data_t *obj)
 	_protocol = static_cast<Protocol>(obs_data_get_int(obj, "protocol"));
 	_ip.Load(obj, "ip");
 	_port.Load(obj, "port");
-	_message.Load(obj);
+	_messages.resize(1);
+	_messages.front().Load(obj);
+	OBSDataArrayAutoRelease additionalMessages =
+		obs_data_get_array(obj, "additionalMessages");
+	const size_t count = obs_data_array_count(additionalMessages);
+	for (size_t i = 0; i < count; ++i) {
+		OBSDataAutoRelease data =
+			obs_data_array_item(additionalMessages, i);
+		OSCMessage message;
+		message.Load(data);
+		_messages.emplace_back(message);
+	}
 	return true;
 }
 
@@ -191,26 +120,25 @@ std::shared_ptr<MacroAction> MacroActionOSC::Copy() const
 void MacroActionOSC::SetProtocol(Protocol p)
 {
 	_protocol = p;
-	_reconnect = true;
 }
 
 void MacroActionOSC::SetIP(const std::string &ip)
 {
 	_ip = ip;
-	_reconnect = true;
 }
 
 void MacroActionOSC::SetPortNr(IntVariable port)
 {
 	_port = port;
-	_reconnect = true;
 }
 
 void MacroActionOSC::ResolveVariablesToFixedValues()
 {
 	_ip.ResolveVariables();
 	_port.ResolveVariables();
-	_message.ResolveVariables();
+	for (auto &message : _messages) {
+		message.ResolveVariables();
+	}
 }
 
 static void populateProtocolSelection(QComboBox *list)
@@ -225,7 +153,9 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 	  _protocol(new QComboBox(this)),
 	  _ip(new VariableLineEdit(this)),
 	  _port(new VariableSpinBox(this)),
-	  _message(new OSCMessageEdit(this))
+	  _messageLayout(new QVBoxLayout()),
+	  _addMessage(new QToolButton(this)),
+	  _removeMessage(new QToolButton(this))
 {
 	populateProtocolSelection(_protocol);
 	_port->setMaximum(65535);
@@ -254,8 +184,22 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 
 	auto messageGroup =
 		new QGroupBox(obs_module_text("AdvSceneSwitcher.osc.message"));
-	auto messageLayout = new QHBoxLayout();
-	messageLayout->addWidget(_message);
+	_addMessage->setProperty("themeID",
+				 QVariant(QString::fromUtf8("addIconSmall")));
+	_addMessage->setToolTip(
+		obs_module_text("AdvSceneSwitcher.osc.message.add"));
+	_removeMessage->setProperty(
+		"themeID", QVariant(QString::fromUtf8("removeIconSmall")));
+	_removeMessage->setToolTip(
+		obs_module_text("AdvSceneSwitcher.osc.message.remove"));
+	auto controlLayout = new QHBoxLayout();
+	controlLayout->setContentsMargins(0, 0, 0, 0);
+	controlLayout->addWidget(_addMessage);
+	controlLayout->addWidget(_removeMessage);
+	controlLayout->addStretch();
+	auto messageLayout = new QVBoxLayout();
+	messageLayout->addLayout(_messageLayout);
+	messageLayout->addLayout(controlLayout);
 	messageGroup->setLayout(messageLayout);
 
 	auto mainLayout = new QVBoxLayout;
@@ -271,8 +215,10 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 		_port,
 		SIGNAL(NumberVariableChanged(const NumberVariable<int> &)),
 		this, SLOT(PortChanged(const NumberVariable<int> &)));
-	QWidget::connect(_message, SIGNAL(MessageChanged(const OSCMessage &)),
-			 this, SLOT(MessageChanged(const OSCMessage &)));
+	QWidget::connect(_addMessage, SIGNAL(clicked()), this,
+			 SLOT(AddMessage()));
+	QWidget::connect(_removeMessage, SIGNAL(clicked()), this,
+			 SLOT(RemoveMessage()));
 
 	_entryData = entryData;
 	UpdateEntryData();
@@ -288,7 +234,10 @@ void MacroActionOSCEdit::UpdateEntryData()
 	_protocol->setCurrentIndex(static_cast<int>(_entryData->GetProtocol()));
 	_ip->setText(_entryData->GetIP());
 	_port->SetValue(_entryData->GetPortNr());
-	_message->SetMessage(_entryData->_message);
+	for (const auto &message : _entryData->_messages) {
+		AddMessageEdit(message);
+	}
+	SetMessageControlsEnabled();
 
 	adjustSize();
 	updateGeometry();
@@ -324,14 +273,70 @@ void MacroActionOSCEdit::PortChanged(const NumberVariable<int> &value)
 	_entryData->SetPortNr(value);
 }
 
+void MacroActionOSCEdit::AddMessageEdit(const OSCMessage &message)
+{
+	auto edit = new OSCMessageEdit(this);
+	edit->SetMessage(message);
+	QWidget::connect(edit, SIGNAL(MessageChanged(const OSCMessage &)),
+			 this, SLOT(MessageChanged(const OSCMessage &)));
+	_messageLayout->addWidget(edit);
+	_messages.emplace_back(edit);
+}
+
+void MacroActionOSCEdit::SetMessageControlsEnabled()
+{
+	_removeMessage->setEnabled(_messages.size() > 1);
+}
+
 void MacroActionOSCEdit::MessageChanged(const OSCMessage &m)
 {
 	if (_loading || !_entryData) {
 		return;
 	}
 
+	auto it = std::find(_messages.begin(), _messages.end(), sender());
+	if (it == _messages.end()) {
+		return;
+	}
+
 	auto lock = LockContext();
-	_entryData->_message = m;
+	_entryData->_messages.at(std::distance(_messages.begin(), it)) = m;
+
+	adjustSize();
+	updateGeometry();
+}
+
+void MacroActionOSCEdit::AddMessage()
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	OSCMessage message;
+	{
+		auto lock = LockContext();
+		_entryData->_messages.emplace_back(message);
+	}
+	AddMessageEdit(message);
+	SetMessageControlsEnabled();
+
+	adjustSize();
+	updateGeometry();
+}
+
+void MacroActionOSCEdit::RemoveMessage()
+{
+	if (_loading || !_entryData || _messages.size() <= 1) {
+		return;
+	}
+
+	{
+		auto lock = LockContext();
+		_entryData->_messages.pop_back();
+	}
+	_messages.back()->deleteLater();
+	_messages.pop_back();
+	SetMessageControlsEnabled();
 
 	adjustSize();
 	updateGeometry();
@@ -1,9 +1,9 @@
 #pragma once
 #include "macro-action-edit.hpp"
 #include "osc-helpers.hpp"
+#include "osc-transport.hpp"
 
 #include <memory>
-#include <asio.hpp>
 
 namespace advss {
 
@@ -18,10 +18,7 @@ public:
 	static std::shared_ptr<MacroAction> Create(Macro *m);
 	std::shared_ptr<MacroAction> Copy() const;
 
-	enum class Protocol {
-		TCP,
-		UDP,
-	};
+	using Protocol = OSCTransport::Protocol;
 
 	void SetProtocol(Protocol);
 	Protocol GetProtocol() const { return _protocol; }
@@ -31,25 +28,15 @@ public:
 	IntVariable GetPortNr() { return _port; }
 	void ResolveVariablesToFixedValues();
 
-	OSCMessage _message;
+	// Multiple messages are sent as a single OSC bundle
+	std::vector<OSCMessage> _messages = {OSCMessage()};
 
 private:
-	void SendOSCTCPMessage(const asio::mutable_buffer &);
-	void SendOSCUDPMessage(const asio::mutable_buffer &);
-
-	void CheckReconnect();
-	void TCPReconnect();
-	void UDPReconnect();
+	std::string GetMessagesString() const;
 
 	Protocol _protocol = Protocol::UDP;
 	StringVariable _ip = "localhost";
 	IntVariable _port = 12345;
-	bool _reconnect = true;
-
-	asio::io_context _ctx;
-	asio::ip::tcp::socket _tcpSocket;
-	asio::ip::udp::socket _udpSocket;
-	asio::ip::udp::endpoint _updEndpoint;
 
 	static bool _registered;
 	static const std::string id;
@@ -75,6 +62,8 @@ private slots:
 	void MessageChanged(const OSCMessage &);
 	void ProtocolChanged(int);
 	void PortChanged(const NumberVariable<int> &value);
+	void AddMessage();
+	void RemoveMessage();
 
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -83,10 +72,16 @@ protected:
 	std::shared_ptr<MacroActionOSC> _entryData;
 
 private:
+	void AddMessageEdit(const OSCMessage &);
+	void SetMessageControlsEnabled();
+
 	QComboBox *_protocol;
 	VariableLineEdit *_ip;
 	VariableSpinBox *_port;
-	OSCMessageEdit *_message;
+	QVBoxLayout *_messageLayout;
+	std::vector<OSCMessageEdit *> _messages;
+	QToolButton *_addMessage;
+	QToolButton *_removeMessage;
 	bool _loading = true;
 };
 
@@ -35,6 +35,18 @@ const static std::map<MacroConditionAudio::OutputCondition, std::string>
 		 "AdvSceneSwitcher.condition.audio.state.below"},
 };
 
+const static std::map<MacroConditionAudio::OutputMeasurement, std::string>
+	outputMeasurementTypes = {
+		{MacroConditionAudio::OutputMeasurement::PEAK,
+		 "AdvSceneSwitcher.condition.audio.measurement.peak"},
+		{MacroConditionAudio::OutputMeasurement::PEAK_HOLD,
+		 "AdvSceneSwitcher.condition.audio.measurement.peakHold"},
+		{MacroConditionAudio::OutputMeasurement::RMS,
+		 "AdvSceneSwitcher.condition.audio.measurement.rms"},
+		{MacroConditionAudio::OutputMeasurement::LOUDNESS,
+		 "AdvSceneSwitcher.condition.audio.measurement.loudness"},
+};
+
 const static std::map<MacroConditionAudio::VolumeCondition, std::string>
 	audioVolumeConditionTypes = {
 		{MacroConditionAudio::VolumeCondition::ABOVE,
@@ -55,45 +67,34 @@ void MacroConditionAudio::SetType(const Type &type)
 	SetupTempVars();
 }
 
-MacroConditionAudio::~MacroConditionAudio()
+void MacroConditionAudio::SetOutputMeasurement(OutputMeasurement measurement)
 {
-	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
-	obs_volmeter_destroy(_volmeter);
+	_measurement = measurement;
+	_levelWindow->Clear();
 }
 
-float MacroConditionAudio::GetVolumePeak()
+void MacroConditionAudio::SetMeasurementWindow(const Duration &window)
 {
-	using namespace std::chrono_literals;
-	using namespace std::chrono;
-	static constexpr std::chrono::milliseconds timeout = 250ms;
-
-	// OBS might rarely not update _peak quickly enough when very low
-	// intervals are configured on the General tab.
-	// In that case _peak might be set to negative infinity still, which
-	// will result in unexpected behavior, so we use the previously valid
-	// peak value instead.
-	//
-	// If no volume update was received within a timeout window, however, it
-	// is assumed, that the source no longer produces any audio output and
-	// thus a peak volume value of negative infinity is used.
-
-	float peak;
+	_window = window;
+	_levelWindow->SetWindowSize(std::chrono::milliseconds(
+		static_cast<int64_t>(_window.Milliseconds())));
+}
 
-	std::lock_guard<std::mutex> lock(_peakMutex);
-	auto msPassedSinceLastUpdate = duration_cast<milliseconds>(
-		high_resolution_clock::now() - _lastPeakUpdate);
-	if (_lastPeakUpdate.time_since_epoch().count() != 0 &&
-	    msPassedSinceLastUpdate > timeout) {
-		peak = -std::numeric_limits<float>::infinity();
-	} else {
-		peak = _peakUpdated ? _peak : _previousPeak;
+float MacroConditionAudio::GetOutputVolume()
+{
+	switch (_measurement) {
+	case OutputMeasurement::PEAK:
+		return _levelWindow->ConsumePeak();
+	case OutputMeasurement::PEAK_HOLD:
+		return _levelWindow->GetPeakHold();
+	case OutputMeasurement::RMS:
+		return _levelWindow->GetRMS();
+	case OutputMeasurement::LOUDNESS:
+		return _levelWindow->GetLoudness();
+	default:
+		break;
 	}
-
-	_previousPeak = peak;
-	_peak = -std::numeric_limits<float>::infinity();
-	_peakUpdated = false;
-
-	return peak;
+	return -std::numeric_limits<float>::infinity();
 }
 
 bool MacroConditionAudio::CheckOutputCondition()
@@ -102,8 +103,18 @@ bool MacroConditionAudio::CheckOutputCondition()
 	OBSSourceAutoRelease source =
 		obs_weak_source_get_source(_audioSource.GetSource());
 
-	float peak = GetVolumePeak();
-	double curVolume = _useDb ? peak : DecibelToPercent(peak) * 100;
+	// The source of variable based selections might have changed since the
+	// last check
+	if (_audioSource.GetType() == SourceSelection::Type::VARIABLE &&
+	    (!_levelMonitor ||
+	     _levelMonitor->GetSource() != _audioSource.GetSource())) {
+		ResetVolmeter();
+	}
+
+	_window.ResolveVariables();
+	SetMeasurementWindow(_window);
+	float level = GetOutputVolume();
+	double curVolume = _useDb ? level : DecibelToPercent(level) * 100;
 
 	switch (_outputCondition) {
 	case OutputCondition::ABOVE:
@@ -127,11 +138,6 @@ bool MacroConditionAudio::CheckOutputCondition()
 	SetVariableValue(std::to_string(curVolume));
 	SetTempVarValue("output_volume", std::to_string(curVolume));
 
-	// Reset for next check
-	if (_audioSource.GetType() == SourceSelection::Type::VARIABLE) {
-		ResetVolmeter();
-	}
-
 	return ret && source;
 }
 
@@ -288,26 +294,13 @@ bool MacroConditionAudio::Save(obs_data_t *obj) const
 			 static_cast<int>(_volumeCondition));
 	obs_data_set_bool(obj, "useDb", _useDb);
 	_volumeDB.Save(obj, "volumeDB");
+	obs_data_set_int(obj, "outputMeasurement",
+			 static_cast<int>(_measurement));
+	_window.Save(obj, "measurementWindow");
 	obs_data_set_int(obj, "version", 3);
 	return true;
 }
 
-obs_volmeter_t *AddVolmeterToSource(MacroConditionAudio *entry,
-				    obs_weak_source *source)
-{
-	obs_volmeter_t *volmeter = obs_volmeter_create(OBS_FADER_LOG);
-	obs_volmeter_add_callback(volmeter, MacroConditionAudio::SetVolumeLevel,
-				  entry);
-	OBSSourceAutoRelease audioSource = obs_weak_source_get_source(source);
-	if (!obs_volmeter_attach_source(volmeter, audioSource)) {
-		const char *name = obs_source_get_name(audioSource);
-		blog(LOG_WARNING, "failed to attach volmeter to source %s",
-		     name);
-	}
-
-	return volmeter;
-}
-
 bool MacroConditionAudio::Load(obs_data_t *obj)
 {
 	MacroCondition::Load(obj);
@@ -328,7 +321,12 @@ bool MacroConditionAudio::Load(obs_data_t *obj)
 		obs_data_get_int(obj, "outputCondition"));
 	_volumeCondition = static_cast<VolumeCondition>(
 		obs_data_get_int(obj, "volumeCondition"));
-	_volmeter = AddVolmeterToSource(this, _audioSource.GetSource());
+	_measurement = static_cast<OutputMeasurement>(
+		obs_data_get_int(obj, "outputMeasurement"));
+	if (obs_data_has_user_value(obj, "measurementWindow")) {
+		_window.Load(obj, "measurementWindow");
+	}
+	SetMeasurementWindow(_window);
 
 	if (obs_data_get_int(obj, "version") < 2) {
 		// Set default values for dB handling
@@ -354,32 +352,21 @@ std::string MacroConditionAudio::GetShortDesc() const
 	return _audioSource.ToString();
 }
 
-void MacroConditionAudio::SetVolumeLevel(void *data, const float *,
-					 const float peak[MAX_AUDIO_CHANNELS],
-					 const float *)
-{
-	auto c = static_cast<MacroConditionAudio *>(data);
-	const auto macro = c->GetMacro();
-	if (MacroIsPaused(macro)) {
-		return;
-	}
-
-	std::lock_guard<std::mutex> lock(c->_peakMutex);
-	for (int i = 0; i < MAX_AUDIO_CHANNELS; i++) {
-		if (peak[i] > c->_peak) {
-			c->_peak = peak[i];
-		}
-	}
-	c->_peakUpdated = true;
-	c->_lastPeakUpdate = std::chrono::high_resolution_clock::now();
-}
-
 void MacroConditionAudio::ResetVolmeter()
 {
-	obs_volmeter_remove_callback(_volmeter, SetVolumeLevel, this);
-	obs_volmeter_destroy(_volmeter);
+	// A new window is used as the previous one might still be registered
+	// at the level monitor of the old source
+	auto window = std::make_shared<AudioLevelWindow>();
+	window->SetWindowSize(_levelWindow->GetWindowSize());
+	_levelWindow = window;
 
-	_volmeter = AddVolmeterToSource(this, _audioSource.GetSource());
+	auto source = _audioSource.GetSource();
+	if (!source) {
+		_levelMonitor.reset();
+		return;
+	}
+	_levelMonitor = AudioLevelMonitor::Get(source);
+	_levelMonitor->AddWindow(_levelWindow);
 }
 
 void MacroConditionAudio::SetupTempVars()
@@ -450,6 +437,13 @@ static inline void populateOutputConditionSelection(QComboBox *list)
 	}
 }
 
+static inline void populateOutputMeasurementSelection(QComboBox *list)
+{
+	for (const auto &[_, name] : outputMeasurementTypes) {
+		list->addItem(obs_module_text(name.c_str()));
+	}
+}
+
 static inline void populateVolumeConditionSelection(QComboBox *list)
 {
 	list->clear();
@@ -464,6 +458,9 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	  _checkTypes(new QComboBox()),
 	  _sources(new SourceSelectionWidget(this, QStringList(), true)),
 	  _condition(new QComboBox()),
+	  _measurement(new QComboBox()),
+	  _window(new DurationSelection(this, false, 0.1)),
+	  _measurementLayout(new QHBoxLayout()),
 	  _volumePercent(new VariableDoubleSpinBox()),
 	  _volumeDB(new VariableDoubleSpinBox),
 	  _percentDBToggle(new QPushButton),
@@ -516,8 +513,13 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 		this, SLOT(VolumeDBChanged(const NumberVariable<double> &)));
 	QWidget::connect(_percentDBToggle, SIGNAL(clicked()), this,
 			 SLOT(PercentDBClicked()));
+	QWidget::connect(_measurement, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(MeasurementChanged(int)));
+	QWidget::connect(_window, SIGNAL(DurationChanged(const Duration &)),
+			 this, SLOT(WindowChanged(const Duration &)));
 
 	populateCheckTypes(_checkTypes);
+	populateOutputMeasurementSelection(_measurement);
 	PopulateMonitorTypeSelection(_monitorTypes);
 
 	QHBoxLayout *switchLayout = new QHBoxLayout;
@@ -534,9 +536,15 @@ MacroConditionAudioEdit::MacroConditionAudioEdit(
 	};
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.audio.entry"),
 		     switchLayout, widgetPlaceholders);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.audio.entry.measurement"),
+		_measurementLayout,
+		{{"{{measurement}}", _measurement}, {"{{window}}", _window}});
 
 	QVBoxLayout *mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(switchLayout);
+	mainLayout->addLayout(_measurementLayout);
 	mainLayout->addWidget(_balance);
 	setLayout(mainLayout);
 
@@ -637,6 +645,20 @@ void MacroConditionAudioEdit::VolumeDBChanged(
 	SyncSliderAndValueSelection(false);
 }
 
+void MacroConditionAudioEdit::MeasurementChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetOutputMeasurement(
+		static_cast<MacroConditionAudio::OutputMeasurement>(value));
+	SetWidgetVisibility();
+}
+
+void MacroConditionAudioEdit::WindowChanged(const Duration &window)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetMeasurementWindow(window);
+}
+
 void MacroConditionAudioEdit::PercentDBClicked()
 {
 	if (_loading || !_entryData) {
@@ -735,6 +757,9 @@ void MacroConditionAudioEdit::UpdateEntryData()
 	_syncOffset->SetValue(_entryData->_syncOffset);
 	_monitorTypes->setCurrentIndex(_entryData->_monitorType);
 	_balance->SetDoubleValue(_entryData->_balance);
+	_measurement->setCurrentIndex(
+		static_cast<int>(_entryData->GetOutputMeasurement()));
+	_window->SetDuration(_entryData->GetMeasurementWindow());
 	_checkTypes->setCurrentIndex(
 		_checkTypes->findData(static_cast<int>(_entryData->GetType())));
 
@@ -791,6 +816,13 @@ void MacroConditionAudioEdit::SetWidgetVisibility()
 			     MacroConditionAudio::Type::BALANCE);
 	_volMeter->setVisible(_entryData->GetType() ==
 			      MacroConditionAudio::Type::OUTPUT_VOLUME);
+	const bool isOutputVolume = _entryData->GetType() ==
+				    MacroConditionAudio::Type::OUTPUT_VOLUME;
+	SetLayoutVisible(_measurementLayout, isOutputVolume);
+	_window->setVisible(
+		isOutputVolume &&
+		_entryData->GetOutputMeasurement() !=
+			MacroConditionAudio::OutputMeasurement::PEAK);
 	_volumePercent->setVisible(HasVolumeControl() && !_entryData->_useDb);
 	_volumeDB->setVisible(HasVolumeControl() && _entryData->_useDb);
 	_percentDBToggle->setText(_entryData->_useDb ? "dB" : "%");
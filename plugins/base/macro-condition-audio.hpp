@@ -1,20 +1,19 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "audio-level-monitor.hpp"
+#include "duration-control.hpp"
 #include "volume-control.hpp"
 #include "slider-spinbox.hpp"
 #include "source-selection.hpp"
 
-#include <limits>
 #include <QWidget>
 #include <QComboBox>
-#include <chrono>
 
 namespace advss {
 
 class MacroConditionAudio : public MacroCondition {
 public:
 	MacroConditionAudio(Macro *m) : MacroCondition(m, true) {}
-	~MacroConditionAudio();
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
@@ -24,10 +23,6 @@ public:
 	{
 		return std::make_shared<MacroConditionAudio>(m);
 	}
-	static void SetVolumeLevel(void *data,
-				   const float magnitude[MAX_AUDIO_CHANNELS],
-				   const float peak[MAX_AUDIO_CHANNELS],
-				   const float inputPeak[MAX_AUDIO_CHANNELS]);
 	void ResetVolmeter();
 
 	enum class Type {
@@ -45,6 +40,17 @@ public:
 		BELOW,
 	};
 
+	enum class OutputMeasurement {
+		PEAK,
+		PEAK_HOLD,
+		RMS,
+		LOUDNESS,
+	};
+	void SetOutputMeasurement(OutputMeasurement);
+	OutputMeasurement GetOutputMeasurement() const { return _measurement; }
+	void SetMeasurementWindow(const Duration &);
+	Duration GetMeasurementWindow() const { return _window; }
+
 	enum class VolumeCondition {
 		ABOVE,
 		EXACT,
@@ -62,23 +68,23 @@ public:
 	DoubleVariable _balance = 0.5;
 	OutputCondition _outputCondition = OutputCondition::ABOVE;
 	VolumeCondition _volumeCondition = VolumeCondition::ABOVE;
-	obs_volmeter_t *_volmeter = nullptr;
 
 private:
+	void SetupResources() { ResetVolmeter(); }
 	bool CheckOutputCondition();
 	bool CheckVolumeCondition();
 	bool CheckSyncOffset();
 	bool CheckMonitor();
 	bool CheckBalance();
 	void SetupTempVars();
-	float GetVolumePeak();
+	float GetOutputVolume();
 
 	Type _checkType = Type::OUTPUT_VOLUME;
-	std::mutex _peakMutex;
-	float _peak = -std::numeric_limits<float>::infinity();
-	float _previousPeak = -std::numeric_limits<float>::infinity();
-	bool _peakUpdated = false;
-	std::chrono::high_resolution_clock::time_point _lastPeakUpdate = {};
+	OutputMeasurement _measurement = OutputMeasurement::PEAK;
+	Duration _window = 2.0;
+	std::shared_ptr<AudioLevelMonitor> _levelMonitor;
+	std::shared_ptr<AudioLevelWindow> _levelWindow =
+		std::make_shared<AudioLevelWindow>();
 	static bool _registered;
 	static const std::string id;
 };
@@ -105,6 +111,8 @@ private slots:
 	void VolumePercentChanged(const NumberVariable<double> &vol);
 	void ConditionChanged(int cond);
 	void CheckTypeChanged(int cond);
+	void MeasurementChanged(int);
+	void WindowChanged(const Duration &);
 	void SyncOffsetChanged(const NumberVariable<int> &value);
 	void MonitorTypeChanged(int value);
 	void BalanceChanged(const NumberVariable<double> &value);
@@ -122,6 +130,9 @@ private:
 	QComboBox *_checkTypes;
 	SourceSelectionWidget *_sources;
 	QComboBox *_condition;
+	QComboBox *_measurement;
+	DurationSelection *_window;
+	QHBoxLayout *_measurementLayout;
 	VariableDoubleSpinBox *_volumePercent;
 	VariableDoubleSpinBox *_volumeDB;
 	QPushButton *_percentDBToggle;
@@ -98,11 +98,7 @@ bool MacroConditionClipboard::CheckCondition()
 {
 	switch (_condition) {
 	case Condition::CHANGED:
-		while (!_messageBuffer->Empty()) {
-			auto message = _messageBuffer->ConsumeMessage();
-			if (!message) {
-				continue;
-			}
+		while (const auto message = _messageBuffer->ConsumeMessage()) {
 			SetTempVarValue("text", *message);
 			return true;
 		}
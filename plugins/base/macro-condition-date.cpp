@@ -181,6 +181,10 @@ bool MacroConditionDate::CheckCondition()
 		return false;
 	}
 	auto msSinceLastCheck = MillisecondsSinceMacroConditionCheck(m);
+	if (_updateOnRepeat) {
+		// The date is updated while checking and saved as is
+		MarkDirty();
+	}
 	if (_dayOfWeekCheck) {
 		return CheckDayOfWeek(msSinceLastCheck);
 	}
@@ -1,12 +1,12 @@
 #include "macro-condition-file.hpp"
-#include "curl-helper.hpp"
 #include "layout-helpers.hpp"
 #include "plugin-state-helpers.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <QFileDialog>
-#include <QTextStream>
-#include <regex>
+#include <QFileInfo>
+#include <QStandardItemModel>
 
 namespace advss {
 
@@ -17,30 +17,8 @@ bool MacroConditionFile::_registered = MacroConditionFactory::Register(
 	{MacroConditionFile::Create, MacroConditionFileEdit::Create,
 	 "AdvSceneSwitcher.condition.file"});
 
-static std::hash<std::string> strHash;
-
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
-{
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
-}
-
-static std::string getRemoteData(std::string &url)
-{
-	std::string readBuffer;
-	CurlHelper::SetOpt(CURLOPT_URL, url.c_str());
-	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCallback);
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &readBuffer);
-	// Set timeout to at least one second
-	int timeout = GetIntervalValue() / 1000;
-	if (timeout == 0) {
-		timeout = 1;
-	}
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT, 1);
-	CurlHelper::Perform();
-	return readBuffer;
-}
+static constexpr int maxCaptureGroups = 5;
+static constexpr auto minPollInterval = std::chrono::milliseconds(100);
 
 void MacroConditionFile::SetCondition(Condition condition)
 {
@@ -48,84 +26,83 @@ void MacroConditionFile::SetCondition(Condition condition)
 	SetupTempVars();
 }
 
-bool MacroConditionFile::MatchFileContent(QString &filedata)
+bool MacroConditionFile::MatchFileContent(const std::string &content,
+					  uint64_t hash)
 {
 	if (_onlyMatchIfChanged) {
-		size_t newHash = strHash(filedata.toUtf8().constData());
-		if (newHash == _lastHash) {
+		if (hash == _lastHash) {
 			return false;
 		}
-		_lastHash = newHash;
+		_lastHash = hash;
 	}
 
 	if (_regex.Enabled()) {
-		return _regex.Matches(filedata, QString::fromStdString(_text));
+		return _regex.Matches(content, _text);
 	}
+	return CompareIgnoringLineEnding(content, std::string(_text));
+}
 
-	QString text = QString::fromStdString(_text);
-	return CompareIgnoringLineEnding(text, filedata);
+bool MacroConditionFile::UpdateRemoteFile()
+{
+	const auto interval = std::chrono::milliseconds(
+		static_cast<long long>(_pollInterval.Milliseconds()));
+	return _remoteFile.Update(_file, std::max(interval, minPollInterval));
 }
 
 bool MacroConditionFile::CheckRemoteFileContent()
 {
-	std::string path = _file;
-	std::string data = getRemoteData(path);
-	SetVariableValue(data);
-	SetTempVarValue("content", data);
-	QString qdata = QString::fromStdString(data);
-	return MatchFileContent(qdata);
+	// The latest content received in the background is used
+	if (!UpdateRemoteFile()) {
+		return false;
+	}
+
+	const auto &content = _remoteFile.GetContent();
+	SetVariableValue(content);
+	SetTempVarValue("content", content);
+	return MatchFileContent(content, _remoteFile.GetHash());
 }
 
 bool MacroConditionFile::CheckLocalFileContent()
 {
-	QFile file(QString::fromStdString(_file));
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+	// The file is only read again once it was modified
+	if (_watchedFile.Update(_file) == WatchedFile::State::UNAVAILABLE) {
 		return false;
 	}
 
 	if (_useTime) {
-		QDateTime newLastMod = QFileInfo(file).lastModified();
+		QDateTime newLastMod =
+			QFileInfo(QString::fromStdString(_file)).lastModified();
 		if (_lastMod == newLastMod) {
 			return false;
 		}
 		_lastMod = newLastMod;
 	}
 
-	QString filedata = QTextStream(&file).readAll();
-	SetVariableValue(filedata.toStdString());
-	SetTempVarValue("content", filedata.toStdString());
-	bool match = MatchFileContent(filedata);
-
-	file.close();
-	return match;
+	const auto &content = _watchedFile.GetContent();
+	SetVariableValue(content);
+	SetTempVarValue("content", content);
+	return MatchFileContent(content, _watchedFile.GetHash());
 }
 
 bool MacroConditionFile::CheckChangeContent()
 {
-	QString filedata;
-	switch (_fileType) {
-	case FileType::LOCAL: {
-		std::string path = _file;
-		QFile file(QString::fromStdString(path));
-		if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+	if (_fileType == FileType::REMOTE) {
+		if (!UpdateRemoteFile()) {
 			return false;
 		}
-		filedata = QTextStream(&file).readAll();
-		file.close();
-	} break;
-	case FileType::REMOTE: {
-		std::string path = _file;
-		std::string data = getRemoteData(path);
-		QString filedata = QString::fromStdString(data);
-	} break;
-	default:
-		break;
+		SetTempVarValue("content", _remoteFile.GetContent());
+		const bool contentChanged = _remoteFile.GetHash() != _lastHash;
+		_lastHash = _remoteFile.GetHash();
+		return contentChanged;
 	}
 
-	SetTempVarValue("content", filedata.toStdString());
-	size_t newHash = strHash(filedata.toUtf8().constData());
-	const bool contentChanged = newHash != _lastHash;
-	_lastHash = newHash;
+	if (_watchedFile.Update(_file) == WatchedFile::State::UNAVAILABLE) {
+		return false;
+	}
+
+	SetTempVarValue("content", _watchedFile.GetContent());
+	const bool contentChanged = _watchedFile.GetHash() != _lastHash;
+	_lastHash = _watchedFile.GetHash();
 	return contentChanged;
 }
 
@@ -144,6 +121,55 @@ bool MacroConditionFile::CheckChangeDate()
 	return dateChanged;
 }
 
+bool MacroConditionFile::CheckNewLines()
+{
+	if (_fileType == FileType::REMOTE) {
+		// Not offered for remote files, but the file type might have
+		// been changed afterwards or set by an older version
+		if (!_remoteNewLineWarned) {
+			blog(LOG_WARNING,
+			     "cannot detect new lines in remote file \"%s\"",
+			     _file.c_str());
+			_remoteNewLineWarned = true;
+		}
+		return false;
+	}
+
+	// Only compile the expression again if it was modified
+	const auto regex = _regex.GetRegularExpression(_text);
+	if (regex != _lineRegex) {
+		_lineRegex = regex;
+	}
+
+	const std::string text = _text;
+	std::string matchingLine;
+	QRegularExpressionMatch match;
+	auto matches = [&](std::string_view line) {
+		if (_regex.Enabled()) {
+			match = _lineRegex.match(QString::fromUtf8(
+				line.data(), static_cast<int>(line.size())));
+			if (!match.hasMatch()) {
+				return false;
+			}
+		} else if (line != text) {
+			return false;
+		}
+		matchingLine = line;
+		return true;
+	};
+	if (!_fileTail.FindLine(_file, matches)) {
+		return false;
+	}
+
+	SetVariableValue(matchingLine);
+	SetTempVarValue("line", matchingLine);
+	for (int i = 1; i <= maxCaptureGroups; ++i) {
+		SetTempVarValue("captureGroup" + std::to_string(i),
+				match.captured(i).toStdString());
+	}
+	return true;
+}
+
 void MacroConditionFile::SetupTempVars()
 {
 	MacroCondition::SetupTempVars();
@@ -151,6 +177,16 @@ void MacroConditionFile::SetupTempVars()
 		AddTempvar(
 			"date",
 			obs_module_text("AdvSceneSwitcher.tempVar.file.date"));
+	} else if (_condition == Condition::NEW_LINE) {
+		AddTempvar(
+			"line",
+			obs_module_text("AdvSceneSwitcher.tempVar.file.line"));
+		const QString name = obs_module_text(
+			"AdvSceneSwitcher.tempVar.file.captureGroup");
+		for (int i = 1; i <= maxCaptureGroups; ++i) {
+			AddTempvar("captureGroup" + std::to_string(i),
+				   name.arg(i).toStdString());
+		}
 	} else {
 		AddTempvar("content",
 			   obs_module_text(
@@ -175,6 +211,9 @@ bool MacroConditionFile::CheckCondition()
 	case Condition::DATE_CHANGE:
 		ret = CheckChangeDate();
 		break;
+	case Condition::NEW_LINE:
+		ret = CheckNewLines();
+		break;
 	default:
 		break;
 	}
@@ -195,6 +234,7 @@ bool MacroConditionFile::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
 	obs_data_set_bool(obj, "useTime", _useTime);
 	obs_data_set_bool(obj, "onlyMatchIfChanged", _onlyMatchIfChanged);
+	_pollInterval.Save(obj, "pollInterval");
 	return true;
 }
 
@@ -214,6 +254,9 @@ bool MacroConditionFile::Load(obs_data_t *obj)
 		static_cast<Condition>(obs_data_get_int(obj, "condition")));
 	_useTime = obs_data_get_bool(obj, "useTime");
 	_onlyMatchIfChanged = obs_data_get_bool(obj, "onlyMatchIfChanged");
+	if (obs_data_has_user_value(obj, "pollInterval")) {
+		_pollInterval.Load(obj, "pollInterval");
+	}
 	return true;
 }
 
@@ -237,6 +280,8 @@ static void populateConditions(QComboBox *list)
 		"AdvSceneSwitcher.condition.file.type.contentChange"));
 	list->addItem(obs_module_text(
 		"AdvSceneSwitcher.condition.file.type.dateChange"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.file.type.newLine"));
 }
 
 MacroConditionFileEdit::MacroConditionFileEdit(
@@ -249,8 +294,10 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 	  _regex(new RegexConfigWidget(parent)),
 	  _checkModificationDate(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.fileTab.checkfileContentTime"))),
-	  _checkFileContent(new QCheckBox(
-		  obs_module_text("AdvSceneSwitcher.fileTab.checkfileContent")))
+	  _checkFileContent(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.fileTab.checkfileContent"))),
+	  _pollInterval(new DurationSelection(this, false)),
+	  _pollIntervalControls(new QWidget(this))
 {
 	populateFileTypes(_fileTypes);
 	populateConditions(_conditions);
@@ -270,6 +317,9 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 			 this, SLOT(CheckModificationDateChanged(int)));
 	QWidget::connect(_checkFileContent, SIGNAL(stateChanged(int)), this,
 			 SLOT(OnlyMatchIfChangedChanged(int)));
+	QWidget::connect(_pollInterval,
+			 SIGNAL(DurationChanged(const Duration &)), this,
+			 SLOT(PollIntervalChanged(const Duration &)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{fileType}}", _fileTypes},
@@ -279,6 +329,7 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 		{"{{useRegex}}", _regex},
 		{"{{checkModificationDate}}", _checkModificationDate},
 		{"{{checkFileContent}}", _checkFileContent},
+		{"{{pollInterval}}", _pollInterval},
 	};
 
 	QVBoxLayout *mainLayout = new QVBoxLayout;
@@ -297,9 +348,17 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 	PlaceWidgets(
 		obs_module_text("AdvSceneSwitcher.condition.file.entry.line3"),
 		line3Layout, widgetPlaceholders);
+	auto pollIntervalLayout = new QHBoxLayout;
+	pollIntervalLayout->setContentsMargins(0, 0, 0, 0);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.file.entry.pollInterval"),
+		pollIntervalLayout, widgetPlaceholders);
+	_pollIntervalControls->setLayout(pollIntervalLayout);
 	mainLayout->addLayout(line1Layout);
 	mainLayout->addLayout(line2Layout);
 	mainLayout->addLayout(line3Layout);
+	mainLayout->addWidget(_pollIntervalControls);
 
 	setLayout(mainLayout);
 
@@ -322,6 +381,7 @@ void MacroConditionFileEdit::UpdateEntryData()
 	_regex->SetRegexConfig(_entryData->_regex);
 	_checkModificationDate->setChecked(_entryData->_useTime);
 	_checkFileContent->setChecked(_entryData->_onlyMatchIfChanged);
+	_pollInterval->SetDuration(_entryData->_pollInterval);
 
 	// TODO: Remove in future version
 	if (!_entryData->_useTime) {
@@ -353,6 +413,7 @@ void MacroConditionFileEdit::FileTypeChanged(int index)
 
 	auto lock = LockContext();
 	_entryData->_fileType = type;
+	SetWidgetVisibility();
 }
 
 void MacroConditionFileEdit::ConditionChanged(int index)
@@ -424,16 +485,29 @@ void MacroConditionFileEdit::OnlyMatchIfChangedChanged(int state)
 	_entryData->_onlyMatchIfChanged = state;
 }
 
+void MacroConditionFileEdit::PollIntervalChanged(const Duration &interval)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_pollInterval = interval;
+}
+
 void MacroConditionFileEdit::SetWidgetVisibility()
 {
 	if (!_entryData) {
 		return;
 	}
 
-	_matchText->setVisible(_entryData->GetCondition() ==
-			       MacroConditionFile::Condition::MATCH);
-	_regex->setVisible(_entryData->GetCondition() ==
-			   MacroConditionFile::Condition::MATCH);
+	const bool matchText =
+		_entryData->GetCondition() ==
+			MacroConditionFile::Condition::MATCH ||
+		_entryData->GetCondition() ==
+			MacroConditionFile::Condition::NEW_LINE;
+	_matchText->setVisible(matchText);
+	_regex->setVisible(matchText);
 	_checkModificationDate->setVisible(
 		_entryData->_useTime &&
 		_entryData->GetCondition() ==
@@ -442,6 +516,15 @@ void MacroConditionFileEdit::SetWidgetVisibility()
 		_entryData->_onlyMatchIfChanged &&
 		_entryData->GetCondition() ==
 			MacroConditionFile::Condition::MATCH);
+	_pollIntervalControls->setVisible(
+		_entryData->_fileType == MacroConditionFile::FileType::REMOTE);
+
+	// New lines can only be detected in local files
+	auto model = qobject_cast<QStandardItemModel *>(_conditions->model());
+	auto newLineItem = model->item(
+		static_cast<int>(MacroConditionFile::Condition::NEW_LINE));
+	newLineItem->setEnabled(_entryData->_fileType ==
+				MacroConditionFile::FileType::LOCAL);
 	adjustSize();
 	updateGeometry();
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "duration-control.hpp"
 #include "file-selection.hpp"
+#include "file-watcher.hpp"
+#include "remote-file.hpp"
 #include "variable-text-edit.hpp"
 #include "regex-config.hpp"
 
@@ -35,6 +38,7 @@ public:
 		MATCH,
 		CONTENT_CHANGE,
 		DATE_CHANGE,
+		NEW_LINE,
 	};
 	void SetCondition(Condition condition);
 	Condition GetCondition() const { return _condition; }
@@ -43,22 +47,31 @@ public:
 	StringVariable _text = obs_module_text("AdvSceneSwitcher.enterText");
 	FileType _fileType = FileType::LOCAL;
 	RegexConfig _regex;
+	// Remote files are polled in the background at this interval
+	Duration _pollInterval = Duration(1.0);
 
 	// TODO: Remove in future version
 	bool _useTime = false;
 	bool _onlyMatchIfChanged = false;
 
 private:
-	bool MatchFileContent(QString &filedata);
+	bool MatchFileContent(const std::string &content, uint64_t hash);
+	bool UpdateRemoteFile();
 	bool CheckRemoteFileContent();
 	bool CheckLocalFileContent();
 	bool CheckChangeContent();
 	bool CheckChangeDate();
+	bool CheckNewLines();
 	void SetupTempVars();
 
 	Condition _condition = Condition::MATCH;
 	QDateTime _lastMod;
-	size_t _lastHash = 0;
+	uint64_t _lastHash = 0;
+	WatchedFile _watchedFile{WatchedFile::LineEndings::CONVERT};
+	RemoteFile _remoteFile;
+	FileTail _fileTail;
+	QRegularExpression _lineRegex;
+	bool _remoteNewLineWarned = false;
 	static bool _registered;
 	static const std::string id;
 };
@@ -87,6 +100,7 @@ private slots:
 	void RegexChanged(const RegexConfig &);
 	void CheckModificationDateChanged(int state);
 	void OnlyMatchIfChangedChanged(int state);
+	void PollIntervalChanged(const Duration &);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -98,6 +112,8 @@ protected:
 	RegexConfigWidget *_regex;
 	QCheckBox *_checkModificationDate;
 	QCheckBox *_checkFileContent;
+	DurationSelection *_pollInterval;
+	QWidget *_pollIntervalControls;
 	std::shared_ptr<MacroConditionFile> _entryData;
 
 private:
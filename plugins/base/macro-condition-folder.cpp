@@ -3,8 +3,7 @@
 #include "macro-helpers.hpp"
 #include "layout-helpers.hpp"
 
-#include <QDir>
-#include <QFileInfo>
+#include <algorithm>
 
 namespace advss {
 
@@ -37,28 +36,49 @@ MacroConditionFolder::MacroConditionFolder(Macro *m) : MacroCondition(m, true)
 
 bool MacroConditionFolder::CheckCondition()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	bool ret = _matched;
-	if (_lastWatchedValue != _folder.UnresolvedValue()) {
+	if (!_watch || _watch->GetPath() != std::string(_folder) ||
+	    _watch->IsRecursive() != _recursive) {
 		SetupWatcher();
 	}
 
-	SetTempVarValues();
+	auto changes = _watch->TakeChanges();
+	if (MacroWasPausedSince(GetMacro(), _lastCheck)) {
+		changes = {};
+	}
+	_lastCheck = std::chrono::high_resolution_clock::now();
 
-	_newFiles.clear();
-	_changedFiles.clear();
-	_removedFiles.clear();
-	_newDirs.clear();
-	_removedDirs.clear();
-	_matched = false;
+	if (_enableFilter) {
+		FilterChanges(changes);
+	}
+	SetTempVarValues(changes);
 
-	return ret;
+	switch (_condition) {
+	case Condition::ANY:
+		return changes.overflow || !changes.newFiles.empty() ||
+		       !changes.changedFiles.empty() ||
+		       !changes.removedFiles.empty() ||
+		       !changes.newDirs.empty() || !changes.removedDirs.empty();
+	case Condition::FILE_ADD:
+		return !changes.newFiles.empty();
+	case Condition::FILE_CHANGE:
+		return !changes.changedFiles.empty();
+	case Condition::FILE_REMOVE:
+		return !changes.removedFiles.empty();
+	case Condition::FOLDER_ADD:
+		return !changes.newDirs.empty();
+	case Condition::FOLDER_REMOVE:
+		return !changes.removedDirs.empty();
+	default:
+		break;
+	}
+	return false;
 }
 
 bool MacroConditionFolder::Save(obs_data_t *obj) const
 {
 	MacroCondition::Save(obj);
 	_folder.Save(obj, "file");
+	obs_data_set_bool(obj, "recursive", _recursive);
 	obs_data_set_bool(obj, "enableFilter", _enableFilter);
 	_regex.Save(obj);
 	_filter.Save(obj, "filter");
@@ -70,6 +90,7 @@ bool MacroConditionFolder::Load(obs_data_t *obj)
 {
 	MacroCondition::Load(obj);
 	_folder.Load(obj, "file");
+	_recursive = obs_data_get_bool(obj, "recursive");
 	_enableFilter = obs_data_get_bool(obj, "enableFilter");
 	_regex.Load(obj);
 	_regex.SetEnabled(true); // Already controlled via _enableFilter
@@ -90,147 +111,44 @@ void MacroConditionFolder::SetFolder(const std::string &folder)
 	SetupWatcher();
 }
 
-static QSet<QString> getFilesInDir(const QString &path)
-{
-	QSet<QString> result;
-	for (const auto &file : QDir(path).entryList(QDir::Files)) {
-		result << file;
-	}
-	return result;
-}
-
-static QSet<QString> getDirsInDir(const QString &path)
-{
-	QSet<QString> result;
-	for (const auto &dir : QDir(path).entryList(QDir::AllDirs)) {
-		result << dir;
-	}
-	return result;
-}
-
-static void reduceSetToPatternMatch(QSet<QString> &set,
-				    const RegexConfig &regex,
-				    const std::string &pattern)
-{
-	QSet<QString> copy = set;
-	for (const auto &value : copy) {
-		if (!regex.Matches(value.toStdString(), pattern)) {
-			set.remove(value);
-		}
-	}
-}
-
-void MacroConditionFolder::DirectoryChanged(const QString &path)
+void MacroConditionFolder::SetRecursive(bool recursive)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	if (MacroIsPaused(GetMacro())) {
-		return;
-	}
-
-	auto currentFiles = getFilesInDir(path);
-	auto currentDirs = getDirsInDir(path);
-
-	if (currentFiles.count() > _currentFiles.count()) {
-		_newFiles += currentFiles - _currentFiles;
-	} else {
-		_removedFiles += _currentFiles - currentFiles;
-	}
-
-	if (currentDirs.count() > _currentDirs.count()) {
-		_newDirs += currentDirs - _currentDirs;
-	} else {
-		_removedDirs += _currentDirs - currentDirs;
-	}
-
-	if (_enableFilter) {
-		reduceSetToPatternMatch(_newFiles, _regex, _filter);
-		reduceSetToPatternMatch(_removedFiles, _regex, _filter);
-		reduceSetToPatternMatch(_newDirs, _regex, _filter);
-		reduceSetToPatternMatch(_removedDirs, _regex, _filter);
-	}
-
-	switch (_condition) {
-	case Condition::ANY:
-		_matched = _matched || _newFiles.count() > 0 ||
-			   _removedFiles.count() > 0 || _newDirs.count() > 0 ||
-			   _removedDirs.count() > 0;
-		break;
-	case Condition::FILE_ADD:
-		_matched = _newFiles.count() > 0;
-		break;
-	case Condition::FILE_REMOVE:
-		_matched = _removedFiles.count() > 0;
-		break;
-	case Condition::FOLDER_ADD:
-		_matched = _newDirs.count() > 0;
-		break;
-	case Condition::FOLDER_REMOVE:
-		_matched = _removedDirs.count() > 0;
-		break;
-	default:
-		break;
-	}
-
-	for (const auto &newFile : _newFiles) {
-		_watcher->addPath(path + "/" + newFile);
-	}
-
-	_currentFiles = currentFiles;
-	_currentDirs = currentDirs;
+	_recursive = recursive;
+	SetupWatcher();
 }
 
-void MacroConditionFolder::FileChanged(const QString &path)
+void MacroConditionFolder::SetupWatcher()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	QFileInfo fileInfo(path);
-	if (!fileInfo.exists()) {
-		return;
-	}
-
-	const auto fileName = fileInfo.fileName();
-	if (_enableFilter && !_regex.Matches(fileName.toStdString(), _filter)) {
-		return;
-	}
-
-	_changedFiles << fileName;
-	if (_condition == Condition::FILE_CHANGE ||
-	    _condition == Condition::ANY) {
-		_matched = true;
-	}
+	_watch = FileWatcher::RegisterFolder(_folder, _recursive);
 }
 
-static QStringList getFileWatcherList(const QSet<QString> &files,
-				      const QString &dirName)
+void MacroConditionFolder::FilterChanges(
+	FileWatcher::FolderWatch::Changes &changes) const
 {
-	QStringList list;
-	for (const auto &value : files) {
-		list << (dirName + "/" + value);
-	}
-	return list;
-}
+	auto filter = [this](std::vector<std::string> &paths) {
+		paths.erase(std::remove_if(paths.begin(), paths.end(),
+					   [this](const std::string &path) {
+						   return !_regex.Matches(
+							   path, _filter);
+					   }),
+			    paths.end());
+	};
 
-void MacroConditionFolder::SetupWatcher()
-{
-	_watcher = std::make_unique<QFileSystemWatcher>();
-	const auto path = QString::fromStdString(_folder);
-	_currentFiles = getFilesInDir(path);
-	_currentDirs = getDirsInDir(path);
-	_lastWatchedValue = _folder.UnresolvedValue();
-	connect(_watcher.get(), SIGNAL(directoryChanged(const QString &)), this,
-		SLOT(DirectoryChanged(const QString &)));
-	connect(_watcher.get(), SIGNAL(fileChanged(const QString &)), this,
-		SLOT(FileChanged(const QString &)));
-	_watcher.get()->addPaths(getFileWatcherList(_currentFiles, path));
-	_watcher->addPath(path);
+	filter(changes.newFiles);
+	filter(changes.changedFiles);
+	filter(changes.removedFiles);
+	filter(changes.newDirs);
+	filter(changes.removedDirs);
 }
 
-void MacroConditionFolder::SetTempVarValues()
+void MacroConditionFolder::SetTempVarValues(
+	const FileWatcher::FolderWatch::Changes &changes)
 {
-	auto setVarHelper = [this](const QSet<QString> &set,
+	auto setVarHelper = [this](const std::vector<std::string> &paths,
 				   const std::string &id) {
 		std::string result;
-		for (const auto &value : set) {
-			result += value.toStdString() + "\n";
+		for (const auto &path : paths) {
+			result += path + "\n";
 		}
 		if (result.size() > 0) {
 			result.pop_back();
@@ -238,11 +156,11 @@ void MacroConditionFolder::SetTempVarValues()
 		SetTempVarValue(id, result);
 	};
 
-	setVarHelper(_newFiles, "newFiles");
-	setVarHelper(_changedFiles, "changedFiles");
-	setVarHelper(_removedFiles, "removedFiles");
-	setVarHelper(_newDirs, "newDirs");
-	setVarHelper(_removedDirs, "removedDirs");
+	setVarHelper(changes.newFiles, "newFiles");
+	setVarHelper(changes.changedFiles, "changedFiles");
+	setVarHelper(changes.removedFiles, "removedFiles");
+	setVarHelper(changes.newDirs, "newDirs");
+	setVarHelper(changes.removedDirs, "removedDirs");
 }
 
 void MacroConditionFolder::SetupTempVars()
@@ -276,6 +194,8 @@ MacroConditionFolderEdit::MacroConditionFolderEdit(
 	: QWidget(parent),
 	  _conditions(new QComboBox()),
 	  _folder(new FileSelection(FileSelection::Type::FOLDER)),
+	  _recursive(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.folder.recursive"))),
 	  _enableFilter(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.condition.folder.enableFilter"))),
 	  _filterLayout(new QHBoxLayout()),
@@ -288,6 +208,8 @@ MacroConditionFolderEdit::MacroConditionFolderEdit(
 			 SLOT(ConditionChanged(int)));
 	QWidget::connect(_folder, SIGNAL(PathChanged(const QString &)), this,
 			 SLOT(PathChanged(const QString &)));
+	QWidget::connect(_recursive, SIGNAL(stateChanged(int)), this,
+			 SLOT(RecursiveChanged(int)));
 	QWidget::connect(_enableFilter, SIGNAL(stateChanged(int)), this,
 			 SLOT(EnableFilterChanged(int)));
 	QWidget::connect(_regex,
@@ -316,6 +238,7 @@ MacroConditionFolderEdit::MacroConditionFolderEdit(
 
 	auto layout = new QVBoxLayout();
 	layout->addLayout(entryLayout);
+	layout->addWidget(_recursive);
 	layout->addWidget(_enableFilter);
 	layout->addLayout(_filterLayout);
 	setLayout(layout);
@@ -334,6 +257,7 @@ void MacroConditionFolderEdit::UpdateEntryData()
 	_conditions->setCurrentIndex(_conditions->findData(
 		static_cast<int>(_entryData->_condition)));
 	_folder->SetPath(_entryData->GetFolder());
+	_recursive->setChecked(_entryData->GetRecursive());
 	_enableFilter->setChecked(_entryData->_enableFilter);
 	_regex->SetRegexConfig(_entryData->_regex);
 	_filter->setText(_entryData->_filter);
@@ -364,6 +288,16 @@ void MacroConditionFolderEdit::PathChanged(const QString &text)
 		QString::fromStdString(_entryData->GetShortDesc()));
 }
 
+void MacroConditionFolderEdit::RecursiveChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->SetRecursive(value);
+}
+
 void MacroConditionFolderEdit::RegexChanged(const RegexConfig &regex)
 {
 	if (_loading || !_entryData) {
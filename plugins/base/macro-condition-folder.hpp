@@ -1,16 +1,15 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "file-selection.hpp"
+#include "file-watcher.hpp"
 #include "regex-config.hpp"
 #include "variable-line-edit.hpp"
 
-#include <QFileSystemWatcher>
+#include <chrono>
 
 namespace advss {
 
-class MacroConditionFolder : public QObject, public MacroCondition {
-	Q_OBJECT
-
+class MacroConditionFolder : public MacroCondition {
 public:
 	MacroConditionFolder(Macro *m);
 	bool CheckCondition();
@@ -24,6 +23,8 @@ public:
 	}
 	void SetFolder(const std::string &);
 	StringVariable GetFolder() const { return _folder; }
+	void SetRecursive(bool);
+	bool GetRecursive() const { return _recursive; }
 
 	enum class Condition {
 		ANY,
@@ -39,29 +40,17 @@ public:
 	RegexConfig _regex = RegexConfig(true);
 	StringVariable _filter = ".*";
 
-private slots:
-	void DirectoryChanged(const QString &);
-	void FileChanged(const QString &);
-
 private:
 	void SetupWatcher();
-	void SetTempVarValues();
+	void FilterChanges(FileWatcher::FolderWatch::Changes &) const;
+	void SetTempVarValues(const FileWatcher::FolderWatch::Changes &);
 	void SetupTempVars();
 
 	StringVariable _folder = obs_module_text("AdvSceneSwitcher.enterPath");
+	bool _recursive = false;
 
-	std::unique_ptr<QFileSystemWatcher> _watcher;
-	std::string _lastWatchedValue = "";
-
-	std::mutex _mutex;
-	bool _matched = false;
-	QSet<QString> _newFiles;
-	QSet<QString> _changedFiles;
-	QSet<QString> _removedFiles;
-	QSet<QString> _newDirs;
-	QSet<QString> _removedDirs;
-	QSet<QString> _currentFiles;
-	QSet<QString> _currentDirs;
+	std::shared_ptr<FileWatcher::FolderWatch> _watch;
+	std::chrono::high_resolution_clock::time_point _lastCheck{};
 
 	static bool _registered;
 	static const std::string id;
@@ -86,6 +75,7 @@ public:
 private slots:
 	void ConditionChanged(int index);
 	void PathChanged(const QString &text);
+	void RecursiveChanged(int value);
 	void EnableFilterChanged(int value);
 	void RegexChanged(const RegexConfig &);
 	void FilterChanged();
@@ -97,6 +87,7 @@ private:
 
 	QComboBox *_conditions;
 	FileSelection *_folder;
+	QCheckBox *_recursive;
 	QCheckBox *_enableFilter;
 	QHBoxLayout *_filterLayout;
 	RegexConfigWidget *_regex;
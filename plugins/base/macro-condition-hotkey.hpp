@@ -23,6 +23,9 @@ public:
 	bool _checkPressed = true;
 
 private:
+	// The key binding is owned by OBS and can be changed in its settings
+	bool CanReuseSavedSettings() const { return false; }
+
 	std::chrono::high_resolution_clock::time_point _lastCheck{};
 
 	static bool _registered;
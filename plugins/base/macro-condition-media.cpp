@@ -98,10 +98,12 @@ bool MacroConditionMedia::CheckState()
 
 	switch (_state) {
 	case State::OBS_MEDIA_STATE_STOPPED:
-		match = _stopped || currentState == OBS_MEDIA_STATE_STOPPED;
+		match = EventOccurred(MediaStateTracker::Event::STOPPED) ||
+			currentState == OBS_MEDIA_STATE_STOPPED;
 		break;
 	case State::OBS_MEDIA_STATE_ENDED:
-		match = _ended || currentState == OBS_MEDIA_STATE_ENDED;
+		match = EventOccurred(MediaStateTracker::Event::ENDED) ||
+			currentState == OBS_MEDIA_STATE_ENDED;
 		break;
 	case State::PLAYLIST_ENDED:
 		match = CheckPlaylistEnd(currentState);
@@ -127,22 +129,40 @@ bool MacroConditionMedia::CheckState()
 bool MacroConditionMedia::CheckPlaylistEnd(const obs_media_state currentState)
 {
 	bool consecutiveEndedStates = false;
-	if (_next || currentState != OBS_MEDIA_STATE_ENDED) {
+	if (EventOccurred(MediaStateTracker::Event::NEXT) ||
+	    currentState != OBS_MEDIA_STATE_ENDED) {
 		_previousStateEnded = false;
 	}
 	if (currentState == OBS_MEDIA_STATE_ENDED && _previousStateEnded) {
 		consecutiveEndedStates = true;
 	}
-	_previousStateEnded = _ended || currentState == OBS_MEDIA_STATE_ENDED;
+	_previousStateEnded = EventOccurred(MediaStateTracker::Event::ENDED) ||
+			      currentState == OBS_MEDIA_STATE_ENDED;
 	return consecutiveEndedStates;
 }
 
+bool MacroConditionMedia::EventOccurred(MediaStateTracker::Event event) const
+{
+	// Ignore events which happened while the macro was paused
+	return _tracker && _tracker->OccurredSince(event, _lastCheck) &&
+	       !MacroWasPausedSince(GetMacro(), _lastCheck);
+}
+
 bool MacroConditionMedia::CheckMediaMatch()
 {
-	if (!_source.GetSource()) {
+	const auto source = _source.GetSource();
+	if (!source) {
 		return false;
 	}
 
+	if (!_tracker || _tracker->GetSource() != source) {
+		_tracker = MediaStateTracker::Get(source);
+		_lastCheck = std::chrono::high_resolution_clock::now();
+	}
+
+	// Events occurring while the conditions are checked are picked up by
+	// the next check
+	const auto checkTime = std::chrono::high_resolution_clock::now();
 	bool matched = false;
 	switch (_checkType) {
 	case CheckType::STATE:
@@ -158,10 +178,7 @@ bool MacroConditionMedia::CheckMediaMatch()
 		break;
 	}
 
-	// reset for next check
-	_stopped = false;
-	_ended = false;
-	_next = false;
+	_lastCheck = checkTime;
 
 	return matched;
 }
@@ -185,7 +202,6 @@ MacroConditionMedia::MacroConditionMedia(const MacroConditionMedia &other)
 	  _time(other._time),
 	  _lastConfigureScene(other._lastConfigureScene)
 {
-	ResetSignalHandler();
 }
 
 MacroConditionMedia &
@@ -200,9 +216,6 @@ MacroConditionMedia::operator=(const MacroConditionMedia &other)
 	_rawSource = other._rawSource;
 	_time = other._time;
 	_lastConfigureScene = other._lastConfigureScene;
-
-	ResetSignalHandler();
-
 	return *this;
 }
 
@@ -304,10 +317,6 @@ bool MacroConditionMedia::Load(obs_data_t *obj)
 		static_cast<Time>(obs_data_get_int(obj, "restriction"));
 	_time.Load(obj);
 
-	if (_sourceType == SourceType::SOURCE) {
-		ResetSignalHandler();
-	}
-
 	UpdateMediaSourcesOfSceneList();
 	if (!obs_data_has_user_value(obj, "version")) {
 		if (_state == State::OBS_MEDIA_STATE_ENDED) {
@@ -357,47 +366,6 @@ bool MacroConditionMedia::IsUsingLegacyCheck() const
 	       _timeRestriction != Time::TIME_RESTRICTION_NONE;
 }
 
-void MacroConditionMedia::ResetSignalHandler()
-{
-	_signals.clear();
-	OBSSourceAutoRelease mediasource =
-		obs_weak_source_get_source(_source.GetSource());
-	signal_handler_t *sh = obs_source_get_signal_handler(mediasource);
-	_signals.emplace_back(sh, "media_stopped", MediaStopped, this);
-	_signals.emplace_back(sh, "media_ended", MediaEnded, this);
-	_signals.emplace_back(sh, "media_next", MediaNext, this);
-}
-
-void MacroConditionMedia::MediaStopped(void *data, calldata_t *)
-{
-	MacroConditionMedia *media = static_cast<MacroConditionMedia *>(data);
-	const auto macro = media->GetMacro();
-	if (MacroIsPaused(macro)) {
-		return;
-	}
-	media->_stopped = true;
-}
-
-void MacroConditionMedia::MediaEnded(void *data, calldata_t *)
-{
-	MacroConditionMedia *media = static_cast<MacroConditionMedia *>(data);
-	const auto macro = media->GetMacro();
-	if (MacroIsPaused(macro)) {
-		return;
-	}
-	media->_ended = true;
-}
-
-void MacroConditionMedia::MediaNext(void *data, calldata_t *)
-{
-	MacroConditionMedia *media = static_cast<MacroConditionMedia *>(data);
-	const auto macro = media->GetMacro();
-	if (MacroIsPaused(macro)) {
-		return;
-	}
-	media->_next = true;
-}
-
 static void populateSateSelection(QComboBox *list, bool addLegacyEntries)
 {
 	for (const auto &[value, name] : mediaStates) {
@@ -526,7 +494,6 @@ void MacroConditionMediaEdit::SourceTypeChanged(int idx)
 		_entryData->_sourceGroup.clear();
 	}
 
-	_entryData->ResetSignalHandler();
 	emit HeaderInfoChanged(
 		QString::fromStdString(_entryData->GetShortDesc()));
 
@@ -547,7 +514,6 @@ void MacroConditionMediaEdit::SourceChanged(const SourceSelection &source)
 	_entryData->_sourceGroup.clear();
 	_entryData->_sourceType = MacroConditionMedia::SourceType::SOURCE;
 	_entryData->_source = source;
-	_entryData->ResetSignalHandler();
 	emit HeaderInfoChanged(
 		QString::fromStdString(_entryData->GetShortDesc()));
 	SetWidgetVisibility();
@@ -3,6 +3,7 @@
 #include "duration-control.hpp"
 #include "scene-selection.hpp"
 #include "source-selection.hpp"
+#include "media-state-tracker.hpp"
 
 #include <limits>
 #include <obs.hpp>
@@ -26,11 +27,7 @@ public:
 	{
 		return std::make_shared<MacroConditionMedia>(m);
 	}
-	void ResetSignalHandler();
 	void UpdateMediaSourcesOfSceneList();
-	static void MediaStopped(void *data, calldata_t *);
-	static void MediaEnded(void *data, calldata_t *);
-	static void MediaNext(void *data, calldata_t *);
 
 	enum class SourceType { SOURCE, ANY, ALL };
 	SourceType _sourceType = SourceType::SOURCE;
@@ -78,12 +75,11 @@ private:
 	bool CheckPlaylistEnd(const obs_media_state);
 	bool CheckMediaMatch();
 	void HandleSceneChange();
+	bool EventOccurred(MediaStateTracker::Event) const;
 
-	std::vector<OBSSignal> _signals;
-
-	bool _stopped = false;
-	bool _ended = false;
-	bool _next = false;
+	std::shared_ptr<MediaStateTracker> _tracker;
+	std::chrono::high_resolution_clock::time_point _lastCheck =
+		std::chrono::high_resolution_clock::now();
 
 	// Workaround to enable use of "ended" to specify end of VLC playlist
 	bool _previousStateEnded = false;
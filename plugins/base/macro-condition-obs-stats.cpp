@@ -54,288 +54,75 @@ const static std::map<MacroConditionStats::Condition, std::string>
 		 "AdvSceneSwitcher.condition.stats.condition.below"},
 };
 
-MacroConditionStats::MacroConditionStats(Macro *m)
-	: MacroCondition(m),
-	  _cpu_info(os_cpu_usage_info_start())
-{
-}
-
-MacroConditionStats::~MacroConditionStats()
-{
-	os_cpu_usage_info_destroy(_cpu_info);
-}
-
-bool MacroConditionStats::CheckFPS() const
-{
-	switch (_condition) {
-	case Condition::ABOVE:
-		return obs_get_active_fps() > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(obs_get_active_fps(), _value, 0.01);
-	case Condition::BELOW:
-		return obs_get_active_fps() < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckCPU() const
-{
-	double usage = os_cpu_usage_info_query(_cpu_info);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return usage > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(usage, _value, 0.1);
-	case Condition::BELOW:
-		return usage < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckMemory() const
-{
-	auto rss =
-		(long double)os_get_proc_resident_size() / (1024.0l * 1024.0l);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return rss > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(rss, _value, 0.1);
-	case Condition::BELOW:
-		return rss < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckAvgFrametime() const
-{
-	auto num = (long double)obs_get_average_frame_time_ns() / 1000000.0l;
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckRenderLag()
-{
-	uint32_t total_rendered = obs_get_total_frames();
-	uint32_t total_lagged = obs_get_lagged_frames();
-
-	if (total_rendered < _first_rendered || total_lagged < _first_lagged) {
-		_first_rendered = total_rendered;
-		_first_lagged = total_lagged;
-	}
-	total_rendered -= _first_rendered;
-	total_lagged -= _first_lagged;
-
-	auto num = total_rendered ? (long double)total_lagged /
-					    (long double)total_rendered
-				  : 0.0l;
-	num *= 100.0l;
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckEncodeLag()
-{
-	video_t *video = obs_get_video();
-	uint32_t total_encoded = video_output_get_total_frames(video);
-	uint32_t total_skipped = video_output_get_skipped_frames(video);
-
-	if (total_encoded < _first_encoded || total_skipped < _first_encoded) {
-		_first_encoded = total_encoded;
-		_first_skipped = total_skipped;
-	}
-	total_encoded -= _first_encoded;
-	total_skipped -= _first_skipped;
-
-	auto num = total_encoded ? (long double)total_skipped /
-					   (long double)total_encoded
-				 : 0.0l;
-	num *= 100.0l;
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-void MacroConditionStats::OutputInfo::Update(obs_output_t *output)
-{
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	uint64_t curTime = os_gettime_ns();
-	uint64_t bytesSent = totalBytes;
-
-	if (bytesSent < lastBytesSent)
-		bytesSent = 0;
-	if (bytesSent == 0)
-		lastBytesSent = 0;
-
-	uint64_t bitsBetween = (bytesSent - lastBytesSent) * 8;
-	long double timePassed =
-		(long double)(curTime - lastBytesSentTime) / 1000000000.0l;
-	kbps = (long double)bitsBetween / timePassed / 1000.0l;
-
-	if (timePassed < 0.01l)
-		kbps = 0.0l;
-
-	int total = output ? obs_output_get_total_frames(output) : 0;
-	int dropped = output ? obs_output_get_frames_dropped(output) : 0;
-
-	if (total < first_total || dropped < first_dropped) {
-		first_total = 0;
-		first_dropped = 0;
-	}
-
-	total -= first_total;
-	dropped -= first_dropped;
-
-	dropped_relative =
-		total ? (long double)dropped / (long double)total * 100.0l
-		      : 0.0l;
-
-	lastBytesSent = bytesSent;
-	lastBytesSentTime = curTime;
-}
-
-bool MacroConditionStats::CheckStreamDroppedFrames()
-{
-	OBSOutputAutoRelease output = obs_frontend_get_streaming_output();
-	_streamInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _streamInfo.dropped_relative > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_streamInfo.dropped_relative, _value, 0.1);
-	case Condition::BELOW:
-		return _streamInfo.dropped_relative < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckStreamBitrate()
-{
-	OBSOutputAutoRelease output = obs_frontend_get_streaming_output();
-	_streamInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _streamInfo.kbps > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_streamInfo.kbps, _value, 1.0);
-	case Condition::BELOW:
-		return _streamInfo.kbps < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckStreamMBSent() const
-{
-	OBSOutputAutoRelease output = obs_frontend_get_streaming_output();
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	long double num = (long double)totalBytes / (1024.0l * 1024.0l);
+const static std::map<MacroConditionStats::Aggregation, std::string>
+	aggregationTypes = {
+		{MacroConditionStats::Aggregation::LATEST,
+		 "AdvSceneSwitcher.condition.stats.aggregation.latest"},
+		{MacroConditionStats::Aggregation::AVERAGE,
+		 "AdvSceneSwitcher.condition.stats.aggregation.average"},
+		{MacroConditionStats::Aggregation::MINIMUM,
+		 "AdvSceneSwitcher.condition.stats.aggregation.minimum"},
+		{MacroConditionStats::Aggregation::MAXIMUM,
+		 "AdvSceneSwitcher.condition.stats.aggregation.maximum"},
+		{MacroConditionStats::Aggregation::PERCENTILE,
+		 "AdvSceneSwitcher.condition.stats.aggregation.percentile"},
+};
 
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
+const static std::map<MacroConditionStats::Type, OBSStatsSampler::Stat>
+	sampledStats = {
+		{MacroConditionStats::Type::FPS, OBSStatsSampler::Stat::FPS},
+		{MacroConditionStats::Type::CPU_USAGE,
+		 OBSStatsSampler::Stat::CPU_USAGE},
+		{MacroConditionStats::Type::MEM_USAGE,
+		 OBSStatsSampler::Stat::MEM_USAGE},
+		{MacroConditionStats::Type::AVG_FRAMETIME,
+		 OBSStatsSampler::Stat::AVG_FRAMETIME},
+		{MacroConditionStats::Type::RENDER_LAG,
+		 OBSStatsSampler::Stat::RENDER_LAG},
+		{MacroConditionStats::Type::ENCODE_LAG,
+		 OBSStatsSampler::Stat::ENCODE_LAG},
+		{MacroConditionStats::Type::STREAM_DROPPED_FRAMES,
+		 OBSStatsSampler::Stat::STREAM_DROPPED_FRAMES},
+		{MacroConditionStats::Type::STREAM_BITRATE,
+		 OBSStatsSampler::Stat::STREAM_BITRATE},
+		{MacroConditionStats::Type::STREAM_MB_SENT,
+		 OBSStatsSampler::Stat::STREAM_MB_SENT},
+		{MacroConditionStats::Type::RECORDING_DROPPED_FRAMES,
+		 OBSStatsSampler::Stat::RECORDING_DROPPED_FRAMES},
+		{MacroConditionStats::Type::RECORDING_BITRATE,
+		 OBSStatsSampler::Stat::RECORDING_BITRATE},
+		{MacroConditionStats::Type::RECORDING_MB_SENT,
+		 OBSStatsSampler::Stat::RECORDING_MB_SENT},
+};
 
-bool MacroConditionStats::CheckRecordingDroppedFrames()
+MacroConditionStats::MacroConditionStats(Macro *m)
+	: MacroCondition(m),
+	  _sampler(OBSStatsSampler::Get())
 {
-	OBSOutputAutoRelease output = obs_frontend_get_recording_output();
-	_recordingInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _recordingInfo.dropped_relative > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_recordingInfo.dropped_relative, _value,
-				    0.1);
-	case Condition::BELOW:
-		return _recordingInfo.dropped_relative < _value;
-	default:
-		break;
-	}
-	return false;
 }
 
-bool MacroConditionStats::CheckRecordingBitrate()
+bool MacroConditionStats::CheckSampledValue(double tolerance)
 {
-	OBSOutputAutoRelease output = obs_frontend_get_recording_output();
-	_recordingInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _recordingInfo.kbps > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_recordingInfo.kbps, _value, 1.0);
-	case Condition::BELOW:
-		return _recordingInfo.kbps < _value;
-	default:
-		break;
+	auto it = sampledStats.find(_type);
+	if (it == sampledStats.end()) {
+		return false;
 	}
-	return false;
-}
 
-bool MacroConditionStats::CheckRecordingMBSent() const
-{
-	OBSOutputAutoRelease output = obs_frontend_get_recording_output();
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	long double num = (long double)totalBytes / (1024.0l * 1024.0l);
+	_window.ResolveVariables();
+	_percentile.ResolveVariables();
+	const double value = _sampler->GetValue(
+		it->second, _aggregation,
+		std::chrono::milliseconds(
+			static_cast<int64_t>(_window.Milliseconds())),
+		_percentile);
 
 	switch (_condition) {
 	case Condition::ABOVE:
-		return num > _value;
+		return value > _value;
 	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
+		return DoubleEquals(value, _value, tolerance);
 	case Condition::BELOW:
-		return num < _value;
+		return value < _value;
 	default:
 		break;
 	}
@@ -393,36 +180,17 @@ bool MacroConditionStats::CheckCondition()
 {
 	switch (_type) {
 	case Type::FPS:
-		return CheckFPS();
-	case Type::CPU_USAGE:
-		return CheckCPU();
+		return CheckSampledValue(0.01);
 	case Type::DISK_USAGE:
 		return CheckDiskUsage();
-	case Type::MEM_USAGE:
-		return CheckMemory();
-	case Type::AVG_FRAMETIME:
-		return CheckAvgFrametime();
-	case Type::RENDER_LAG:
-		return CheckRenderLag();
-	case Type::ENCODE_LAG:
-		return CheckEncodeLag();
-	case Type::STREAM_DROPPED_FRAMES:
-		return CheckStreamDroppedFrames();
 	case Type::STREAM_BITRATE:
-		return CheckStreamBitrate();
-	case Type::STREAM_MB_SENT:
-		return CheckStreamMBSent();
-	case Type::RECORDING_DROPPED_FRAMES:
-		return CheckRecordingDroppedFrames();
 	case Type::RECORDING_BITRATE:
-		return CheckRecordingBitrate();
-	case Type::RECORDING_MB_SENT:
-		return CheckRecordingMBSent();
+		return CheckSampledValue(1.0);
 	default:
 		break;
 	}
 
-	return false;
+	return CheckSampledValue(0.1);
 }
 
 bool MacroConditionStats::Save(obs_data_t *obj) const
@@ -431,6 +199,9 @@ bool MacroConditionStats::Save(obs_data_t *obj) const
 	_value.Save(obj, "value");
 	obs_data_set_int(obj, "type", static_cast<int>(_type));
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
+	obs_data_set_int(obj, "aggregation", static_cast<int>(_aggregation));
+	_percentile.Save(obj, "percentile");
+	_window.Save(obj, "window");
 	obs_data_set_int(obj, "version", 1);
 	return true;
 }
@@ -447,6 +218,14 @@ bool MacroConditionStats::Load(obs_data_t *obj)
 	_type = static_cast<MacroConditionStats::Type>(
 		obs_data_get_int(obj, "type"));
 	_condition = static_cast<Condition>(obs_data_get_int(obj, "condition"));
+	_aggregation = static_cast<Aggregation>(
+		obs_data_get_int(obj, "aggregation"));
+	if (obs_data_has_user_value(obj, "percentile")) {
+		_percentile.Load(obj, "percentile");
+	}
+	if (obs_data_has_user_value(obj, "window")) {
+		_window.Load(obj, "window");
+	}
 	return true;
 }
 
@@ -474,12 +253,20 @@ MacroConditionStatsEdit::MacroConditionStatsEdit(
 	: QWidget(parent),
 	  _stats(new QComboBox()),
 	  _condition(new QComboBox()),
-	  _value(new VariableDoubleSpinBox())
+	  _value(new VariableDoubleSpinBox()),
+	  _aggregation(new QComboBox()),
+	  _percentile(new VariableDoubleSpinBox()),
+	  _window(new DurationSelection(this, true, 0.5)),
+	  _aggregationLayout(new QHBoxLayout())
 {
 	_value->setMaximum(999999999999);
+	_percentile->setMinimum(0.0);
+	_percentile->setMaximum(100.0);
+	_percentile->setSuffix("%");
 
 	populateList(_stats, statsTypes);
 	populateList(_condition, statsConditionTypes);
+	populateList(_aggregation, aggregationTypes);
 
 	setToolTip(
 		obs_module_text("AdvSceneSwitcher.condition.stats.dockHint"));
@@ -492,13 +279,32 @@ MacroConditionStatsEdit::MacroConditionStatsEdit(
 			 SLOT(StatsTypeChanged(int)));
 	QWidget::connect(_condition, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(ConditionChanged(int)));
+	QWidget::connect(_aggregation, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(AggregationChanged(int)));
+	QWidget::connect(
+		_percentile,
+		SIGNAL(NumberVariableChanged(const NumberVariable<double> &)),
+		this, SLOT(PercentileChanged(const NumberVariable<double> &)));
+	QWidget::connect(_window, SIGNAL(DurationChanged(const Duration &)),
+			 this, SLOT(WindowChanged(const Duration &)));
 
-	auto layout = new QHBoxLayout;
+	auto entryLayout = new QHBoxLayout;
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.stats.entry"),
-		     layout,
+		     entryLayout,
 		     {{"{{value}}", _value},
 		      {"{{stats}}", _stats},
 		      {"{{condition}}", _condition}});
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.stats.entry.aggregation"),
+		_aggregationLayout,
+		{{"{{aggregation}}", _aggregation},
+		 {"{{percentile}}", _percentile},
+		 {"{{window}}", _window}});
+
+	auto layout = new QVBoxLayout;
+	layout->addLayout(entryLayout);
+	layout->addLayout(_aggregationLayout);
 	setLayout(layout);
 
 	_entryData = entryData;
@@ -532,6 +338,29 @@ void MacroConditionStatsEdit::ConditionChanged(int cond)
 		static_cast<MacroConditionStats::Condition>(cond);
 }
 
+void MacroConditionStatsEdit::AggregationChanged(int value)
+{
+	{
+		GUARD_LOADING_AND_LOCK();
+		_entryData->_aggregation =
+			static_cast<MacroConditionStats::Aggregation>(value);
+	}
+	SetWidgetVisibility();
+}
+
+void MacroConditionStatsEdit::PercentileChanged(
+	const NumberVariable<double> &value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_percentile = value;
+}
+
+void MacroConditionStatsEdit::WindowChanged(const Duration &window)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_window = window;
+}
+
 void MacroConditionStatsEdit::UpdateEntryData()
 {
 	if (!_entryData) {
@@ -541,6 +370,10 @@ void MacroConditionStatsEdit::UpdateEntryData()
 	_value->SetValue(_entryData->_value);
 	_stats->setCurrentIndex(static_cast<int>(_entryData->_type));
 	_condition->setCurrentIndex(static_cast<int>(_entryData->_condition));
+	_aggregation->setCurrentIndex(
+		static_cast<int>(_entryData->_aggregation));
+	_percentile->SetValue(_entryData->_percentile);
+	_window->SetDuration(_entryData->_window);
 	SetWidgetVisibility();
 }
 
@@ -607,6 +440,17 @@ void MacroConditionStatsEdit::SetWidgetVisibility()
 		break;
 	}
 
+	using Aggregation = MacroConditionStats::Aggregation;
+	const auto aggregation = _entryData->_aggregation;
+	const bool isSampled = _entryData->_type !=
+			       MacroConditionStats::Type::DISK_USAGE;
+	const bool usesWindow = aggregation != Aggregation::LATEST &&
+				aggregation != Aggregation::AVERAGE;
+	SetLayoutVisible(_aggregationLayout, isSampled);
+	_percentile->setVisible(isSampled &&
+				aggregation == Aggregation::PERCENTILE);
+	_window->setVisible(isSampled && usesWindow);
+
 	adjustSize();
 }
 
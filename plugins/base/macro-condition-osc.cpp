@@ -0,0 +1,311 @@
+#include "macro-condition-osc.hpp"
+#include "macro-helpers.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <QGroupBox>
+
+namespace advss {
+
+const std::string MacroConditionOSC::id = "osc";
+
+bool MacroConditionOSC::_registered = MacroConditionFactory::Register(
+	MacroConditionOSC::id,
+	{MacroConditionOSC::Create, MacroConditionOSCEdit::Create,
+	 "AdvSceneSwitcher.condition.osc"});
+
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	AddPluginCleanupStep([]() { OSCReceiver::Stop(); });
+	return true;
+}
+
+MacroConditionOSC::MacroConditionOSC(Macro *m) : MacroCondition(m, true) {}
+
+void MacroConditionOSC::UpdateMessageBuffer()
+{
+	const int port = _port;
+	const std::string address = _address;
+	const auto key = std::to_string(static_cast<int>(_protocol)) + ":" +
+			 std::to_string(port) + ":" + address;
+	if (_messageBuffer && key == _messageBufferKey) {
+		return;
+	}
+
+	_messageBuffer.reset();
+	_messageBuffer = OSCReceiver::Register(_protocol, port, address);
+	_messageBufferKey = key;
+	CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
+}
+
+bool MacroConditionOSC::CheckCondition()
+{
+	UpdateMessageBuffer();
+
+	const bool macroWasPausedSinceLastCheck =
+		MacroWasPausedSince(GetMacro(), _lastCheck);
+	_lastCheck = std::chrono::high_resolution_clock::now();
+	if (macroWasPausedSinceLastCheck) {
+		_messageBuffer->Clear();
+		return false;
+	}
+
+	while (const auto message = _messageBuffer->ConsumeMessage()) {
+		const auto &view = message->GetView();
+		const auto arguments = view.GetArgumentsString();
+		if (_checkArguments) {
+			const bool matches =
+				_regex.Enabled()
+					? _regex.Matches(arguments, _arguments)
+					: arguments == std::string(_arguments);
+			if (!matches) {
+				continue;
+			}
+		}
+
+		SetTempVarValue("address", std::string(view.GetAddress()));
+		SetTempVarValue("arguments", arguments);
+		SetVariableValue(arguments);
+		if (_clearBufferOnMatch) {
+			_messageBuffer->Clear();
+		}
+		return true;
+	}
+	SetVariableValue("");
+	return false;
+}
+
+bool MacroConditionOSC::Save(obs_data_t *obj) const
+{
+	MacroCondition::Save(obj);
+	obs_data_set_int(obj, "protocol", static_cast<int>(_protocol));
+	_port.Save(obj, "port");
+	_address.Save(obj, "address");
+	obs_data_set_bool(obj, "checkArguments", _checkArguments);
+	_arguments.Save(obj, "arguments");
+	_regex.Save(obj);
+	obs_data_set_bool(obj, "clearBufferOnMatch", _clearBufferOnMatch);
+	return true;
+}
+
+bool MacroConditionOSC::Load(obs_data_t *obj)
+{
+	MacroCondition::Load(obj);
+	_protocol = static_cast<Protocol>(obs_data_get_int(obj, "protocol"));
+	_port.Load(obj, "port");
+	_address.Load(obj, "address");
+	_checkArguments = obs_data_get_bool(obj, "checkArguments");
+	_arguments.Load(obj, "arguments");
+	_regex.Load(obj);
+	_clearBufferOnMatch = obs_data_get_bool(obj, "clearBufferOnMatch");
+	UpdateMessageBuffer();
+	return true;
+}
+
+std::string MacroConditionOSC::GetShortDesc() const
+{
+	return std::string(_protocol == Protocol::UDP ? "UDP " : "TCP ") +
+	       std::to_string(_port.GetValue()) + " " +
+	       std::string(_address);
+}
+
+void MacroConditionOSC::SetProtocol(Protocol protocol)
+{
+	_protocol = protocol;
+	UpdateMessageBuffer();
+}
+
+void MacroConditionOSC::SetPortNr(const IntVariable &port)
+{
+	_port = port;
+	UpdateMessageBuffer();
+}
+
+void MacroConditionOSC::SetAddress(const std::string &address)
+{
+	_address = address;
+	UpdateMessageBuffer();
+}
+
+void MacroConditionOSC::SetupTempVars()
+{
+	MacroCondition::SetupTempVars();
+	AddTempvar("address",
+		   obs_module_text("AdvSceneSwitcher.tempVar.osc.address"),
+		   obs_module_text(
+			   "AdvSceneSwitcher.tempVar.osc.address.description"));
+	AddTempvar(
+		"arguments",
+		obs_module_text("AdvSceneSwitcher.tempVar.osc.arguments"),
+		obs_module_text(
+			"AdvSceneSwitcher.tempVar.osc.arguments.description"));
+}
+
+static void populateProtocolSelection(QComboBox *list)
+{
+	list->addItem("TCP");
+	list->addItem("UDP");
+}
+
+MacroConditionOSCEdit::MacroConditionOSCEdit(
+	QWidget *parent, std::shared_ptr<MacroConditionOSC> entryData)
+	: QWidget(parent),
+	  _protocol(new QComboBox(this)),
+	  _port(new VariableSpinBox(this)),
+	  _address(new VariableLineEdit(this)),
+	  _checkArguments(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.osc.checkArguments"))),
+	  _arguments(new VariableLineEdit(this)),
+	  _regex(new RegexConfigWidget(this)),
+	  _clearBufferOnMatch(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.clearBufferOnMatch")))
+{
+	populateProtocolSelection(_protocol);
+	_port->setMaximum(65535);
+	_address->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.osc.address.tooltip"));
+
+	auto networkGroup =
+		new QGroupBox(obs_module_text("AdvSceneSwitcher.osc.network"));
+	auto networkLayout = new QGridLayout;
+	int row = 0;
+	networkLayout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.osc.network.protocol")),
+		row, 0);
+	networkLayout->addWidget(_protocol, row, 1);
+	++row;
+	networkLayout->addWidget(new QLabel(obs_module_text(
+					 "AdvSceneSwitcher.osc.network.port")),
+				 row, 0);
+	networkLayout->addWidget(_port, row, 1);
+	networkGroup->setLayout(networkLayout);
+
+	auto messageGroup =
+		new QGroupBox(obs_module_text("AdvSceneSwitcher.osc.message"));
+	auto messageLayout = new QGridLayout;
+	row = 0;
+	messageLayout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.condition.osc.address")),
+		row, 0);
+	messageLayout->addWidget(_address, row, 1);
+	++row;
+	messageLayout->addWidget(_checkArguments, row, 0);
+	auto argumentsLayout = new QHBoxLayout;
+	argumentsLayout->setContentsMargins(0, 0, 0, 0);
+	argumentsLayout->addWidget(_arguments);
+	argumentsLayout->addWidget(_regex);
+	messageLayout->addLayout(argumentsLayout, row, 1);
+	messageGroup->setLayout(messageLayout);
+
+	auto mainLayout = new QVBoxLayout;
+	mainLayout->addWidget(networkGroup);
+	mainLayout->addWidget(messageGroup);
+	mainLayout->addWidget(_clearBufferOnMatch);
+	setLayout(mainLayout);
+
+	QWidget::connect(_protocol, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(ProtocolChanged(int)));
+	QWidget::connect(
+		_port,
+		SIGNAL(NumberVariableChanged(const NumberVariable<int> &)),
+		this, SLOT(PortChanged(const NumberVariable<int> &)));
+	QWidget::connect(_address, SIGNAL(editingFinished()), this,
+			 SLOT(AddressChanged()));
+	QWidget::connect(_checkArguments, SIGNAL(stateChanged(int)), this,
+			 SLOT(CheckArgumentsChanged(int)));
+	QWidget::connect(_arguments, SIGNAL(editingFinished()), this,
+			 SLOT(ArgumentsChanged()));
+	QWidget::connect(_regex,
+			 SIGNAL(RegexConfigChanged(const RegexConfig &)), this,
+			 SLOT(RegexChanged(const RegexConfig &)));
+	QWidget::connect(_clearBufferOnMatch, SIGNAL(stateChanged(int)), this,
+			 SLOT(ClearBufferOnMatchChanged(int)));
+
+	_entryData = entryData;
+	UpdateEntryData();
+	_loading = false;
+}
+
+void MacroConditionOSCEdit::UpdateEntryData()
+{
+	if (!_entryData) {
+		return;
+	}
+
+	_protocol->setCurrentIndex(static_cast<int>(_entryData->GetProtocol()));
+	_port->SetValue(_entryData->GetPortNr());
+	_address->setText(_entryData->GetAddress());
+	_checkArguments->setChecked(_entryData->_checkArguments);
+	_arguments->setText(_entryData->_arguments);
+	_regex->SetRegexConfig(_entryData->_regex);
+	_clearBufferOnMatch->setChecked(_entryData->_clearBufferOnMatch);
+	SetWidgetVisibility();
+}
+
+void MacroConditionOSCEdit::SetWidgetVisibility()
+{
+	_arguments->setEnabled(_entryData->_checkArguments);
+	_regex->setEnabled(_entryData->_checkArguments);
+
+	adjustSize();
+	updateGeometry();
+}
+
+void MacroConditionOSCEdit::ProtocolChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetProtocol(
+		static_cast<MacroConditionOSC::Protocol>(value));
+	emit HeaderInfoChanged(
+		QString::fromStdString(_entryData->GetShortDesc()));
+}
+
+void MacroConditionOSCEdit::PortChanged(const NumberVariable<int> &value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetPortNr(value);
+	emit HeaderInfoChanged(
+		QString::fromStdString(_entryData->GetShortDesc()));
+}
+
+void MacroConditionOSCEdit::AddressChanged()
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->SetAddress(_address->text().toStdString());
+	emit HeaderInfoChanged(
+		QString::fromStdString(_entryData->GetShortDesc()));
+}
+
+void MacroConditionOSCEdit::CheckArgumentsChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_checkArguments = value;
+	SetWidgetVisibility();
+}
+
+void MacroConditionOSCEdit::ArgumentsChanged()
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_arguments = _arguments->text().toStdString();
+}
+
+void MacroConditionOSCEdit::RegexChanged(const RegexConfig &regex)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_regex = regex;
+
+	adjustSize();
+	updateGeometry();
+}
+
+void MacroConditionOSCEdit::ClearBufferOnMatchChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_clearBufferOnMatch = value;
+}
+
+} // namespace advss
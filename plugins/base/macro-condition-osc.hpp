@@ -0,0 +1,100 @@
+#pragma once
+#include "macro-condition-edit.hpp"
+#include "osc-receiver.hpp"
+#include "regex-config.hpp"
+#include "variable-line-edit.hpp"
+#include "variable-spinbox.hpp"
+
+#include <QCheckBox>
+
+namespace advss {
+
+class MacroConditionOSC : public MacroCondition {
+public:
+	MacroConditionOSC(Macro *m);
+	bool CheckCondition();
+	bool Save(obs_data_t *obj) const;
+	bool Load(obs_data_t *obj);
+	std::string GetShortDesc() const;
+	std::string GetId() const { return id; };
+	static std::shared_ptr<MacroCondition> Create(Macro *m)
+	{
+		return std::make_shared<MacroConditionOSC>(m);
+	}
+
+	using Protocol = OSCReceiver::Protocol;
+
+	void SetProtocol(Protocol);
+	Protocol GetProtocol() const { return _protocol; }
+	void SetPortNr(const IntVariable &);
+	IntVariable GetPortNr() const { return _port; }
+	void SetAddress(const std::string &);
+	StringVariable GetAddress() const { return _address; }
+
+	bool _checkArguments = false;
+	StringVariable _arguments = "";
+	RegexConfig _regex;
+	bool _clearBufferOnMatch = true;
+
+private:
+	void SetupTempVars();
+	// Registers for the messages of the currently configured port and
+	// address, which might change due to the use of variables
+	void UpdateMessageBuffer();
+
+	Protocol _protocol = Protocol::UDP;
+	IntVariable _port = 12345;
+	StringVariable _address = "/address";
+
+	OSCMessageBuffer _messageBuffer;
+	std::string _messageBufferKey;
+	std::chrono::high_resolution_clock::time_point _lastCheck{};
+
+	static bool _registered;
+	static const std::string id;
+};
+
+class MacroConditionOSCEdit : public QWidget {
+	Q_OBJECT
+
+public:
+	MacroConditionOSCEdit(
+		QWidget *parent,
+		std::shared_ptr<MacroConditionOSC> cond = nullptr);
+	void UpdateEntryData();
+	static QWidget *Create(QWidget *parent,
+			       std::shared_ptr<MacroCondition> cond)
+	{
+		return new MacroConditionOSCEdit(
+			parent,
+			std::dynamic_pointer_cast<MacroConditionOSC>(cond));
+	}
+
+private slots:
+	void ProtocolChanged(int);
+	void PortChanged(const NumberVariable<int> &value);
+	void AddressChanged();
+	void CheckArgumentsChanged(int);
+	void ArgumentsChanged();
+	void RegexChanged(const RegexConfig &);
+	void ClearBufferOnMatchChanged(int);
+
+signals:
+	void HeaderInfoChanged(const QString &);
+
+private:
+	void SetWidgetVisibility();
+
+	QComboBox *_protocol;
+	VariableSpinBox *_port;
+	VariableLineEdit *_address;
+	QCheckBox *_checkArguments;
+	VariableLineEdit *_arguments;
+	RegexConfigWidget *_regex;
+	QCheckBox *_clearBufferOnMatch;
+
+	std::shared_ptr<MacroConditionOSC> _entryData;
+	bool _loading = true;
+};
+
+} // namespace advss
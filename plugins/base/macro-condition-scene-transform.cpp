@@ -5,6 +5,8 @@
 #include "text-helpers.hpp"
 #include "scene-item-transform-helpers.hpp"
 
+#include <algorithm>
+
 namespace advss {
 
 const std::string MacroConditionSceneTransform::id = "scene_transform";
@@ -81,6 +83,28 @@ didTransformOfAnySceneItemChange(const std::vector<OBSSceneItem> &items,
 	return ret;
 }
 
+std::vector<OBSSceneItem> MacroConditionSceneTransform::GetSignaledItems(
+	const std::vector<OBSSceneItem> &items)
+{
+	if (!_events) {
+		_events = std::make_unique<SceneItemEventBuffer>(
+			"item_transform");
+	}
+	_events->Watch(items);
+
+	std::vector<OBSSceneItem> result;
+	const auto events = _events->Consume();
+	for (const auto &item : items) {
+		if (std::any_of(events.begin(), events.end(),
+				[&item](const SceneItemEventBuffer::Event &e) {
+					return e.IsFor(item);
+				})) {
+			result.emplace_back(item);
+		}
+	}
+	return result;
+}
+
 bool MacroConditionSceneTransform::CheckAllSettings(
 	const std::vector<OBSSceneItem> &items)
 {
@@ -92,6 +116,17 @@ bool MacroConditionSceneTransform::CheckAllSettings(
 						       _regex, newVariable);
 		break;
 	case Condition::CHANGED:
+		if (_useEvents) {
+			// Changes which were reverted before this check are
+			// reported as well
+			const auto changed = GetSignaledItems(items);
+			if (changed.empty()) {
+				return false;
+			}
+			newVariable = GetSceneItemTransform(changed.back());
+			ret = true;
+			break;
+		}
 		ret = didTransformOfAnySceneItemChange(
 			items, _previousTransform, newVariable);
 		break;
@@ -208,6 +243,13 @@ bool MacroConditionSceneTransform::CheckSingleSetting(
 
 bool MacroConditionSceneTransform::CheckCondition()
 {
+	// Only the transform as a whole is signaled, so changes of a single
+	// setting which were reverted cannot be detected
+	if (!_useEvents || _condition != Condition::CHANGED ||
+	    _settingsType != SettingsType::ALL) {
+		_events.reset();
+	}
+
 	auto items = _source.GetSceneItems(_scene);
 	if (items.empty()) {
 		return false;
@@ -237,6 +279,7 @@ bool MacroConditionSceneTransform::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "settingsType", static_cast<int>(_settingsType));
 	obs_data_set_int(obj, "compare", static_cast<int>(_compare));
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
+	obs_data_set_bool(obj, "useEvents", _useEvents);
 	obs_data_set_int(obj, "version", 1);
 	return true;
 }
@@ -262,6 +305,7 @@ bool MacroConditionSceneTransform::Load(obs_data_t *obj)
 	_compare = static_cast<Compare>(obs_data_get_int(obj, "compare"));
 	SetCondition(
 		static_cast<Condition>(obs_data_get_int(obj, "condition")));
+	_useEvents = obs_data_get_bool(obj, "useEvents");
 
 	// TOOD: remove in future version
 	if (obs_data_has_user_value(obj, "regex")) {
@@ -347,6 +391,8 @@ MacroConditionSceneTransformEdit::MacroConditionSceneTransformEdit(
 	  _singleSettingValue(new VariableLineEdit(this)),
 	  _regex(new RegexConfigWidget(parent)),
 	  _settingSelection(new TransformSettingSelection(this)),
+	  _useEvents(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.sceneTransform.useEvents"))),
 	  _compareLayout(new QHBoxLayout())
 {
 	populateSelection(_settingsType, settingsTypes);
@@ -381,6 +427,8 @@ MacroConditionSceneTransformEdit::MacroConditionSceneTransformEdit(
 	QWidget::connect(_regex,
 			 SIGNAL(RegexConfigChanged(const RegexConfig &)), this,
 			 SLOT(RegexChanged(const RegexConfig &)));
+	QWidget::connect(_useEvents, SIGNAL(stateChanged(int)), this,
+			 SLOT(UseEventsChanged(int)));
 
 	const std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{scenes}}", _scenes},
@@ -416,6 +464,7 @@ MacroConditionSceneTransformEdit::MacroConditionSceneTransformEdit(
 	mainLayout->addLayout(_compareLayout);
 	mainLayout->addWidget(_transformString);
 	mainLayout->addLayout(optionsLayout);
+	mainLayout->addWidget(_useEvents);
 	setLayout(mainLayout);
 
 	_entryData = entryData;
@@ -441,6 +490,7 @@ void MacroConditionSceneTransformEdit::UpdateEntryData()
 	_settingSelection->SetSetting(_entryData->_setting);
 	_transformString->setPlainText(_entryData->_transformString);
 	_singleSettingValue->setText(_entryData->_singleSetting);
+	_useEvents->setChecked(_entryData->_useEvents);
 	SetWidgetVisibility();
 }
 
@@ -568,6 +618,12 @@ void MacroConditionSceneTransformEdit::RegexChanged(const RegexConfig &conf)
 	updateGeometry();
 }
 
+void MacroConditionSceneTransformEdit::UseEventsChanged(int state)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_useEvents = state;
+}
+
 void MacroConditionSceneTransformEdit::SetWidgetVisibility()
 {
 	const auto condition = _entryData->GetCondition();
@@ -594,6 +650,10 @@ void MacroConditionSceneTransformEdit::SetWidgetVisibility()
 	_settingSelection->setVisible(
 		settingsType ==
 		MacroConditionSceneTransform::SettingsType::SINGLE);
+	_useEvents->setVisible(
+		condition == MacroConditionSceneTransform::Condition::CHANGED &&
+		settingsType ==
+			MacroConditionSceneTransform::SettingsType::ALL);
 	if (condition == MacroConditionSceneTransform::Condition::MATCHES &&
 	    settingsType ==
 		    MacroConditionSceneTransform::SettingsType::SINGLE) {
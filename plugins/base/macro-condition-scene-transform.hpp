@@ -1,6 +1,7 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "regex-config.hpp"
+#include "scene-item-event-buffer.hpp"
 #include "scene-item-selection.hpp"
 #include "scene-selection.hpp"
 #include "transform-setting.hpp"
@@ -40,9 +41,14 @@ public:
 	StringVariable _transformString = "";
 	StringVariable _singleSetting = "";
 	TransformSetting _setting;
+	// Check for transform changes signaled since the last check instead of
+	// comparing the current transform to the one of the last check
+	bool _useEvents = false;
 
 private:
 	void SetupTempVars();
+	std::vector<OBSSceneItem>
+	GetSignaledItems(const std::vector<OBSSceneItem> &);
 	bool CheckAllSettings(const std::vector<OBSSceneItem> &);
 	bool CheckSingleSetting(const std::vector<OBSSceneItem> &);
 	bool
@@ -56,6 +62,7 @@ private:
 
 	std::vector<std::string> _previousTransform;
 	std::vector<std::string> _previousSettingValues;
+	std::unique_ptr<SceneItemEventBuffer> _events;
 
 	static bool _registered;
 	static const std::string id;
@@ -91,6 +98,7 @@ private slots:
 	void TransformChanged();
 	void SettingValueChanged();
 	void RegexChanged(const RegexConfig &);
+	void UseEventsChanged(int state);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -109,6 +117,7 @@ private:
 	VariableLineEdit *_singleSettingValue;
 	RegexConfigWidget *_regex;
 	TransformSettingSelection *_settingSelection;
+	QCheckBox *_useEvents;
 	QHBoxLayout *_compareLayout;
 
 	std::shared_ptr<MacroConditionSceneTransform> _entryData;
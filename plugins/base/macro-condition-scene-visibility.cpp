@@ -66,13 +66,52 @@ didVisibilityOfAnySceneItemsChange(const std::vector<OBSSceneItem> &items,
 	return ret;
 }
 
+bool MacroConditionSceneVisibility::CheckEvents(
+	const std::vector<OBSSceneItem> &items)
+{
+	if (!_events) {
+		_events = std::make_unique<SceneItemEventBuffer>(
+			"item_visible");
+	}
+	_events->Watch(items);
+
+	bool ret = false;
+	for (const auto &event : _events->Consume()) {
+		if (!event.IsFor(items)) {
+			continue;
+		}
+		switch (_condition) {
+		case Condition::SHOWN:
+			ret = ret || event.visible;
+			break;
+		case Condition::HIDDEN:
+			ret = ret || !event.visible;
+			break;
+		case Condition::CHANGED:
+			ret = true;
+			break;
+		default:
+			break;
+		}
+	}
+	return ret;
+}
+
 bool MacroConditionSceneVisibility::CheckCondition()
 {
+	if (!_useEvents) {
+		_events.reset();
+	}
+
 	auto items = _source.GetSceneItems(_scene);
 	if (items.empty()) {
 		return false;
 	}
 
+	if (_useEvents) {
+		return CheckEvents(items);
+	}
+
 	switch (_condition) {
 	case Condition::SHOWN:
 		return areAllSceneItemsShown(items);
@@ -94,6 +133,7 @@ bool MacroConditionSceneVisibility::Save(obs_data_t *obj) const
 	_scene.Save(obj);
 	_source.Save(obj);
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
+	obs_data_set_bool(obj, "useEvents", _useEvents);
 
 	return true;
 }
@@ -111,6 +151,7 @@ bool MacroConditionSceneVisibility::Load(obs_data_t *obj)
 	_scene.Load(obj);
 	_source.Load(obj);
 	_condition = static_cast<Condition>(obs_data_get_int(obj, "condition"));
+	_useEvents = obs_data_get_bool(obj, "useEvents");
 	return true;
 }
 
@@ -137,6 +178,10 @@ MacroConditionSceneVisibilityEdit::MacroConditionSceneVisibilityEdit(
 	_scenes = new SceneSelectionWidget(window(), true, false, true, true);
 	_sources = new SceneItemSelectionWidget(parent);
 	_conditions = new QComboBox();
+	_useEvents = new QCheckBox(obs_module_text(
+		"AdvSceneSwitcher.condition.sceneVisibility.useEvents"));
+	_useEvents->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.sceneVisibility.useEvents.tooltip"));
 
 	populateConditionSelection(_conditions);
 
@@ -149,17 +194,22 @@ MacroConditionSceneVisibilityEdit::MacroConditionSceneVisibilityEdit(
 			 this, SLOT(SourceChanged(const SceneItemSelection &)));
 	QWidget::connect(_conditions, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(ConditionChanged(int)));
+	QWidget::connect(_useEvents, SIGNAL(stateChanged(int)), this,
+			 SLOT(UseEventsChanged(int)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{sources}}", _sources},
 		{"{{scenes}}", _scenes},
 		{"{{conditions}}", _conditions},
 	};
-	QHBoxLayout *mainLayout = new QHBoxLayout;
+	auto entryLayout = new QHBoxLayout;
 	PlaceWidgets(
 		obs_module_text(
 			"AdvSceneSwitcher.condition.sceneVisibility.entry"),
-		mainLayout, widgetPlaceholders);
+		entryLayout, widgetPlaceholders);
+	auto mainLayout = new QVBoxLayout;
+	mainLayout->addLayout(entryLayout);
+	mainLayout->addWidget(_useEvents);
 	setLayout(mainLayout);
 
 	_entryData = entryData;
@@ -213,6 +263,12 @@ void MacroConditionSceneVisibilityEdit::ConditionChanged(int index)
 	}
 }
 
+void MacroConditionSceneVisibilityEdit::UseEventsChanged(int state)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_useEvents = state;
+}
+
 void MacroConditionSceneVisibilityEdit::UpdateEntryData()
 {
 	if (!_entryData) {
@@ -220,6 +276,7 @@ void MacroConditionSceneVisibilityEdit::UpdateEntryData()
 	}
 
 	_conditions->setCurrentIndex(static_cast<int>(_entryData->_condition));
+	_useEvents->setChecked(_entryData->_useEvents);
 	_scenes->SetScene(_entryData->_scene);
 	if (_entryData->_condition ==
 	    MacroConditionSceneVisibility::Condition::CHANGED) {
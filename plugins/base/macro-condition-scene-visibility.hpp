@@ -2,7 +2,9 @@
 #include "macro-condition-edit.hpp"
 #include "scene-selection.hpp"
 #include "scene-item-selection.hpp"
+#include "scene-item-event-buffer.hpp"
 
+#include <QCheckBox>
 #include <QComboBox>
 
 namespace advss {
@@ -29,9 +31,15 @@ public:
 	SceneSelection _scene;
 	SceneItemSelection _source;
 	Condition _condition = Condition::SHOWN;
+	// Check for visibility changes signaled since the last check instead
+	// of the current visibility state
+	bool _useEvents = false;
 
 private:
+	bool CheckEvents(const std::vector<OBSSceneItem> &);
+
 	std::vector<bool> _previousVisibilty;
+	std::unique_ptr<SceneItemEventBuffer> _events;
 
 	static bool _registered;
 	static const std::string id;
@@ -58,6 +66,7 @@ private slots:
 	void SceneChanged(const SceneSelection &);
 	void SourceChanged(const SceneItemSelection &);
 	void ConditionChanged(int cond);
+	void UseEventsChanged(int state);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -65,6 +74,7 @@ protected:
 	SceneSelectionWidget *_scenes;
 	SceneItemSelectionWidget *_sources;
 	QComboBox *_conditions;
+	QCheckBox *_useEvents;
 
 	std::shared_ptr<MacroConditionSceneVisibility> _entryData;
 
@@ -107,6 +107,7 @@ void MacroConditionTimer::Pause()
 	if (!_paused) {
 		_paused = true;
 		_remaining = _duration.TimeRemaining();
+		MarkDirty();
 	}
 }
 
@@ -115,12 +116,14 @@ void MacroConditionTimer::Continue()
 	if (_paused) {
 		_paused = false;
 		_duration.SetTimeRemaining(_remaining);
+		MarkDirty();
 	}
 }
 
 void MacroConditionTimer::Reset()
 {
 	_remaining = _duration.Seconds();
+	MarkDirty();
 	_duration.Reset();
 	if (_type == TimerType::RANDOM) {
 		SetRandomTimeRemaining();
@@ -35,6 +35,7 @@ public:
 	bool _oneshot = false;
 
 private:
+	bool CanReuseSavedSettings() const { return !_saveRemaining; }
 	void SetRandomTimeRemaining();
 	void SetVariables(double seconds);
 	void SetupTempVars();
@@ -158,7 +158,6 @@ bool MacroConditionTransition::Load(obs_data_t *obj)
 	_transition.Load(obj);
 	_scene.Load(obj);
 	_duration.Load(obj);
-	ConnectToTransitionSignals();
 	return true;
 }
 
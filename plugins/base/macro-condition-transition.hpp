@@ -39,6 +39,7 @@ public:
 	Duration _duration;
 
 private:
+	void SetupResources() { ConnectToTransitionSignals(); }
 	static void TransitionStarted(void *data, calldata_t *);
 	static void TransitionEnded(void *data, calldata_t *);
 
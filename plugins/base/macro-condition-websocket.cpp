@@ -25,6 +25,7 @@ MacroConditionWebsocket::MacroConditionWebsocket(Macro *m)
 	: MacroCondition(m, true)
 {
 	_messageBuffer = RegisterForWebsocketMessages();
+	CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
 }
 
 bool MacroConditionWebsocket::CheckCondition()
@@ -41,11 +42,7 @@ bool MacroConditionWebsocket::CheckCondition()
 		return false;
 	}
 
-	while (!_messageBuffer->Empty()) {
-		auto message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
+	while (const auto message = _messageBuffer->ConsumeMessage()) {
 		if (_regex.Enabled()) {
 			if (!_regex.Matches(*message, _message)) {
 				continue;
@@ -123,6 +120,7 @@ void MacroConditionWebsocket::SetType(Type type)
 	_type = type;
 	if (_type == Type::REQUEST) {
 		_messageBuffer = RegisterForWebsocketMessages();
+		CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
 		return;
 	}
 
@@ -131,6 +129,7 @@ void MacroConditionWebsocket::SetType(Type type)
 		return;
 	}
 	_messageBuffer = connection->RegisterForEvents();
+	CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
 }
 
 void MacroConditionWebsocket::SetConnection(const std::string &connectionName)
@@ -146,6 +145,7 @@ void MacroConditionWebsocket::SetConnection(const std::string &connectionName)
 		return;
 	}
 	_messageBuffer = connection->RegisterForEvents();
+	CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
 }
 
 std::weak_ptr<WSConnection> MacroConditionWebsocket::GetConnection() const
@@ -0,0 +1,88 @@
+#include "audio-level-monitor.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace advss {
+
+static std::mutex monitorMutex;
+static std::unordered_map<obs_weak_source_t *, std::weak_ptr<AudioLevelMonitor>>
+	monitors;
+
+AudioLevelMonitor::AudioLevelMonitor(const OBSWeakSource &source)
+	: _source(source),
+	  _volmeter(obs_volmeter_create(OBS_FADER_LOG))
+{
+	obs_volmeter_add_callback(_volmeter, VolumeLevel, this);
+	OBSSourceAutoRelease audioSource = obs_weak_source_get_source(source);
+	if (!obs_volmeter_attach_source(_volmeter, audioSource)) {
+		const char *name = obs_source_get_name(audioSource);
+		blog(LOG_WARNING, "failed to attach volmeter to source %s",
+		     name);
+	}
+}
+
+AudioLevelMonitor::~AudioLevelMonitor()
+{
+	obs_volmeter_remove_callback(_volmeter, VolumeLevel, this);
+	obs_volmeter_destroy(_volmeter);
+}
+
+std::shared_ptr<AudioLevelMonitor>
+AudioLevelMonitor::Get(const OBSWeakSource &source)
+{
+	std::lock_guard<std::mutex> lock(monitorMutex);
+	for (auto it = monitors.begin(); it != monitors.end();) {
+		if (it->second.expired()) {
+			it = monitors.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto it = monitors.find(source.Get());
+	if (it != monitors.end()) {
+		return it->second.lock();
+	}
+
+	// Constructor is private so std::make_shared cannot be used
+	auto monitor = std::shared_ptr<AudioLevelMonitor>(
+		new AudioLevelMonitor(source));
+	monitors[source.Get()] = monitor;
+	return monitor;
+}
+
+void AudioLevelMonitor::AddWindow(
+	const std::shared_ptr<AudioLevelWindow> &window)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto isExpired = [](const std::weak_ptr<AudioLevelWindow> &ptr) {
+		return ptr.expired();
+	};
+	_windows.erase(std::remove_if(_windows.begin(), _windows.end(),
+				      isExpired),
+		       _windows.end());
+	_windows.emplace_back(window);
+}
+
+void AudioLevelMonitor::VolumeLevel(void *data,
+				    const float magnitude[MAX_AUDIO_CHANNELS],
+				    const float peak[MAX_AUDIO_CHANNELS],
+				    const float *)
+{
+	auto monitor = static_cast<AudioLevelMonitor *>(data);
+	const int channelCount =
+		obs_volmeter_get_nr_channels(monitor->_volmeter);
+	const auto now = AudioLevelWindow::Clock::now();
+
+	std::lock_guard<std::mutex> lock(monitor->_mutex);
+	for (const auto &window_ : monitor->_windows) {
+		auto window = window_.lock();
+		if (!window) {
+			continue;
+		}
+		window->AddSample(magnitude, peak, channelCount, now);
+	}
+}
+
+} // namespace advss
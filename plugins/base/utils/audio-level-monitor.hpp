@@ -0,0 +1,35 @@
+#pragma once
+#include "audio-level-window.hpp"
+
+#include <memory>
+#include <mutex>
+#include <obs.hpp>
+#include <vector>
+
+namespace advss {
+
+// Attaches a single volume meter to an audio source and forwards its level
+// updates to all registered windows.
+// Instances are shared by all users of the same source.
+class AudioLevelMonitor {
+public:
+	~AudioLevelMonitor();
+	static std::shared_ptr<AudioLevelMonitor> Get(const OBSWeakSource &);
+
+	void AddWindow(const std::shared_ptr<AudioLevelWindow> &);
+	OBSWeakSource GetSource() const { return _source; }
+
+private:
+	AudioLevelMonitor(const OBSWeakSource &);
+	static void VolumeLevel(void *data,
+				const float magnitude[MAX_AUDIO_CHANNELS],
+				const float peak[MAX_AUDIO_CHANNELS],
+				const float inputPeak[MAX_AUDIO_CHANNELS]);
+
+	OBSWeakSource _source;
+	obs_volmeter_t *_volmeter = nullptr;
+	std::mutex _mutex;
+	std::vector<std::weak_ptr<AudioLevelWindow>> _windows;
+};
+
+} // namespace advss
@@ -0,0 +1,177 @@
+#include "audio-level-window.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace advss {
+
+// Upper bound of samples kept per window to limit memory usage in case very
+// long windows are configured
+constexpr size_t maxSampleCount = 1 << 16;
+
+// OBS reports roughly 50 volume meter updates per second, so if no update was
+// received for a while it is assumed that the source no longer produces any
+// audio output
+constexpr std::chrono::milliseconds peakTimeout(250);
+
+static double decibelToPower(float db)
+{
+	return std::isfinite(db) ? std::pow(10.0, db / 10.0) : 0.0;
+}
+
+static float powerToDecibel(double power)
+{
+	return power <= 0.0 ? -std::numeric_limits<float>::infinity()
+			    : static_cast<float>(10.0 * std::log10(power));
+}
+
+void AudioLevelWindow::SetWindowSize(std::chrono::milliseconds windowSize)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_windowSize = windowSize;
+}
+
+std::chrono::milliseconds AudioLevelWindow::GetWindowSize() const
+{
+	return _windowSize;
+}
+
+void AudioLevelWindow::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_samples.clear();
+	_peakCandidates.clear();
+	_meanPowerSum = 0.0;
+	_channelPowerSum = 0.0;
+	_peak = -std::numeric_limits<float>::infinity();
+	_previousPeak = -std::numeric_limits<float>::infinity();
+	_peakUpdated = false;
+	_lastPeakUpdate = {};
+}
+
+void AudioLevelWindow::AddSample(const float *magnitude, const float *peak,
+				 int channelCount, Clock::time_point time)
+{
+	if (channelCount <= 0) {
+		return;
+	}
+
+	double channelPowerSum = 0.0;
+	float maxPeak = -std::numeric_limits<float>::infinity();
+	for (int i = 0; i < channelCount; i++) {
+		channelPowerSum += decibelToPower(magnitude[i]);
+		maxPeak = std::max(maxPeak, peak[i]);
+	}
+	const double meanPower = channelPowerSum / channelCount;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_samples.push_back({time, meanPower, channelPowerSum});
+	_meanPowerSum += meanPower;
+	_channelPowerSum += channelPowerSum;
+
+	// Older candidates which are not louder than the new peak can never be
+	// the maximum of the window again
+	while (!_peakCandidates.empty() &&
+	       _peakCandidates.back().peak <= maxPeak) {
+		_peakCandidates.pop_back();
+	}
+	_peakCandidates.push_back({time, maxPeak});
+
+	if (maxPeak > _peak) {
+		_peak = maxPeak;
+	}
+	_peakUpdated = true;
+	_lastPeakUpdate = time;
+
+	RemoveExpiredSamples(time);
+}
+
+void AudioLevelWindow::RemoveExpiredSamples(Clock::time_point now)
+{
+	const auto cutoff = now - _windowSize;
+	while (!_samples.empty() && (_samples.front().time < cutoff ||
+				     _samples.size() > maxSampleCount)) {
+		_meanPowerSum -= _samples.front().meanPower;
+		_channelPowerSum -= _samples.front().channelPowerSum;
+		_samples.pop_front();
+	}
+	while (!_peakCandidates.empty() &&
+	       _peakCandidates.front().time < cutoff) {
+		_peakCandidates.pop_front();
+	}
+
+	// Avoid accumulating floating point errors of the running sums
+	if (_samples.empty()) {
+		_meanPowerSum = 0.0;
+		_channelPowerSum = 0.0;
+	}
+}
+
+float AudioLevelWindow::GetRMS(Clock::time_point now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	RemoveExpiredSamples(now);
+	if (_samples.empty()) {
+		return -std::numeric_limits<float>::infinity();
+	}
+	return powerToDecibel(std::max(_meanPowerSum, 0.0) / _samples.size());
+}
+
+float AudioLevelWindow::GetPeakHold(Clock::time_point now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	RemoveExpiredSamples(now);
+	if (_peakCandidates.empty()) {
+		return -std::numeric_limits<float>::infinity();
+	}
+	return _peakCandidates.front().peak;
+}
+
+float AudioLevelWindow::GetLoudness(Clock::time_point now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	RemoveExpiredSamples(now);
+	if (_samples.empty()) {
+		return -std::numeric_limits<float>::infinity();
+	}
+
+	// See ITU-R BS.1770 for the definition of the loudness offset
+	const double meanSquare =
+		std::max(_channelPowerSum, 0.0) / _samples.size();
+	return -0.691f + powerToDecibel(meanSquare);
+}
+
+float AudioLevelWindow::ConsumePeak(Clock::time_point now)
+{
+	// OBS might rarely not provide a new sample quickly enough when very
+	// low intervals are configured on the General tab.
+	// In that case _peak might be set to negative infinity still, which
+	// will result in unexpected behavior, so we use the previously valid
+	// peak value instead.
+	//
+	// If no volume update was received within a timeout window, however, it
+	// is assumed, that the source no longer produces any audio output and
+	// thus a peak volume value of negative infinity is used.
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	float peak;
+	if (_lastPeakUpdate.time_since_epoch().count() != 0 &&
+	    now - _lastPeakUpdate > peakTimeout) {
+		peak = -std::numeric_limits<float>::infinity();
+	} else {
+		peak = _peakUpdated ? _peak : _previousPeak;
+	}
+
+	_previousPeak = peak;
+	_peak = -std::numeric_limits<float>::infinity();
+	_peakUpdated = false;
+	return peak;
+}
+
+size_t AudioLevelWindow::GetSampleCount()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _samples.size();
+}
+
+} // namespace advss
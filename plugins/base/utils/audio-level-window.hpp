@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <mutex>
+
+namespace advss {
+
+// Keeps the volume meter samples of the configured time window and provides
+// sliding window aggregates of those samples.
+//
+// Adding a sample and querying the aggregates is O(1) amortized, as running
+// sums are used for the averaged values and a monotonic queue is used for the
+// peak-hold value.
+class AudioLevelWindow {
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	void SetWindowSize(std::chrono::milliseconds);
+	std::chrono::milliseconds GetWindowSize() const;
+	void Clear();
+
+	// Magnitude and peak values are expected in dBFS for each channel
+	void AddSample(const float *magnitude, const float *peak,
+		       int channelCount, Clock::time_point = Clock::now());
+
+	// Average RMS level of all channels over the window in dBFS
+	float GetRMS(Clock::time_point now = Clock::now());
+	// Highest peak of any channel seen within the window in dBFS
+	float GetPeakHold(Clock::time_point now = Clock::now());
+	// Loudness over the window in LUFS (without K-weighting)
+	float GetLoudness(Clock::time_point now = Clock::now());
+	// Highest peak since the last call of this function in dBFS
+	float ConsumePeak(Clock::time_point now = Clock::now());
+	size_t GetSampleCount();
+
+private:
+	struct Sample {
+		Clock::time_point time;
+		double meanPower;
+		double channelPowerSum;
+	};
+	struct PeakSample {
+		Clock::time_point time;
+		float peak;
+	};
+
+	void RemoveExpiredSamples(Clock::time_point now);
+
+	std::mutex _mutex;
+	std::chrono::milliseconds _windowSize = std::chrono::seconds(3);
+	std::deque<Sample> _samples;
+	std::deque<PeakSample> _peakCandidates;
+	double _meanPowerSum = 0.0;
+	double _channelPowerSum = 0.0;
+
+	float _peak = -std::numeric_limits<float>::infinity();
+	float _previousPeak = -std::numeric_limits<float>::infinity();
+	bool _peakUpdated = false;
+	Clock::time_point _lastPeakUpdate = {};
+};
+
+} // namespace advss
@@ -94,7 +94,10 @@ WSConnection::WSConnection(const WSConnection &other) : Item(other)
 	_reconnect = other._reconnect;
 	_reconnectDelay = other._reconnectDelay;
 	_useOBSWSProtocol = other._useOBSWSProtocol;
+	_sendQueueSize = other._sendQueueSize;
+	_sendQueuePolicy = other._sendQueuePolicy;
 	_client.UseOBSWebsocketProtocol(_useOBSWSProtocol);
+	ApplySendQueueLimit();
 }
 
 WSConnection &WSConnection::operator=(const WSConnection &other)
@@ -111,6 +114,9 @@ WSConnection &WSConnection::operator=(const WSConnection &other)
 		_reconnectDelay = other._reconnectDelay;
 		_client.UseOBSWebsocketProtocol(_useOBSWSProtocol);
 		_useOBSWSProtocol = other._useOBSWSProtocol;
+		_sendQueueSize = other._sendQueueSize;
+		_sendQueuePolicy = other._sendQueuePolicy;
+		ApplySendQueueLimit();
 		_client.Disconnect();
 	}
 	return *this;
@@ -152,9 +158,9 @@ void WSConnection::SendMsg(const std::string &msg)
 		return;
 	}
 
-	if (status == WSClientConnection::Status::AUTHENTICATED) {
-		_client.SendRequest(msg);
-	}
+	// Messages sent while the connection is still being established are
+	// queued and sent once it is ready
+	_client.SendRequest(msg);
 }
 
 void WSConnection::Load(obs_data_t *obj)
@@ -178,6 +184,11 @@ void WSConnection::Load(obs_data_t *obj)
 	_connectOnStart = obs_data_get_bool(obj, "connectOnStart");
 	_reconnect = obs_data_get_bool(obj, "reconnect");
 	_reconnectDelay = obs_data_get_int(obj, "reconnectDelay");
+	obs_data_set_default_int(obj, "sendQueueSize", 1000);
+	_sendQueueSize = obs_data_get_int(obj, "sendQueueSize");
+	_sendQueuePolicy = static_cast<MessageBufferOverflowPolicy>(
+		obs_data_get_int(obj, "sendQueuePolicy"));
+	ApplySendQueueLimit();
 
 	if (_connectOnStart) {
 		_client.Connect(GetURI(), _password, _reconnect,
@@ -197,6 +208,9 @@ void WSConnection::Save(obs_data_t *obj) const
 	obs_data_set_bool(obj, "connectOnStart", _connectOnStart);
 	obs_data_set_bool(obj, "reconnect", _reconnect);
 	obs_data_set_int(obj, "reconnectDelay", _reconnectDelay);
+	obs_data_set_int(obj, "sendQueueSize", _sendQueueSize);
+	obs_data_set_int(obj, "sendQueuePolicy",
+			 static_cast<int>(_sendQueuePolicy));
 	obs_data_set_int(obj, "version", 1);
 }
 
@@ -211,6 +225,16 @@ void WSConnection::UseOBSWebsocketProtocol(bool useOBSWSProtocol)
 	_client.UseOBSWebsocketProtocol(useOBSWSProtocol);
 }
 
+void WSConnection::ApplySendQueueLimit()
+{
+	_client.SetSendQueueLimit(_sendQueueSize, _sendQueuePolicy);
+}
+
+WSClientConnection::SendStatistics WSConnection::GetSendStatistics() const
+{
+	return _client.GetSendStatistics();
+}
+
 WSConnection *GetConnectionByName(const QString &name)
 {
 	return GetConnectionByName(name.toStdString());
@@ -343,10 +367,14 @@ WSConnectionSettingsDialog::WSConnectionSettingsDialog(
 	  _reconnect(new QCheckBox()),
 	  _reconnectDelay(new QSpinBox()),
 	  _useOBSWSProtocol(new QCheckBox()),
+	  _sendQueueSize(new QSpinBox()),
+	  _sendQueuePolicy(new QComboBox()),
+	  _statistics(new QLabel()),
 	  _test(new QPushButton(
 		  obs_module_text("AdvSceneSwitcher.connection.test"))),
 	  _status(new QLabel()),
-	  _layout(new QGridLayout())
+	  _layout(new QGridLayout()),
+	  _connection(settings)
 {
 	_port->setMaximum(65535);
 	_showPassword->setMaximumWidth(22);
@@ -355,6 +383,12 @@ WSConnectionSettingsDialog::WSConnectionSettingsDialog(
 		"QPushButton { background-color: transparent; border: 0px }");
 	_reconnectDelay->setMaximum(9999);
 	_reconnectDelay->setSuffix("s");
+	_sendQueueSize->setMinimum(1);
+	_sendQueueSize->setMaximum(100000);
+	_sendQueuePolicy->addItem(obs_module_text(
+		"AdvSceneSwitcher.connection.sendQueuePolicy.dropOldest"));
+	_sendQueuePolicy->addItem(obs_module_text(
+		"AdvSceneSwitcher.connection.sendQueuePolicy.dropNewest"));
 
 	_useCustomURI->setChecked(settings._useCustomURI);
 	_customUri->setText(QString::fromStdString(settings._customURI));
@@ -365,6 +399,9 @@ WSConnectionSettingsDialog::WSConnectionSettingsDialog(
 	_reconnect->setChecked(settings._reconnect);
 	_reconnectDelay->setValue(settings._reconnectDelay);
 	_useOBSWSProtocol->setChecked(settings._useOBSWSProtocol);
+	_sendQueueSize->setValue(settings._sendQueueSize);
+	_sendQueuePolicy->setCurrentIndex(
+		static_cast<int>(settings._sendQueuePolicy));
 
 	QWidget::connect(_useCustomURI, SIGNAL(stateChanged(int)), this,
 			 SLOT(UseCustomURIChanged(int)));
@@ -442,6 +479,23 @@ WSConnectionSettingsDialog::WSConnectionSettingsDialog(
 		row, 0);
 	_layout->addWidget(_useOBSWSProtocol, row, 1);
 	++row;
+	_layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.connection.sendQueueSize")),
+		row, 0);
+	_layout->addWidget(_sendQueueSize, row, 1);
+	++row;
+	_layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.connection.sendQueuePolicy")),
+		row, 0);
+	_layout->addWidget(_sendQueuePolicy, row, 1);
+	++row;
+	_layout->addWidget(new QLabel(obs_module_text(
+				   "AdvSceneSwitcher.connection.statistics")),
+			   row, 0);
+	_layout->addWidget(_statistics, row, 1);
+	++row;
 	_layout->addWidget(_test, row, 0);
 	_layout->addWidget(_status, row, 1);
 	++row;
@@ -453,6 +507,12 @@ WSConnectionSettingsDialog::WSConnectionSettingsDialog(
 	ProtocolChanged(_useOBSWSProtocol->isChecked());
 	HidePassword();
 	UseCustomURIChanged(settings._useCustomURI);
+
+	SetStatistics();
+	_statisticsTimer.setInterval(1000);
+	QWidget::connect(&_statisticsTimer, &QTimer::timeout, this,
+			 &WSConnectionSettingsDialog::SetStatistics);
+	_statisticsTimer.start();
 }
 
 void WSConnectionSettingsDialog::UseCustomURIChanged(int state)
@@ -500,6 +560,21 @@ void WSConnectionSettingsDialog::SetStatus()
 	}
 }
 
+void WSConnectionSettingsDialog::SetStatistics()
+{
+	const auto stats = _connection.GetSendStatistics();
+	auto toMs = [](std::chrono::microseconds duration) {
+		return QString::number(duration.count() / 1000.0, 'f', 1);
+	};
+	const QString format = obs_module_text(
+		"AdvSceneSwitcher.connection.statistics.format");
+	_statistics->setText(format.arg(stats.queued)
+				     .arg(stats.sent)
+				     .arg(stats.dropped)
+				     .arg(toMs(stats.averageLatency))
+				     .arg(toMs(stats.maxLatency)));
+}
+
 void WSConnectionSettingsDialog::ShowPassword()
 {
 	SetButtonIcon(_showPassword, ":res/images/visible.svg");
@@ -546,6 +621,10 @@ bool WSConnectionSettingsDialog::AskForSettings(QWidget *parent,
 	settings._reconnect = dialog._reconnect->isChecked();
 	settings._reconnectDelay = dialog._reconnectDelay->value();
 	settings.UseOBSWebsocketProtocol(dialog._useOBSWSProtocol->isChecked());
+	settings._sendQueueSize = dialog._sendQueueSize->value();
+	settings._sendQueuePolicy = static_cast<MessageBufferOverflowPolicy>(
+		dialog._sendQueuePolicy->currentIndex());
+	settings.ApplySendQueueLimit();
 	settings.Reconnect();
 	return true;
 }
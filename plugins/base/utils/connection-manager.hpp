@@ -45,9 +45,11 @@ public:
 	bool IsUsingOBSProtocol() const { return _useOBSWSProtocol; }
 	std::string GetURI() const;
 	uint64_t GetPort() const { return _port; }
+	WSClientConnection::SendStatistics GetSendStatistics() const;
 
 private:
 	void UseOBSWebsocketProtocol(bool);
+	void ApplySendQueueLimit();
 
 	bool _useCustomURI = false;
 	std::string _customURI = "ws://localhost:4455";
@@ -58,6 +60,9 @@ private:
 	bool _reconnect = true;
 	int _reconnectDelay = 3;
 	bool _useOBSWSProtocol = true;
+	int _sendQueueSize = 1000;
+	MessageBufferOverflowPolicy _sendQueuePolicy =
+		MessageBufferOverflowPolicy::DROP_OLDEST;
 
 	WSClientConnection _client;
 
@@ -79,6 +84,7 @@ private slots:
 	void ShowPassword();
 	void HidePassword();
 	void SetStatus();
+	void SetStatistics();
 	void TestConnection();
 
 private:
@@ -92,12 +98,17 @@ private:
 	QCheckBox *_reconnect;
 	QSpinBox *_reconnectDelay;
 	QCheckBox *_useOBSWSProtocol;
+	QSpinBox *_sendQueueSize;
+	QComboBox *_sendQueuePolicy;
+	QLabel *_statistics;
 	QPushButton *_test;
 	QLabel *_status;
 	QGridLayout *_layout;
 
 	QTimer _statusTimer;
+	QTimer _statisticsTimer;
 	WSClientConnection _testConnection;
+	const WSConnection &_connection;
 
 	int _customURIRow = -1;
 	int _addressRow = -1;
@@ -0,0 +1,195 @@
+#include "obs-stats-sampler.hpp"
+
+#include <obs-frontend-api.h>
+
+namespace advss {
+
+constexpr std::chrono::milliseconds samplingInterval(500);
+// Keep the last 10 minutes of samples
+constexpr size_t sampleCapacity = 1200;
+
+static std::mutex samplerMutex;
+static std::weak_ptr<OBSStatsSampler> sampler;
+
+OBSStatsSampler::OBSStatsSampler() : _cpuInfo(os_cpu_usage_info_start())
+{
+	for (auto &series : _series) {
+		series = TimeSeries(sampleCapacity);
+	}
+	_thread = std::thread(&OBSStatsSampler::Run, this);
+}
+
+OBSStatsSampler::~OBSStatsSampler()
+{
+	_stop = true;
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+	os_cpu_usage_info_destroy(_cpuInfo);
+}
+
+std::shared_ptr<OBSStatsSampler> OBSStatsSampler::Get()
+{
+	std::lock_guard<std::mutex> lock(samplerMutex);
+	auto instance = sampler.lock();
+	if (instance) {
+		return instance;
+	}
+
+	// Constructor is private so std::make_shared cannot be used
+	instance = std::shared_ptr<OBSStatsSampler>(new OBSStatsSampler());
+	sampler = instance;
+	return instance;
+}
+
+double OBSStatsSampler::GetValue(Stat stat, Aggregation aggregation,
+				 std::chrono::milliseconds window,
+				 double percentile)
+{
+	if (stat >= Stat::LAST_STAT) {
+		return 0.0;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	const auto &series = _series[static_cast<int>(stat)];
+	switch (aggregation) {
+	case Aggregation::LATEST:
+		return series.GetLatest();
+	case Aggregation::AVERAGE:
+		return series.GetAverage();
+	case Aggregation::MINIMUM:
+		return series.GetMinimum(window);
+	case Aggregation::MAXIMUM:
+		return series.GetMaximum(window);
+	case Aggregation::PERCENTILE:
+		return series.GetPercentile(percentile, window);
+	default:
+		break;
+	}
+	return 0.0;
+}
+
+void OBSStatsSampler::Run()
+{
+	while (!_stop) {
+		Sample();
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_cv.wait_for(lock, samplingInterval,
+			     [this]() { return _stop.load(); });
+	}
+}
+
+void OBSStatsSampler::OutputInfo::Update(obs_output_t *output,
+					 TimeSeries::Clock::time_point now,
+					 TimeSeries &bitrate,
+					 TimeSeries &droppedFrames,
+					 TimeSeries &mbSent)
+{
+	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
+	uint64_t curTime = os_gettime_ns();
+	uint64_t bytesSent = totalBytes;
+
+	if (bytesSent < lastBytesSent) {
+		bytesSent = 0;
+	}
+	if (bytesSent == 0) {
+		lastBytesSent = 0;
+	}
+
+	uint64_t bitsBetween = (bytesSent - lastBytesSent) * 8;
+	long double timePassed =
+		(long double)(curTime - lastBytesSentTime) / 1000000000.0l;
+	long double kbps = (long double)bitsBetween / timePassed / 1000.0l;
+	if (timePassed < 0.01l) {
+		kbps = 0.0l;
+	}
+
+	int total = output ? obs_output_get_total_frames(output) : 0;
+	int dropped = output ? obs_output_get_frames_dropped(output) : 0;
+
+	if (total < firstTotal || dropped < firstDropped) {
+		firstTotal = 0;
+		firstDropped = 0;
+	}
+
+	total -= firstTotal;
+	dropped -= firstDropped;
+
+	double droppedRelative =
+		total ? (double)dropped / (double)total * 100.0 : 0.0;
+
+	lastBytesSent = bytesSent;
+	lastBytesSentTime = curTime;
+
+	bitrate.Add((double)kbps, now);
+	droppedFrames.Add(droppedRelative, now);
+	mbSent.Add((double)totalBytes / (1024.0 * 1024.0), now);
+}
+
+void OBSStatsSampler::Sample()
+{
+	const auto now = TimeSeries::Clock::now();
+
+	// Query everything before locking to keep the time readers are blocked
+	// as short as possible
+	const double fps = obs_get_active_fps();
+	const double cpu = os_cpu_usage_info_query(_cpuInfo);
+	const double rss =
+		(double)os_get_proc_resident_size() / (1024.0 * 1024.0);
+	const double frameTime =
+		(double)obs_get_average_frame_time_ns() / 1000000.0;
+
+	uint32_t totalRendered = obs_get_total_frames();
+	uint32_t totalLagged = obs_get_lagged_frames();
+	if (totalRendered < _firstRendered || totalLagged < _firstLagged) {
+		_firstRendered = totalRendered;
+		_firstLagged = totalLagged;
+	}
+	totalRendered -= _firstRendered;
+	totalLagged -= _firstLagged;
+	const double renderLag =
+		totalRendered ? (double)totalLagged / (double)totalRendered *
+					100.0
+			      : 0.0;
+
+	video_t *video = obs_get_video();
+	uint32_t totalEncoded = video_output_get_total_frames(video);
+	uint32_t totalSkipped = video_output_get_skipped_frames(video);
+	if (totalEncoded < _firstEncoded || totalSkipped < _firstSkipped) {
+		_firstEncoded = totalEncoded;
+		_firstSkipped = totalSkipped;
+	}
+	totalEncoded -= _firstEncoded;
+	totalSkipped -= _firstSkipped;
+	const double encodeLag =
+		totalEncoded ? (double)totalSkipped / (double)totalEncoded *
+				       100.0
+			     : 0.0;
+
+	OBSOutputAutoRelease streamOutput =
+		obs_frontend_get_streaming_output();
+	OBSOutputAutoRelease recordingOutput =
+		obs_frontend_get_recording_output();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto series = [this](Stat stat) -> TimeSeries & {
+		return _series[static_cast<int>(stat)];
+	};
+	series(Stat::FPS).Add(fps, now);
+	series(Stat::CPU_USAGE).Add(cpu, now);
+	series(Stat::MEM_USAGE).Add(rss, now);
+	series(Stat::AVG_FRAMETIME).Add(frameTime, now);
+	series(Stat::RENDER_LAG).Add(renderLag, now);
+	series(Stat::ENCODE_LAG).Add(encodeLag, now);
+	_streamInfo.Update(streamOutput, now, series(Stat::STREAM_BITRATE),
+			   series(Stat::STREAM_DROPPED_FRAMES),
+			   series(Stat::STREAM_MB_SENT));
+	_recordingInfo.Update(recordingOutput, now,
+			      series(Stat::RECORDING_BITRATE),
+			      series(Stat::RECORDING_DROPPED_FRAMES),
+			      series(Stat::RECORDING_MB_SENT));
+}
+
+} // namespace advss
@@ -0,0 +1,82 @@
+#pragma once
+#include "time-series.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <obs.hpp>
+#include <thread>
+#include <util/platform.h>
+
+namespace advss {
+
+// Periodically polls the OBS statistics on a background thread so that all
+// users share one consistent set of values instead of each of them querying
+// OBS and computing the rates on their own.
+// The sampler is running as long as any user holds a reference to it.
+class OBSStatsSampler {
+public:
+	~OBSStatsSampler();
+	static std::shared_ptr<OBSStatsSampler> Get();
+
+	enum class Stat {
+		FPS,
+		CPU_USAGE,
+		MEM_USAGE,
+		AVG_FRAMETIME,
+		RENDER_LAG,
+		ENCODE_LAG,
+		STREAM_DROPPED_FRAMES,
+		STREAM_BITRATE,
+		STREAM_MB_SENT,
+		RECORDING_DROPPED_FRAMES,
+		RECORDING_BITRATE,
+		RECORDING_MB_SENT,
+		LAST_STAT,
+	};
+
+	enum class Aggregation {
+		LATEST,
+		AVERAGE,
+		MINIMUM,
+		MAXIMUM,
+		PERCENTILE,
+	};
+
+	double GetValue(Stat, Aggregation, std::chrono::milliseconds window,
+			double percentile = 95.0);
+
+private:
+	OBSStatsSampler();
+	void Run();
+	void Sample();
+
+	struct OutputInfo {
+		void Update(obs_output_t *output,
+			    TimeSeries::Clock::time_point now,
+			    TimeSeries &bitrate, TimeSeries &droppedFrames,
+			    TimeSeries &mbSent);
+
+		uint64_t lastBytesSent = 0;
+		uint64_t lastBytesSentTime = 0;
+		int firstTotal = 0;
+		int firstDropped = 0;
+	};
+
+	std::atomic_bool _stop = {false};
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::thread _thread;
+
+	TimeSeries _series[static_cast<int>(Stat::LAST_STAT)];
+	os_cpu_usage_info_t *_cpuInfo = nullptr;
+	uint32_t _firstEncoded = 0xFFFFFFFF;
+	uint32_t _firstSkipped = 0xFFFFFFFF;
+	uint32_t _firstRendered = 0xFFFFFFFF;
+	uint32_t _firstLagged = 0xFFFFFFFF;
+	OutputInfo _streamInfo;
+	OutputInfo _recordingInfo;
+};
+
+} // namespace advss
@@ -0,0 +1,228 @@
+#pragma once
+#include "osc-parser.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace advss {
+
+// Maps OSC address patterns to values of type T.
+//
+// The patterns are split into their parts, so the cost of looking up the values
+// matching a received address depends on the number of parts of the address
+// and the number of patterns containing wildcards instead of the total number
+// of patterns.
+// An empty part, like in "/mixer//fader", matches any number of parts of an
+// address as defined by OSC 1.1.
+template<class T> class OSCAddressTrie {
+public:
+	// Returns the value of the pattern and inserts it if necessary
+	T &Get(std::string_view pattern);
+	void Remove(std::string_view pattern);
+	void RemoveIf(const std::function<bool(T &)> &predicate);
+	// Calls the callback once for every value whose pattern matches the
+	// given address
+	void Match(std::string_view address,
+		   const std::function<void(T &)> &callback);
+	bool Empty() const { return _root.Empty(); }
+
+private:
+	struct Node {
+		// Parts without wildcards can be looked up directly
+		std::map<std::string, std::unique_ptr<Node>, std::less<>>
+			literals;
+		std::vector<std::pair<std::string, std::unique_ptr<Node>>>
+			patterns;
+		std::unique_ptr<Node> anyParts;
+		std::unique_ptr<T> value;
+
+		bool Empty() const
+		{
+			return literals.empty() && patterns.empty() &&
+			       !anyParts && !value;
+		}
+		Node *GetChild(std::string_view part, bool create);
+		bool RemoveIf(const std::function<bool(T &)> &predicate);
+		void Match(std::string_view address,
+			   const std::function<void(T &)> &callback,
+			   std::vector<const T *> &matched);
+	};
+
+	static bool NextPart(std::string_view &address, std::string_view &part);
+
+	Node _root;
+};
+
+template<class T>
+inline bool OSCAddressTrie<T>::NextPart(std::string_view &address,
+					std::string_view &part)
+{
+	if (address.empty() || address[0] != '/') {
+		return false;
+	}
+	address.remove_prefix(1);
+	const auto end = address.find('/');
+	part = address.substr(0, end);
+	address.remove_prefix(
+		end == std::string_view::npos ? address.size() : end);
+	return true;
+}
+
+template<class T>
+inline typename OSCAddressTrie<T>::Node *
+OSCAddressTrie<T>::Node::GetChild(std::string_view part, bool create)
+{
+	if (part.empty()) {
+		if (!anyParts && create) {
+			anyParts = std::make_unique<Node>();
+		}
+		return anyParts.get();
+	}
+
+	if (!IsOSCAddressPattern(part)) {
+		auto it = literals.find(part);
+		if (it != literals.end()) {
+			return it->second.get();
+		}
+		if (!create) {
+			return nullptr;
+		}
+		auto &child = literals[std::string(part)];
+		child = std::make_unique<Node>();
+		return child.get();
+	}
+
+	for (auto &[pattern, child] : patterns) {
+		if (pattern == part) {
+			return child.get();
+		}
+	}
+	if (!create) {
+		return nullptr;
+	}
+	patterns.emplace_back(std::string(part), std::make_unique<Node>());
+	return patterns.back().second.get();
+}
+
+template<class T> inline T &OSCAddressTrie<T>::Get(std::string_view pattern)
+{
+	Node *node = &_root;
+	std::string_view part;
+	while (NextPart(pattern, part)) {
+		node = node->GetChild(part, true);
+	}
+	if (!node->value) {
+		node->value = std::make_unique<T>();
+	}
+	return *node->value;
+}
+
+template<class T>
+inline void OSCAddressTrie<T>::Remove(std::string_view pattern)
+{
+	Node *node = &_root;
+	std::string_view part;
+	while (node && NextPart(pattern, part)) {
+		node = node->GetChild(part, false);
+	}
+	if (!node) {
+		return;
+	}
+	node->value.reset();
+	// Prune the nodes which are no longer needed
+	_root.RemoveIf([](T &) { return false; });
+}
+
+template<class T>
+inline bool
+OSCAddressTrie<T>::Node::RemoveIf(const std::function<bool(T &)> &predicate)
+{
+	if (value && predicate(*value)) {
+		value.reset();
+	}
+	for (auto it = literals.begin(); it != literals.end();) {
+		if (it->second->RemoveIf(predicate)) {
+			it = literals.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (auto it = patterns.begin(); it != patterns.end();) {
+		if (it->second->RemoveIf(predicate)) {
+			it = patterns.erase(it);
+		} else {
+			++it;
+		}
+	}
+	if (anyParts && anyParts->RemoveIf(predicate)) {
+		anyParts.reset();
+	}
+	return Empty();
+}
+
+template<class T>
+inline void
+OSCAddressTrie<T>::RemoveIf(const std::function<bool(T &)> &predicate)
+{
+	_root.RemoveIf(predicate);
+}
+
+template<class T>
+inline void
+OSCAddressTrie<T>::Node::Match(std::string_view address,
+			       const std::function<void(T &)> &callback,
+			       std::vector<const T *> &matched)
+{
+	if (anyParts) {
+		// Try to continue matching at every remaining part
+		for (auto rest = address;;) {
+			anyParts->Match(rest, callback, matched);
+			std::string_view part;
+			if (!NextPart(rest, part)) {
+				break;
+			}
+		}
+	}
+
+	std::string_view part;
+	auto rest = address;
+	if (!NextPart(rest, part)) {
+		if (!address.empty() || !value) {
+			return;
+		}
+		// Patterns containing "//" can reach the same node on
+		// multiple paths, but each value is only reported once
+		for (const auto *value_ : matched) {
+			if (value_ == value.get()) {
+				return;
+			}
+		}
+		matched.emplace_back(value.get());
+		callback(*value);
+		return;
+	}
+
+	auto it = literals.find(part);
+	if (it != literals.end()) {
+		it->second->Match(rest, callback, matched);
+	}
+	for (auto &[pattern, child] : patterns) {
+		if (MatchOSCAddressPart(pattern, part)) {
+			child->Match(rest, callback, matched);
+		}
+	}
+}
+
+template<class T>
+inline void OSCAddressTrie<T>::Match(std::string_view address,
+				     const std::function<void(T &)> &callback)
+{
+	std::vector<const T *> matched;
+	_root.Match(address, callback, matched);
+}
+
+} // namespace advss
@@ -0,0 +1,64 @@
+#include "osc-encoder.hpp"
+
+#include <cstring>
+
+namespace advss {
+
+static void appendUInt32(std::vector<char> &buffer, uint32_t value)
+{
+	buffer.push_back(static_cast<char>(value >> 24));
+	buffer.push_back(static_cast<char>(value >> 16));
+	buffer.push_back(static_cast<char>(value >> 8));
+	buffer.push_back(static_cast<char>(value));
+}
+
+// Appends the data and pads it with zeros to a multiple of four bytes
+static void appendPadded(std::vector<char> &buffer, const char *data,
+			 size_t size, bool nullTerminated)
+{
+	buffer.insert(buffer.end(), data, data + size);
+	size_t padding = 4 - (size & 0x3);
+	if (padding == 4 && !nullTerminated) {
+		padding = 0;
+	}
+	buffer.insert(buffer.end(), padding, '\0');
+}
+
+void AppendOSCInt32(std::vector<char> &buffer, int32_t value)
+{
+	appendUInt32(buffer, static_cast<uint32_t>(value));
+}
+
+void AppendOSCFloat(std::vector<char> &buffer, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	appendUInt32(buffer, bits);
+}
+
+void AppendOSCString(std::vector<char> &buffer, const std::string &value)
+{
+	appendPadded(buffer, value.c_str(), strlen(value.c_str()), true);
+}
+
+void AppendOSCBlob(std::vector<char> &buffer, const std::vector<char> &value)
+{
+	appendUInt32(buffer, static_cast<uint32_t>(value.size()));
+	appendPadded(buffer, value.data(), value.size(), false);
+}
+
+void EncodeOSCBundle(const std::vector<std::vector<char>> &messages,
+		     std::vector<char> &buffer)
+{
+	buffer.clear();
+	AppendOSCString(buffer, "#bundle");
+	// The time tag 1 means that the bundle is to be processed immediately
+	appendUInt32(buffer, 0);
+	appendUInt32(buffer, 1);
+	for (const auto &message : messages) {
+		appendUInt32(buffer, static_cast<uint32_t>(message.size()));
+		buffer.insert(buffer.end(), message.begin(), message.end());
+	}
+}
+
+} // namespace advss
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace advss {
+
+// Functions appending the values of OSC messages to a buffer.
+//
+// Strings and blobs are padded with zeros to a multiple of four bytes, so the
+// values following them remain aligned.
+void AppendOSCInt32(std::vector<char> &buffer, int32_t value);
+void AppendOSCFloat(std::vector<char> &buffer, float value);
+// Only the part up to the first null character is appended
+void AppendOSCString(std::vector<char> &buffer, const std::string &value);
+void AppendOSCBlob(std::vector<char> &buffer, const std::vector<char> &value);
+
+// Combines multiple encoded messages into a single OSC bundle, which is to be
+// processed immediately by the receiver
+void EncodeOSCBundle(const std::vector<std::vector<char>> &messages,
+		     std::vector<char> &buffer);
+
+} // namespace advss
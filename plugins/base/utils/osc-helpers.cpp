@@ -1,17 +1,12 @@
 #include "osc-helpers.hpp"
+#include "osc-encoder.hpp"
 #include "log-helper.hpp"
 #include "obs-module-helper.hpp"
 #include "ui-helpers.hpp"
 
 #include <QGroupBox>
 #include <QLayout>
-#include <string.h>
-
-#ifdef WIN32
-#include <winsock.h>
-#else
-#include <arpa/inet.h>
-#endif
+#include <cstring>
 
 namespace advss {
 
@@ -29,63 +24,33 @@ std::unordered_map<size_t, OSCMessageElement::TypeInfo>
 		{7, {"AdvSceneSwitcher.osc.message.type.null", "N"}},
 };
 
-// Based on https://github.com/mhroth/tinyosc
-struct FillMessageElementBufferVisitor {
+struct AppendMessageElementVisitor {
 	std::vector<char> &buffer;
-	uint32_t &curOffset;
 
 	bool success = false;
 
 	void operator()(const StringVariable &value)
 	{
-		std::string string = value;
-		int length = (int)strlen(string.c_str());
-		if (curOffset + length >= buffer.size()) {
-			buffer.resize(curOffset + length + 1);
-		}
-		strncpy(buffer.data() + curOffset, string.c_str(),
-			buffer.size() - curOffset - length);
-		curOffset = (curOffset + 4 + length) & ~0x3;
+		AppendOSCString(buffer, value);
 		success = true;
 	}
 	void operator()(const IntVariable &value)
 	{
-		if (curOffset + 4 > buffer.size()) {
-			buffer.resize(curOffset + 4);
-		}
-		int32_t k = value;
-		*((uint32_t *)(buffer.data() + curOffset)) = htonl(k);
-		curOffset += 4;
+		AppendOSCInt32(buffer, value);
 		success = true;
 	}
 	void operator()(const DoubleVariable &value)
 	{
-		if (curOffset + 4 > buffer.size()) {
-			buffer.resize(curOffset + 4);
-		}
-		const float f = value;
-		*((uint32_t *)(buffer.data() + curOffset)) =
-			htonl(*((uint32_t *)&f));
-		curOffset += 4;
+		AppendOSCFloat(buffer, static_cast<float>(value.GetValue()));
 		success = true;
 	}
 	void operator()(const OSCBlob &value)
 	{
-		if (curOffset + 4 > buffer.size()) {
-			buffer.resize(curOffset + 4);
-		}
 		auto blob = value.GetBinary();
 		if (!blob.has_value()) {
 			return;
 		}
-		if (curOffset + 4 + blob->size() > buffer.size()) {
-			buffer.resize(curOffset + 4 + blob->size());
-		}
-		*((uint32_t *)(buffer.data() + curOffset)) =
-			htonl(blob->size());
-		curOffset += 4;
-		memcpy(buffer.data() + curOffset, blob->data(), blob->size());
-		curOffset = (curOffset + 3 + blob->size()) & ~0x3;
+		AppendOSCBlob(buffer, *blob);
 		success = true;
 	}
 	void operator()(const OSCTrue &) { success = true; }
@@ -94,6 +59,14 @@ struct FillMessageElementBufferVisitor {
 	void operator()(const OSCNull &) { success = true; }
 };
 
+static bool appendMessageElement(std::vector<char> &buffer,
+				 const OSCMessageElement &element)
+{
+	AppendMessageElementVisitor visitor{buffer};
+	std::visit(visitor, element.GetValue());
+	return visitor.success;
+}
+
 OSCBlob::OSCBlob(const std::string &stringRepresentation)
 	: _stringRep(stringRepresentation)
 {
@@ -109,6 +82,11 @@ std::string OSCBlob::GetStringRepresentation() const
 	return _stringRep;
 }
 
+const std::string &OSCBlob::GetUnresolvedStringRepresentation() const
+{
+	return _stringRep.UnresolvedValue();
+}
+
 std::optional<std::vector<char>> OSCBlob::GetBinary() const
 {
 	std::vector<char> bytes;
@@ -165,53 +143,106 @@ void OSCNull::Save(obs_data_t *obj, const char *name) const
 	obs_data_set_bool(obj, name, true);
 }
 
-std::optional<std::vector<char>> OSCMessage::GetBuffer() const
+OSCMessage::OSCMessage(const OSCMessage &other)
+	: _address(other._address),
+	  _elements(other._elements)
 {
-	if (std::string(_address).empty()) {
-		return {};
-	}
+}
+
+OSCMessage &OSCMessage::operator=(const OSCMessage &other)
+{
+	// The encoded message is not copied as it might be modified while the
+	// other message is sent
+	std::lock_guard<std::mutex> lock(_mutex);
+	_address = other._address;
+	_elements = other._elements;
+	_encoded.clear();
+	_dynamicElements.clear();
+	return *this;
+}
 
-	std::vector<char> buffer(128, 0);
-	uint32_t currentOffset = (uint32_t)strlen(_address.c_str());
-	if (currentOffset > buffer.size()) {
-		buffer.resize(buffer.size() * 2);
+bool OSCMessage::EncodeAll() const
+{
+	_encoded.clear();
+	_dynamicElements.clear();
+	_encodedAddress = _address;
+	if (_encodedAddress.empty()) {
+		return false;
 	}
-	strncpy(buffer.data(), _address.c_str(), buffer.size());
-	currentOffset = (currentOffset + 4) & ~0x3;
 
-	std::string typeTags;
+	AppendOSCString(_encoded, _encodedAddress);
+
+	std::string typeTags = ",";
 	for (const auto &e : _elements) {
 		typeTags += e.GetTypeTag();
 	}
+	AppendOSCString(_encoded, typeTags);
 
-	buffer.at(currentOffset++) = ',';
-	int length = (int)strlen(typeTags.c_str());
-	if (currentOffset + length >= buffer.size()) {
-		buffer.resize(buffer.size() * 2);
+	for (size_t i = 0; i < _elements.size(); i++) {
+		const auto offset = _encoded.size();
+		if (!appendMessageElement(_encoded, _elements[i])) {
+			_encoded.clear();
+			_dynamicElements.clear();
+			return false;
+		}
+		if (_elements[i].IsVariableBound()) {
+			_dynamicElements.push_back(
+				{i, offset, _encoded.size() - offset});
+		}
 	}
-	strncpy(buffer.data() + currentOffset, typeTags.c_str(),
-		buffer.size() - currentOffset - length);
-	currentOffset = (currentOffset + 4 + length) & ~0x3;
+	return true;
+}
 
-	for (const auto &e : _elements) {
-		const auto &value = e._value;
-		FillMessageElementBufferVisitor visitor{buffer, currentOffset};
-		std::visit(visitor, value);
-		if (!visitor.success) {
-			return {};
+bool OSCMessage::PatchDynamicElements() const
+{
+	for (const auto &element : _dynamicElements) {
+		_patchBuffer.clear();
+		if (!appendMessageElement(_patchBuffer,
+					  _elements[element.index])) {
+			return false;
 		}
+		// Values which changed their encoded size, e.g. longer strings,
+		// require the message to be encoded again
+		if (_patchBuffer.size() != element.size) {
+			return EncodeAll();
+		}
+		memcpy(_encoded.data() + element.offset, _patchBuffer.data(),
+		       element.size);
 	}
+	return true;
+}
 
-	buffer.resize(currentOffset);
-	return buffer;
+bool OSCMessage::Encode(std::vector<char> &buffer) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// Only the elements bound to variables are updated if the message was
+	// already encoded before
+	const bool addressChanged =
+		_address.UnresolvedValue().find("${") != std::string::npos &&
+		std::string(_address) != _encodedAddress;
+	bool success = false;
+	if (_encoded.empty() || addressChanged) {
+		success = EncodeAll();
+	} else {
+		success = PatchDynamicElements();
+	}
+	if (!success) {
+		_encoded.clear();
+		return false;
+	}
+	buffer = _encoded;
+	return true;
 }
 
 void OSCMessage::ResolveVariables()
 {
+	std::lock_guard<std::mutex> lock(_mutex);
 	_address.ResolveVariables();
 	for (auto &element : _elements) {
 		element.ResolveVariables();
 	}
+	_encoded.clear();
 }
 
 const char *OSCMessageElement::GetTypeTag() const
@@ -229,6 +260,27 @@ const char *OSCMessageElement::GetTypeTag(const OSCMessageElement &element)
 	return _typeNames.at(element._value.index()).tag;
 }
 
+bool OSCMessageElement::IsVariableBound() const
+{
+	return std::visit(
+		[](auto &&arg) -> bool {
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, IntVariable> ||
+				      std::is_same_v<T, DoubleVariable>) {
+				return !arg.IsFixedType();
+			} else if constexpr (std::is_same_v<T, StringVariable>) {
+				return arg.UnresolvedValue().find("${") !=
+				       std::string::npos;
+			} else if constexpr (std::is_same_v<T, OSCBlob>) {
+				return arg.GetUnresolvedStringRepresentation()
+					       .find("${") != std::string::npos;
+			} else {
+				return false;
+			}
+		},
+		_value);
+}
+
 void OSCMessageElement::ResolveVariables()
 {
 	std::visit(
@@ -350,9 +402,11 @@ void OSCMessage::Save(obs_data_t *obj) const
 void OSCMessage::Load(obs_data_t *obj)
 {
 
+	std::lock_guard<std::mutex> lock(_mutex);
 	auto data = obs_data_get_obj(obj, "oscMessage");
 	_address.Load(data, "address");
 	_elements.clear();
+	_encoded.clear();
 	auto elements = obs_data_get_array(data, "elements");
 	size_t count = obs_data_array_count(elements);
 	for (size_t i = 0; i < count; i++) {
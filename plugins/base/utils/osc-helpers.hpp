@@ -5,6 +5,7 @@
 #include "variable-line-edit.hpp"
 #include "variable-spinbox.hpp"
 
+#include <mutex>
 #include <variant>
 #include <unordered_map>
 
@@ -16,6 +17,7 @@ public:
 	OSCBlob(const std::string &stringRepresentation);
 	void SetStringRepresentation(const StringVariable &);
 	std::string GetStringRepresentation() const;
+	const std::string &GetUnresolvedStringRepresentation() const;
 	std::optional<std::vector<char>> GetBinary() const;
 	void Save(obs_data_t *obj, const char *name) const;
 	void Load(obs_data_t *obj, const char *name);
@@ -64,11 +66,18 @@ public:
 	void Save(obs_data_t *obj) const;
 	void Load(obs_data_t *obj);
 
+	using Value = std::variant<IntVariable, DoubleVariable, StringVariable,
+				   OSCBlob, OSCTrue, OSCFalse, OSCInfinity,
+				   OSCNull>;
+
 	std::string ToString() const;
 	const char *GetTypeName() const;
 	const char *GetTypeTag() const;
 	static const char *GetTypeName(const OSCMessageElement &);
 	static const char *GetTypeTag(const OSCMessageElement &);
+	const Value &GetValue() const { return _value; }
+	// Returns true if the value of the element depends on variables
+	bool IsVariableBound() const;
 
 	void ResolveVariables();
 
@@ -78,9 +87,7 @@ private:
 	};
 	static std::unordered_map<size_t, TypeInfo> _typeNames;
 
-	std::variant<IntVariable, DoubleVariable, StringVariable, OSCBlob,
-		     OSCTrue, OSCFalse, OSCInfinity, OSCNull>
-		_value;
+	Value _value;
 
 	friend class OSCMessage;
 	friend class OSCMessageElementEdit;
@@ -88,20 +95,44 @@ private:
 
 class OSCMessage {
 public:
+	OSCMessage() = default;
+	OSCMessage(const OSCMessage &);
+	OSCMessage &operator=(const OSCMessage &);
+
 	void Save(obs_data_t *obj) const;
 	void Load(obs_data_t *obj);
 
 	std::string ToString() const;
-	std::optional<std::vector<char>> GetBuffer() const;
+	// Encodes the message into the buffer and returns false if it could
+	// not be encoded.
+	// The message is only encoded completely on the first call and only the
+	// elements bound to variables are updated afterwards.
+	bool Encode(std::vector<char> &buffer) const;
 
 	void ResolveVariables();
 
 private:
+	bool EncodeAll() const;
+	bool PatchDynamicElements() const;
+
 	StringVariable _address = "/address";
 	std::vector<OSCMessageElement> _elements = {
 		OSCMessageElement("example"),
 		OSCMessageElement(IntVariable(3))};
 
+	struct DynamicElement {
+		size_t index;
+		size_t offset;
+		size_t size;
+	};
+	mutable std::vector<char> _encoded;
+	mutable std::string _encodedAddress;
+	mutable std::vector<DynamicElement> _dynamicElements;
+	mutable std::vector<char> _patchBuffer;
+	// Guards the encoded message, as the same message might be sent by
+	// multiple threads at once
+	mutable std::mutex _mutex;
+
 	friend class OSCMessageEdit;
 };
 
@@ -0,0 +1,450 @@
+#include "osc-parser.hpp"
+
+#include <cstring>
+
+namespace advss {
+
+// Nested bundles are rare, so this only guards against malicious packets
+static constexpr int maxBundleDepth = 8;
+static constexpr std::string_view bundleTag("#bundle\0", 8);
+
+static uint32_t readUInt32(const char *data)
+{
+	const auto bytes = reinterpret_cast<const unsigned char *>(data);
+	return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) |
+	       (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+static uint64_t readUInt64(const char *data)
+{
+	return (uint64_t(readUInt32(data)) << 32) | readUInt32(data + 4);
+}
+
+// Reads a null terminated string, which is padded to a multiple of four bytes,
+// and returns the number of bytes it occupies or zero if it is malformed
+static size_t readPaddedString(std::string_view data, size_t offset,
+			       std::string_view &result)
+{
+	if (offset >= data.size()) {
+		return 0;
+	}
+	const auto end = data.find('\0', offset);
+	if (end == std::string_view::npos) {
+		return 0;
+	}
+	const size_t size = ((end - offset) + 4) & ~size_t(3);
+	if (offset + size > data.size()) {
+		return 0;
+	}
+	result = data.substr(offset, end - offset);
+	return size;
+}
+
+// Returns the number of bytes the argument occupies or zero if it is malformed
+static size_t readArgument(std::string_view data, size_t offset, char type,
+			   OSCArgument &argument)
+{
+	argument.type = type;
+	argument.value = std::monostate();
+	const size_t remaining =
+		offset <= data.size() ? data.size() - offset : 0;
+	const char *value = data.data() + offset;
+
+	switch (type) {
+	case 'i':
+	case 'c':
+	case 'r':
+		if (remaining < 4) {
+			return 0;
+		}
+		argument.value = static_cast<int32_t>(readUInt32(value));
+		return 4;
+	case 'f': {
+		if (remaining < 4) {
+			return 0;
+		}
+		const uint32_t bits = readUInt32(value);
+		float f;
+		memcpy(&f, &bits, sizeof(f));
+		argument.value = f;
+		return 4;
+	}
+	case 'm':
+		if (remaining < 4) {
+			return 0;
+		}
+		argument.value = data.substr(offset, 4);
+		return 4;
+	case 'h':
+	case 't':
+		if (remaining < 8) {
+			return 0;
+		}
+		argument.value = static_cast<int64_t>(readUInt64(value));
+		return 8;
+	case 'd': {
+		if (remaining < 8) {
+			return 0;
+		}
+		const uint64_t bits = readUInt64(value);
+		double d;
+		memcpy(&d, &bits, sizeof(d));
+		argument.value = d;
+		return 8;
+	}
+	case 's':
+	case 'S': {
+		std::string_view string;
+		const auto size = readPaddedString(data, offset, string);
+		argument.value = string;
+		return size;
+	}
+	case 'b': {
+		if (remaining < 4) {
+			return 0;
+		}
+		const size_t blobSize = readUInt32(value);
+		const size_t size = 4 + ((blobSize + 3) & ~size_t(3));
+		if (blobSize > remaining || size > remaining) {
+			return 0;
+		}
+		argument.value = data.substr(offset + 4, blobSize);
+		return size;
+	}
+	case 'T':
+	case 'F':
+	case 'N':
+	case 'I':
+	case '[':
+	case ']':
+		// Arguments without data do not occupy any bytes, so the
+		// caller cannot tell them apart from malformed ones by size
+		return SIZE_MAX;
+	default:
+		return 0;
+	}
+}
+
+bool ParseOSCMessage(std::string_view data, OSCMessageView &message)
+{
+	std::string_view address;
+	size_t offset = readPaddedString(data, 0, address);
+	if (offset == 0 || address.empty() || address[0] != '/') {
+		return false;
+	}
+
+	std::string_view typeTags;
+	if (offset < data.size()) {
+		const auto size = readPaddedString(data, offset, typeTags);
+		if (size == 0 || typeTags.empty() || typeTags[0] != ',') {
+			return false;
+		}
+		typeTags.remove_prefix(1);
+		offset += size;
+	}
+
+	// Validate all arguments up front
+	const auto arguments = data.substr(offset);
+	size_t argumentOffset = 0;
+	for (const char type : typeTags) {
+		OSCArgument argument;
+		const auto size =
+			readArgument(arguments, argumentOffset, type, argument);
+		if (size == 0) {
+			return false;
+		}
+		if (size != SIZE_MAX) {
+			argumentOffset += size;
+		}
+	}
+
+	message._address = address;
+	message._typeTags = typeTags;
+	message._arguments = arguments.substr(0, argumentOffset);
+	return true;
+}
+
+static bool parseOSCPacket(std::string_view packet,
+			   const OSCMessageHandler &handler, int depth)
+{
+	if (packet.size() < 4 || (packet.size() & 0x3) != 0) {
+		return false;
+	}
+
+	if (packet[0] == '/') {
+		OSCMessageView message;
+		if (!ParseOSCMessage(packet, message)) {
+			return false;
+		}
+		handler(message);
+		return true;
+	}
+
+	if (packet.substr(0, bundleTag.size()) != bundleTag ||
+	    depth >= maxBundleDepth) {
+		return false;
+	}
+
+	// Skip bundle tag and time tag
+	size_t offset = bundleTag.size() + 8;
+	if (offset > packet.size()) {
+		return false;
+	}
+	while (offset < packet.size()) {
+		if (packet.size() - offset < 4) {
+			return false;
+		}
+		const size_t size = readUInt32(packet.data() + offset);
+		offset += 4;
+		if (size > packet.size() - offset) {
+			return false;
+		}
+		if (!parseOSCPacket(packet.substr(offset, size), handler,
+				    depth + 1)) {
+			return false;
+		}
+		offset += size;
+	}
+	return true;
+}
+
+bool ParseOSCPacket(std::string_view packet, const OSCMessageHandler &handler)
+{
+	return parseOSCPacket(packet, handler, 0);
+}
+
+void OSCMessageView::ForEachArgument(
+	const std::function<void(const OSCArgument &)> &callback) const
+{
+	size_t offset = 0;
+	OSCArgument argument;
+	for (const char type : _typeTags) {
+		const auto size = readArgument(_arguments, offset, type,
+					       argument);
+		if (size == 0) {
+			// Cannot happen, as messages are validated while
+			// parsing them
+			return;
+		}
+		if (size != SIZE_MAX) {
+			offset += size;
+		}
+		callback(argument);
+	}
+}
+
+std::string OSCMessageView::GetArgumentsString() const
+{
+	std::string result;
+	ForEachArgument([&result](const OSCArgument &argument) {
+		if (!result.empty()) {
+			result += ' ';
+		}
+		result += argument.ToString();
+	});
+	return result;
+}
+
+std::string OSCMessageView::ToString() const
+{
+	const auto arguments = GetArgumentsString();
+	if (arguments.empty()) {
+		return std::string(_address);
+	}
+	return std::string(_address) + " " + arguments;
+}
+
+static std::string_view rebase(std::string_view view, const char *from,
+			       const char *to)
+{
+	if (view.data() == nullptr) {
+		return view;
+	}
+	return std::string_view(to + (view.data() - from), view.size());
+}
+
+OSCMessageView OSCMessageView::Rebase(const char *from, const char *to) const
+{
+	OSCMessageView result;
+	result._address = rebase(_address, from, to);
+	result._typeTags = rebase(_typeTags, from, to);
+	result._arguments = rebase(_arguments, from, to);
+	return result;
+}
+
+OSCReceivedMessage::OSCReceivedMessage(const OSCMessageView &view)
+{
+	// All parts of a message are stored consecutively
+	const auto begin = view._address.data();
+	const auto end = view._arguments.data() + view._arguments.size();
+	_data.assign(begin, end);
+	_view = view.Rebase(begin, _data.data());
+}
+
+OSCReceivedMessage::OSCReceivedMessage(const OSCReceivedMessage &other)
+	: _data(other._data),
+	  _view(other._view.Rebase(other._data.data(), _data.data()))
+{
+}
+
+OSCReceivedMessage &
+OSCReceivedMessage::operator=(const OSCReceivedMessage &other)
+{
+	if (this != &other) {
+		_data = other._data;
+		_view = other._view.Rebase(other._data.data(), _data.data());
+	}
+	return *this;
+}
+
+static std::string toHexString(std::string_view data)
+{
+	static constexpr char digits[] = "0123456789abcdef";
+	std::string result;
+	result.reserve(data.size() * 4);
+	for (const char c : data) {
+		const auto byte = static_cast<unsigned char>(c);
+		result += "\\x";
+		result += digits[byte >> 4];
+		result += digits[byte & 0xF];
+	}
+	return result;
+}
+
+std::string OSCArgument::ToString() const
+{
+	switch (type) {
+	case 'b':
+	case 'm':
+		return toHexString(std::get<std::string_view>(value));
+	case 'T':
+		return "true";
+	case 'F':
+		return "false";
+	case 'N':
+		return "null";
+	case 'I':
+		return "infinity";
+	case '[':
+		return "[";
+	case ']':
+		return "]";
+	default:
+		break;
+	}
+
+	return std::visit(
+		[](auto &&arg) -> std::string {
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, std::monostate>) {
+				return "";
+			} else if constexpr (std::is_same_v<
+						     T, std::string_view>) {
+				return std::string(arg);
+			} else {
+				return std::to_string(arg);
+			}
+		},
+		value);
+}
+
+static bool matchCharacterSet(std::string_view set, char c)
+{
+	bool negate = false;
+	if (!set.empty() && set[0] == '!') {
+		negate = true;
+		set.remove_prefix(1);
+	}
+
+	bool matched = false;
+	for (size_t i = 0; i < set.size(); ++i) {
+		if (i + 2 < set.size() && set[i + 1] == '-') {
+			matched |= set[i] <= c && c <= set[i + 2];
+			i += 2;
+			continue;
+		}
+		matched |= set[i] == c;
+	}
+	return matched != negate;
+}
+
+bool MatchOSCAddressPart(std::string_view pattern, std::string_view part)
+{
+	while (!pattern.empty()) {
+		switch (pattern[0]) {
+		case '?':
+			if (part.empty()) {
+				return false;
+			}
+			break;
+		case '*':
+			// Collapse consecutive wildcards
+			while (!pattern.empty() && pattern[0] == '*') {
+				pattern.remove_prefix(1);
+			}
+			if (pattern.empty()) {
+				return true;
+			}
+			for (size_t i = 0; i <= part.size(); ++i) {
+				if (MatchOSCAddressPart(pattern,
+							part.substr(i))) {
+					return true;
+				}
+			}
+			return false;
+		case '[': {
+			const auto end = pattern.find(']', 1);
+			if (end == std::string_view::npos) {
+				return false;
+			}
+			if (part.empty() ||
+			    !matchCharacterSet(pattern.substr(1, end - 1),
+					       part[0])) {
+				return false;
+			}
+			pattern.remove_prefix(end + 1);
+			part.remove_prefix(1);
+			continue;
+		}
+		case '{': {
+			const auto end = pattern.find('}', 1);
+			if (end == std::string_view::npos) {
+				return false;
+			}
+			const auto rest = pattern.substr(end + 1);
+			auto alternatives = pattern.substr(1, end - 1);
+			for (;;) {
+				const auto comma = alternatives.find(',');
+				const auto alternative =
+					alternatives.substr(0, comma);
+				if (part.substr(0, alternative.size()) ==
+					    alternative &&
+				    MatchOSCAddressPart(
+					    rest,
+					    part.substr(alternative.size()))) {
+					return true;
+				}
+				if (comma == std::string_view::npos) {
+					return false;
+				}
+				alternatives.remove_prefix(comma + 1);
+			}
+		}
+		default:
+			if (part.empty() || pattern[0] != part[0]) {
+				return false;
+			}
+			break;
+		}
+		pattern.remove_prefix(1);
+		part.remove_prefix(1);
+	}
+	return part.empty();
+}
+
+bool IsOSCAddressPattern(std::string_view address)
+{
+	return address.find_first_of("?*[]{}") != std::string_view::npos;
+}
+
+} // namespace advss
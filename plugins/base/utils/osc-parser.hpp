@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace advss {
+
+// Argument of a received OSC message.
+//
+// Strings, symbols, blobs and MIDI messages reference the packet the argument
+// was parsed from.
+// Arguments without a value, like "T" or "N", only consist of their type tag.
+struct OSCArgument {
+	char type = '\0';
+	std::variant<std::monostate, int32_t, int64_t, float, double,
+		     std::string_view>
+		value;
+
+	// Uses the same representation as the values entered for the OSC
+	// action, e.g. "\x01\x02" for blobs
+	std::string ToString() const;
+};
+
+// Message within a received OSC packet.
+//
+// The views reference the packet the message was parsed from and are only
+// valid as long as the packet is.
+// Messages are validated completely while parsing the packet, so iterating
+// over the arguments of a message cannot fail.
+class OSCMessageView {
+public:
+	std::string_view GetAddress() const { return _address; }
+	// Type tags of the arguments without the leading ','
+	std::string_view GetTypeTags() const { return _typeTags; }
+	size_t GetArgumentCount() const { return _typeTags.size(); }
+	void ForEachArgument(const std::function<void(const OSCArgument &)> &)
+		const;
+	// Space separated string representation of all arguments
+	std::string GetArgumentsString() const;
+	std::string ToString() const;
+
+	// Returns a view with all references moved from one copy of the data
+	// to another copy of it
+	OSCMessageView Rebase(const char *from, const char *to) const;
+
+private:
+	std::string_view _address;
+	std::string_view _typeTags;
+	std::string_view _arguments;
+
+	friend bool ParseOSCMessage(std::string_view, OSCMessageView &);
+	friend class OSCReceivedMessage;
+};
+
+// Copy of a received message, which remains valid after the packet it was
+// received in was discarded
+class OSCReceivedMessage {
+public:
+	explicit OSCReceivedMessage(const OSCMessageView &);
+	OSCReceivedMessage(const OSCReceivedMessage &);
+	OSCReceivedMessage &operator=(const OSCReceivedMessage &);
+
+	const OSCMessageView &GetView() const { return _view; }
+
+private:
+	std::string _data;
+	OSCMessageView _view;
+};
+
+using OSCMessageHandler = std::function<void(const OSCMessageView &)>;
+
+// Calls the handler for every message contained in the packet, including the
+// messages of nested bundles, without allocating any memory.
+// The time tags of bundles are ignored and all messages are handled right away.
+// Returns false if the packet is malformed, in which case the handler might
+// still have been called for the valid messages preceding the malformed part.
+bool ParseOSCPacket(std::string_view packet, const OSCMessageHandler &);
+bool ParseOSCMessage(std::string_view data, OSCMessageView &);
+
+// Returns true if a single part of an address, so the part between two '/',
+// matches the given part of an OSC address pattern.
+// Supports the wildcards "?", "*", "[abc]", "[a-z]", "[!abc]" and "{foo,bar}".
+bool MatchOSCAddressPart(std::string_view pattern, std::string_view part);
+bool IsOSCAddressPattern(std::string_view);
+
+} // namespace advss
@@ -0,0 +1,415 @@
+#include "osc-receiver.hpp"
+#include "log-helper.hpp"
+#include "message-dispatcher.hpp"
+#include "osc-address-trie.hpp"
+
+#include <algorithm>
+#include <asio.hpp>
+#include <cstring>
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+// Larger packets cannot be sent via UDP anyway
+static constexpr size_t maxPacketSize = 65536;
+static constexpr size_t minReadSize = 4096;
+
+static asio::io_context ioContext;
+static std::optional<asio::executor_work_guard<asio::io_context::executor_type>>
+	workGuard;
+static std::thread ioThread;
+
+std::mutex OSCReceiver::_mutex;
+std::map<std::string, std::weak_ptr<OSCReceiver::ListenerRef>>
+	OSCReceiver::_listeners;
+bool OSCReceiver::_running = false;
+
+// All members except for the dispatchers are only accessed by the receive
+// thread once the listener was opened
+class OSCReceiver::Listener : public std::enable_shared_from_this<Listener> {
+public:
+	Listener(Protocol protocol, int port);
+	bool Open();
+	bool IsOpen() const;
+	// Must only be called by the receive thread or while it is stopped
+	void CloseSockets();
+	OSCMessageBuffer RegisterClient(const std::string &addressPattern,
+					size_t capacity);
+	void HandlePacket(std::string_view packet);
+
+private:
+	void ReceiveUDP();
+	void AcceptTCP();
+	void Dispatch(const OSCMessageView &);
+
+	const Protocol _protocol;
+	const int _port;
+	const OSCMessageHandler _dispatch;
+	asio::ip::udp::socket _udpSocket;
+	asio::ip::tcp::acceptor _acceptor;
+	std::vector<char> _udpBuffer;
+	std::vector<std::weak_ptr<Session>> _sessions;
+
+	std::mutex _mutex;
+	OSCAddressTrie<MessageDispatcher<OSCReceivedMessage>> _dispatchers;
+};
+
+// Splits the TCP stream of a single client into packets
+class OSCReceiver::Session : public std::enable_shared_from_this<Session> {
+public:
+	Session(asio::ip::tcp::socket &&, const std::shared_ptr<Listener> &);
+	void Read();
+	void Close();
+
+private:
+	// Returns false if the stream is malformed
+	bool HandlePackets();
+
+	asio::ip::tcp::socket _socket;
+	const std::shared_ptr<Listener> _listener;
+	std::vector<char> _buffer;
+	size_t _size = 0;
+};
+
+// Closes the listener once the last buffer registered for it was released
+struct OSCReceiver::ListenerRef {
+	ListenerRef(const std::shared_ptr<Listener> &listener_)
+		: listener(listener_)
+	{
+	}
+	~ListenerRef();
+
+	const std::shared_ptr<Listener> listener;
+};
+
+OSCReceiver::Listener::Listener(Protocol protocol, int port)
+	: _protocol(protocol),
+	  _port(port),
+	  _dispatch([this](const OSCMessageView &message) {
+		  Dispatch(message);
+	  }),
+	  _udpSocket(ioContext),
+	  _acceptor(ioContext)
+{
+}
+
+bool OSCReceiver::Listener::Open()
+{
+	asio::error_code ec;
+	const auto port = static_cast<unsigned short>(_port);
+	if (_protocol == Protocol::UDP) {
+		_udpSocket.open(asio::ip::udp::v4(), ec);
+		if (!ec) {
+			_udpSocket.bind({asio::ip::udp::v4(), port}, ec);
+		}
+	} else {
+		_acceptor.open(asio::ip::tcp::v4(), ec);
+		if (!ec) {
+			_acceptor.set_option(
+				asio::ip::tcp::acceptor::reuse_address(true),
+				ec);
+		}
+		if (!ec) {
+			_acceptor.bind({asio::ip::tcp::v4(), port}, ec);
+		}
+		if (!ec) {
+			_acceptor.listen(
+				asio::socket_base::max_listen_connections, ec);
+		}
+	}
+
+	if (ec) {
+		blog(LOG_WARNING, "failed to listen for OSC messages on %s %d: %s",
+		     _protocol == Protocol::UDP ? "UDP" : "TCP", _port,
+		     ec.message().c_str());
+		CloseSockets();
+		return false;
+	}
+
+	asio::post(ioContext, [self = shared_from_this()]() {
+		if (self->_protocol == Protocol::UDP) {
+			self->_udpBuffer.resize(maxPacketSize);
+			self->ReceiveUDP();
+		} else {
+			self->AcceptTCP();
+		}
+	});
+	return true;
+}
+
+bool OSCReceiver::Listener::IsOpen() const
+{
+	return _udpSocket.is_open() || _acceptor.is_open();
+}
+
+void OSCReceiver::Listener::CloseSockets()
+{
+	asio::error_code ec;
+	_udpSocket.close(ec);
+	_acceptor.close(ec);
+	for (const auto &weakSession : _sessions) {
+		if (auto session = weakSession.lock()) {
+			session->Close();
+		}
+	}
+	_sessions.clear();
+}
+
+void OSCReceiver::Listener::ReceiveUDP()
+{
+	_udpSocket.async_receive(
+		asio::buffer(_udpBuffer),
+		[self = shared_from_this()](const asio::error_code &ec,
+					    size_t size) {
+			if (!self->_udpSocket.is_open()) {
+				return;
+			}
+			if (!ec) {
+				self->HandlePacket(std::string_view(
+					self->_udpBuffer.data(), size));
+			}
+			self->ReceiveUDP();
+		});
+}
+
+void OSCReceiver::Listener::AcceptTCP()
+{
+	_acceptor.async_accept([self = shared_from_this()](
+				       const asio::error_code &ec,
+				       asio::ip::tcp::socket socket) {
+		if (!self->_acceptor.is_open()) {
+			return;
+		}
+		if (!ec) {
+			auto session = std::make_shared<Session>(
+				std::move(socket), self);
+			auto &sessions = self->_sessions;
+			auto isClosed = [](const std::weak_ptr<Session> &s) {
+				return s.expired();
+			};
+			sessions.erase(std::remove_if(sessions.begin(),
+						      sessions.end(), isClosed),
+				       sessions.end());
+			sessions.emplace_back(session);
+			session->Read();
+		}
+		self->AcceptTCP();
+	});
+}
+
+void OSCReceiver::Listener::HandlePacket(std::string_view packet)
+{
+	if (!ParseOSCPacket(packet, _dispatch)) {
+		vblog(LOG_INFO, "received malformed OSC packet on %s %d",
+		      _protocol == Protocol::UDP ? "UDP" : "TCP", _port);
+	}
+}
+
+void OSCReceiver::Listener::Dispatch(const OSCMessageView &view)
+{
+	// The message is only copied if anyone is interested in it and is
+	// then shared by all matching patterns
+	MessageBuffer<OSCReceivedMessage>::Message message;
+	std::lock_guard<std::mutex> lock(_mutex);
+	_dispatchers.Match(
+		view.GetAddress(),
+		[&view, &message](
+			MessageDispatcher<OSCReceivedMessage> &dispatcher) {
+			if (!message) {
+				message = std::make_shared<
+					const OSCReceivedMessage>(view);
+			}
+			dispatcher.DispatchMessage(message);
+		});
+}
+
+OSCMessageBuffer
+OSCReceiver::Listener::RegisterClient(const std::string &addressPattern,
+				      size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_dispatchers.RemoveIf(
+		[](MessageDispatcher<OSCReceivedMessage> &dispatcher) {
+			return !dispatcher.HasClients();
+		});
+	return _dispatchers.Get(addressPattern).RegisterClient(capacity);
+}
+
+OSCReceiver::Session::Session(asio::ip::tcp::socket &&socket,
+			      const std::shared_ptr<Listener> &listener)
+	: _socket(std::move(socket)),
+	  _listener(listener)
+{
+}
+
+void OSCReceiver::Session::Read()
+{
+	if (_buffer.size() - _size < minReadSize) {
+		_buffer.resize(_size + minReadSize);
+	}
+	_socket.async_read_some(
+		asio::buffer(_buffer.data() + _size, _buffer.size() - _size),
+		[self = shared_from_this()](const asio::error_code &ec,
+					    size_t size) {
+			if (ec) {
+				self->Close();
+				return;
+			}
+			self->_size += size;
+			if (!self->HandlePackets()) {
+				self->Close();
+				return;
+			}
+			self->Read();
+		});
+}
+
+void OSCReceiver::Session::Close()
+{
+	asio::error_code ec;
+	_socket.close(ec);
+}
+
+static uint32_t readPacketSize(const char *data)
+{
+	const auto bytes = reinterpret_cast<const unsigned char *>(data);
+	return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) |
+	       (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+bool OSCReceiver::Session::HandlePackets()
+{
+	size_t offset = 0;
+	bool valid = true;
+	while (offset < _size) {
+		const std::string_view data(_buffer.data() + offset,
+					    _size - offset);
+		if (data[0] == '/' || data[0] == '#') {
+			// Packets without size prefix can only be told apart
+			// by the reads they were received in
+			_listener->HandlePacket(data);
+			offset = _size;
+			break;
+		}
+		if (data.size() < 4) {
+			break;
+		}
+		const size_t size = readPacketSize(data.data());
+		if (size > maxPacketSize) {
+			valid = false;
+			break;
+		}
+		if (data.size() < 4 + size) {
+			break;
+		}
+		_listener->HandlePacket(data.substr(4, size));
+		offset += 4 + size;
+	}
+
+	// Keep the incomplete remainder for the next read
+	if (offset > 0) {
+		memmove(_buffer.data(), _buffer.data() + offset,
+			_size - offset);
+		_size -= offset;
+	}
+	return valid;
+}
+
+OSCReceiver::ListenerRef::~ListenerRef()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_running) {
+		listener->CloseSockets();
+		return;
+	}
+
+	// Close the sockets right away, so the port can be bound again
+	std::promise<void> closed;
+	asio::post(ioContext, [this, &closed]() {
+		listener->CloseSockets();
+		closed.set_value();
+	});
+	closed.get_future().wait();
+}
+
+void OSCReceiver::StartThread()
+{
+	if (_running) {
+		return;
+	}
+	ioContext.restart();
+	workGuard.emplace(asio::make_work_guard(ioContext));
+	ioThread = std::thread([]() { ioContext.run(); });
+	_running = true;
+}
+
+OSCMessageBuffer OSCReceiver::Register(Protocol protocol, int port,
+				       const std::string &addressPattern,
+				       size_t capacity)
+{
+	// Declared before the lock, as releasing the last reference to a
+	// listener requires the lock
+	std::shared_ptr<ListenerRef> ref;
+	std::lock_guard<std::mutex> lock(_mutex);
+	StartThread();
+
+	for (auto it = _listeners.begin(); it != _listeners.end();) {
+		if (it->second.expired()) {
+			it = _listeners.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto &weakRef = _listeners[std::to_string(static_cast<int>(protocol)) +
+				   ":" + std::to_string(port)];
+	ref = weakRef.lock();
+	if (!ref || !ref->listener->IsOpen()) {
+		auto listener = std::make_shared<Listener>(protocol, port);
+		listener->Open();
+		ref = std::make_shared<ListenerRef>(listener);
+		weakRef = ref;
+	}
+
+	struct Registration {
+		std::shared_ptr<ListenerRef> ref;
+		OSCMessageBuffer buffer;
+	};
+	auto registration = std::make_shared<Registration>(Registration{
+		ref, ref->listener->RegisterClient(addressPattern, capacity)});
+	// The returned buffer keeps the listener open for as long as it is used
+	return OSCMessageBuffer(registration, registration->buffer.get());
+}
+
+void OSCReceiver::Stop()
+{
+	std::vector<std::shared_ptr<ListenerRef>> listeners;
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_running) {
+		return;
+	}
+
+	for (const auto &entry : _listeners) {
+		if (auto ref = entry.second.lock()) {
+			listeners.emplace_back(ref);
+		}
+	}
+	_listeners.clear();
+
+	workGuard.reset();
+	ioContext.stop();
+	ioThread.join();
+	_running = false;
+
+	for (const auto &ref : listeners) {
+		ref->listener->CloseSockets();
+	}
+	// Release the handlers of the aborted operations
+	ioContext.restart();
+	ioContext.poll();
+}
+
+} // namespace advss
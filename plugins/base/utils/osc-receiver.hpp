@@ -0,0 +1,53 @@
+#pragma once
+#include "message-buffer.hpp"
+#include "osc-parser.hpp"
+#include "osc-transport.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace advss {
+
+using OSCMessageBuffer = std::shared_ptr<MessageBuffer<OSCReceivedMessage>>;
+
+// Receives OSC packets on behalf of all OSC conditions.
+//
+// A single socket is bound per protocol and port and shared by all conditions
+// listening on it.
+// All sockets are served by a dedicated thread, which parses the received
+// packets in place and only copies the messages whose address matches the
+// pattern of at least one registered buffer.
+//
+// TCP streams are expected to prefix each packet with its size as defined by
+// OSC 1.0, but packets without size prefix, as sent by the OSC action, are
+// accepted as well as long as they are received in one piece.
+class OSCReceiver {
+public:
+	using Protocol = OSCTransport::Protocol;
+
+	// Messages received on the port whose address matches the pattern
+	// are appended to the returned buffer.
+	// The port is closed again once all buffers registered for it were
+	// released.
+	[[nodiscard]] static OSCMessageBuffer
+	Register(Protocol, int port, const std::string &addressPattern,
+		 size_t capacity =
+			 MessageBuffer<OSCReceivedMessage>::defaultCapacity);
+	// Closes all ports and stops the receive thread
+	static void Stop();
+
+private:
+	class Listener;
+	class Session;
+	struct ListenerRef;
+
+	static void StartThread();
+
+	static std::mutex _mutex;
+	static std::map<std::string, std::weak_ptr<ListenerRef>> _listeners;
+	static bool _running;
+};
+
+} // namespace advss
@@ -0,0 +1,228 @@
+#include "osc-transport.hpp"
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <asio.hpp>
+#include <chrono>
+
+namespace advss {
+
+// Host names are resolved again periodically in case their address changed
+static constexpr auto resolveTTL = std::chrono::minutes(1);
+// Endpoints which were not sent to for this long are closed, e.g. the ones
+// entered while typing a host name
+static constexpr auto idleTimeout = std::chrono::minutes(5);
+static constexpr auto evictionInterval = std::chrono::seconds(30);
+
+static asio::io_context ioContext;
+
+class OSCTransport::Endpoint {
+public:
+	Endpoint(Protocol protocol, const std::string &host, int port);
+	bool Send(const std::vector<char> &packet);
+
+private:
+	bool Resolve();
+	bool Open();
+	void Reset();
+
+	const Protocol _protocol;
+	const std::string _host;
+	const int _port;
+
+	std::mutex _mutex;
+	bool _resolved = false;
+	std::chrono::steady_clock::time_point _resolveTime;
+	asio::ip::udp::endpoint _udpEndpoint;
+	asio::ip::tcp::endpoint _tcpEndpoint;
+	asio::ip::udp::socket _udpSocket;
+	asio::ip::tcp::socket _tcpSocket;
+};
+
+std::mutex OSCTransport::_mutex;
+std::unordered_map<std::string, OSCTransport::EndpointEntry>
+	OSCTransport::_endpoints;
+std::chrono::steady_clock::time_point OSCTransport::_lastEviction;
+
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	AddPluginCleanupStep([]() { OSCTransport::Clear(); });
+	return true;
+}
+
+template<class Resolver>
+static auto resolve(const std::string &host, int port, asio::error_code &ec)
+{
+	Resolver resolver(ioContext);
+	const auto service = std::to_string(port);
+	using Protocol = typename Resolver::protocol_type;
+	auto results = resolver.resolve(Protocol::v4(), host, service, ec);
+	if (ec) {
+		results = resolver.resolve(Protocol::v6(), host, service, ec);
+	}
+	return results;
+}
+
+OSCTransport::Endpoint::Endpoint(Protocol protocol, const std::string &host,
+				 int port)
+	: _protocol(protocol),
+	  _host(host),
+	  _port(port),
+	  _udpSocket(ioContext),
+	  _tcpSocket(ioContext)
+{
+}
+
+bool OSCTransport::Endpoint::Resolve()
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (_resolved && now - _resolveTime < resolveTTL) {
+		return true;
+	}
+
+	asio::error_code ec;
+	if (_protocol == Protocol::UDP) {
+		auto results =
+			resolve<asio::ip::udp::resolver>(_host, _port, ec);
+		if (!ec && !results.empty()) {
+			const auto endpoint = results.begin()->endpoint();
+			if (_resolved && endpoint != _udpEndpoint) {
+				Reset();
+			}
+			_udpEndpoint = endpoint;
+		}
+	} else {
+		auto results =
+			resolve<asio::ip::tcp::resolver>(_host, _port, ec);
+		if (!ec && !results.empty()) {
+			const auto endpoint = results.begin()->endpoint();
+			if (_resolved && endpoint != _tcpEndpoint) {
+				Reset();
+			}
+			_tcpEndpoint = endpoint;
+		}
+	}
+
+	if (ec) {
+		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
+		     _host.c_str(), ec.message().c_str());
+		// Keep using the previous result if there is one
+		return _resolved;
+	}
+	_resolved = true;
+	_resolveTime = now;
+	return true;
+}
+
+bool OSCTransport::Endpoint::Open()
+{
+	asio::error_code ec;
+	if (_protocol == Protocol::UDP) {
+		if (!_udpSocket.is_open()) {
+			_udpSocket.open(_udpEndpoint.protocol(), ec);
+		}
+	} else if (!_tcpSocket.is_open()) {
+		_tcpSocket.connect(_tcpEndpoint, ec);
+		if (ec) {
+			_tcpSocket.close();
+		}
+	}
+
+	if (ec) {
+		blog(LOG_WARNING, "failed to connect to %s %s %d: %s",
+		     _protocol == Protocol::UDP ? "UDP" : "TCP", _host.c_str(),
+		     _port, ec.message().c_str());
+		return false;
+	}
+	return true;
+}
+
+void OSCTransport::Endpoint::Reset()
+{
+	asio::error_code ec;
+	_udpSocket.close(ec);
+	_tcpSocket.close(ec);
+}
+
+bool OSCTransport::Endpoint::Send(const std::vector<char> &packet)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	asio::error_code ec;
+
+	// Retry once with a newly resolved address and a new socket, as the
+	// connection might have been closed by the receiver in the meantime
+	for (int attempt = 0; attempt < 2; attempt++) {
+		if (!Resolve() || !Open()) {
+			return false;
+		}
+
+		ec.clear();
+		if (_protocol == Protocol::UDP) {
+			_udpSocket.send_to(asio::buffer(packet), _udpEndpoint,
+					   0, ec);
+		} else {
+			asio::write(_tcpSocket, asio::buffer(packet), ec);
+		}
+		if (!ec) {
+			return true;
+		}
+
+		Reset();
+		_resolved = false;
+	}
+
+	blog(LOG_WARNING, "failed to send OSC message via %s %s %d: %s",
+	     _protocol == Protocol::UDP ? "UDP" : "TCP", _host.c_str(), _port,
+	     ec.message().c_str());
+	return false;
+}
+
+std::shared_ptr<OSCTransport::Endpoint>
+OSCTransport::GetEndpoint(Protocol protocol, const std::string &host, int port)
+{
+	const auto key = std::to_string(static_cast<int>(protocol)) + ":" +
+			 host + ":" + std::to_string(port);
+	const auto now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (now - _lastEviction >= evictionInterval) {
+		EvictIdleEndpoints(now);
+	}
+	auto &entry = _endpoints[key];
+	if (!entry.endpoint) {
+		entry.endpoint =
+			std::make_shared<Endpoint>(protocol, host, port);
+	}
+	entry.lastUse = now;
+	return entry.endpoint;
+}
+
+void OSCTransport::EvictIdleEndpoints(
+	const std::chrono::steady_clock::time_point &now)
+{
+	// Endpoints currently sending are kept alive by their senders
+	for (auto it = _endpoints.begin(); it != _endpoints.end();) {
+		if (now - it->second.lastUse >= idleTimeout) {
+			it = _endpoints.erase(it);
+		} else {
+			++it;
+		}
+	}
+	_lastEviction = now;
+}
+
+bool OSCTransport::Send(Protocol protocol, const std::string &host, int port,
+			const std::vector<char> &packet)
+{
+	return GetEndpoint(protocol, host, port)->Send(packet);
+}
+
+void OSCTransport::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_endpoints.clear();
+}
+
+} // namespace advss
@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Sends OSC packets on behalf of all OSC actions.
+//
+// A single socket is kept open per endpoint and is shared by all actions
+// sending to it, so sending a packet neither requires a new socket nor a new
+// connection.
+// Host names are only resolved again once the cached result expired or
+// sending to the resolved address failed.
+// Sockets of endpoints which were not sent to for a while are closed.
+class OSCTransport {
+public:
+	enum class Protocol {
+		TCP,
+		UDP,
+	};
+
+	// Returns false if the packet could not be sent
+	static bool Send(Protocol, const std::string &host, int port,
+			 const std::vector<char> &packet);
+	// Closes all sockets
+	static void Clear();
+
+private:
+	class Endpoint;
+	struct EndpointEntry {
+		std::shared_ptr<Endpoint> endpoint;
+		std::chrono::steady_clock::time_point lastUse;
+	};
+	static std::shared_ptr<Endpoint> GetEndpoint(Protocol,
+						     const std::string &host,
+						     int port);
+	static void
+	EvictIdleEndpoints(const std::chrono::steady_clock::time_point &now);
+
+	static std::mutex _mutex;
+	static std::unordered_map<std::string, EndpointEntry> _endpoints;
+	static std::chrono::steady_clock::time_point _lastEviction;
+};
+
+} // namespace advss
@@ -0,0 +1,140 @@
+#include "scene-item-event-buffer.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace advss {
+
+static constexpr std::array<const char *, 2> removeSignals = {"remove",
+							      "destroy"};
+
+// Events which were never consumed, for example because the macro is paused,
+// should not pile up indefinitely
+constexpr size_t maxBufferedEvents = 1024;
+
+SceneItemEventBuffer::SceneItemEventBuffer(const char *signal)
+	: _signal(signal)
+{
+}
+
+SceneItemEventBuffer::~SceneItemEventBuffer()
+{
+	for (const auto &weak : _connectedSources) {
+		// Sources which are already gone were disconnected in
+		// SourceRemoved()
+		OBSSourceAutoRelease source = obs_weak_source_get_source(weak);
+		Disconnect(source);
+	}
+}
+
+bool SceneItemEventBuffer::Event::IsFor(obs_sceneitem_t *item) const
+{
+	return obs_sceneitem_get_scene(item) == scene &&
+	       obs_sceneitem_get_id(item) == itemId;
+}
+
+bool SceneItemEventBuffer::Event::IsFor(
+	const std::vector<OBSSceneItem> &items) const
+{
+	return std::any_of(items.begin(), items.end(),
+			   [this](const OBSSceneItem &item) {
+				   return IsFor(item);
+			   });
+}
+
+void SceneItemEventBuffer::ItemSignal(void *data, calldata_t *cd)
+{
+	auto buffer = static_cast<SceneItemEventBuffer *>(data);
+	auto item = static_cast<obs_sceneitem_t *>(calldata_ptr(cd, "item"));
+	if (!item) {
+		return;
+	}
+
+	Event event;
+	event.scene = obs_sceneitem_get_scene(item);
+	event.itemId = obs_sceneitem_get_id(item);
+	event.visible = calldata_bool(cd, "visible");
+
+	std::lock_guard<std::mutex> lock(buffer->_mutex);
+	if (buffer->_events.size() >= maxBufferedEvents) {
+		buffer->_events.pop_front();
+	}
+	buffer->_events.emplace_back(event);
+}
+
+void SceneItemEventBuffer::SourceRemoved(void *data, calldata_t *cd)
+{
+	// Disconnect right away as the signal handler will no longer be
+	// available once the source is destroyed
+	auto source = static_cast<obs_source_t *>(calldata_ptr(cd, "source"));
+	static_cast<SceneItemEventBuffer *>(data)->Disconnect(source);
+}
+
+void SceneItemEventBuffer::Connect(obs_source_t *source)
+{
+	auto sh = obs_source_get_signal_handler(source);
+	signal_handler_connect(sh, _signal, ItemSignal, this);
+	for (const auto signal : removeSignals) {
+		signal_handler_connect(sh, signal, SourceRemoved, this);
+	}
+}
+
+void SceneItemEventBuffer::Disconnect(obs_source_t *source)
+{
+	if (!source) {
+		return;
+	}
+	auto sh = obs_source_get_signal_handler(source);
+	signal_handler_disconnect(sh, _signal, ItemSignal, this);
+	for (const auto signal : removeSignals) {
+		signal_handler_disconnect(sh, signal, SourceRemoved, this);
+	}
+}
+
+void SceneItemEventBuffer::Watch(const std::vector<OBSSceneItem> &items)
+{
+	// Items of groups are signaled by the group and not by the scene
+	std::vector<obs_source_t *> sources;
+	for (const auto &item : items) {
+		auto scene = obs_sceneitem_get_scene(item);
+		auto source = obs_scene_get_source(scene);
+		if (source && std::find(sources.begin(), sources.end(),
+					source) == sources.end()) {
+			sources.emplace_back(source);
+		}
+	}
+
+	std::vector<OBSWeakSource> connectedSources;
+	for (const auto &weak : _connectedSources) {
+		OBSSourceAutoRelease source = obs_weak_source_get_source(weak);
+		if (!source) {
+			continue;
+		}
+		auto it = std::find(sources.begin(), sources.end(),
+				    source.Get());
+		if (it == sources.end()) {
+			Disconnect(source);
+			continue;
+		}
+		sources.erase(it);
+		connectedSources.emplace_back(weak);
+	}
+
+	for (const auto source : sources) {
+		Connect(source);
+		OBSWeakSourceAutoRelease weak =
+			obs_source_get_weak_source(source);
+		connectedSources.emplace_back(weak.Get());
+	}
+	_connectedSources = std::move(connectedSources);
+}
+
+std::vector<SceneItemEventBuffer::Event> SceneItemEventBuffer::Consume()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<Event> events(_events.begin(), _events.end());
+	_events.clear();
+	return events;
+}
+
+} // namespace advss
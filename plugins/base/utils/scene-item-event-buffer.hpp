@@ -0,0 +1,48 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <obs.hpp>
+#include <vector>
+
+namespace advss {
+
+// Records the scene item signals of the given type (e.g. "item_visible" or
+// "item_transform") emitted by the scenes and groups the watched scene items
+// belong to, so that conditions can react to every change which happened
+// since they were last checked instead of only comparing the current state to
+// the state observed during the previous check.
+class SceneItemEventBuffer {
+public:
+	SceneItemEventBuffer(const char *signal);
+	~SceneItemEventBuffer();
+
+	struct Event {
+		bool IsFor(obs_sceneitem_t *) const;
+		bool IsFor(const std::vector<OBSSceneItem> &) const;
+
+		obs_scene_t *scene = nullptr;
+		int64_t itemId = 0;
+		bool visible = false;
+	};
+
+	// Connects to the signal handlers of the scenes and groups containing
+	// the given items and disconnects from all others
+	void Watch(const std::vector<OBSSceneItem> &);
+	std::vector<Event> Consume();
+
+private:
+	static void ItemSignal(void *data, calldata_t *);
+	static void SourceRemoved(void *data, calldata_t *);
+	void Connect(obs_source_t *);
+	void Disconnect(obs_source_t *);
+
+	const char *_signal;
+
+	// Only accessed from Watch() and the destructor
+	std::vector<OBSWeakSource> _connectedSources;
+
+	std::mutex _mutex;
+	std::deque<Event> _events;
+};
+
+} // namespace advss
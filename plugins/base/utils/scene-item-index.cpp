@@ -0,0 +1,320 @@
+#include "scene-item-index.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace advss {
+
+// Signals emitted by scenes and groups whenever their items change
+static constexpr std::array<const char *, 4> itemSignals = {
+	"item_add", "item_remove", "reorder", "refresh"};
+static constexpr std::array<const char *, 2> removeSignals = {"remove",
+							      "destroy"};
+
+static std::mutex indexMutex;
+static std::unordered_map<obs_weak_source_t *, std::shared_ptr<SceneItemIndex>>
+	indices;
+
+static void sourceRenamed(void *, calldata_t *)
+{
+	std::lock_guard<std::mutex> lock(indexMutex);
+	for (const auto &[_, index] : indices) {
+		index->Invalidate();
+	}
+}
+
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	AddPluginInitStep([]() {
+		signal_handler_connect(obs_get_signal_handler(),
+				       "source_rename", sourceRenamed, nullptr);
+	});
+	AddPluginCleanupStep([]() {
+		signal_handler_disconnect(obs_get_signal_handler(),
+					  "source_rename", sourceRenamed,
+					  nullptr);
+		std::lock_guard<std::mutex> lock(indexMutex);
+		indices.clear();
+	});
+	return true;
+}
+
+struct SceneItemIndex::BuildContext {
+	SceneItemIndex *index;
+	Snapshot *snapshot;
+};
+
+SceneItemIndex::SceneItemIndex(const OBSWeakSource &scene) : _scene(scene)
+{
+	OBSSourceAutoRelease source = obs_weak_source_get_source(scene);
+	Connect(source);
+}
+
+SceneItemIndex::~SceneItemIndex()
+{
+	DisconnectAll();
+}
+
+std::shared_ptr<SceneItemIndex> SceneItemIndex::Get(const OBSWeakSource &scene)
+{
+	std::lock_guard<std::mutex> lock(indexMutex);
+	for (auto it = indices.begin(); it != indices.end();) {
+		if (obs_weak_source_expired(it->first)) {
+			it = indices.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (!scene || obs_weak_source_expired(scene)) {
+		return {};
+	}
+
+	auto it = indices.find(scene.Get());
+	if (it != indices.end()) {
+		return it->second;
+	}
+
+	// Constructor is private so std::make_shared cannot be used
+	auto index = std::shared_ptr<SceneItemIndex>(new SceneItemIndex(scene));
+	indices[scene.Get()] = index;
+	return index;
+}
+
+void SceneItemIndex::Invalidate()
+{
+	// Might be called from within scene signal handlers while the scene is
+	// locked, so the build mutex must not be acquired here
+	++_generation;
+	std::atomic_store(&_snapshot, std::shared_ptr<const Snapshot>());
+}
+
+void SceneItemIndex::ItemsChanged(void *data, calldata_t *)
+{
+	static_cast<SceneItemIndex *>(data)->Invalidate();
+}
+
+void SceneItemIndex::SourceRemoved(void *data, calldata_t *cd)
+{
+	auto index = static_cast<SceneItemIndex *>(data);
+	index->Invalidate();
+
+	// Disconnect right away as the signal handler will no longer be
+	// available once the source is destroyed
+	auto source = static_cast<obs_source_t *>(calldata_ptr(cd, "source"));
+	auto sh = obs_source_get_signal_handler(source);
+	for (const auto signal : itemSignals) {
+		signal_handler_disconnect(sh, signal, ItemsChanged, data);
+	}
+	for (const auto signal : removeSignals) {
+		signal_handler_disconnect(sh, signal, SourceRemoved, data);
+	}
+
+	// Otherwise a group which is added back to the scene later on would
+	// be considered connected already and its changes would be missed
+	const auto isRemovedSource = [source](const OBSWeakSource &weak) {
+		return obs_weak_source_references_source(weak, source);
+	};
+	std::lock_guard<std::mutex> lock(index->_connectedMutex);
+	auto &connected = index->_connectedSources;
+	connected.erase(std::remove_if(connected.begin(), connected.end(),
+				       isRemovedSource),
+			connected.end());
+}
+
+bool SceneItemIndex::IsConnected(obs_source_t *source) const
+{
+	return std::find_if(_connectedSources.begin(), _connectedSources.end(),
+			    [source](const OBSWeakSource &weak) {
+				    return obs_weak_source_references_source(
+					    weak, source);
+			    }) != _connectedSources.end();
+}
+
+void SceneItemIndex::Connect(obs_source_t *source)
+{
+	if (!source) {
+		return;
+	}
+
+	// The signal handlers must not be connected while holding the lock as
+	// SourceRemoved() acquires it from within a signal handler
+	{
+		std::lock_guard<std::mutex> lock(_connectedMutex);
+		if (IsConnected(source)) {
+			return;
+		}
+		OBSWeakSourceAutoRelease weak =
+			obs_source_get_weak_source(source);
+		_connectedSources.emplace_back(weak.Get());
+	}
+
+	auto sh = obs_source_get_signal_handler(source);
+	for (const auto signal : itemSignals) {
+		signal_handler_connect(sh, signal, ItemsChanged, this);
+	}
+	for (const auto signal : removeSignals) {
+		signal_handler_connect(sh, signal, SourceRemoved, this);
+	}
+}
+
+void SceneItemIndex::DisconnectAll()
+{
+	std::vector<OBSWeakSource> connectedSources;
+	{
+		std::lock_guard<std::mutex> lock(_connectedMutex);
+		connectedSources.swap(_connectedSources);
+	}
+
+	for (const auto &weak : connectedSources) {
+		// Sources which are already gone were disconnected in
+		// SourceRemoved()
+		OBSSourceAutoRelease source = obs_weak_source_get_source(weak);
+		if (!source) {
+			continue;
+		}
+		auto sh = obs_source_get_signal_handler(source);
+		for (const auto signal : itemSignals) {
+			signal_handler_disconnect(sh, signal, ItemsChanged,
+						  this);
+		}
+		for (const auto signal : removeSignals) {
+			signal_handler_disconnect(sh, signal, SourceRemoved,
+						  this);
+		}
+	}
+}
+
+bool SceneItemIndex::AddItem(obs_scene_t *, obs_sceneitem_t *item, void *ptr)
+{
+	auto context = static_cast<BuildContext *>(ptr);
+	auto &snapshot = *context->snapshot;
+	auto source = obs_sceneitem_get_source(item);
+	const size_t idx = snapshot.items.size();
+
+	snapshot.items.emplace_back(item);
+	snapshot.byName[obs_source_get_name(source)].emplace_back(idx);
+	auto typeName = obs_source_get_display_name(obs_source_get_id(source));
+	if (typeName) {
+		snapshot.byType[typeName].emplace_back(idx);
+	}
+
+	if (obs_sceneitem_is_group(item)) {
+		// Connect before visiting the group's items so no change
+		// happening in between can be missed
+		context->index->Connect(source);
+		obs_scene_t *group = obs_sceneitem_group_get_scene(item);
+		obs_scene_enum_items(group, AddItem, ptr);
+	}
+
+	return true;
+}
+
+std::shared_ptr<const SceneItemIndex::Snapshot> SceneItemIndex::Build()
+{
+	const auto generation = _generation.load();
+	auto snapshot = std::make_shared<Snapshot>();
+
+	OBSSourceAutoRelease source = obs_weak_source_get_source(_scene);
+	auto scene = obs_scene_from_source(source);
+	if (!scene) {
+		return snapshot;
+	}
+
+	BuildContext context{this, snapshot.get()};
+	obs_scene_enum_items(scene, AddItem, &context);
+
+	// The scene changed while it was being enumerated so the result must
+	// not be cached
+	if (_generation != generation) {
+		return snapshot;
+	}
+
+	// Invalidate() might run between checking the generation and storing
+	// the snapshot, so the generation has to be checked again afterwards.
+	// The outdated snapshot is only dropped if no newer one replaced it.
+	std::shared_ptr<const Snapshot> stored = snapshot;
+	std::atomic_store(&_snapshot, stored);
+	if (_generation != generation) {
+		std::atomic_compare_exchange_strong(
+			&_snapshot, &stored, std::shared_ptr<const Snapshot>());
+	}
+	return snapshot;
+}
+
+std::shared_ptr<const SceneItemIndex::Snapshot> SceneItemIndex::GetSnapshot()
+{
+	auto snapshot = std::atomic_load(&_snapshot);
+	if (snapshot) {
+		return snapshot;
+	}
+
+	std::lock_guard<std::mutex> lock(_buildMutex);
+	snapshot = std::atomic_load(&_snapshot);
+	if (snapshot) {
+		return snapshot;
+	}
+	return Build();
+}
+
+std::vector<OBSSceneItem>
+SceneItemIndex::GetItems(const Snapshot &snapshot,
+			 const std::vector<size_t> &indices)
+{
+	std::vector<OBSSceneItem> items;
+	items.reserve(indices.size());
+	for (const auto idx : indices) {
+		items.emplace_back(snapshot.items[idx]);
+	}
+	return items;
+}
+
+std::vector<OBSSceneItem>
+SceneItemIndex::GetItemsByName(const std::string &name)
+{
+	auto snapshot = GetSnapshot();
+	auto it = snapshot->byName.find(name);
+	if (it == snapshot->byName.end()) {
+		return {};
+	}
+	return GetItems(*snapshot, it->second);
+}
+
+std::vector<OBSSceneItem>
+SceneItemIndex::GetItemsByType(const std::string &type)
+{
+	auto snapshot = GetSnapshot();
+	auto it = snapshot->byType.find(type);
+	if (it == snapshot->byType.end()) {
+		return {};
+	}
+	return GetItems(*snapshot, it->second);
+}
+
+std::vector<OBSSceneItem>
+SceneItemIndex::GetItemsByPattern(const RegexConfig &regex,
+				  const std::string &pattern)
+{
+	// Each distinct source name only has to be matched once
+	auto snapshot = GetSnapshot();
+	std::vector<size_t> matches;
+	for (const auto &[name, indices] : snapshot->byName) {
+		if (regex.Matches(name, pattern)) {
+			matches.insert(matches.end(), indices.begin(),
+				       indices.end());
+		}
+	}
+	std::sort(matches.begin(), matches.end());
+	return GetItems(*snapshot, matches);
+}
+
+std::vector<OBSSceneItem> SceneItemIndex::GetAllItems()
+{
+	return GetSnapshot()->items;
+}
+
+} // namespace advss
@@ -0,0 +1,62 @@
+#pragma once
+#include "regex-config.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <obs.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Caches the scene items of a scene including the items of nested groups,
+// indexed by source name and source type, so that scene item selections do
+// not have to enumerate the whole scene on every check.
+//
+// The cached state is dropped whenever the scene or one of its groups signals
+// a change of its items and is rebuilt on the next lookup.
+// Items are returned in the same order obs_scene_enum_items() would visit
+// them with groups being expanded right after the group item itself.
+class SceneItemIndex {
+public:
+	~SceneItemIndex();
+	static std::shared_ptr<SceneItemIndex> Get(const OBSWeakSource &scene);
+
+	std::vector<OBSSceneItem> GetItemsByName(const std::string &name);
+	std::vector<OBSSceneItem> GetItemsByType(const std::string &type);
+	std::vector<OBSSceneItem> GetItemsByPattern(const RegexConfig &,
+						    const std::string &pattern);
+	std::vector<OBSSceneItem> GetAllItems();
+	void Invalidate();
+
+private:
+	struct Snapshot {
+		std::vector<OBSSceneItem> items;
+		std::unordered_map<std::string, std::vector<size_t>> byName;
+		std::unordered_map<std::string, std::vector<size_t>> byType;
+	};
+	struct BuildContext;
+
+	SceneItemIndex(const OBSWeakSource &scene);
+	std::shared_ptr<const Snapshot> GetSnapshot();
+	std::shared_ptr<const Snapshot> Build();
+	bool IsConnected(obs_source_t *) const;
+	void Connect(obs_source_t *);
+	void DisconnectAll();
+	static std::vector<OBSSceneItem>
+	GetItems(const Snapshot &, const std::vector<size_t> &indices);
+	static bool AddItem(obs_scene_t *, obs_sceneitem_t *, void *);
+	static void ItemsChanged(void *data, calldata_t *);
+	static void SourceRemoved(void *data, calldata_t *);
+
+	OBSWeakSource _scene;
+	std::shared_ptr<const Snapshot> _snapshot;
+	std::atomic_uint64_t _generation = {0};
+	std::mutex _buildMutex;
+	std::mutex _connectedMutex;
+	std::vector<OBSWeakSource> _connectedSources;
+};
+
+} // namespace advss
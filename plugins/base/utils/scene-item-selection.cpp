@@ -1,5 +1,6 @@
 #include "scene-item-selection.hpp"
 #include "layout-helpers.hpp"
+#include "scene-item-index.hpp"
 #include "obs-module-helper.hpp"
 #include "selection-helpers.hpp"
 #include "source-helpers.hpp"
@@ -36,59 +37,6 @@ const static std::map<SceneItemSelection::Type, std::string> types = {
 
 /* ------------------------------------------------------------------------- */
 
-struct NameMatchData {
-	std::string name;
-	std::vector<OBSSceneItem> items = {};
-};
-
-static bool getSceneItemsByNameHelper(obs_scene_t *, obs_sceneitem_t *item,
-				      void *ptr)
-{
-	auto itemInfo = reinterpret_cast<NameMatchData *>(ptr);
-	auto sourceName = obs_source_get_name(obs_sceneitem_get_source(item));
-	if (itemInfo->name == sourceName) {
-		itemInfo->items.emplace_back(item);
-	}
-
-	if (obs_sceneitem_is_group(item)) {
-		obs_scene_t *scene = obs_sceneitem_group_get_scene(item);
-		obs_scene_enum_items(scene, getSceneItemsByNameHelper, ptr);
-	}
-
-	return true;
-}
-
-static std::vector<OBSSceneItem> getSceneItemsWithName(obs_scene_t *scene,
-						       const std::string &name)
-{
-	NameMatchData itemInfo = {name};
-	obs_scene_enum_items(scene, getSceneItemsByNameHelper, &itemInfo);
-	return itemInfo.items;
-}
-
-struct NamePatternMatchData {
-	std::string pattern;
-	const RegexConfig &regex;
-	std::vector<OBSSceneItem> items = {};
-};
-
-static bool getSceneItemsByPatternHelper(obs_scene_t *, obs_sceneitem_t *item,
-					 void *ptr)
-{
-	auto data = reinterpret_cast<NamePatternMatchData *>(ptr);
-	auto sourceName = obs_source_get_name(obs_sceneitem_get_source(item));
-	if (data->regex.Matches(sourceName, data->pattern)) {
-		data->items.emplace_back(item);
-	}
-
-	if (obs_sceneitem_is_group(item)) {
-		obs_scene_t *scene = obs_sceneitem_group_get_scene(item);
-		obs_scene_enum_items(scene, getSceneItemsByPatternHelper, ptr);
-	}
-
-	return true;
-}
-
 struct ItemCountData {
 	std::string name;
 	int count = 0;
@@ -157,41 +105,6 @@ static bool getSceneItemAtIdx(obs_scene_t *, obs_sceneitem_t *item, void *ptr)
 	return true;
 }
 
-struct GroupData {
-	std::string type;
-	std::vector<OBSSceneItem> items = {};
-};
-
-static bool getSceneItemsOfType(obs_scene_t *, obs_sceneitem_t *item, void *ptr)
-{
-	auto data = reinterpret_cast<GroupData *>(ptr);
-	auto sourceTypeName = obs_source_get_display_name(
-		obs_source_get_id(obs_sceneitem_get_source(item)));
-	if (sourceTypeName && data->type == sourceTypeName) {
-		data->items.emplace_back(item);
-	}
-
-	if (obs_sceneitem_is_group(item)) {
-		obs_scene_t *scene = obs_sceneitem_group_get_scene(item);
-		obs_scene_enum_items(scene, getSceneItemsOfType, ptr);
-	}
-
-	return true;
-}
-
-static bool getAllSceneItems(obs_scene_t *, obs_sceneitem_t *item, void *ptr)
-{
-	auto items = reinterpret_cast<std::vector<OBSSceneItem> *>(ptr);
-	items->emplace_back(item);
-
-	if (obs_sceneitem_is_group(item)) {
-		obs_scene_t *scene = obs_sceneitem_group_get_scene(item);
-		obs_scene_enum_items(scene, getAllSceneItems, ptr);
-	}
-
-	return true;
-}
-
 /* ------------------------------------------------------------------------- */
 
 void SceneItemSelection::Save(obs_data_t *obj, const char *name) const
@@ -346,8 +259,10 @@ void SceneItemSelection::ReduceBadedOnIndexSelection(
 std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByName(
 	const SceneSelection &sceneSelection) const
 {
-	auto s = obs_weak_source_get_source(sceneSelection.GetScene(false));
-	OBSSceneAutoRelease scene = obs_scene_from_source(s);
+	auto index = SceneItemIndex::Get(sceneSelection.GetScene(false));
+	if (!index) {
+		return {};
+	}
 	std::string name;
 	if (_type == Type::VARIABLE_NAME) {
 		auto var = _variable.lock();
@@ -358,7 +273,7 @@ std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByName(
 	} else {
 		name = GetWeakSourceName(_source);
 	}
-	auto items = getSceneItemsWithName(scene, name);
+	auto items = index->GetItemsByName(name);
 	ReduceBadedOnIndexSelection(items);
 	return items;
 }
@@ -366,13 +281,13 @@ std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByName(
 std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByPattern(
 	const SceneSelection &sceneSelection) const
 {
-	auto s = obs_weak_source_get_source(sceneSelection.GetScene(false));
-	auto scene = obs_scene_from_source(s);
-	NamePatternMatchData data{_pattern, _regex};
-	obs_scene_enum_items(scene, getSceneItemsByPatternHelper, &data);
-	obs_source_release(s);
-	ReduceBadedOnIndexSelection(data.items);
-	return data.items;
+	auto index = SceneItemIndex::Get(sceneSelection.GetScene(false));
+	if (!index) {
+		return {};
+	}
+	auto items = index->GetItemsByPattern(_regex, _pattern);
+	ReduceBadedOnIndexSelection(items);
+	return items;
 }
 
 std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByGroup(
@@ -382,13 +297,13 @@ std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByGroup(
 		return {};
 	}
 
-	auto s = obs_weak_source_get_source(sceneSelection.GetScene(false));
-	auto scene = obs_scene_from_source(s);
-	GroupData data{_sourceGroup};
-	obs_scene_enum_items(scene, getSceneItemsOfType, &data);
-	obs_source_release(s);
-	ReduceBadedOnIndexSelection(data.items);
-	return data.items;
+	auto index = SceneItemIndex::Get(sceneSelection.GetScene(false));
+	if (!index) {
+		return {};
+	}
+	auto items = index->GetItemsByType(_sourceGroup);
+	ReduceBadedOnIndexSelection(items);
+	return items;
 }
 
 std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByIdx(
@@ -426,12 +341,11 @@ std::vector<OBSSceneItem> SceneItemSelection::GetSceneItemsByIdx(
 std::vector<OBSSceneItem>
 SceneItemSelection::GetAllSceneItems(const SceneSelection &sceneSelection) const
 {
-	auto s = obs_weak_source_get_source(sceneSelection.GetScene(false));
-	auto scene = obs_scene_from_source(s);
-	std::vector<OBSSceneItem> items;
-	obs_scene_enum_items(scene, getAllSceneItems, &items);
-	obs_source_release(s);
-	return items;
+	auto index = SceneItemIndex::Get(sceneSelection.GetScene(false));
+	if (!index) {
+		return {};
+	}
+	return index->GetAllItems();
 }
 
 SceneItemSelection::NameConflictSelection
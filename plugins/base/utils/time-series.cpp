@@ -0,0 +1,100 @@
+#include "time-series.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace advss {
+
+TimeSeries::TimeSeries(size_t capacity, double smoothingFactor)
+	: _samples(std::max<size_t>(capacity, 1)),
+	  _smoothingFactor(std::clamp(smoothingFactor, 0.0, 1.0))
+{
+}
+
+void TimeSeries::Add(double value, Clock::time_point time)
+{
+	if (_count == 0) {
+		_average = value;
+	} else {
+		_average += _smoothingFactor * (value - _average);
+	}
+
+	_samples[_next] = {time, value};
+	_next = (_next + 1) % _samples.size();
+	_count = std::min(_count + 1, _samples.size());
+}
+
+void TimeSeries::Clear()
+{
+	_next = 0;
+	_count = 0;
+	_average = 0.0;
+}
+
+double TimeSeries::GetLatest() const
+{
+	if (_count == 0) {
+		return 0.0;
+	}
+	return _samples[(_next + _samples.size() - 1) % _samples.size()].value;
+}
+
+std::vector<double>
+TimeSeries::GetValuesInWindow(std::chrono::milliseconds window,
+			      Clock::time_point now) const
+{
+	std::vector<double> values;
+	const auto cutoff = now - window;
+
+	// Walk backwards from the newest sample until the window is left
+	for (size_t i = 0; i < _count; i++) {
+		const auto &sample =
+			_samples[(_next + _samples.size() - 1 - i) %
+				 _samples.size()];
+		if (sample.time < cutoff) {
+			break;
+		}
+		values.emplace_back(sample.value);
+	}
+	return values;
+}
+
+double TimeSeries::GetMinimum(std::chrono::milliseconds window,
+			      Clock::time_point now) const
+{
+	const auto values = GetValuesInWindow(window, now);
+	if (values.empty()) {
+		return 0.0;
+	}
+	return *std::min_element(values.begin(), values.end());
+}
+
+double TimeSeries::GetMaximum(std::chrono::milliseconds window,
+			      Clock::time_point now) const
+{
+	const auto values = GetValuesInWindow(window, now);
+	if (values.empty()) {
+		return 0.0;
+	}
+	return *std::max_element(values.begin(), values.end());
+}
+
+double TimeSeries::GetPercentile(double percentile,
+				 std::chrono::milliseconds window,
+				 Clock::time_point now) const
+{
+	auto values = GetValuesInWindow(window, now);
+	if (values.empty()) {
+		return 0.0;
+	}
+
+	// Nearest-rank method
+	percentile = std::clamp(percentile, 0.0, 100.0);
+	auto rank = static_cast<size_t>(
+		std::ceil(percentile / 100.0 * values.size()));
+	rank = std::clamp<size_t>(rank, 1, values.size()) - 1;
+	std::nth_element(values.begin(), values.begin() + rank, values.end());
+	return values[rank];
+}
+
+} // namespace advss
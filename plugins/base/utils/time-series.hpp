@@ -0,0 +1,48 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+namespace advss {
+
+// Fixed capacity ring buffer of timestamped values with an exponentially
+// weighted moving average and window based aggregates.
+class TimeSeries {
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	TimeSeries(size_t capacity = 1024, double smoothingFactor = 0.2);
+
+	void Add(double value, Clock::time_point = Clock::now());
+	void Clear();
+	bool Empty() const { return _count == 0; }
+	size_t Size() const { return _count; }
+
+	// All getters return 0 if no values are available
+	double GetLatest() const;
+	double GetAverage() const { return _average; }
+	double GetMinimum(std::chrono::milliseconds window,
+			  Clock::time_point now = Clock::now()) const;
+	double GetMaximum(std::chrono::milliseconds window,
+			  Clock::time_point now = Clock::now()) const;
+	// Percentile is expected in the range of [0, 100]
+	double GetPercentile(double percentile,
+			     std::chrono::milliseconds window,
+			     Clock::time_point now = Clock::now()) const;
+
+private:
+	struct Sample {
+		Clock::time_point time;
+		double value;
+	};
+
+	std::vector<double> GetValuesInWindow(std::chrono::milliseconds window,
+					      Clock::time_point now) const;
+
+	std::vector<Sample> _samples;
+	size_t _next = 0;
+	size_t _count = 0;
+	double _smoothingFactor;
+	double _average = 0.0;
+};
+
+} // namespace advss
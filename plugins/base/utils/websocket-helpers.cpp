@@ -4,6 +4,7 @@
 #include "plugin-state-helpers.hpp"
 #include "sync-helpers.hpp"
 
+#include <algorithm>
 #include <QCryptographicHash>
 #include <obs-websocket-api.h>
 
@@ -16,6 +17,14 @@ using websocketpp::lib::bind;
 #define RPC_VERSION 1
 #undef DispatchMessage
 
+// Stop handing queued messages to the connection while this many bytes are
+// still waiting to be written to the socket
+constexpr size_t maxBufferedAmount = 1024 * 1024;
+constexpr long backPressureRetryDelayMs = 10;
+// Queued messages are dropped once they are older than this, as whatever they
+// were meant to trigger is most likely no longer relevant
+constexpr auto maxSendQueueAge = std::chrono::seconds(30);
+
 constexpr char VendorName[] = "AdvancedSceneSwitcher";
 constexpr char VendorRequest[] = "AdvancedSceneSwitcherMessage";
 constexpr char VendorEvent[] = "AdvancedSceneSwitcherEvent";
@@ -221,7 +230,111 @@ std::string ConstructVendorRequestMessage(const std::string &message)
 
 void WSClientConnection::SendRequest(const std::string &msg)
 {
-	Send(msg);
+	std::lock_guard<std::mutex> lock(_sendMtx);
+	if (_sendQueue.size() >= _maxSendQueueSize) {
+		++_sendStats.dropped;
+		vblog(LOG_INFO, "send queue of '%s' is full - dropping message",
+		      _uri.c_str());
+		if (_sendQueuePolicy ==
+			    MessageBufferOverflowPolicy::DROP_NEWEST ||
+		    _sendQueue.empty()) {
+			return;
+		}
+		_sendQueue.pop_front();
+	}
+	_sendQueue.push_back({msg, std::chrono::steady_clock::now()});
+	ScheduleFlush();
+}
+
+void WSClientConnection::SetSendQueueLimit(size_t maxSize,
+					   MessageBufferOverflowPolicy policy)
+{
+	std::lock_guard<std::mutex> lock(_sendMtx);
+	_maxSendQueueSize = maxSize;
+	_sendQueuePolicy = policy;
+	while (_sendQueue.size() > _maxSendQueueSize) {
+		_sendQueue.pop_front();
+		++_sendStats.dropped;
+	}
+}
+
+WSClientConnection::SendStatistics
+WSClientConnection::GetSendStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_sendMtx);
+	auto stats = _sendStats;
+	stats.queued = _sendQueue.size();
+	if (stats.sent > 0) {
+		stats.averageLatency = _totalSendLatency / stats.sent;
+	}
+	return stats;
+}
+
+// Must be called with _sendMtx locked.
+// All messages queued until the flush runs are sent in one go, which allows
+// websocketpp to write them to the socket with a single write operation.
+void WSClientConnection::ScheduleFlush()
+{
+	if (_flushScheduled || _sendQueue.empty() ||
+	    _status != Status::AUTHENTICATED) {
+		return;
+	}
+	_flushScheduled = true;
+	_client.get_io_service().post([this]() { FlushSendQueue(); });
+}
+
+// Runs on the thread of the connection
+void WSClientConnection::FlushSendQueue()
+{
+	websocketpp::lib::error_code ec;
+	auto con = _client.get_con_from_hdl(_connection, ec);
+	std::unique_lock<std::mutex> lock(_sendMtx);
+	_flushScheduled = false;
+	if (ec || _status != Status::AUTHENTICATED) {
+		// The queue is flushed again once the connection is established
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	size_t outdated = 0;
+	while (!_sendQueue.empty() &&
+	       now - _sendQueue.front().time > maxSendQueueAge) {
+		_sendQueue.pop_front();
+		++outdated;
+	}
+	if (outdated > 0) {
+		_sendStats.dropped += outdated;
+		vblog(LOG_INFO, "dropped %zu outdated messages queued for '%s'",
+		      outdated, _uri.c_str());
+	}
+
+	while (!_sendQueue.empty()) {
+		if (con->get_buffered_amount() > maxBufferedAmount) {
+			// Keep the remaining messages queued until the peer
+			// caught up instead of growing the write buffer
+			_flushScheduled = true;
+			_client.set_timer(
+				backPressureRetryDelayMs,
+				[this](const websocketpp::lib::error_code &) {
+					FlushSendQueue();
+				});
+			return;
+		}
+
+		const auto entry = std::move(_sendQueue.front());
+		_sendQueue.pop_front();
+		const auto latency =
+			std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - entry.time);
+		_totalSendLatency += latency;
+		_sendStats.maxLatency =
+			std::max(_sendStats.maxLatency, latency);
+		++_sendStats.sent;
+
+		lock.unlock();
+		Send(entry.message);
+		lock.lock();
+	}
 }
 
 WebsocketMessageBuffer WSClientConnection::RegisterForEvents()
@@ -250,6 +363,8 @@ void WSClientConnection::OnGenericOpen(connection_hdl)
 {
 	blog(LOG_INFO, "connection to %s opened", _uri.c_str());
 	_status = Status::AUTHENTICATED;
+	std::lock_guard<std::mutex> lock(_sendMtx);
+	ScheduleFlush();
 }
 
 void WSClientConnection::OnOBSOpen(connection_hdl)
@@ -379,9 +494,12 @@ void WSClientConnection::OnOBSMessage(connection_hdl,
 	case 0: // Hello
 		HandleHello(json);
 		break;
-	case 2: // Identified
+	case 2: { // Identified
 		_status = Status::AUTHENTICATED;
+		std::lock_guard<std::mutex> lock(_sendMtx);
+		ScheduleFlush();
 		break;
+	}
 	case 5: // Event (Vendor)
 		HandleEvent(json);
 		break;
@@ -415,6 +533,12 @@ void WSClientConnection::OnClose(connection_hdl)
 {
 	blog(LOG_INFO, "client-connection to %s closed.", _uri.c_str());
 	_status = Status::DISCONNECTED;
+
+	// Messages queued for this connection must not be sent once a new
+	// connection is established, possibly long after they were queued
+	std::lock_guard<std::mutex> lock(_sendMtx);
+	_sendStats.dropped += _sendQueue.size();
+	_sendQueue.clear();
 }
 
 } // namespace advss
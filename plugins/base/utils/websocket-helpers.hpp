@@ -2,6 +2,8 @@
 #include "message-buffer.hpp"
 #include "message-dispatcher.hpp"
 
+#include <chrono>
+#include <deque>
 #include <set>
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
@@ -30,18 +32,36 @@ void SendWebsocketEvent(const std::string &);
 std::string ConstructVendorRequestMessage(const std::string &message);
 [[nodiscard]] WebsocketMessageBuffer RegisterForWebsocketMessages();
 
+// Messages are not sent by the thread requesting it, but are appended to an
+// outbound queue, which is drained by the thread of the connection.
+// This way a slow peer or a connection attempt in progress does not block
+// the macro sending the message.
 class WSClientConnection : public QObject {
 	using server = websocketpp::server<websocketpp::config::asio>;
 	using client = websocketpp::client<websocketpp::config::asio_client>;
 
 public:
+	struct SendStatistics {
+		size_t queued = 0;
+		uint64_t sent = 0;
+		uint64_t dropped = 0;
+		// Time between queueing a message and handing it to the socket
+		std::chrono::microseconds averageLatency{0};
+		std::chrono::microseconds maxLatency{0};
+	};
+
 	explicit WSClientConnection(bool useOBSProtocol = true);
 	virtual ~WSClientConnection();
 
 	void Connect(const std::string &uri, const std::string &pass,
 		     bool _reconnect, int reconnectDelay = 10);
 	void Disconnect();
+	// Queues the message to be sent once the connection is established.
+	// Messages still queued when the connection is closed or which were
+	// queued for too long are dropped.
 	void SendRequest(const std::string &msg);
+	void SetSendQueueLimit(size_t maxSize, MessageBufferOverflowPolicy);
+	SendStatistics GetSendStatistics() const;
 	[[nodiscard]] WebsocketMessageBuffer RegisterForEvents();
 	std::string GetFail() { return _failMsg; }
 
@@ -61,6 +81,8 @@ private:
 	void OnOBSMessage(connection_hdl hdl, client::message_ptr message);
 	void OnClose(connection_hdl hdl);
 	void Send(const std::string &);
+	void ScheduleFlush();
+	void FlushSendQueue();
 	void ConnectThread();
 	void HandleHello(obs_data_t *helloMsg);
 	void HandleEvent(obs_data_t *event);
@@ -81,6 +103,19 @@ private:
 	std::atomic_bool _disconnect{false};
 
 	WebsocketMessageDispatcher _dispatcher;
+
+	struct QueuedMessage {
+		std::string message;
+		std::chrono::steady_clock::time_point time;
+	};
+	mutable std::mutex _sendMtx;
+	std::deque<QueuedMessage> _sendQueue;
+	size_t _maxSendQueueSize = 1000;
+	MessageBufferOverflowPolicy _sendQueuePolicy =
+		MessageBufferOverflowPolicy::DROP_OLDEST;
+	bool _flushScheduled = false;
+	SendStatistics _sendStats;
+	std::chrono::microseconds _totalSendLatency{0};
 };
 
 } // namespace advss
@@ -204,21 +204,15 @@ void MacroActionMidiEdit::ToggleListen()
 void MacroActionMidiEdit::SetMessageSelectionToLastReceived()
 {
 	auto lock = LockContext();
-	if (!_entryData || !_messageBuffer || _messageBuffer->Empty()) {
+	if (!_entryData || !_messageBuffer) {
 		return;
 	}
 
-	std::optional<MidiMessage> message;
-	while (!_messageBuffer->Empty()) {
-		message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-	}
-
-	if (!message) {
+	const auto messages = _messageBuffer->ConsumeMessages();
+	if (messages.empty()) {
 		return;
 	}
+	const auto &message = messages.back();
 
 	_message->SetMessage(*message);
 	_entryData->_message = *message;
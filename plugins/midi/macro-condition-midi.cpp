@@ -26,11 +26,7 @@ bool MacroConditionMidi::CheckCondition()
 		return false;
 	}
 
-	while (!_messageBuffer->Empty()) {
-		auto message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
+	while (const auto message = _messageBuffer->ConsumeMessage()) {
 		if (message->Matches(_message)) {
 			SetVariableValues(*message);
 			if (_clearBufferOnMatch) {
@@ -59,6 +55,7 @@ bool MacroConditionMidi::Load(obs_data_t *obj)
 	_message.Load(obj);
 	_device.Load(obj);
 	_messageBuffer = _device.RegisterForMidiMessages();
+	CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
 	_clearBufferOnMatch = obs_data_get_bool(obj, "clearBufferOnMatch");
 	if (!obs_data_has_user_value(obj, "version")) {
 		_clearBufferOnMatch = true;
@@ -75,6 +72,7 @@ void MacroConditionMidi::SetDevice(const MidiDevice &dev)
 {
 	_device = dev;
 	_messageBuffer = dev.RegisterForMidiMessages();
+	CheckMacroOnNewMessages(GetMacro(), _messageBuffer);
 }
 
 void MacroConditionMidi::SetupTempVars()
@@ -246,21 +244,15 @@ void MacroConditionMidiEdit::ToggleListen()
 void MacroConditionMidiEdit::SetMessageSelectionToLastReceived()
 {
 	auto lock = LockContext();
-	if (!_entryData || !_messageBuffer || _messageBuffer->Empty()) {
+	if (!_entryData || !_messageBuffer) {
 		return;
 	}
 
-	std::optional<MidiMessage> message;
-	while (!_messageBuffer->Empty()) {
-		message = _messageBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-	}
-
-	if (!message) {
+	const auto messages = _messageBuffer->ConsumeMessages();
+	if (messages.empty()) {
 		return;
 	}
+	const auto &message = messages.back();
 
 	_message->SetMessage(*message);
 	_entryData->_message = *message;
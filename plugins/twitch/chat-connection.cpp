@@ -15,315 +15,6 @@ using websocketpp::lib::bind;
 
 static const int reconnectDelay = 15;
 
-/* ------------------------------------------------------------------------- */
-
-static ParsedTags parseTags(const std::string &tags)
-{
-	ParsedTags parsedTags;
-	static constexpr std::array<std::string_view, 2> tagsToIgnore = {
-		"client-nonce", "flags"};
-
-	std::vector<std::string> parsedTagPairs;
-	size_t pos = 0;
-	size_t endPos;
-
-	while ((endPos = tags.find(';', pos)) != std::string::npos) {
-		parsedTagPairs.push_back(tags.substr(pos, endPos - pos));
-		pos = endPos + 1;
-	}
-
-	parsedTagPairs.push_back(tags.substr(pos));
-
-	for (const auto &tagPair : parsedTagPairs) {
-		size_t equalsPos = tagPair.find('=');
-		std::string tagName = tagPair.substr(0, equalsPos);
-		std::string tagValue = (equalsPos != std::string::npos)
-					       ? tagPair.substr(equalsPos + 1)
-					       : "";
-
-		if (std::find(tagsToIgnore.begin(), tagsToIgnore.end(),
-			      tagName) != tagsToIgnore.end()) {
-			continue;
-		}
-
-		if (tagValue.empty()) {
-			parsedTags.tagMap[tagName] = {};
-			continue;
-		}
-
-		if (tagName == "badges" || tagName == "badge-info") {
-			ParsedTags::BadgeMap badgeMap;
-			std::vector<std::string> badgePairs;
-			size_t badgePos = 0;
-			size_t badgeEndPos;
-
-			while ((badgeEndPos = tagValue.find(',', badgePos)) !=
-			       std::string::npos) {
-				badgePairs.push_back(tagValue.substr(
-					badgePos, badgeEndPos - badgePos));
-				badgePos = badgeEndPos + 1;
-			}
-
-			badgePairs.push_back(tagValue.substr(badgePos));
-
-			for (const auto &badgePair : badgePairs) {
-				size_t slashPos = badgePair.find('/');
-				std::string badgeName =
-					badgePair.substr(0, slashPos);
-				std::string badgeValue =
-					(slashPos != std::string::npos)
-						? badgePair.substr(slashPos + 1)
-						: "";
-
-				badgeMap[badgeName] = badgeValue;
-			}
-
-			parsedTags.tagMap[tagName] = badgeMap;
-
-		} else if (tagName == "emotes") {
-			ParsedTags::EmoteMap emoteMap;
-			std::vector<std::string> emotePairs;
-			size_t emotePos = 0;
-			size_t emoteEndPos;
-
-			while ((emoteEndPos = tagValue.find('/', emotePos)) !=
-			       std::string::npos) {
-				emotePairs.push_back(tagValue.substr(
-					emotePos, emoteEndPos - emotePos));
-				emotePos = emoteEndPos + 1;
-			}
-
-			emotePairs.push_back(tagValue.substr(emotePos));
-
-			for (const auto &emotePair : emotePairs) {
-				size_t colonPos = emotePair.find(':');
-				std::string emoteId =
-					emotePair.substr(0, colonPos);
-				std::string positions =
-					(colonPos != std::string::npos)
-						? emotePair.substr(colonPos + 1)
-						: "";
-
-				std::vector<std::pair<int, int>> textPositions;
-				size_t positionPos = 0;
-				size_t positionEndPos;
-
-				while ((positionEndPos = positions.find(
-						',', positionPos)) !=
-				       std::string::npos) {
-					std::string position = positions.substr(
-						positionPos,
-						positionEndPos - positionPos);
-					size_t dashPos = position.find('-');
-					int startPos = std::stoi(
-						position.substr(0, dashPos));
-					int endPos = std::stoi(
-						position.substr(dashPos + 1));
-					textPositions.push_back(
-						{startPos, endPos});
-					positionPos = positionEndPos + 1;
-				}
-
-				textPositions.push_back(
-					{std::stoi(
-						 positions.substr(positionPos)),
-					 std::stoi(positions.substr(
-						 positionPos))});
-				emoteMap[emoteId] = textPositions;
-			}
-
-			parsedTags.tagMap[tagName] = emoteMap;
-		} else if (tagName == "emote-sets") {
-			ParsedTags::EmoteSet emoteSetIds;
-			size_t setIdPos = 0;
-			size_t setIdEndPos;
-
-			while ((setIdEndPos = tagValue.find(',', setIdPos)) !=
-			       std::string::npos) {
-				emoteSetIds.push_back(tagValue.substr(
-					setIdPos, setIdEndPos - setIdPos));
-				setIdPos = setIdEndPos + 1;
-			}
-
-			emoteSetIds.push_back(tagValue.substr(setIdPos));
-
-			parsedTags.tagMap[tagName] = emoteSetIds;
-		} else {
-			parsedTags.tagMap[tagName] = tagValue;
-		}
-	}
-
-	return parsedTags;
-}
-
-static void parseSource(const std::string &rawSourceComponent,
-			IRCMessage &message)
-{
-	if (rawSourceComponent.empty()) {
-		return;
-	}
-	size_t nickPos = 0;
-	size_t nickEndPos = rawSourceComponent.find('!');
-
-	if (nickEndPos != std::string::npos) {
-		message.source.nick = rawSourceComponent.substr(
-			nickPos, nickEndPos - nickPos);
-		message.source.host = rawSourceComponent.substr(nickEndPos + 1);
-	} else {
-		// Assume the entire source is the host if no '!' is found
-		message.source.host = rawSourceComponent;
-	}
-}
-
-static void parseCommand(const std::string &rawCommandComponent,
-			 IRCMessage &message)
-{
-	std::vector<std::string> commandParts;
-	size_t pos = 0;
-	size_t endPos;
-
-	while ((endPos = rawCommandComponent.find(' ', pos)) !=
-	       std::string::npos) {
-		commandParts.push_back(
-			rawCommandComponent.substr(pos, endPos - pos));
-		pos = endPos + 1;
-	}
-
-	commandParts.push_back(rawCommandComponent.substr(pos));
-
-	if (commandParts.empty()) {
-		return;
-	}
-
-	message.command.command = commandParts[0];
-	if (message.command.command == "CAP") {
-		if (commandParts.size() < 3) {
-			return;
-		}
-		message.command.parameters = (commandParts[2] == "ACK");
-	} else if (message.command.command == "RECONNECT") {
-		blog(LOG_INFO,
-		     "The Twitch IRC server is about to terminate the connection for maintenance.");
-	} else if (message.command.command == "421") {
-		// Unsupported command
-		return;
-	} else if (message.command.command == "PING" ||
-		   message.command.command == "001" ||
-		   message.command.command == "JOIN" ||
-		   message.command.command == "PART" ||
-		   message.command.command == "NOTICE" ||
-		   message.command.command == "CLEARCHAT" ||
-		   message.command.command == "HOSTTARGET" ||
-		   message.command.command == "PRIVMSG") {
-		if (commandParts.size() < 2) {
-			return;
-		}
-		message.command.parameters = commandParts[1];
-	} else if (message.command.command == "GLOBALUSERSTATE" ||
-		   message.command.command == "USERSTATE" ||
-		   message.command.command == "ROOMSTATE" ||
-		   message.command.command == "002" ||
-		   message.command.command == "003" ||
-		   message.command.command == "004" ||
-		   message.command.command == "353" ||
-		   message.command.command == "366" ||
-		   message.command.command == "372" ||
-		   message.command.command == "375" ||
-		   message.command.command == "376") {
-		// Do nothing for these cases for now
-	} else {
-		vblog(LOG_INFO, "Unexpected IRC command: %s",
-		      message.command.command.c_str());
-	}
-}
-
-static IRCMessage parseMessage(const std::string &message)
-{
-	IRCMessage parsedMessage;
-
-	size_t idx = 0;
-	std::string rawTagsComponent;
-	std::string rawSourceComponent;
-	std::string rawCommandComponent;
-	std::string rawMessageComponent;
-
-	if (message[idx] == '@') {
-		size_t endIdx = message.find(' ');
-		rawTagsComponent = message.substr(1, endIdx - 1);
-		idx = endIdx + 1;
-	}
-
-	if (message[idx] == ':') {
-		idx += 1;
-		size_t endIdx = message.find(' ', idx);
-		rawSourceComponent = message.substr(idx, endIdx - idx);
-		idx = endIdx + 1;
-	}
-
-	size_t endIdx = message.find(':', idx);
-	if (endIdx == std::string::npos) {
-		endIdx = message.length();
-	}
-
-	rawCommandComponent = message.substr(idx, endIdx - idx);
-	if (endIdx != message.length()) {
-		idx = endIdx + 1;
-		rawMessageComponent = message.substr(idx);
-	}
-
-	parsedMessage.tags = parseTags(rawTagsComponent);
-	parseSource(rawSourceComponent, parsedMessage);
-	parseCommand(rawCommandComponent, parsedMessage);
-	parsedMessage.message = rawMessageComponent;
-	return parsedMessage;
-}
-
-static std::vector<IRCMessage> parseMessages(const std::string &messagesStr)
-{
-	static constexpr std::string_view delimiter = "\r\n";
-	std::vector<IRCMessage> messages;
-
-	auto isWhitespace = [](const std::string &str) -> bool {
-		for (char c : str) {
-			if (!std::isspace(static_cast<unsigned char>(c))) {
-				return false;
-			}
-		}
-		return true;
-	};
-
-	size_t start = 0;
-	size_t end = messagesStr.find(delimiter);
-	while (end != std::string::npos) {
-		auto message = messagesStr.substr(start, end - start);
-		if (isWhitespace(message)) {
-			continue;
-		}
-		auto parsedMessage = parseMessage(message);
-		if (parsedMessage.command.command.empty()) {
-			vblog(LOG_INFO, "discarding IRC message: %s",
-			      message.c_str());
-		} else {
-			messages.emplace_back(parsedMessage);
-		}
-		start = end + delimiter.length();
-		end = messagesStr.find(delimiter, start);
-	}
-	auto message = messagesStr.substr(start);
-	if (isWhitespace(message)) {
-		return messages;
-	}
-	auto parsedMessage = parseMessage(message);
-	if (parsedMessage.command.command.empty()) {
-		vblog(LOG_INFO, "discarding IRC message: %s", message.c_str());
-		return messages;
-	}
-	messages.emplace_back(parsedMessage);
-	return messages;
-}
-
-/* ------------------------------------------------------------------------- */
-
 static constexpr std::string_view defaultURL =
 	"wss://irc-ws.chat.twitch.tv:443";
 
@@ -519,38 +210,38 @@ void TwitchChatConnection::JoinChannel(const std::string &channelName)
 
 void TwitchChatConnection::HandleJoin(const IRCMessage &message)
 {
-	_joinedChannelName = std::get<std::string>(message.command.parameters);
+	_joinedChannelName = message.GetParameter();
 	vblog(LOG_INFO, "Twitch chat join was successful!");
 }
 
-void TwitchChatConnection::HandleNewMessage(const IRCMessage &message)
+void TwitchChatConnection::HandleNewMessage(const IRCMessagePtr &message)
 {
 	_messageDispatcher.DispatchMessage(message);
 	vblog(LOG_INFO, "Received new chat message %s",
-	      message.message.c_str());
+	      std::string(message->GetMessage()).c_str());
 }
 
-void TwitchChatConnection::HandleWhisper(const IRCMessage &message)
+void TwitchChatConnection::HandleWhisper(const IRCMessagePtr &message)
 {
 	_whisperDispatcher.DispatchMessage(message);
 	vblog(LOG_INFO, "Received new chat whisper message %s",
-	      message.message.c_str());
+	      std::string(message->GetMessage()).c_str());
 }
 
 void TwitchChatConnection::HandleNotice(const IRCMessage &message) const
 {
-	if (message.message == "Login unsuccessful") {
+	const std::string text(message.GetMessage());
+	if (text == "Login unsuccessful") {
 		blog(LOG_INFO, "Twitch chat connection was unsuccessful: %s",
-		     message.message.c_str());
+		     text.c_str());
 		return;
-	} else if (message.message ==
-		   "You don't have permission to perform that action") {
+	} else if (text == "You don't have permission to perform that action") {
 		blog(LOG_INFO,
 		     "No permission. Check if the access token is still valid");
 		return;
 	}
 
-	vblog(LOG_INFO, "Twitch chat notice: %s", message.message.c_str());
+	vblog(LOG_INFO, "Twitch chat notice: %s", text.c_str());
 }
 
 void TwitchChatConnection::HandleReconnect()
@@ -588,27 +279,28 @@ void TwitchChatConnection::OnMessage(
 		return;
 	}
 
-	std::string payload = message->get_payload();
-	auto messages = parseMessages(payload);
+	// The payload is not needed anymore, so it is moved into the buffer
+	// backing the parsed messages instead of being copied
+	auto messages = ParseIRCMessages(std::move(message->get_raw_payload()));
 
-	for (const auto &message : messages) {
-		if (message.command.command == authOKCommand) {
+	for (const auto &ircMessage : messages) {
+		const auto command = ircMessage->GetCommand();
+		if (command == authOKCommand) {
 			vblog(LOG_INFO,
 			      "Twitch chat connection authenticated!");
 			_authenticated = true;
 			JoinChannel(_channel.GetName());
-		} else if (message.command.command == pingCommand) {
-			Send("PONG " +
-			     std::get<std::string>(message.command.parameters));
-		} else if (message.command.command == joinOKCommand) {
-			HandleJoin(message);
-		} else if (message.command.command == newMessageCommand) {
-			HandleNewMessage(message);
-		} else if (message.command.command == whisperCommand) {
-			HandleWhisper(message);
-		} else if (message.command.command == noticeCommand) {
-			HandleNotice(message);
-		} else if (message.command.command == reconnectCommand) {
+		} else if (command == pingCommand) {
+			Send("PONG " + std::string(ircMessage->GetParameter()));
+		} else if (command == joinOKCommand) {
+			HandleJoin(*ircMessage);
+		} else if (command == newMessageCommand) {
+			HandleNewMessage(ircMessage);
+		} else if (command == whisperCommand) {
+			HandleWhisper(ircMessage);
+		} else if (command == noticeCommand) {
+			HandleNotice(*ircMessage);
+		} else if (command == reconnectCommand) {
 			HandleReconnect();
 		}
 	}
@@ -1,5 +1,6 @@
 #pragma once
 #include "channel-selection.hpp"
+#include "irc-message.hpp"
 #include "token.hpp"
 
 #include <condition_variable>
@@ -14,30 +15,6 @@ namespace advss {
 
 using websocketpp::connection_hdl;
 
-struct ParsedTags {
-	using BadgeMap = std::unordered_map<std::string, std::string>;
-	using EmoteMap = std::unordered_map<std::string,
-					    std::vector<std::pair<int, int>>>;
-	using EmoteSet = std::vector<std::string>;
-	std::unordered_map<std::string, std::variant<std::string, BadgeMap,
-						     EmoteMap, EmoteSet>>
-		tagMap;
-};
-
-struct IRCMessage {
-	ParsedTags tags;
-	struct {
-		std::string nick;
-		std::string host;
-	} source;
-	struct {
-		std::string command;
-		std::variant<std::string, bool, std::vector<std::string>>
-			parameters;
-	} command;
-	std::string message;
-};
-
 using ChatMessageBuffer = std::shared_ptr<MessageBuffer<IRCMessage>>;
 using ChatMessageDispatcher = MessageDispatcher<IRCMessage>;
 
@@ -73,8 +50,8 @@ private:
 	void Authenticate();
 	void JoinChannel(const std::string &);
 	void HandleJoin(const IRCMessage &);
-	void HandleNewMessage(const IRCMessage &);
-	void HandleWhisper(const IRCMessage &);
+	void HandleNewMessage(const IRCMessagePtr &);
+	void HandleWhisper(const IRCMessagePtr &);
 	void HandleNotice(const IRCMessage &) const;
 	void HandleReconnect();
 
@@ -3,6 +3,7 @@
 #include "twitch-helpers.hpp"
 
 #include <log-helper.hpp>
+#include <nlohmann/json.hpp>
 
 namespace advss {
 
@@ -266,6 +267,26 @@ bool EventSub::IsValidID(const std::string &id)
 	return !_sessionID.empty() && id == _sessionID;
 }
 
+static const nlohmann::json &getObject(const nlohmann::json &json,
+				       const char *key)
+{
+	static const nlohmann::json empty = nlohmann::json::object();
+	auto it = json.find(key);
+	if (it == json.end() || !it->is_object()) {
+		return empty;
+	}
+	return *it;
+}
+
+static std::string getString(const nlohmann::json &json, const char *key)
+{
+	auto it = json.find(key);
+	if (it == json.end() || !it->is_string()) {
+		return "";
+	}
+	return it->get<std::string>();
+}
+
 void EventSub::OnMessage(connection_hdl, EventSubWSClient::message_ptr message)
 {
 	if (!message) {
@@ -275,30 +296,36 @@ void EventSub::OnMessage(connection_hdl, EventSubWSClient::message_ptr message)
 		return;
 	}
 
-	std::string payload = message->get_payload();
-	OBSDataAutoRelease json = obs_data_create_from_json(payload.c_str());
-	if (!json) {
+	const auto &payload = message->get_payload();
+	nlohmann::json json;
+	try {
+		json = nlohmann::json::parse(payload);
+	} catch (const nlohmann::json::exception &) {
+		blog(LOG_ERROR, "invalid JSON payload received for '%s'",
+		     payload.c_str());
+		return;
+	}
+	if (!json.is_object()) {
 		blog(LOG_ERROR, "invalid JSON payload received for '%s'",
 		     payload.c_str());
 		return;
 	}
 
-	OBSDataAutoRelease metadata = obs_data_get_obj(json, "metadata");
-	std::string timestamp =
-		obs_data_get_string(metadata, "message_timestamp");
+	const auto &metadata = getObject(json, "metadata");
+	std::string timestamp = getString(metadata, "message_timestamp");
 	if (!isValidTimestamp(timestamp)) {
 		blog(LOG_WARNING,
 		     "Discarding Twitch EventSub with invalid timestamp");
 		return;
 	}
-	std::string id = obs_data_get_string(metadata, "message_id");
+	std::string id = getString(metadata, "message_id");
 	if (!IsValidMessageID(id)) {
 		blog(LOG_WARNING,
 		     "Discarding Twitch EventSub with invalid message_id");
 		return;
 	}
-	std::string messageType = obs_data_get_string(metadata, "message_type");
-	OBSDataAutoRelease payloadJson = obs_data_get_obj(json, "payload");
+	std::string messageType = getString(metadata, "message_type");
+	const auto &payloadJson = getObject(json, "payload");
 	if (messageType == "session_welcome") {
 		HandleWelcome(payloadJson);
 	} else if (messageType == "session_keepalive") {
@@ -315,10 +342,10 @@ void EventSub::OnMessage(connection_hdl, EventSubWSClient::message_ptr message)
 	}
 }
 
-void EventSub::HandleWelcome(obs_data_t *data)
+void EventSub::HandleWelcome(const nlohmann::json &data)
 {
-	OBSDataAutoRelease session = obs_data_get_obj(data, "session");
-	_sessionID = obs_data_get_string(session, "id");
+	const auto &session = getObject(data, "session");
+	_sessionID = getString(session, "id");
 	blog(LOG_INFO, "Twitch EventSub connected");
 }
 
@@ -327,44 +354,47 @@ void EventSub::HandleKeepAlive() const
 	// Nothing to do
 }
 
-void EventSub::HandleNotification(obs_data_t *data)
+void EventSub::HandleNotification(const nlohmann::json &data)
 {
-	Event event;
-	OBSDataAutoRelease subscription =
-		obs_data_get_obj(data, "subscription");
-	event.id = obs_data_get_string(subscription, "id");
-	event.type = obs_data_get_string(subscription, "type");
-	OBSDataAutoRelease eventData = obs_data_get_obj(data, "event");
-	event.data = eventData;
-	_dispatcher.DispatchMessage(event);
+	auto event = std::make_shared<Event>();
+	const auto &subscription = getObject(data, "subscription");
+	event->id = getString(subscription, "id");
+	event->type = getString(subscription, "type");
+	const auto &eventData = getObject(data, "event");
+	event->json = eventData.dump();
+	event->fields.reserve(eventData.size());
+	for (auto it = eventData.begin(); it != eventData.end(); ++it) {
+		event->fields.emplace_back(it.key(),
+					   it->is_string()
+						   ? it->get<std::string>()
+						   : it->dump());
+	}
+	_dispatcher.DispatchMessage(std::move(event));
 }
 
-void EventSub::HandleReconnect(obs_data_t *data)
+void EventSub::HandleReconnect(const nlohmann::json &data)
 {
-	OBSDataAutoRelease session = obs_data_get_obj(data, "session");
-	auto id = obs_data_get_string(session, "id");
+	const auto &session = getObject(data, "session");
+	auto id = getString(session, "id");
 	if (!IsValidID(id)) {
 		vblog(LOG_INFO,
 		      "ignoring Twitch EventSub reconnect message with invalid id");
 		return;
 	}
-	_url = obs_data_get_string(session, "reconnect_url");
+	_url = getString(session, "reconnect_url");
 	websocketpp::lib::error_code ec;
 	_client.close(_connection, websocketpp::close::status::normal,
 		      "Twitch EventSub reconnecting", ec);
 }
 
-void EventSub::HanldeRevocation(obs_data_t *data)
+void EventSub::HanldeRevocation(const nlohmann::json &data)
 {
-	OBSDataAutoRelease subscription =
-		obs_data_get_obj(data, "subscription");
-	auto id = obs_data_get_string(subscription, "id");
-	auto status = obs_data_get_string(subscription, "status");
-	auto type = obs_data_get_string(subscription, "type");
-	auto version = obs_data_get_string(subscription, "version");
-	OBSDataAutoRelease condition =
-		obs_data_get_obj(subscription, "condition");
-	auto conditionJson = obs_data_get_json(condition);
+	const auto &subscription = getObject(data, "subscription");
+	auto id = getString(subscription, "id");
+	auto status = getString(subscription, "status");
+	auto type = getString(subscription, "type");
+	auto version = getString(subscription, "version");
+	auto conditionJson = getObject(subscription, "condition").dump();
 	blog(LOG_INFO,
 	     "Twitch EventSub revoked:\n"
 	     "id: %s\n"
@@ -372,7 +402,8 @@ void EventSub::HanldeRevocation(obs_data_t *data)
 	     "type: %s\n"
 	     "version: %s\n"
 	     "condition: %s\n",
-	     id, status, type, version, conditionJson ? conditionJson : "");
+	     id.c_str(), status.c_str(), type.c_str(), version.c_str(),
+	     conditionJson.c_str());
 
 	std::lock_guard<std::mutex> lock(_subscriptionMtx);
 	for (auto it = _activeSubscriptions.begin();
@@ -412,10 +443,14 @@ bool Subscription::operator<(const Subscription &other) const
 	return jsonString < otherJsonString;
 }
 
-std::string Event::ToString() const
+std::string Event::GetField(const std::string &name) const
 {
-	auto json = obs_data_get_json(data);
-	return json ? json : "";
+	for (const auto &[key, value] : fields) {
+		if (key == name) {
+			return value;
+		}
+	}
+	return "";
 }
 
 } // namespace advss
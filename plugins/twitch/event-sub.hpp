@@ -1,6 +1,7 @@
 #pragma once
 #include "message-dispatcher.hpp"
 
+#include <nlohmann/json_fwd.hpp>
 #include <obs.hpp>
 #include <websocketpp/client.hpp>
 #include <QObject>
@@ -32,12 +33,19 @@ using websocketpp::connection_hdl;
 using EventSubMessageBuffer = std::shared_ptr<MessageBuffer<Event>>;
 using EventSubMessageDispatcher = MessageDispatcher<Event>;
 
+// Events are parsed once when they are received and then shared by all
+// conditions, which is why all data the conditions need is extracted up front
 struct Event {
 	std::string id;
 	std::string type;
-	OBSData data;
-
-	std::string ToString() const;
+	// The "event" object of the notification serialized as JSON
+	std::string json;
+	// Top level fields of the "event" object.
+	// Values which are not strings are serialized as JSON.
+	std::vector<std::pair<std::string, std::string>> fields;
+
+	std::string GetField(const std::string &name) const;
+	const std::string &ToString() const { return json; }
 };
 
 struct Subscription {
@@ -70,11 +78,11 @@ private:
 	bool IsValidMessageID(const std::string &);
 	bool IsValidID(const std::string &);
 
-	void HandleWelcome(obs_data_t *);
+	void HandleWelcome(const nlohmann::json &);
 	void HandleKeepAlive() const;
-	void HandleNotification(obs_data_t *);
-	void HandleReconnect(obs_data_t *);
-	void HanldeRevocation(obs_data_t *);
+	void HandleNotification(const nlohmann::json &);
+	void HandleReconnect(const nlohmann::json &);
+	void HanldeRevocation(const nlohmann::json &);
 
 	void RegisterInstance();
 	void UnregisterInstance();
@@ -0,0 +1,73 @@
+#include "http-client-pool.hpp"
+
+namespace advss {
+
+HttpClientPool::Client::Client(HttpClientPool *pool, const std::string &uri,
+			       std::unique_ptr<httplib::Client> &&client)
+	: _pool(pool),
+	  _uri(uri),
+	  _client(std::move(client))
+{
+}
+
+HttpClientPool::Client::~Client()
+{
+	// Moved from clients have nothing to return
+	if (!_client) {
+		return;
+	}
+	_pool->Release(_uri, std::move(_client));
+}
+
+HttpClientPool::HttpClientPool(size_t maxIdleClientsPerHost)
+	: _maxIdleClientsPerHost(maxIdleClientsPerHost)
+{
+}
+
+HttpClientPool::Client HttpClientPool::Acquire(const std::string &uri)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto &clients = _idleClients[uri];
+		if (!clients.empty()) {
+			auto client = std::move(clients.back());
+			clients.pop_back();
+			return Client(this, uri, std::move(client));
+		}
+	}
+
+	auto client = std::make_unique<httplib::Client>(uri);
+	client->set_keep_alive(true);
+	++_created;
+	return Client(this, uri, std::move(client));
+}
+
+void HttpClientPool::Release(const std::string &uri,
+			     std::unique_ptr<httplib::Client> &&client)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto &clients = _idleClients[uri];
+	if (clients.size() >= _maxIdleClientsPerHost) {
+		// Closes the connection
+		return;
+	}
+	clients.emplace_back(std::move(client));
+}
+
+void HttpClientPool::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_idleClients.clear();
+}
+
+size_t HttpClientPool::IdleCount(const std::string &uri)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _idleClients.find(uri);
+	if (it == _idleClients.end()) {
+		return 0;
+	}
+	return it->second.size();
+}
+
+} // namespace advss
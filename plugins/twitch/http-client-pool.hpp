@@ -0,0 +1,62 @@
+#pragma once
+#include <httplib.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Keeps the connections of finished requests alive so later requests to the
+// same host can reuse them instead of having to perform a new TCP and TLS
+// handshake each time.
+//
+// A httplib::Client must not be used by multiple threads at the same time, so
+// each request borrows a client exclusively, which is returned to the pool
+// once the Client handle goes out of scope.
+class HttpClientPool {
+public:
+	class Client {
+	public:
+		Client(Client &&) = default;
+		Client &operator=(Client &&) = delete;
+		~Client();
+
+		httplib::Client *operator->() const { return _client.get(); }
+		httplib::Client &operator*() const { return *_client; }
+
+	private:
+		Client(HttpClientPool *, const std::string &uri,
+		       std::unique_ptr<httplib::Client> &&);
+
+		HttpClientPool *_pool;
+		std::string _uri;
+		std::unique_ptr<httplib::Client> _client;
+
+		friend class HttpClientPool;
+	};
+
+	explicit HttpClientPool(size_t maxIdleClientsPerHost = 4);
+
+	// The pool has to outlive all clients acquired from it
+	Client Acquire(const std::string &uri);
+	void Clear();
+
+	size_t IdleCount(const std::string &uri);
+	uint64_t CreatedCount() const { return _created; }
+
+private:
+	void Release(const std::string &uri, std::unique_ptr<httplib::Client> &&);
+
+	const size_t _maxIdleClientsPerHost;
+	std::mutex _mutex;
+	std::unordered_map<std::string,
+			   std::vector<std::unique_ptr<httplib::Client>>>
+		_idleClients;
+	std::atomic_uint64_t _created = {0};
+};
+
+} // namespace advss
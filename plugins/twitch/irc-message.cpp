@@ -0,0 +1,260 @@
+#include "irc-message.hpp"
+
+#include <log-helper.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+
+namespace advss {
+
+namespace {
+
+struct Frame {
+	std::string payload;
+	std::vector<IRCMessage> messages;
+};
+
+} // namespace
+
+template<class Func>
+static void forEachPart(std::string_view str, char delimiter, Func &&func)
+{
+	size_t pos = 0;
+	size_t endPos;
+	while ((endPos = str.find(delimiter, pos)) != std::string_view::npos) {
+		func(str.substr(pos, endPos - pos));
+		pos = endPos + 1;
+	}
+	func(str.substr(pos));
+}
+
+static std::pair<std::string_view, std::string_view>
+splitOnce(std::string_view str, char delimiter)
+{
+	const auto pos = str.find(delimiter);
+	if (pos == std::string_view::npos) {
+		return {str, {}};
+	}
+	return {str.substr(0, pos), str.substr(pos + 1)};
+}
+
+static int toInt(std::string_view str)
+{
+	int value = 0;
+	std::from_chars(str.data(), str.data() + str.size(), value);
+	return value;
+}
+
+static bool isWhitespace(std::string_view str)
+{
+	return std::all_of(str.begin(), str.end(), [](char c) {
+		return std::isspace(static_cast<unsigned char>(c));
+	});
+}
+
+static ParsedTags::BadgeMap parseBadges(std::string_view value)
+{
+	ParsedTags::BadgeMap badgeMap;
+	forEachPart(value, ',', [&badgeMap](std::string_view badge) {
+		auto [name, version] = splitOnce(badge, '/');
+		badgeMap[std::string(name)] = std::string(version);
+	});
+	return badgeMap;
+}
+
+static ParsedTags::EmoteMap parseEmotes(std::string_view value)
+{
+	ParsedTags::EmoteMap emoteMap;
+	forEachPart(value, '/', [&emoteMap](std::string_view emote) {
+		auto [id, positions] = splitOnce(emote, ':');
+		auto &textPositions = emoteMap[std::string(id)];
+		forEachPart(positions, ',', [&](std::string_view position) {
+			auto [start, end] = splitOnce(position, '-');
+			textPositions.emplace_back(toInt(start), toInt(end));
+		});
+	});
+	return emoteMap;
+}
+
+static ParsedTags::EmoteSet parseEmoteSets(std::string_view value)
+{
+	ParsedTags::EmoteSet emoteSetIds;
+	forEachPart(value, ',', [&emoteSetIds](std::string_view id) {
+		emoteSetIds.emplace_back(id);
+	});
+	return emoteSetIds;
+}
+
+static ParsedTags parseTags(std::string_view tags)
+{
+	static constexpr std::array<std::string_view, 2> tagsToIgnore = {
+		"client-nonce", "flags"};
+
+	ParsedTags parsedTags;
+	if (tags.empty()) {
+		return parsedTags;
+	}
+
+	forEachPart(tags, ';', [&parsedTags](std::string_view tag) {
+		auto [name, value] = splitOnce(tag, '=');
+		if (std::find(tagsToIgnore.begin(), tagsToIgnore.end(),
+			      name) != tagsToIgnore.end()) {
+			return;
+		}
+
+		auto &parsedValue = parsedTags.tagMap[std::string(name)];
+		if (value.empty()) {
+			return;
+		}
+
+		if (name == "badges" || name == "badge-info") {
+			parsedValue = parseBadges(value);
+		} else if (name == "emotes") {
+			parsedValue = parseEmotes(value);
+		} else if (name == "emote-sets") {
+			parsedValue = parseEmoteSets(value);
+		} else {
+			parsedValue = std::string(value);
+		}
+	});
+
+	return parsedTags;
+}
+
+static void checkCommand(std::string_view command)
+{
+	static constexpr std::array<std::string_view, 23> knownCommands = {
+		"CAP", "421", "PING", "001", "JOIN", "PART", "NOTICE",
+		"CLEARCHAT", "HOSTTARGET", "PRIVMSG", "WHISPER", "RECONNECT",
+		"USERSTATE", "ROOMSTATE", "GLOBALUSERSTATE", "002", "003",
+		"004", "353", "366", "372", "375", "376"};
+
+	if (command == "RECONNECT") {
+		blog(LOG_INFO,
+		     "The Twitch IRC server is about to terminate the connection for maintenance.");
+	} else if (std::find(knownCommands.begin(), knownCommands.end(),
+			     command) == knownCommands.end()) {
+		vblog(LOG_INFO, "Unexpected IRC command: %s",
+		      std::string(command).c_str());
+	}
+}
+
+bool IRCMessage::Parse(std::string_view line)
+{
+	if (line.empty()) {
+		return false;
+	}
+
+	if (line[0] == '@') {
+		auto [tags, rest] = splitOnce(line.substr(1), ' ');
+		_rawTags = tags;
+		line = rest;
+	}
+
+	if (!line.empty() && line[0] == ':') {
+		auto [source, rest] = splitOnce(line.substr(1), ' ');
+		line = rest;
+		auto [nick, host] = splitOnce(source, '!');
+		// Assume the entire source is the host if no '!' is found
+		if (host.empty()) {
+			_host = nick;
+		} else {
+			_nick = nick;
+			_host = host;
+		}
+	}
+
+	auto [command, message] = splitOnce(line, ':');
+	_message = message;
+
+	auto [name, parameters] = splitOnce(command, ' ');
+	_command = name;
+	_parameter = splitOnce(parameters, ' ').first;
+	if (_command.empty()) {
+		return false;
+	}
+
+	checkCommand(_command);
+	return true;
+}
+
+std::optional<std::string_view> IRCMessage::GetTag(std::string_view name) const
+{
+	std::optional<std::string_view> result;
+	forEachPart(_rawTags, ';', [&](std::string_view tag) {
+		if (result) {
+			return;
+		}
+		auto [tagName, value] = splitOnce(tag, '=');
+		if (tagName == name) {
+			result = value;
+		}
+	});
+	return result;
+}
+
+const ParsedTags &IRCMessage::GetTags() const
+{
+	// Concurrent first accesses might both decode the tags, but only one
+	// of the results will be kept
+	auto tags = std::atomic_load(&_tags);
+	if (!tags) {
+		tags = std::make_shared<const ParsedTags>(parseTags(_rawTags));
+		std::shared_ptr<const ParsedTags> expected;
+		if (!std::atomic_compare_exchange_strong(&_tags, &expected,
+							 tags)) {
+			tags = expected;
+		}
+	}
+	return *tags;
+}
+
+std::vector<IRCMessagePtr> ParseIRCMessages(std::string &&payload)
+{
+	static constexpr std::string_view delimiter = "\r\n";
+
+	auto frame = std::make_shared<Frame>();
+	frame->payload = std::move(payload);
+	const std::string_view data = frame->payload;
+
+	// Count the lines first so the messages are stored in a single block
+	size_t lineCount = 1;
+	for (size_t pos = data.find(delimiter); pos != std::string_view::npos;
+	     pos = data.find(delimiter, pos + delimiter.length())) {
+		++lineCount;
+	}
+	frame->messages.reserve(lineCount);
+
+	size_t start = 0;
+	while (start <= data.length()) {
+		auto end = data.find(delimiter, start);
+		if (end == std::string_view::npos) {
+			end = data.length();
+		}
+		const auto line = data.substr(start, end - start);
+		start = end + delimiter.length();
+
+		if (isWhitespace(line)) {
+			continue;
+		}
+		IRCMessage message;
+		if (!message.Parse(line)) {
+			vblog(LOG_INFO, "discarding IRC message: %s",
+			      std::string(line).c_str());
+			continue;
+		}
+		frame->messages.emplace_back(std::move(message));
+	}
+
+	// The messages share ownership of the frame they were parsed from
+	std::vector<IRCMessagePtr> messages;
+	messages.reserve(frame->messages.size());
+	for (const auto &message : frame->messages) {
+		messages.emplace_back(frame, &message);
+	}
+	return messages;
+}
+
+} // namespace advss
@@ -0,0 +1,74 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace advss {
+
+struct ParsedTags {
+	using BadgeMap = std::unordered_map<std::string, std::string>;
+	using EmoteMap = std::unordered_map<std::string,
+					    std::vector<std::pair<int, int>>>;
+	using EmoteSet = std::vector<std::string>;
+	std::unordered_map<std::string, std::variant<std::string, BadgeMap,
+						     EmoteMap, EmoteSet>>
+		tagMap;
+};
+
+class IRCMessage;
+using IRCMessagePtr = std::shared_ptr<const IRCMessage>;
+
+// Splits the payload of a websocket frame into its IRC messages.
+//
+// The payload is moved into a buffer which is shared by all messages parsed
+// from it and the messages only reference the ranges of their components
+// within that buffer, so the number of allocations needed to parse a frame does
+// not depend on the length or the number of the messages it contains.
+// Lines without a command are discarded.
+std::vector<IRCMessagePtr> ParseIRCMessages(std::string &&payload);
+
+// A message received from the Twitch chat server.
+//
+// The returned views remain valid as long as the message itself is alive.
+// The tags are only decoded on first access of GetTags(), as most messages are
+// only matched against their text and never need them.
+class IRCMessage {
+public:
+	IRCMessage() = default;
+	IRCMessage(const IRCMessage &) = delete;
+	IRCMessage(IRCMessage &&) = default;
+	IRCMessage &operator=(const IRCMessage &) = delete;
+	IRCMessage &operator=(IRCMessage &&) = default;
+
+	std::string_view GetCommand() const { return _command; }
+	// First parameter of the command, e.g. the channel of a PRIVMSG
+	std::string_view GetParameter() const { return _parameter; }
+	std::string_view GetNick() const { return _nick; }
+	std::string_view GetHost() const { return _host; }
+	std::string_view GetMessage() const { return _message; }
+	std::string_view GetRawTags() const { return _rawTags; }
+
+	// Looks up the raw value of a single tag without decoding the others
+	std::optional<std::string_view> GetTag(std::string_view name) const;
+	const ParsedTags &GetTags() const;
+
+private:
+	bool Parse(std::string_view line);
+
+	std::string_view _rawTags;
+	std::string_view _nick;
+	std::string_view _host;
+	std::string_view _command;
+	std::string_view _parameter;
+	std::string_view _message;
+	// Only accessed using std::atomic_load() and std::atomic_store()
+	mutable std::shared_ptr<const ParsedTags> _tags;
+
+	friend std::vector<IRCMessagePtr> ParseIRCMessages(std::string &&);
+};
+
+} // namespace advss
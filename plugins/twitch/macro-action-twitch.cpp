@@ -90,6 +90,44 @@ const static std::map<MacroActionTwitch::RedemptionStatus, std::string>
 		{MacroActionTwitch::RedemptionStatus::FULFILLED, "FULFILLED"},
 };
 
+// Requests are sent asynchronously so the macro does not have to wait for
+// the reply, which is only used for logging
+static RequestCallback logFailure(const std::string &message,
+				  int expectedStatus)
+{
+	return [message, expectedStatus](const RequestResult &result) {
+		if (result.status != expectedStatus) {
+			blog(LOG_INFO, "%s (%d)", message.c_str(),
+			     result.status);
+		}
+	};
+}
+
+static void logCommercialResult(const RequestResult &result)
+{
+	if (result.status == 200) {
+		OBSDataArrayAutoRelease replyArray =
+			obs_data_get_array(result.data, "data");
+		OBSDataAutoRelease replyData =
+			obs_data_array_item(replyArray, 0);
+		vblog(LOG_INFO,
+		      "Commercial started! (%d)\n"
+		      "length: %lld\n"
+		      "message: %s\n"
+		      "retry_after: %lld\n",
+		      result.status, obs_data_get_int(replyData, "length"),
+		      obs_data_get_string(replyData, "message"),
+		      obs_data_get_int(replyData, "retry_after"));
+	} else {
+		blog(LOG_INFO,
+		     "Failed to start commercial! (%d)\n"
+		     "error: %s\n"
+		     "message: %s\n",
+		     result.status, obs_data_get_string(result.data, "error"),
+		     obs_data_get_string(result.data, "message"));
+	}
+}
+
 void MacroActionTwitch::SetStreamTitle(
 	const std::shared_ptr<TwitchToken> &token) const
 {
@@ -99,15 +137,11 @@ void MacroActionTwitch::SetStreamTitle(
 
 	OBSDataAutoRelease data = obs_data_create();
 	obs_data_set_string(data, "title", _streamTitle.c_str());
-	auto result = SendPatchRequest(*token, "https://api.twitch.tv",
-				       "/helix/channels",
-				       {{"broadcaster_id", token->GetUserID()}},
-				       data.Get());
-
-	if (result.status != 204) {
-		blog(LOG_INFO, "Failed to set stream title! (%d)",
-		     result.status);
-	}
+	SendPatchRequestAsync(*token, "https://api.twitch.tv",
+			      "/helix/channels",
+			      {{"broadcaster_id", token->GetUserID()}},
+			      data.Get(),
+			      logFailure("Failed to set stream title!", 204));
 }
 
 void MacroActionTwitch::SetStreamCategory(
@@ -120,15 +154,11 @@ void MacroActionTwitch::SetStreamCategory(
 	OBSDataAutoRelease data = obs_data_create();
 	obs_data_set_string(data, "game_id",
 			    std::to_string(_category.id).c_str());
-	auto result = SendPatchRequest(*token, "https://api.twitch.tv",
-				       "/helix/channels",
-				       {{"broadcaster_id", token->GetUserID()}},
-				       data.Get());
-
-	if (result.status != 204) {
-		blog(LOG_INFO, "Failed to set stream category! (%d)",
-		     result.status);
-	}
+	SendPatchRequestAsync(*token, "https://api.twitch.tv",
+			      "/helix/channels",
+			      {{"broadcaster_id", token->GetUserID()}},
+			      data.Get(),
+			      logFailure("Failed to set stream category!", 204));
 }
 
 void MacroActionTwitch::CreateStreamMarker(
@@ -142,12 +172,9 @@ void MacroActionTwitch::CreateStreamMarker(
 				    _markerDescription.c_str());
 	}
 
-	auto result = SendPostRequest(*token, "https://api.twitch.tv",
-				      "/helix/streams/markers", {}, data.Get());
-
-	if (result.status != 200) {
-		blog(LOG_INFO, "Failed to create marker! (%d)", result.status);
-	}
+	SendPostRequestAsync(*token, "https://api.twitch.tv",
+			     "/helix/streams/markers", {}, data.Get(),
+			     logFailure("Failed to create marker!", 200));
 }
 
 void MacroActionTwitch::CreateStreamClip(
@@ -155,14 +182,11 @@ void MacroActionTwitch::CreateStreamClip(
 {
 	auto hasDelay = _clipHasDelay ? "true" : "false";
 
-	auto result = SendPostRequest(*token, "https://api.twitch.tv",
-				      "/helix/clips",
-				      {{"broadcaster_id", token->GetUserID()},
-				       {"has_delay", hasDelay}});
-
-	if (result.status != 202) {
-		blog(LOG_INFO, "Failed to create clip! (%d)", result.status);
-	}
+	SendPostRequestAsync(*token, "https://api.twitch.tv", "/helix/clips",
+			     {{"broadcaster_id", token->GetUserID()},
+			      {"has_delay", hasDelay}},
+			     nullptr,
+			     logFailure("Failed to create clip!", 202));
 }
 
 void MacroActionTwitch::StartCommercial(
@@ -171,31 +195,9 @@ void MacroActionTwitch::StartCommercial(
 	OBSDataAutoRelease data = obs_data_create();
 	obs_data_set_string(data, "broadcaster_id", token->GetUserID().c_str());
 	obs_data_set_int(data, "length", _duration.Seconds());
-	auto result = SendPostRequest(*token, "https://api.twitch.tv",
-				      "/helix/channels/commercial", {},
-				      data.Get());
-
-	if (result.status == 200) {
-		OBSDataArrayAutoRelease replyArray =
-			obs_data_get_array(result.data, "data");
-		OBSDataAutoRelease replyData =
-			obs_data_array_item(replyArray, 0);
-		vblog(LOG_INFO,
-		      "Commercial started! (%d)\n"
-		      "length: %lld\n"
-		      "message: %s\n"
-		      "retry_after: %lld\n",
-		      result.status, obs_data_get_int(replyData, "length"),
-		      obs_data_get_string(replyData, "message"),
-		      obs_data_get_int(replyData, "retry_after"));
-	} else {
-		blog(LOG_INFO,
-		     "Failed to start commercial! (%d)\n"
-		     "error: %s\n"
-		     "message: %s\n",
-		     result.status, obs_data_get_string(result.data, "error"),
-		     obs_data_get_string(result.data, "message"));
-	}
+	SendPostRequestAsync(*token, "https://api.twitch.tv",
+			     "/helix/channels/commercial", {}, data.Get(),
+			     logCommercialResult);
 }
 
 void MacroActionTwitch::SendChatAnnouncement(
@@ -208,15 +210,11 @@ void MacroActionTwitch::SendChatAnnouncement(
 		announcementColorsTwitch.at(_announcementColor).c_str());
 	auto userId = token->GetUserID();
 
-	auto result = SendPostRequest(
+	SendPostRequestAsync(
 		*token, "https://api.twitch.tv", "/helix/chat/announcements",
 		{{"broadcaster_id", userId}, {"moderator_id", userId}},
-		data.Get());
-
-	if (result.status != 204) {
-		blog(LOG_INFO, "Failed to send chat announcement! (%d)",
-		     result.status);
-	}
+		data.Get(),
+		logFailure("Failed to send chat announcement!", 204));
 }
 
 void MacroActionTwitch::SetChatEmoteOnlyMode(
@@ -226,15 +224,13 @@ void MacroActionTwitch::SetChatEmoteOnlyMode(
 	obs_data_set_bool(data, "emote_mode", enable);
 	auto userId = token->GetUserID();
 
-	auto result = SendPatchRequest(
+	const std::string failureMessage =
+		std::string("Failed to ") + (enable ? "enable" : "disable") +
+		" chat's emote-only mode!";
+	SendPatchRequestAsync(
 		*token, "https://api.twitch.tv", "/helix/chat/settings",
 		{{"broadcaster_id", userId}, {"moderator_id", userId}},
-		data.Get());
-
-	if (result.status != 200) {
-		blog(LOG_INFO, "Failed to %s chat's emote-only mode! (%d)",
-		     enable ? "enable" : "disable", result.status);
-	}
+		data.Get(), logFailure(failureMessage, 200));
 }
 
 void MacroActionTwitch::StartRaid(const std::shared_ptr<TwitchToken> &token)
@@ -244,12 +240,9 @@ void MacroActionTwitch::StartRaid(const std::shared_ptr<TwitchToken> &token)
 			    token->GetUserID().c_str());
 	obs_data_set_string(data, "to_broadcaster_id",
 			    _channel.GetUserID(*token).c_str());
-	auto result = SendPostRequest(*token, "https://api.twitch.tv",
-				      "/helix/raids", {}, data.Get());
-
-	if (result.status != 200) {
-		blog(LOG_INFO, "Failed to start raid! (%d)\n", result.status);
-	}
+	SendPostRequestAsync(*token, "https://api.twitch.tv", "/helix/raids",
+			     {}, data.Get(),
+			     logFailure("Failed to start raid!", 200));
 }
 
 void MacroActionTwitch::SendChatMessage(
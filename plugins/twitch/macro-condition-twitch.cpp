@@ -4,7 +4,6 @@
 #include <layout-helpers.hpp>
 #include <macro-helpers.hpp>
 #include <log-helper.hpp>
-#include <nlohmann/json.hpp>
 
 namespace advss {
 
@@ -253,58 +252,25 @@ void MacroConditionTwitch::ResetChatConnection()
 	_chatConnection.reset();
 }
 
-static void
-setTempVarsHelper(const std::string &jsonStr,
-		  std::function<void(const char *, const char *)> setVar)
+void MacroConditionTwitch::SetEventTempVars(const Event &event)
 {
-	try {
-		auto json = nlohmann::json::parse(jsonStr);
-		for (auto it = json.begin(); it != json.end(); ++it) {
-			if (it->is_string()) {
-				setVar(it.key().c_str(),
-				       it->get<std::string>().c_str());
-				continue;
-			}
-			setVar(it.key().c_str(), it->dump().c_str());
-		}
-	} catch (const nlohmann::json::exception &e) {
-		vblog(LOG_INFO, "%s", jsonStr.c_str());
-		vblog(LOG_INFO, "%s", e.what());
+	for (const auto &[name, value] : event.fields) {
+		SetTempVarValue(name, value);
 	}
 }
 
-static void
-setTempVarsHelper(obs_data_t *data,
-		  std::function<void(const char *, const char *)> setVar)
-{
-	auto jsonStr = obs_data_get_json(data);
-	if (!jsonStr) {
-		return;
-	}
-
-	setTempVarsHelper(jsonStr, setVar);
-}
-
 bool MacroConditionTwitch::CheckChannelGenericEvents(TwitchToken &token)
 {
 	if (!_eventBuffer) {
 		return false;
 	}
 
-	while (!_eventBuffer->Empty()) {
-		auto event = _eventBuffer->ConsumeMessage();
-		if (!event) {
-			continue;
-		}
+	while (const auto event = _eventBuffer->ConsumeMessage()) {
 		if (_subscriptionID != event->id) {
 			continue;
 		}
 		SetVariableValue(event->ToString());
-		setTempVarsHelper(
-			event->data,
-			std::bind(&MacroConditionTwitch::SetTempVarValue, this,
-				  std::placeholders::_1,
-				  std::placeholders::_2));
+		SetEventTempVars(*event);
 
 		if (_clearBufferOnMatch) {
 			_eventBuffer->Clear();
@@ -321,11 +287,7 @@ bool MacroConditionTwitch::CheckChannelLiveEvents(TwitchToken &token)
 		return false;
 	}
 
-	while (!_eventBuffer->Empty()) {
-		auto event = _eventBuffer->ConsumeMessage();
-		if (!event) {
-			continue;
-		}
+	while (const auto event = _eventBuffer->ConsumeMessage()) {
 		if (_subscriptionID != event->id) {
 			continue;
 		}
@@ -335,18 +297,14 @@ bool MacroConditionTwitch::CheckChannelLiveEvents(TwitchToken &token)
 			continue;
 		}
 
-		auto type = obs_data_get_string(event->data, "type");
+		auto type = event->GetField("type");
 		const auto &typeId = it->second;
 		if (type != typeId) {
 			continue;
 		}
 
 		SetVariableValue(event->ToString());
-		setTempVarsHelper(
-			event->data,
-			std::bind(&MacroConditionTwitch::SetTempVarValue, this,
-				  std::placeholders::_1,
-				  std::placeholders::_2));
+		SetEventTempVars(*event);
 
 		if (_clearBufferOnMatch) {
 			_eventBuffer->Clear();
@@ -376,21 +334,18 @@ bool MacroConditionTwitch::CheckChatMessages(TwitchToken &token)
 			return false;
 		}
 		_chatBuffer = _chatConnection->RegisterForMessages();
+		CheckMacroOnNewMessages(GetMacro(), _chatBuffer);
 		return false;
 	}
 
-	while (!_chatBuffer->Empty()) {
-		auto message = _chatBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-		if (!stringMatches(_regexChat, message->message,
-				   _chatMessage)) {
+	while (const auto message = _chatBuffer->ConsumeMessage()) {
+		const std::string text(message->GetMessage());
+		if (!stringMatches(_regexChat, text, _chatMessage)) {
 			continue;
 		}
 
-		SetTempVarValue("chatter", message->source.nick);
-		SetTempVarValue("chat_message", message->message);
+		SetTempVarValue("chatter", std::string(message->GetNick()));
+		SetTempVarValue("chat_message", text);
 
 		if (_clearBufferOnMatch) {
 			_eventBuffer->Clear();
@@ -853,6 +808,7 @@ void MacroConditionTwitch::SetupEventSubscription(EventSub &eventSub)
 	}
 	RegisterEventSubscription();
 	_eventBuffer = eventSub.RegisterForEvents();
+	CheckMacroOnNewMessages(GetMacro(), _eventBuffer);
 }
 
 bool MacroConditionTwitch::IsUsingEventSubCondition()
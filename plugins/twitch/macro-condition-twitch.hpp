@@ -107,6 +107,7 @@ public:
 	bool _clearBufferOnMatch = false;
 
 private:
+	void SetEventTempVars(const Event &);
 	bool CheckChannelGenericEvents(TwitchToken &token);
 	bool CheckChannelLiveEvents(TwitchToken &token);
 	bool CheckChatMessages(TwitchToken &token);
@@ -0,0 +1,181 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace advss {
+
+// Caches the results of requests identified by a canonical key string.
+//
+// Entries expire after the TTL passed to Get() and the least recently used
+// entries are evicted once the cache holds more than the configured number of
+// entries.
+// Concurrent lookups of the same key, which is not cached yet, will share a
+// single in-flight request instead of each sending their own.
+template<class Value> class RequestCache {
+public:
+	using Clock = std::chrono::steady_clock;
+	using Fetch = std::function<Value()>;
+	using IsCacheable = std::function<bool(const Value &)>;
+
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		// Lookups which waited for the in-flight request of another
+		uint64_t coalesced = 0;
+		uint64_t evictions = 0;
+	};
+
+	explicit RequestCache(size_t maxEntries = 256);
+
+	// Returns the cached value if it is not older than the given TTL and
+	// calls fetch() otherwise.
+	// Values for which isCacheable() returns false, e.g. failed requests,
+	// are only shared with concurrent lookups and are not cached.
+	Value Get(const std::string &key, const Clock::duration &ttl,
+		  const Fetch &fetch, const IsCacheable &isCacheable = {});
+	void Clear();
+
+	size_t Size();
+	Stats GetStats();
+
+private:
+	struct Entry {
+		std::shared_future<Value> value;
+		// Identifies the request which created the entry
+		uint64_t id = 0;
+		bool done = false;
+		Clock::time_point time;
+		typename std::list<std::string>::iterator lruPos;
+	};
+	using EntryMap = std::unordered_map<std::string, Entry>;
+
+	void Erase(typename EntryMap::iterator);
+	void EvictIfNecessary();
+
+	const size_t _maxEntries;
+	std::mutex _mutex;
+	EntryMap _entries;
+	// Most recently used keys are at the front
+	std::list<std::string> _lru;
+	Stats _stats;
+	uint64_t _lastId = 0;
+};
+
+template<class Value>
+inline RequestCache<Value>::RequestCache(size_t maxEntries)
+	: _maxEntries(maxEntries)
+{
+}
+
+template<class Value>
+inline Value RequestCache<Value>::Get(const std::string &key,
+				      const Clock::duration &ttl,
+				      const Fetch &fetch,
+				      const IsCacheable &isCacheable)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _entries.find(key);
+	if (it != _entries.end()) {
+		auto &entry = it->second;
+		if (!entry.done) {
+			++_stats.coalesced;
+			auto value = entry.value;
+			lock.unlock();
+			return value.get();
+		}
+		if (Clock::now() - entry.time < ttl) {
+			++_stats.hits;
+			_lru.splice(_lru.begin(), _lru, entry.lruPos);
+			return entry.value.get();
+		}
+		Erase(it);
+	}
+
+	++_stats.misses;
+	std::promise<Value> promise;
+	auto value = promise.get_future().share();
+	_lru.emplace_front(key);
+	const auto id = ++_lastId;
+	_entries[key] = {value, id, false, {}, _lru.begin()};
+	EvictIfNecessary();
+	lock.unlock();
+
+	// The entry might have been removed by Clear() or replaced in the
+	// meantime, so it is only updated if it still belongs to this request
+	auto finishEntry = [&](bool keep) {
+		std::lock_guard<std::mutex> entryLock(_mutex);
+		auto entry = _entries.find(key);
+		if (entry == _entries.end() || entry->second.id != id) {
+			return;
+		}
+		if (!keep) {
+			Erase(entry);
+			return;
+		}
+		entry->second.done = true;
+		entry->second.time = Clock::now();
+	};
+
+	try {
+		auto result = fetch();
+		finishEntry(!isCacheable || isCacheable(result));
+		promise.set_value(result);
+		return result;
+	} catch (...) {
+		finishEntry(false);
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+}
+
+template<class Value> inline void RequestCache<Value>::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries.clear();
+	_lru.clear();
+}
+
+template<class Value> inline size_t RequestCache<Value>::Size()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _entries.size();
+}
+
+template<class Value>
+inline typename RequestCache<Value>::Stats RequestCache<Value>::GetStats()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+template<class Value>
+inline void RequestCache<Value>::Erase(typename EntryMap::iterator it)
+{
+	_lru.erase(it->second.lruPos);
+	_entries.erase(it);
+}
+
+template<class Value> inline void RequestCache<Value>::EvictIfNecessary()
+{
+	// In-flight requests are not evicted so that concurrent lookups can
+	// still find them
+	auto pos = _lru.end();
+	while (_entries.size() > _maxEntries && pos != _lru.begin()) {
+		--pos;
+		auto it = _entries.find(*pos);
+		if (!it->second.done) {
+			continue;
+		}
+		pos = _lru.erase(pos);
+		_entries.erase(it);
+		++_stats.evictions;
+	}
+}
+
+} // namespace advss
@@ -1,67 +1,146 @@
 #include "twitch-helpers.hpp"
+#include "http-client-pool.hpp"
+#include "request-cache.hpp"
 #include "token.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <log-helper.hpp>
+#include <plugin-state-helpers.hpp>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace advss {
 
 static constexpr std::string_view clientID = "ds5tt4ogliifsqc04mz3d3etnck3e5";
-static const int cacheTimeoutSeconds = 10;
+static constexpr std::chrono::seconds defaultCacheTTL(10);
+static const int requestWorkerCount = 4;
 
-const char *GetClientID()
+// Runs requests submitted using the Send*Async() functions.
+// Requests with the same key are run one after another in the order they
+// were added, so e.g. changes of the same setting cannot overtake each other.
+class RequestQueue {
+public:
+	~RequestQueue() { Stop(); }
+	void Add(const std::string &key, std::function<void()> &&);
+	void Stop();
+
+private:
+	struct Task {
+		std::string key;
+		std::function<void()> run;
+	};
+
+	void Worker();
+	std::deque<Task>::iterator FindRunnableTask();
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<Task> _tasks;
+	std::unordered_set<std::string> _runningKeys;
+	std::vector<std::thread> _workers;
+	bool _stop = false;
+};
+
+static HttpClientPool clientPool;
+static RequestQueue requestQueue;
+static RequestCache<RequestResult> requestCache;
+
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
 {
-	return clientID.data();
+	AddPluginCleanupStep([]() {
+		requestQueue.Stop();
+		clientPool.Clear();
+		const auto stats = requestCache.GetStats();
+		blog(LOG_INFO,
+		     "Twitch request cache: %llu hits, %llu misses, "
+		     "%llu coalesced, %llu evictions",
+		     (unsigned long long)stats.hits,
+		     (unsigned long long)stats.misses,
+		     (unsigned long long)stats.coalesced,
+		     (unsigned long long)stats.evictions);
+		requestCache.Clear();
+	});
+	return true;
 }
 
-class Args {
-public:
-	Args(const std::string &uri, const std::string &path,
-	     const std::string &data, httplib::Params params,
-	     httplib::Headers headers)
-		: _uri(uri),
-		  _path(path),
-		  _data(data),
-		  _params(params),
-		  _headers(headers)
-	{
+void RequestQueue::Add(const std::string &key, std::function<void()> &&task)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_workers.empty()) {
+		for (int i = 0; i < requestWorkerCount; i++) {
+			_workers.emplace_back([this]() { Worker(); });
+		}
 	}
-	bool operator<(const Args &other) const
+	_tasks.push_back({key, std::move(task)});
+	_cv.notify_one();
+}
+
+void RequestQueue::Stop()
+{
+	std::vector<std::thread> workers;
 	{
-		bool ret = true;
-		ret = ret && _uri < other._uri;
-		ret = ret && _path < other._path;
-		ret = ret && _params < other._params;
-		ret = ret && _data < other._data;
-		ret = ret && _headers < other._headers;
-		return ret;
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+		workers.swap(_workers);
+	}
+	_cv.notify_all();
+	for (auto &worker : workers) {
+		worker.join();
 	}
 
-private:
-	std::string _uri;
-	std::string _path;
-	std::string _data;
-	httplib::Params _params;
-	httplib::Headers _headers;
-};
+	// Requests which did not start yet are discarded, which will result
+	// in their futures reporting a broken promise
+	std::lock_guard<std::mutex> lock(_mutex);
+	_tasks.clear();
+	_runningKeys.clear();
+	_stop = false;
+}
 
-struct CacheEntry {
-	RequestResult result;
-	std::chrono::system_clock::time_point cacheTime =
-		std::chrono::system_clock::now();
-};
+// Must be called with _mutex locked
+std::deque<RequestQueue::Task>::iterator RequestQueue::FindRunnableTask()
+{
+	return std::find_if(_tasks.begin(), _tasks.end(),
+			    [this](const Task &task) {
+				    return _runningKeys.count(task.key) == 0;
+			    });
+}
 
-static bool cacheIsTooOld(const CacheEntry &cache)
+void RequestQueue::Worker()
 {
-	auto currentTime = std::chrono::system_clock::now();
-	auto diff = currentTime - cache.cacheTime;
-	return diff >= std::chrono::seconds(cacheTimeoutSeconds);
+	while (true) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this]() {
+				return _stop ||
+				       FindRunnableTask() != _tasks.end();
+			});
+			if (_stop) {
+				return;
+			}
+			auto it = FindRunnableTask();
+			task = std::move(*it);
+			_tasks.erase(it);
+			_runningKeys.insert(task.key);
+		}
+		task.run();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_runningKeys.erase(task.key);
+		// Requests with the same key might be waiting for this one
+		_cv.notify_all();
+	}
 }
 
-static bool cacheIsValid(const std::map<Args, CacheEntry> &cache,
-			 const Args &args)
+const char *GetClientID()
 {
-	auto it = cache.find(args);
-	return it != cache.end() && !cacheIsTooOld(it->second);
+	return clientID.data();
 }
 
 static httplib::Headers getTokenRequestHeaders(const std::string &token)
@@ -79,12 +158,12 @@ static std::string getRequestBody(const OBSData &data)
 }
 
 static RequestResult processResult(const httplib::Result &response,
-				   const char *funcName)
+				   const std::string &method)
 {
 	if (!response) {
 		auto err = response.error();
-		blog(LOG_WARNING, "Twitch request failed in %s with error: %s",
-		     funcName, httplib::to_string(err).c_str());
+		blog(LOG_WARNING, "Twitch %s request failed with error: %s",
+		     method.c_str(), httplib::to_string(err).c_str());
 
 		return {};
 	}
@@ -103,75 +182,99 @@ static RequestResult processResult(const httplib::Result &response,
 	return result;
 }
 
-RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
-			     const std::string &path,
-			     const httplib::Params &params)
+static RequestResult sendRequest(const std::string &method,
+				 const std::string &token,
+				 const std::string &uri,
+				 const std::string &path,
+				 const httplib::Params &params,
+				 const std::string &body)
 {
-	httplib::Client cli(uri);
-	auto tokenStr = token.GetToken();
-
-	if (!tokenStr) {
-		return {};
+	httplib::Request request;
+	request.method = method;
+	request.path = httplib::append_query_params(path, params);
+	request.headers = getTokenRequestHeaders(token);
+	if (method != "GET") {
+		request.set_header("Content-Type", "application/json");
+		request.body = body;
 	}
 
-	auto url = httplib::append_query_params(uri + path, params);
-	vblog(LOG_INFO, "Twitch GET request to %s began", url.c_str());
+	auto url = uri + request.path;
+	vblog(LOG_INFO, "Twitch %s request to %s began", method.c_str(),
+	      url.c_str());
 
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto response = cli.Get(path, params, headers);
+	// Reuses the connection of a previous request to this host if possible
+	auto client = clientPool.Acquire(uri);
+	auto response = client->send(request);
 
-	return processResult(response, __func__);
+	return processResult(response, method);
 }
 
-RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
-			     const std::string &path,
-			     const httplib::Params &params, bool useCache)
+static RequestResult sendRequest(const std::string &method,
+				 const TwitchToken &token,
+				 const std::string &uri,
+				 const std::string &path,
+				 const httplib::Params &params,
+				 const std::string &body = "")
 {
-	static std::map<Args, CacheEntry> cache;
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
 	auto tokenStr = token.GetToken();
-
 	if (!tokenStr) {
 		return {};
 	}
+	return sendRequest(method, *tokenStr, uri, path, params, body);
+}
 
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	Args args(uri, path, "", params, headers);
-
-	if (useCache && cacheIsValid(cache, args)) {
-		auto it = cache.find(args);
-		return it->second.result;
+static std::chrono::seconds getCacheTTL(const std::string &path)
+{
+	using std::chrono::seconds;
+	static const std::unordered_map<std::string, seconds> ttls = {
+		{"/helix/streams", seconds(10)},
+		{"/helix/channels", seconds(10)},
+		// User information like the ID is very unlikely to change
+		{"/helix/users", seconds(300)},
+	};
+	auto it = ttls.find(path);
+	if (it == ttls.end()) {
+		return defaultCacheTTL;
 	}
-
-	auto result = SendGetRequest(token, uri, path, params);
-	cache[args] = {result};
-
-	return result;
+	return it->second;
 }
 
-RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
-			      const std::string &path,
-			      const httplib::Params &params,
-			      const OBSData &data)
+static RequestResult sendCachedRequest(const std::string &method,
+				       const TwitchToken &token,
+				       const std::string &uri,
+				       const std::string &path,
+				       const httplib::Params &params,
+				       const std::string &body, bool useCache)
 {
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
-
 	if (!tokenStr) {
 		return {};
 	}
 
-	auto pathWithParams = httplib::append_query_params(path, params);
-	auto url = uri + pathWithParams;
-	vblog(LOG_INFO, "Twitch POST request to %s began", url.c_str());
+	auto send = [&]() {
+		return sendRequest(method, *tokenStr, uri, path, params, body);
+	};
+	if (!useCache) {
+		return send();
+	}
 
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto body = getRequestBody(data);
-	auto response =
-		cli.Post(pathWithParams, headers, body, "application/json");
+	// The query parameters are URL encoded and sorted by name, so this
+	// results in the same key for identical requests
+	const auto key = method + '\n' + *tokenStr + '\n' + uri +
+			 httplib::append_query_params(path, params) + '\n' +
+			 body;
+	auto isSuccess = [](const RequestResult &result) {
+		return result.status >= 200 && result.status < 300;
+	};
+	return requestCache.Get(key, getCacheTTL(path), send, isSuccess);
+}
 
-	return processResult(response, __func__);
+RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
+			     const std::string &path,
+			     const httplib::Params &params, bool useCache)
+{
+	return sendCachedRequest("GET", token, uri, path, params, "",
+				 useCache);
 }
 
 RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
@@ -179,155 +282,143 @@ RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
 			      const httplib::Params &params,
 			      const OBSData &data, bool useCache)
 {
-	static std::map<Args, CacheEntry> cache;
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
-	auto tokenStr = token.GetToken();
-
-	if (!tokenStr) {
-		return {};
-	}
-
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto body = getRequestBody(data);
-	Args args(uri, path, body, params, headers);
-
-	if (useCache && cacheIsValid(cache, args)) {
-		auto it = cache.find(args);
-		return it->second.result;
-	}
-
-	auto result = SendPostRequest(token, uri, path, params, data);
-	cache[args] = {result};
-
-	return result;
+	return sendCachedRequest("POST", token, uri, path, params,
+				 getRequestBody(data), useCache);
 }
 
 RequestResult SendPutRequest(const TwitchToken &token, const std::string &uri,
 			     const std::string &path,
-			     const httplib::Params &params, const OBSData &data)
+			     const httplib::Params &params, const OBSData &data,
+			     bool useCache)
 {
-	httplib::Client cli(uri);
-	auto tokenStr = token.GetToken();
-
-	if (!tokenStr) {
-		return {};
-	}
-
-	auto pathWithParams = httplib::append_query_params(path, params);
-	auto url = uri + pathWithParams;
-	vblog(LOG_INFO, "Twitch PUT request to %s began", url.c_str());
-
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto body = getRequestBody(data);
-	auto response =
-		cli.Put(pathWithParams, headers, body, "application/json");
+	return sendCachedRequest("PUT", token, uri, path, params,
+				 getRequestBody(data), useCache);
+}
 
-	return processResult(response, __func__);
+RequestResult SendPatchRequest(const TwitchToken &token, const std::string &uri,
+			       const std::string &path,
+			       const httplib::Params &params,
+			       const OBSData &data, bool useCache)
+{
+	return sendCachedRequest("PATCH", token, uri, path, params,
+				 getRequestBody(data), useCache);
 }
 
-RequestResult SendPutRequest(const TwitchToken &token, const std::string &uri,
-			     const std::string &path,
-			     const httplib::Params &params, const OBSData &data,
-			     bool useCache)
+static std::future<RequestResult>
+sendRequestAsync(const std::string &method, const TwitchToken &token,
+		 const std::string &uri, const std::string &path,
+		 const httplib::Params &params, const std::string &body,
+		 const RequestCallback &callback)
 {
-	static std::map<Args, CacheEntry> cache;
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
-	auto tokenStr = token.GetToken();
+	auto promise = std::make_shared<std::promise<RequestResult>>();
+	auto future = promise->get_future();
 
+	auto tokenStr = token.GetToken();
 	if (!tokenStr) {
-		return {};
+		RequestResult result;
+		if (callback) {
+			callback(result);
+		}
+		promise->set_value(result);
+		return future;
 	}
 
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto body = getRequestBody(data);
-	Args args(uri, path, body, params, headers);
-
-	if (useCache && cacheIsValid(cache, args)) {
-		auto it = cache.find(args);
-		return it->second.result;
-	}
-
-	auto result = SendPutRequest(token, uri, path, params, data);
-	cache[args] = {result};
+	// Requests to the same endpoint using the same token are kept in order
+	const auto key = *tokenStr + " " + uri + path;
+	requestQueue.Add(key, [method, tokenString = *tokenStr, uri, path,
+			       params, body, callback, promise]() {
+		auto result = sendRequest(method, tokenString, uri, path,
+					  params, body);
+		if (callback) {
+			callback(result);
+		}
+		promise->set_value(result);
+	});
+	return future;
+}
 
-	return result;
+RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
+			     const std::string &path,
+			     const httplib::Params &params)
+{
+	return sendRequest("GET", token, uri, path, params);
 }
 
-RequestResult SendPatchRequest(const TwitchToken &token, const std::string &uri,
-			       const std::string &path,
-			       const httplib::Params &params,
-			       const OBSData &data)
+std::future<RequestResult>
+SendGetRequestAsync(const TwitchToken &token, const std::string &uri,
+		    const std::string &path, const httplib::Params &params,
+		    const RequestCallback &callback)
 {
-	httplib::Client cli(uri);
-	auto tokenStr = token.GetToken();
+	return sendRequestAsync("GET", token, uri, path, params, "", callback);
+}
 
-	if (!tokenStr) {
-		return {};
-	}
+RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
+			      const std::string &path,
+			      const httplib::Params &params,
+			      const OBSData &data)
+{
+	return sendRequest("POST", token, uri, path, params,
+			   getRequestBody(data));
+}
 
-	auto pathWithParams = httplib::append_query_params(path, params);
-	auto url = uri + pathWithParams;
-	vblog(LOG_INFO, "Twitch PATCH request to %s began", url.c_str());
+std::future<RequestResult>
+SendPostRequestAsync(const TwitchToken &token, const std::string &uri,
+		     const std::string &path, const httplib::Params &params,
+		     const OBSData &data, const RequestCallback &callback)
+{
+	return sendRequestAsync("POST", token, uri, path, params,
+				getRequestBody(data), callback);
+}
 
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto body = getRequestBody(data);
-	auto response =
-		cli.Patch(pathWithParams, headers, body, "application/json");
+RequestResult SendPutRequest(const TwitchToken &token, const std::string &uri,
+			     const std::string &path,
+			     const httplib::Params &params, const OBSData &data)
+{
+	return sendRequest("PUT", token, uri, path, params,
+			   getRequestBody(data));
+}
 
-	return processResult(response, __func__);
+std::future<RequestResult>
+SendPutRequestAsync(const TwitchToken &token, const std::string &uri,
+		    const std::string &path, const httplib::Params &params,
+		    const OBSData &data, const RequestCallback &callback)
+{
+	return sendRequestAsync("PUT", token, uri, path, params,
+				getRequestBody(data), callback);
 }
 
 RequestResult SendPatchRequest(const TwitchToken &token, const std::string &uri,
 			       const std::string &path,
 			       const httplib::Params &params,
-			       const OBSData &data, bool useCache)
+			       const OBSData &data)
 {
-	static std::map<Args, CacheEntry> cache;
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
-	auto tokenStr = token.GetToken();
-
-	if (!tokenStr) {
-		return {};
-	}
-
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto body = getRequestBody(data);
-	Args args(uri, path, body, params, headers);
-
-	if (useCache && cacheIsValid(cache, args)) {
-		auto it = cache.find(args);
-		return it->second.result;
-	}
-
-	auto result = SendPatchRequest(token, uri, path, params, data);
-	cache[args] = {result};
+	return sendRequest("PATCH", token, uri, path, params,
+			   getRequestBody(data));
+}
 
-	return result;
+std::future<RequestResult>
+SendPatchRequestAsync(const TwitchToken &token, const std::string &uri,
+		      const std::string &path, const httplib::Params &params,
+		      const OBSData &data, const RequestCallback &callback)
+{
+	return sendRequestAsync("PATCH", token, uri, path, params,
+				getRequestBody(data), callback);
 }
 
 RequestResult SendDeleteRequest(const TwitchToken &token,
 				const std::string &uri, const std::string &path,
 				const httplib::Params &params)
 {
-	httplib::Client cli(uri);
-	auto tokenStr = token.GetToken();
-
-	if (!tokenStr) {
-		return {};
-	}
-
-	auto pathWithParams = httplib::append_query_params(path, params);
-	auto url = uri + pathWithParams;
-	vblog(LOG_INFO, "Twitch DELETE request to %s began", url.c_str());
-
-	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto response =
-		cli.Delete(pathWithParams, headers, "", "application/json");
+	return sendRequest("DELETE", token, uri, path, params);
+}
 
-	return processResult(response, __func__);
+std::future<RequestResult>
+SendDeleteRequestAsync(const TwitchToken &token, const std::string &uri,
+		       const std::string &path, const httplib::Params &params,
+		       const RequestCallback &callback)
+{
+	return sendRequestAsync("DELETE", token, uri, path, params, "",
+				callback);
 }
 
 } // namespace advss
@@ -3,6 +3,8 @@
 #include <obs.hpp>
 #include <string>
 #include <chrono>
+#include <functional>
+#include <future>
 
 namespace advss {
 
@@ -13,6 +15,8 @@ struct RequestResult {
 	OBSData data = nullptr;
 };
 
+using RequestCallback = std::function<void(const RequestResult &)>;
+
 const char *GetClientID();
 
 // These functions do *not* use or create RequestResult cache entries
@@ -35,8 +39,41 @@ RequestResult SendDeleteRequest(const TwitchToken &token,
 				const std::string &uri, const std::string &path,
 				const httplib::Params &params = {});
 
-// These functions will cache the RequestResult for 10s
-// Note that the cache will be reported as a "memory leak" on OBS shutdown
+// These functions send the request on a worker thread and return right away.
+// The optional callback is invoked on the worker thread once the request is
+// done.
+// Requests to the same endpoint using the same token are sent one after
+// another in the order of these calls.
+std::future<RequestResult>
+SendGetRequestAsync(const TwitchToken &token, const std::string &uri,
+		    const std::string &path, const httplib::Params &params = {},
+		    const RequestCallback &callback = {});
+std::future<RequestResult>
+SendPostRequestAsync(const TwitchToken &token, const std::string &uri,
+		     const std::string &path,
+		     const httplib::Params &params = {},
+		     const OBSData &data = nullptr,
+		     const RequestCallback &callback = {});
+std::future<RequestResult>
+SendPutRequestAsync(const TwitchToken &token, const std::string &uri,
+		    const std::string &path, const httplib::Params &params = {},
+		    const OBSData &data = nullptr,
+		    const RequestCallback &callback = {});
+std::future<RequestResult>
+SendPatchRequestAsync(const TwitchToken &token, const std::string &uri,
+		      const std::string &path,
+		      const httplib::Params &params = {},
+		      const OBSData &data = nullptr,
+		      const RequestCallback &callback = {});
+std::future<RequestResult>
+SendDeleteRequestAsync(const TwitchToken &token, const std::string &uri,
+		       const std::string &path,
+		       const httplib::Params &params = {},
+		       const RequestCallback &callback = {});
+
+// These functions will cache successful results for a duration depending on
+// the requested endpoint (10s by default).
+// Identical requests sent at the same time will share a single request.
 RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
 			     const std::string &path,
 			     const httplib::Params &params, bool useCache);
@@ -1,4 +1,5 @@
 #include "macro-condition-video.hpp"
+#include "video-asset-cache.hpp"
 
 #include <layout-helpers.hpp>
 #include <macro-condition-edit.hpp>
@@ -21,6 +22,15 @@ bool MacroConditionVideo::_registered = MacroConditionFactory::Register(
 	{MacroConditionVideo::Create, MacroConditionVideoEdit::Create,
 	 "AdvSceneSwitcher.condition.video"});
 
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	AddPluginCleanupStep([]() { VideoAssetCache::Stop(); });
+	return true;
+}
+
 const static std::map<VideoCondition, std::string> conditionTypes = {
 	{VideoCondition::MATCH,
 	 "AdvSceneSwitcher.condition.video.condition.match"},
@@ -84,18 +94,6 @@ const static std::map<tesseract::PageSegMode, std::string> pageSegModes = {
 	 "AdvSceneSwitcher.condition.video.ocrMode.sparseTextOSD"},
 };
 
-cv::CascadeClassifier initObjectCascade(std::string &path)
-{
-	cv::CascadeClassifier cascade;
-	try {
-		cascade.load(path);
-	} catch (...) {
-		blog(LOG_WARNING, "failed to load model data \"%s\"",
-		     path.c_str());
-	}
-	return cascade;
-}
-
 static bool requiresFileInput(VideoCondition t)
 {
 	return t == VideoCondition::MATCH || t == VideoCondition::DIFFER ||
@@ -139,8 +137,10 @@ bool MacroConditionVideo::CheckCondition()
 		return _lastMatchResult;
 	}
 
-	if (!FileInputIsUpToDate()) {
-		LoadImageFromFile();
+	// Files are loaded in the background once they are needed, so the
+	// last result is kept until they are available
+	if (!AssetsAvailable()) {
+		return _lastMatchResult;
 	}
 
 	if (_blockUntilScreenshotDone) {
@@ -191,6 +191,7 @@ bool MacroConditionVideo::Load(obs_data_t *obj)
 	SetCondition(static_cast<VideoCondition>(
 		obs_data_get_int(obj, "condition")));
 	_file = obs_data_get_string(obj, "filePath");
+	_patternMatchParameters.image.SetPath(_file);
 	_blockUntilScreenshotDone =
 		obs_data_get_bool(obj, "blockUntilScreenshotDone");
 	// TODO: Remove this fallback in a future version
@@ -206,14 +207,6 @@ bool MacroConditionVideo::Load(obs_data_t *obj)
 	_throttleEnabled = obs_data_get_bool(obj, "throttleEnabled");
 	_throttleCount = obs_data_get_int(obj, "throttleCount");
 	_areaParameters.Load(obj);
-	if (requiresFileInput(_condition)) {
-		(void)LoadImageFromFile();
-	}
-
-	if (_condition == VideoCondition::OBJECT) {
-		LoadModelData(_objMatchParameters.modelPath);
-	}
-
 	return true;
 }
 
@@ -239,39 +232,33 @@ void MacroConditionVideo::GetScreenshot(bool blocking)
 	_getNextScreenshot = false;
 }
 
+QImage MacroConditionVideo::GetMatchImage() const
+{
+	return requiresFileInput(_condition) ? GetPatternImage(true)
+					     : _matchImage;
+}
+
 bool MacroConditionVideo::LoadImageFromFile()
 {
-	const QFileInfo info(QString::fromStdString(_file));
-	_loadedFileLastModified = info.lastModified();
-	_loadedFile = _file;
-	if (!_matchImage.load(info.absoluteFilePath())) {
-		blog(LOG_WARNING, "Cannot load image data from file '%s'",
-		     _file.c_str());
-		(&_matchImage)->~QImage();
-		new (&_matchImage) QImage();
-		_patternImageData = {};
+	_patternMatchParameters.image.SetPath(_file);
+	const auto pattern = _patternMatchParameters.image.Get(true);
+	_lastPattern = pattern;
+	if (!pattern) {
 		return false;
 	}
-
-	_matchImage =
-		_matchImage.convertToFormat(QImage::Format::Format_RGBA8888);
-	_patternMatchParameters.image = _matchImage;
-	_patternImageData = CreatePatternData(_matchImage);
-
 	emit InputFileChanged();
 	return true;
 }
 
-bool MacroConditionVideo::LoadModelData(std::string &path)
+bool MacroConditionVideo::LoadModelData(const std::string &path)
 {
-	_objMatchParameters.modelPath = path;
-	_objMatchParameters.cascade = initObjectCascade(path);
-	return !_objMatchParameters.cascade.empty();
+	_objMatchParameters.SetModelPath(path);
+	return !!_objMatchParameters.model.Get(true);
 }
 
 std::string MacroConditionVideo::GetModelDataPath() const
 {
-	return _objMatchParameters.modelPath;
+	return _objMatchParameters.GetModelPath();
 }
 
 void MacroConditionVideo::SetPageSegMode(tesseract::PageSegMode mode)
@@ -290,10 +277,51 @@ void MacroConditionVideo::SetCondition(VideoCondition condition)
 	SetupTempVars();
 }
 
+void MacroConditionVideo::ResetLastMatch()
+{
+	_lastMatchResult = false;
+	_matchImage = QImage();
+}
+
+QImage MacroConditionVideo::GetPatternImage(bool wait) const
+{
+	const auto pattern = _patternMatchParameters.image.Get(wait);
+	return pattern ? pattern->image : QImage();
+}
+
+bool MacroConditionVideo::AssetsAvailable()
+{
+	if (requiresFileInput(_condition)) {
+		_patternMatchParameters.image.SetPath(_file);
+		const auto pattern = _patternMatchParameters.image.Get();
+		if (pattern != _lastPattern.lock()) {
+			_lastPattern = pattern;
+			emit InputFileChanged();
+		}
+		return pattern || _patternMatchParameters.image.LoadFailed();
+	}
+
+	switch (_condition) {
+	case VideoCondition::OBJECT:
+		return _objMatchParameters.model.LoadingDone();
+	case VideoCondition::OCR:
+		return _ocrParameters.LoadingDone();
+	default:
+		break;
+	}
+	return true;
+}
+
 bool MacroConditionVideo::ScreenshotContainsPattern()
 {
+	const auto pattern = _patternMatchParameters.image.Get();
+	if (!pattern) {
+		SetTempVarValue("patternCount", "0");
+		return false;
+	}
+
 	cv::Mat result;
-	MatchPattern(_screenshotData.image, _patternImageData,
+	MatchPattern(_screenshotData.image, pattern->data,
 		     _patternMatchParameters.threshold, result, nullptr,
 		     _patternMatchParameters.useAlphaAsMask,
 		     _patternMatchParameters.matchMode);
@@ -306,16 +334,6 @@ bool MacroConditionVideo::ScreenshotContainsPattern()
 	return count > 0;
 }
 
-bool MacroConditionVideo::FileInputIsUpToDate() const
-{
-	if (!requiresFileInput(_condition)) {
-		return true;
-	}
-	const QFileInfo info(QString::fromStdString(_file));
-	return (_loadedFileLastModified == info.lastModified()) &&
-	       (_file == _loadedFile);
-}
-
 bool MacroConditionVideo::OutputChanged()
 {
 	if (!_patternMatchParameters.useForChangedCheck) {
@@ -323,8 +341,8 @@ bool MacroConditionVideo::OutputChanged()
 	}
 
 	cv::Mat result;
-	_patternImageData = CreatePatternData(_matchImage);
-	MatchPattern(_screenshotData.image, _patternImageData,
+	const auto patternData = CreatePatternData(_matchImage);
+	MatchPattern(_screenshotData.image, patternData,
 		     _patternMatchParameters.threshold, result, nullptr,
 		     _patternMatchParameters.useAlphaAsMask,
 		     _patternMatchParameters.matchMode);
@@ -336,12 +354,19 @@ bool MacroConditionVideo::OutputChanged()
 
 bool MacroConditionVideo::ScreenshotContainsObject()
 {
-	auto objects = MatchObject(_screenshotData.image,
-				   _objMatchParameters.cascade,
+	const auto model = _objMatchParameters.model.Get();
+	if (!model) {
+		SetTempVarValue("objectCount", "0");
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(model->mutex);
+	auto objects = MatchObject(_screenshotData.image, model->cascade,
 				   _objMatchParameters.scaleFactor,
 				   _objMatchParameters.minNeighbors,
 				   _objMatchParameters.minSize.CV(),
 				   _objMatchParameters.maxSize.CV());
+	lock.unlock();
 	const auto count = objects.size();
 	SetTempVarValue("objectCount", std::to_string(count));
 	return count > 0;
@@ -356,12 +381,12 @@ bool MacroConditionVideo::CheckBrightnessThreshold()
 
 bool MacroConditionVideo::CheckOCR()
 {
-	if (!_ocrParameters.Initialized()) {
+	const auto result = _ocrParameters.Recognize(_screenshotData.image);
+	if (!result) {
 		return false;
 	}
 
-	auto text = RunOCR(_ocrParameters.GetOCR(), _screenshotData.image,
-			   _ocrParameters.color, _ocrParameters.colorThreshold);
+	const auto &text = *result;
 	SetVariableValue(text);
 	SetTempVarValue("text", text);
 	if (!_ocrParameters.regex.Enabled()) {
@@ -394,9 +419,9 @@ bool MacroConditionVideo::Compare()
 
 	switch (_condition) {
 	case VideoCondition::MATCH:
-		return _screenshotData.image == _matchImage;
+		return _screenshotData.image == GetPatternImage();
 	case VideoCondition::DIFFER:
-		return _screenshotData.image != _matchImage;
+		return _screenshotData.image != GetPatternImage();
 	case VideoCondition::HAS_CHANGED:
 		return OutputChanged();
 	case VideoCondition::HAS_NOT_CHANGED:
@@ -1329,23 +1354,11 @@ void MacroConditionVideoEdit::ConditionChanged(int cond)
 	_entryData->ResetLastMatch();
 	SetWidgetVisibility();
 
-	// Reload image data to avoid incorrect matches.
-	//
-	// Condition type HAS_NOT_CHANGED will use matchImage to store previous
-	// frame of video source, which will differ from the image stored at
-	// specified file location.
 	if (_entryData->LoadImageFromFile()) {
 		UpdatePreviewTooltip();
 	}
 	_previewDialog.PatternMatchParametersChanged(
 		_entryData->_patternMatchParameters);
-
-	if (_entryData->GetCondition() == VideoCondition::OBJECT) {
-		auto path = _entryData->GetModelDataPath();
-		_entryData->_objMatchParameters.cascade =
-			initObjectCascade(path);
-	}
-
 	SetupPreviewDialogParams();
 }
 
@@ -13,7 +13,6 @@
 
 #include <QCheckBox>
 #include <QComboBox>
-#include <QDateTime>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -39,12 +38,13 @@ public:
 	{
 		return std::make_shared<MacroConditionVideo>(m);
 	}
-	QImage GetMatchImage() const { return _matchImage; };
+	QImage GetMatchImage() const;
 	void GetScreenshot(bool blocking = false);
+	// Loads the pattern image or model on the calling thread
 	bool LoadImageFromFile();
-	bool LoadModelData(std::string &path);
+	bool LoadModelData(const std::string &path);
 	std::string GetModelDataPath() const;
-	void ResetLastMatch() { _lastMatchResult = false; }
+	void ResetLastMatch();
 	double GetCurrentBrightness() const { return _currentBrightness; }
 	void SetPageSegMode(tesseract::PageSegMode);
 	bool SetLanguage(const std::string &);
@@ -74,7 +74,8 @@ signals:
 	void InputFileChanged();
 
 private:
-	bool FileInputIsUpToDate() const;
+	bool AssetsAvailable();
+	QImage GetPatternImage(bool wait = false) const;
 
 	bool OutputChanged();
 	bool ScreenshotContainsPattern();
@@ -91,17 +92,15 @@ private:
 
 	bool _getNextScreenshot = true;
 	ScreenshotHelper _screenshotData;
+	// The previous frame for condition types which check for changes
 	QImage _matchImage;
-	PatternImageData _patternImageData;
+	std::weak_ptr<PatternImage> _lastPattern;
 
 	bool _lastMatchResult = false;
 	int _runCount = 0;
 
 	double _currentBrightness = 0.;
 
-	std::string _loadedFile;
-	QDateTime _loadedFileLastModified;
-
 	static bool _registered;
 	static const std::string id;
 };
@@ -5,6 +5,52 @@
 
 namespace advss {
 
+static std::shared_ptr<PatternImage>
+loadPatternImage(const std::string &, const std::string &content)
+{
+	QImage image;
+	if (!image.loadFromData(
+		    reinterpret_cast<const uchar *>(content.data()),
+		    static_cast<int>(content.size()))) {
+		return {};
+	}
+
+	auto pattern = std::make_shared<PatternImage>();
+	pattern->image = image.convertToFormat(QImage::Format::Format_RGBA8888);
+	pattern->data = CreatePatternData(pattern->image);
+	return pattern;
+}
+
+static std::shared_ptr<ObjDetectModel>
+loadObjDetectModel(const std::string &path, const std::string &)
+{
+	auto model = std::make_shared<ObjDetectModel>();
+	try {
+		model->cascade.load(path);
+	} catch (...) {
+		return {};
+	}
+	return model->cascade.empty() ? nullptr : model;
+}
+
+static std::shared_ptr<OCRModel> loadOCRModel(const std::string &path,
+					      const std::string &)
+{
+	const auto file = std::filesystem::u8path(path);
+	auto model = std::make_shared<OCRModel>();
+	model->ocr = std::make_unique<tesseract::TessBaseAPI>();
+	if (model->ocr->Init(file.parent_path().u8string().c_str(),
+			     file.stem().u8string().c_str()) != 0) {
+		return {};
+	}
+	return model;
+}
+
+PatternMatchParameters::PatternMatchParameters()
+	: image("pattern image", loadPatternImage)
+{
+}
+
 bool PatternMatchParameters::Save(obs_data_t *obj) const
 {
 	auto data = obs_data_create();
@@ -47,10 +93,18 @@ bool PatternMatchParameters::Load(obs_data_t *obj)
 	return true;
 }
 
+ObjDetectParameters::ObjDetectParameters()
+	: model("object detection model", loadObjDetectModel)
+{
+	SetModelPath(obs_get_module_data_path(obs_current_module()) +
+		     std::string("/res/cascadeClassifiers/"
+				 "haarcascade_frontalface_alt.xml"));
+}
+
 bool ObjDetectParameters::Save(obs_data_t *obj) const
 {
 	auto data = obs_data_create();
-	obs_data_set_string(data, "modelPath", modelPath.c_str());
+	obs_data_set_string(data, "modelPath", GetModelPath().c_str());
 	scaleFactor.Save(data, "scaleFactor");
 	obs_data_set_int(data, "minNeighbors", minNeighbors);
 	minSize.Save(data, "minSize");
@@ -76,7 +130,7 @@ bool ObjDetectParameters::Load(obs_data_t *obj)
 {
 	// TODO: Remove this fallback in a future version
 	if (!obs_data_has_user_value(obj, "patternMatchData")) {
-		modelPath = obs_data_get_string(obj, "modelDataPath");
+		SetModelPath(obs_data_get_string(obj, "modelDataPath"));
 		scaleFactor = obs_data_get_double(obj, "scaleFactor");
 		if (!isScaleFactorValid(scaleFactor)) {
 			scaleFactor = 1.1;
@@ -90,7 +144,7 @@ bool ObjDetectParameters::Load(obs_data_t *obj)
 		return true;
 	}
 	auto data = obs_data_get_obj(obj, "objectMatchData");
-	modelPath = obs_data_get_string(data, "modelPath");
+	SetModelPath(obs_data_get_string(data, "modelPath"));
 	scaleFactor.Load(data, "scaleFactor");
 	// TODO: Remove this fallback in a future version
 	if (!obs_data_has_user_value(data, "version")) {
@@ -109,6 +163,11 @@ bool ObjDetectParameters::Load(obs_data_t *obj)
 	return true;
 }
 
+void ObjDetectParameters::SetModelPath(const std::string &path)
+{
+	model.SetPath(path);
+}
+
 bool AreaParameters::Save(obs_data_t *obj) const
 {
 	auto data = obs_data_create();
@@ -233,49 +292,13 @@ static QColor LoadColor(obs_data_t *obj, const char *name)
 	return color;
 }
 
-OCRParameters::OCRParameters()
+static std::string getOCRModelPath(const std::string &languageCode)
 {
-	Setup();
+	return obs_get_module_data_path(obs_current_module()) +
+	       std::string("/res/ocr") + "/" + languageCode + ".traineddata";
 }
 
-OCRParameters::~OCRParameters()
-{
-	if (!initDone) {
-		return;
-	}
-	ocr->End();
-}
-
-OCRParameters::OCRParameters(const OCRParameters &other)
-	: text(other.text),
-	  regex(other.regex),
-	  color(other.color),
-	  colorThreshold(other.colorThreshold),
-	  pageSegMode(other.pageSegMode)
-{
-	if (!initDone) {
-		Setup();
-	}
-	if (initDone) {
-		ocr->SetPageSegMode(pageSegMode);
-	}
-}
-
-OCRParameters &OCRParameters::operator=(const OCRParameters &other)
-{
-	text = other.text;
-	regex = other.regex;
-	color = other.color;
-	colorThreshold = other.colorThreshold;
-	pageSegMode = other.pageSegMode;
-	if (!initDone) {
-		Setup();
-	}
-	if (initDone) {
-		ocr->SetPageSegMode(pageSegMode);
-	}
-	return *this;
-}
+OCRParameters::OCRParameters() : model("OCR language data", loadOCRModel) {}
 
 bool OCRParameters::Save(obs_data_t *obj) const
 {
@@ -306,29 +329,21 @@ bool OCRParameters::Load(obs_data_t *obj)
 	pageSegMode = static_cast<tesseract::PageSegMode>(
 		obs_data_get_int(data, "pageSegMode"));
 	obs_data_release(data);
-
-	if (initDone) {
-		ocr->SetPageSegMode(pageSegMode);
-	}
 	return true;
 }
 
 void OCRParameters::SetPageMode(tesseract::PageSegMode mode)
 {
 	pageSegMode = mode;
-	ocr->SetPageSegMode(mode);
 }
 
 bool OCRParameters::SetLanguageCode(const std::string &value)
 {
-	std::string dataPath = obs_get_module_data_path(obs_current_module()) +
-			       std::string("/res/ocr") + "/" + value +
-			       ".traineddata";
-	if (!std::filesystem::exists(dataPath)) {
+	if (!std::filesystem::exists(
+		    std::filesystem::u8path(getOCRModelPath(value)))) {
 		return false;
 	}
-	Setup();
-	ocr->SetPageSegMode(pageSegMode);
+	languageCode = value;
 	return true;
 }
 
@@ -337,20 +352,24 @@ std::string OCRParameters::GetLanguageCode() const
 	return languageCode;
 }
 
-void OCRParameters::Setup()
+bool OCRParameters::LoadingDone() const
 {
-	ocr = std::make_unique<tesseract::TessBaseAPI>();
-	if (!ocr) {
-		initDone = false;
-		return;
-	}
-	std::string dataPath = obs_get_module_data_path(obs_current_module()) +
-			       std::string("/res/ocr");
-	if (ocr->Init(dataPath.c_str(), languageCode.c_str()) != 0) {
-		initDone = false;
-		return;
+	model.SetPath(getOCRModelPath(languageCode));
+	return model.LoadingDone();
+}
+
+std::optional<std::string> OCRParameters::Recognize(const QImage &image,
+						    bool wait) const
+{
+	model.SetPath(getOCRModelPath(languageCode));
+	auto ocrModel = model.Get(wait);
+	if (!ocrModel) {
+		return {};
 	}
-	initDone = true;
+
+	std::lock_guard<std::mutex> lock(ocrModel->mutex);
+	ocrModel->ocr->SetPageSegMode(pageSegMode);
+	return RunOCR(ocrModel->ocr.get(), image, color, colorThreshold);
 }
 
 bool ColorParameters::Save(obs_data_t *obj) const
@@ -2,6 +2,7 @@
 #include "opencv-helpers.hpp"
 #include "obs-module-helper.hpp"
 #include "area-selection.hpp"
+#include "video-asset-cache.hpp"
 
 #include <source-selection.hpp>
 #include <scene-selection.hpp>
@@ -12,6 +13,7 @@
 #include <obs-module.h>
 
 #include <QMetaType>
+#include <optional>
 
 #ifdef OCR_SUPPORT
 #include <tesseract/baseapi.h>
@@ -51,50 +53,69 @@ public:
 	SceneSelection scene;
 };
 
+struct PatternImage {
+	QImage image;
+	PatternImageData data;
+};
+
 class PatternMatchParameters {
 public:
+	PatternMatchParameters();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 
-	QImage image;
+	VideoAsset<PatternImage> image;
 	bool useForChangedCheck = false;
 	bool useAlphaAsMask = false;
 	cv::TemplateMatchModes matchMode = cv::TM_CCORR_NORMED;
 	NumberVariable<double> threshold = 0.999;
 };
 
+// The models are shared by all conditions using them, so they can only be
+// used by one of them at a time
+struct ObjDetectModel {
+	std::mutex mutex;
+	cv::CascadeClassifier cascade;
+};
+
 class ObjDetectParameters {
 public:
+	ObjDetectParameters();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 
-	std::string modelPath =
-		obs_get_module_data_path(obs_current_module()) +
-		std::string(
-			"/res/cascadeClassifiers/haarcascade_frontalface_alt.xml");
-	cv::CascadeClassifier cascade;
+	void SetModelPath(const std::string &);
+	const std::string &GetModelPath() const { return model.GetPath(); }
+	VideoAsset<ObjDetectModel> model;
 	NumberVariable<double> scaleFactor = defaultScaleFactor;
 	int minNeighbors = minMinNeighbors;
 	Size minSize{0, 0};
 	Size maxSize{0, 0};
 };
 
+// The language data is shared by all conditions using it, so it can only be
+// used by one of them at a time
+struct OCRModel {
+	std::mutex mutex;
+	std::unique_ptr<tesseract::TessBaseAPI> ocr;
+};
+
 class OCRParameters {
 public:
 	OCRParameters();
-	~OCRParameters();
-	OCRParameters(const OCRParameters &other);
-	OCRParameters &operator=(const OCRParameters &);
 
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 
-	bool Initialized() const { return initDone; }
 	void SetPageMode(tesseract::PageSegMode);
 	bool SetLanguageCode(const std::string &);
 	std::string GetLanguageCode() const;
 	tesseract::PageSegMode GetPageMode() const { return pageSegMode; }
-	tesseract::TessBaseAPI *GetOCR() const { return ocr.get(); }
+	// Returns true once the language data was loaded or loading it failed
+	bool LoadingDone() const;
+	// Returns std::nullopt as long as the language data is not loaded
+	std::optional<std::string> Recognize(const QImage &,
+					     bool wait = false) const;
 
 	StringVariable text = obs_module_text("AdvSceneSwitcher.enterText");
 	RegexConfig regex = RegexConfig::PartialMatchRegexConfig();
@@ -103,11 +124,9 @@ public:
 	StringVariable languageCode = "eng";
 
 private:
-	void Setup();
-
 	tesseract::PageSegMode pageSegMode = tesseract::PSM_SINGLE_BLOCK;
-	std::unique_ptr<tesseract::TessBaseAPI> ocr;
-	bool initDone = false;
+	// The language code might contain variables
+	mutable VideoAsset<OCRModel> model;
 };
 
 class ColorParameters {
@@ -128,7 +128,8 @@ void PreviewDialog::PatternMatchParametersChanged(
 {
 	std::unique_lock<std::mutex> lock(_mtx);
 	_patternMatchParams = params;
-	_patternImageData = CreatePatternData(_patternMatchParams.image);
+	const auto pattern = _patternMatchParams.image.Get(true);
+	_patternImageData = pattern ? pattern->data : PatternImageData();
 }
 
 void PreviewDialog::ObjDetectParametersChanged(const ObjDetectParameters &params)
@@ -336,11 +337,15 @@ void PreviewImage::MarkMatch(QImage &screenshot,
 				     patternImageData.rgbaPattern);
 		}
 	} else if (condition == VideoCondition::OBJECT) {
-		auto objects = MatchObject(screenshot, objDetectParams.cascade,
-					   objDetectParams.scaleFactor,
-					   objDetectParams.minNeighbors,
-					   objDetectParams.minSize.CV(),
-					   objDetectParams.maxSize.CV());
+		std::vector<cv::Rect> objects;
+		if (auto model = objDetectParams.model.Get(true)) {
+			std::lock_guard<std::mutex> lock(model->mutex);
+			objects = MatchObject(screenshot, model->cascade,
+					      objDetectParams.scaleFactor,
+					      objDetectParams.minNeighbors,
+					      objDetectParams.minSize.CV(),
+					      objDetectParams.maxSize.CV());
+		}
 		if (objects.empty()) {
 			emit StatusUpdate(obs_module_text(
 				"AdvSceneSwitcher.condition.video.objectMatchFail"));
@@ -350,8 +355,7 @@ void PreviewImage::MarkMatch(QImage &screenshot,
 			markObjects(screenshot, objects);
 		}
 	} else if (condition == VideoCondition::OCR) {
-		auto text = RunOCR(ocrParams.GetOCR(), screenshot,
-				   ocrParams.color, ocrParams.colorThreshold);
+		auto text = ocrParams.Recognize(screenshot, true).value_or("");
 		QString status(obs_module_text(
 			"AdvSceneSwitcher.condition.video.ocrMatchSuccess"));
 		emit StatusUpdate(status.arg(QString::fromStdString(text)));
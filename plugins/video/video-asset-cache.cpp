@@ -0,0 +1,255 @@
+#include "video-asset-cache.hpp"
+
+#include <log-helper.hpp>
+
+#include <QCryptographicHash>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace advss {
+
+// Assets are unloaded once unused for this long, e.g. because the macros
+// using them are paused
+static constexpr auto unusedTimeout = std::chrono::minutes(5);
+static constexpr auto evictionInterval = std::chrono::seconds(30);
+// Limits how often the files are checked for modifications
+static constexpr auto modificationCheckInterval = std::chrono::seconds(1);
+
+std::mutex VideoAssetCache::_mutex;
+std::condition_variable VideoAssetCache::_cv;
+std::condition_variable VideoAssetCache::_loaded;
+std::deque<std::shared_ptr<VideoAssetCache::Entry>> VideoAssetCache::_queue;
+std::vector<std::weak_ptr<VideoAssetCache::Entry>> VideoAssetCache::_entries;
+std::map<std::pair<std::string, std::string>, std::weak_ptr<void>>
+	VideoAssetCache::_assets;
+std::thread VideoAssetCache::_thread;
+bool VideoAssetCache::_stop = false;
+
+static std::filesystem::file_time_type
+getLastWriteTime(const std::string &path)
+{
+	std::error_code ec;
+	auto time = std::filesystem::last_write_time(
+		std::filesystem::u8path(path), ec);
+	return ec ? std::filesystem::file_time_type::min() : time;
+}
+
+static bool readFile(const std::string &path, std::string &content)
+{
+	std::ifstream file(std::filesystem::u8path(path), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	std::stringstream stream;
+	stream << file.rdbuf();
+	content = stream.str();
+	return true;
+}
+
+static std::string getDigest(const std::string &content)
+{
+	return QCryptographicHash::hash(QByteArray::fromStdString(content),
+					QCryptographicHash::Sha256)
+		.toStdString();
+}
+
+std::shared_ptr<VideoAssetCache::Entry>
+VideoAssetCache::Register(const std::string &type, const std::string &path,
+			  Loader load)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const auto &weakEntry : _entries) {
+		auto entry = weakEntry.lock();
+		if (entry && entry->_type == type && entry->_path == path) {
+			return entry;
+		}
+	}
+
+	auto entry = std::make_shared<Entry>(type, path, std::move(load));
+	_entries.emplace_back(entry);
+	return entry;
+}
+
+std::shared_ptr<void> VideoAssetCache::Get(const std::shared_ptr<Entry> &entry,
+					   bool wait)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	const auto now = std::chrono::steady_clock::now();
+	entry->_lastUse = now;
+
+	bool modified = false;
+	if ((entry->_state == Entry::State::LOADED ||
+	     entry->_state == Entry::State::FAILED) &&
+	    now - entry->_lastModificationCheck >= modificationCheckInterval) {
+		entry->_lastModificationCheck = now;
+		modified = getLastWriteTime(entry->_path) !=
+			   entry->_lastWriteTime;
+	}
+	if (entry->_state == Entry::State::UNLOADED || modified) {
+		entry->_state = Entry::State::QUEUED;
+		_queue.emplace_back(entry);
+		StartThread();
+		_cv.notify_one();
+	}
+
+	if (!wait) {
+		return entry->_asset;
+	}
+
+	if (entry->_state == Entry::State::QUEUED) {
+		_queue.erase(std::remove(_queue.begin(), _queue.end(), entry),
+			     _queue.end());
+		entry->_state = Entry::State::LOADING;
+		lock.unlock();
+		Load(entry);
+		lock.lock();
+	}
+	_loaded.wait(lock, [&entry]() {
+		return entry->_state != Entry::State::LOADING;
+	});
+	return entry->_asset;
+}
+
+bool VideoAssetCache::LoadFailed(const std::shared_ptr<Entry> &entry)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return entry->_state == Entry::State::FAILED;
+}
+
+void VideoAssetCache::UnloadUnusedAssets(
+	const std::chrono::steady_clock::time_point &now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	EvictUnusedAssets(now);
+}
+
+void VideoAssetCache::Stop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_stop = true;
+	if (!_thread.joinable()) {
+		return;
+	}
+	_cv.notify_one();
+	lock.unlock();
+	_thread.join();
+	lock.lock();
+	_thread = std::thread();
+
+	// Queued assets are only loaded if waited for from now on
+	for (const auto &entry : _queue) {
+		entry->_state = Entry::State::UNLOADED;
+	}
+	_queue.clear();
+}
+
+#ifdef UNIT_TEST
+void VideoAssetCache::Reset()
+{
+	Stop();
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stop = false;
+}
+#endif
+
+void VideoAssetCache::StartThread()
+{
+	// Assets requested while shutting down must not start the thread
+	// again, as it would no longer be stopped before exiting
+	if (!_stop && !_thread.joinable()) {
+		_thread = std::thread(Run);
+	}
+}
+
+void VideoAssetCache::Run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto nextEviction = std::chrono::steady_clock::now() + evictionInterval;
+	while (true) {
+		_cv.wait_until(lock, nextEviction,
+			       []() { return _stop || !_queue.empty(); });
+		if (_stop) {
+			break;
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now >= nextEviction) {
+			EvictUnusedAssets(now);
+			nextEviction = now + evictionInterval;
+		}
+		if (_queue.empty()) {
+			continue;
+		}
+
+		auto entry = _queue.front();
+		_queue.pop_front();
+		entry->_state = Entry::State::LOADING;
+		lock.unlock();
+		Load(entry);
+		lock.lock();
+	}
+}
+
+void VideoAssetCache::Load(const std::shared_ptr<Entry> &entry)
+{
+	const auto lastWriteTime = getLastWriteTime(entry->_path);
+	std::string content;
+	std::shared_ptr<void> asset;
+	if (readFile(entry->_path, content)) {
+		const auto key =
+			std::make_pair(entry->_type, getDigest(content));
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			asset = _assets[key].lock();
+		}
+		if (!asset) {
+			asset = entry->_load(entry->_path, content);
+		}
+		if (asset) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_assets[key] = asset;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!asset) {
+		blog(LOG_WARNING, "failed to load %s \"%s\"",
+		     entry->_type.c_str(), entry->_path.c_str());
+	}
+	entry->_asset = asset;
+	entry->_state = asset ? Entry::State::LOADED : Entry::State::FAILED;
+	entry->_lastWriteTime = lastWriteTime;
+	entry->_lastModificationCheck = std::chrono::steady_clock::now();
+	_loaded.notify_all();
+}
+
+void VideoAssetCache::EvictUnusedAssets(
+	const std::chrono::steady_clock::time_point &now)
+{
+	_entries.erase(std::remove_if(_entries.begin(), _entries.end(),
+				      [](const std::weak_ptr<Entry> &entry) {
+					      return entry.expired();
+				      }),
+		       _entries.end());
+	for (const auto &weakEntry : _entries) {
+		auto entry = weakEntry.lock();
+		if (!entry || now - entry->_lastUse < unusedTimeout) {
+			continue;
+		}
+		if (entry->_state == Entry::State::LOADED ||
+		    entry->_state == Entry::State::FAILED) {
+			entry->_asset.reset();
+			entry->_state = Entry::State::UNLOADED;
+		}
+	}
+	for (auto it = _assets.begin(); it != _assets.end();) {
+		if (it->second.expired()) {
+			it = _assets.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+} // namespace advss
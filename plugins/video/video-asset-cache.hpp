@@ -0,0 +1,140 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+// Loads the files used by video conditions, like pattern images or object
+// detection models, in the background once they are first used.
+//
+// Assets are identified by their type and the SHA-256 digest of the file
+// content, so identical files are only loaded once no matter how many
+// conditions refer to them.
+// Assets which were not used for a while are unloaded again.
+class VideoAssetCache {
+public:
+	using Loader = std::function<std::shared_ptr<void>(
+		const std::string &path, const std::string &content)>;
+	class Entry;
+
+	// Entries registered for the same type and path are shared
+	[[nodiscard]] static std::shared_ptr<Entry>
+	Register(const std::string &type, const std::string &path, Loader);
+	// Returns nullptr while the asset is being loaded or if loading failed.
+	// The asset is loaded again if it was modified or unloaded.
+	// If wait is set, the asset is loaded on the calling thread instead.
+	static std::shared_ptr<void> Get(const std::shared_ptr<Entry> &,
+					 bool wait);
+	static bool LoadFailed(const std::shared_ptr<Entry> &);
+	// Unloads the assets which were not used for a while as of the given
+	// time, which the loading thread does periodically
+	static void
+	UnloadUnusedAssets(const std::chrono::steady_clock::time_point &now);
+	// Stops the loading thread for good.
+	// Afterwards assets are only loaded if they are waited for.
+	static void Stop();
+#ifdef UNIT_TEST
+	// Stops the loading thread, but allows it to be started again
+	static void Reset();
+#endif
+
+private:
+	static void StartThread();
+	static void Run();
+	static void Load(const std::shared_ptr<Entry> &);
+	static void
+	EvictUnusedAssets(const std::chrono::steady_clock::time_point &now);
+
+	static std::mutex _mutex;
+	static std::condition_variable _cv;
+	static std::condition_variable _loaded;
+	static std::deque<std::shared_ptr<Entry>> _queue;
+	static std::vector<std::weak_ptr<Entry>> _entries;
+	static std::map<std::pair<std::string, std::string>,
+			std::weak_ptr<void>>
+		_assets;
+	static std::thread _thread;
+	static bool _stop;
+};
+
+class VideoAssetCache::Entry {
+public:
+	Entry(const std::string &type, const std::string &path, Loader load)
+		: _type(type),
+		  _path(path),
+		  _load(std::move(load))
+	{
+	}
+
+private:
+	const std::string _type;
+	const std::string _path;
+	const Loader _load;
+
+	// Only accessed while holding VideoAssetCache::_mutex
+	enum class State { UNLOADED, QUEUED, LOADING, LOADED, FAILED };
+	State _state = State::UNLOADED;
+	std::shared_ptr<void> _asset;
+	std::filesystem::file_time_type _lastWriteTime;
+	std::chrono::steady_clock::time_point _lastModificationCheck;
+	std::chrono::steady_clock::time_point _lastUse;
+
+	friend VideoAssetCache;
+};
+
+// Refers to an asset of type T loaded from a file using the given function.
+// Copies refer to the same asset.
+template<typename T> class VideoAsset {
+public:
+	using Loader = std::shared_ptr<T> (*)(const std::string &path,
+					      const std::string &content);
+
+	VideoAsset(const char *type, Loader load) : _type(type), _load(load) {}
+
+	void SetPath(const std::string &path)
+	{
+		if (_entry && path == _path) {
+			return;
+		}
+		_path = path;
+		_entry = VideoAssetCache::Register(
+			_type, path,
+			[load = _load](const std::string &file,
+				       const std::string &content) {
+				return std::static_pointer_cast<void>(
+					load(file, content));
+			});
+	}
+	const std::string &GetPath() const { return _path; }
+	std::shared_ptr<T> Get(bool wait = false) const
+	{
+		if (!_entry) {
+			return {};
+		}
+		return std::static_pointer_cast<T>(
+			VideoAssetCache::Get(_entry, wait));
+	}
+	bool LoadFailed() const
+	{
+		return !_entry || VideoAssetCache::LoadFailed(_entry);
+	}
+	// Returns true once the asset was loaded or loading it failed
+	bool LoadingDone() const { return Get() || LoadFailed(); }
+
+private:
+	const char *_type;
+	Loader _load;
+	std::string _path;
+	std::shared_ptr<VideoAssetCache::Entry> _entry;
+};
+
+} // namespace advss
@@ -0,0 +1,86 @@
+#include "catch.hpp"
+
+#include <audio-level-window.hpp>
+
+#include <cmath>
+
+using Clock = advss::AudioLevelWindow::Clock;
+
+TEST_CASE("Empty window", "[audio-level-window]")
+{
+	advss::AudioLevelWindow window;
+	REQUIRE(std::isinf(window.GetRMS()));
+	REQUIRE(std::isinf(window.GetPeakHold()));
+	REQUIRE(std::isinf(window.GetLoudness()));
+	REQUIRE(window.GetSampleCount() == 0);
+}
+
+TEST_CASE("RMS is averaged over the window", "[audio-level-window]")
+{
+	using namespace std::chrono_literals;
+	advss::AudioLevelWindow window;
+	window.SetWindowSize(1000ms);
+
+	const auto start = Clock::now();
+	const float loud[2] = {0.f, 0.f};
+	const float silent[2] = {-INFINITY, -INFINITY};
+
+	window.AddSample(loud, loud, 2, start);
+	window.AddSample(silent, silent, 2, start + 100ms);
+	REQUIRE(window.GetRMS(start + 100ms) == Approx(-3.0103f));
+
+	// First sample is no longer part of the window
+	REQUIRE(std::isinf(window.GetRMS(start + 1050ms)));
+	REQUIRE(window.GetSampleCount() == 1);
+}
+
+TEST_CASE("Peak-hold returns the window maximum", "[audio-level-window]")
+{
+	using namespace std::chrono_literals;
+	advss::AudioLevelWindow window;
+	window.SetWindowSize(500ms);
+
+	const auto start = Clock::now();
+	const float values[] = {-10.f, -20.f, -5.f, -30.f};
+	for (int i = 0; i < 4; i++) {
+		window.AddSample(&values[i], &values[i], 1, start + i * 100ms);
+	}
+	REQUIRE(window.GetPeakHold(start + 300ms) == -5.f);
+	REQUIRE(window.GetPeakHold(start + 650ms) == -5.f);
+	REQUIRE(window.GetPeakHold(start + 750ms) == -30.f);
+	REQUIRE(std::isinf(window.GetPeakHold(start + 850ms)));
+}
+
+TEST_CASE("Loudness sums the channel power", "[audio-level-window]")
+{
+	using namespace std::chrono_literals;
+	advss::AudioLevelWindow window;
+
+	const auto start = Clock::now();
+	const float magnitude[2] = {-20.f, -20.f};
+	window.AddSample(magnitude, magnitude, 2, start);
+	REQUIRE(window.GetLoudness(start) == Approx(-20.f + 3.0103f - 0.691f));
+	REQUIRE(window.GetRMS(start) == Approx(-20.f));
+}
+
+TEST_CASE("Peak since last check is consumed", "[audio-level-window]")
+{
+	using namespace std::chrono_literals;
+	advss::AudioLevelWindow window;
+
+	const auto start = Clock::now();
+	const float low = -30.f;
+	const float high = -10.f;
+	window.AddSample(&high, &high, 1, start);
+	window.AddSample(&low, &low, 1, start + 10ms);
+	REQUIRE(window.ConsumePeak(start + 20ms) == -10.f);
+
+	// No new sample yet, so the previous value is reused
+	REQUIRE(window.ConsumePeak(start + 30ms) == -10.f);
+
+	window.AddSample(&low, &low, 1, start + 40ms);
+	REQUIRE(window.ConsumePeak(start + 50ms) == -30.f);
+
+	// Source stopped producing audio
+	REQUIRE(std::isinf(window.ConsumePeak(start + 1s)));
+}
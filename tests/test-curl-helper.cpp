@@ -0,0 +1,152 @@
+#include "catch.hpp"
+
+#include "test-server.hpp"
+
+#include <curl-helper.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace {
+
+// Stand-in for the HTTP endpoints the HTTP action is usually used with
+class HttpActionServer {
+public:
+	HttpActionServer()
+		: _server([this](httplib::Server &server) {
+			  AddRoutes(server);
+		  })
+	{
+	}
+
+	std::string GetUrl(const std::string &path) const
+	{
+		return _server.GetUrl(path);
+	}
+	std::set<int> GetClientPorts()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _ports;
+	}
+
+private:
+	void AddRoutes(httplib::Server &server)
+	{
+		server.Get("/get", [this](const httplib::Request &req,
+					  httplib::Response &res) {
+			AddClientPort(req.remote_port);
+			res.set_content("hello", "text/plain");
+		});
+		server.Post("/post", [this](const httplib::Request &req,
+					    httplib::Response &res) {
+			AddClientPort(req.remote_port);
+			res.status = 201;
+			auto body = req.body + req.get_header_value("X-Test");
+			res.set_content(body, "text/plain");
+		});
+		server.Get("/slow", [](const httplib::Request &,
+				       httplib::Response &res) {
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			res.set_content("slow", "text/plain");
+		});
+	}
+	void AddClientPort(int port)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_ports.emplace(port);
+	}
+
+	std::mutex _mutex;
+	std::set<int> _ports;
+	// Declared last, so the server is stopped before the state its
+	// routes use is destroyed
+	TestServer _server;
+};
+
+} // namespace
+
+TEST_CASE("Async GET and POST requests", "[curl-helper]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl library not found");
+		return;
+	}
+
+	HttpActionServer server;
+	advss::CurlRequest get;
+	get.url = server.GetUrl("/get");
+	auto response = advss::CurlHelper::PerformAsync(get).get();
+	REQUIRE(response.Succeeded());
+	REQUIRE(response.status == 200);
+	REQUIRE(response.body == "hello");
+
+	advss::CurlRequest post;
+	post.url = server.GetUrl("/post");
+	post.method = advss::CurlRequest::Method::POST;
+	post.data = "data";
+	post.headers = {"X-Test: header"};
+	response = advss::CurlHelper::PerformAsync(post).get();
+	REQUIRE(response.Succeeded());
+	REQUIRE(response.status == 201);
+	REQUIRE(response.body == "dataheader");
+
+	get.storeResponse = false;
+	response = advss::CurlHelper::PerformAsync(get).get();
+	REQUIRE(response.Succeeded());
+	REQUIRE(response.body.empty());
+
+	// All requests were sent over the same connection
+	REQUIRE(server.GetClientPorts().size() == 1);
+}
+
+TEST_CASE("Async requests do not block each other", "[curl-helper]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl library not found");
+		return;
+	}
+
+	HttpActionServer server;
+	advss::CurlRequest slow;
+	slow.url = server.GetUrl("/slow");
+	slow.timeout = std::chrono::seconds(5);
+	auto slowResponse = advss::CurlHelper::PerformAsync(slow);
+
+	advss::CurlRequest get;
+	get.url = server.GetUrl("/get");
+	auto response = advss::CurlHelper::PerformAsync(get);
+	REQUIRE(response.wait_for(std::chrono::milliseconds(500)) ==
+		std::future_status::ready);
+	REQUIRE(slowResponse.wait_for(std::chrono::milliseconds(0)) ==
+		std::future_status::timeout);
+	REQUIRE(slowResponse.get().body == "slow");
+}
+
+TEST_CASE("Async request errors", "[curl-helper]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl library not found");
+		return;
+	}
+
+	HttpActionServer server;
+	advss::CurlRequest slow;
+	slow.url = server.GetUrl("/slow");
+	slow.timeout = std::chrono::milliseconds(100);
+	auto response = advss::CurlHelper::PerformAsync(slow).get();
+	REQUIRE_FALSE(response.Succeeded());
+	REQUIRE(response.result == CURLE_OPERATION_TIMEDOUT);
+	REQUIRE_FALSE(response.error.empty());
+
+	slow.timeout = std::chrono::seconds(5);
+	auto aborted = advss::CurlHelper::PerformAsync(slow);
+	advss::CurlHelper::StopAsyncRequests();
+	REQUIRE(aborted.get().result == CURLE_ABORTED_BY_CALLBACK);
+
+	// Requests can be sent again after stopping
+	advss::CurlRequest get;
+	get.url = server.GetUrl("/get");
+	REQUIRE(advss::CurlHelper::PerformAsync(get).get().Succeeded());
+}
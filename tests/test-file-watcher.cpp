@@ -0,0 +1,442 @@
+#include "catch.hpp"
+
+#include <file-watcher.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using State = advss::WatchedFile::State;
+
+static std::string getTempFilePath()
+{
+	return (std::filesystem::temp_directory_path() /
+		("advss-file-watcher-test-" +
+		 std::to_string(std::chrono::steady_clock::now()
+					.time_since_epoch()
+					.count())))
+		.string();
+}
+
+static void writeFile(const std::string &path, const std::string &content,
+		      bool append = false)
+{
+	std::ofstream file(path, std::ios::binary |
+					 (append ? std::ios::app
+						 : std::ios::trunc));
+	file << content;
+}
+
+// Replaces the file at once, as it might otherwise be read while being written
+static void replaceFile(const std::string &path, const std::string &content)
+{
+	writeFile(path + ".tmp", content);
+	std::filesystem::rename(path + ".tmp", path);
+}
+
+// Change notifications are received asynchronously.
+// Returns the last state other than UNCHANGED.
+static State waitForContent(advss::WatchedFile &file, const std::string &path,
+			    const std::string &content)
+{
+	auto state = State::UNCHANGED;
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < timeout) {
+		const auto newState = file.Update(path);
+		if (newState != State::UNCHANGED) {
+			state = newState;
+		}
+		if (newState != State::UNAVAILABLE &&
+		    file.GetContent() == content) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return state;
+}
+
+TEST_CASE("Watched files are only read again if modified", "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	advss::WatchedFile file(advss::WatchedFile::LineEndings::CONVERT);
+	REQUIRE(file.Update(path) == State::UNAVAILABLE);
+	REQUIRE(file.Update(path) == State::UNAVAILABLE);
+
+	replaceFile(path, "first line\r\n");
+	REQUIRE(waitForContent(file, path, "first line\n") == State::MODIFIED);
+	REQUIRE(file.Update(path) == State::UNCHANGED);
+	const auto hash = file.GetHash();
+
+	writeFile(path, "second line\r", true);
+	REQUIRE(waitForContent(file, path, "first line\nsecond line\r") ==
+		State::APPENDED);
+	REQUIRE(file.GetHash() != hash);
+
+	// Line endings split across reads are converted as well
+	writeFile(path, "\nthird line", true);
+	REQUIRE(waitForContent(file, path,
+			       "first line\nsecond line\nthird line") ==
+		State::APPENDED);
+
+	// Rewritten files are read completely
+	replaceFile(path, "replaced\r\nreplaced\r\nreplaced\r\nreplaced\r\n"
+			  "replaced\r\nreplaced\r\nreplaced\r\nreplaced");
+	REQUIRE(waitForContent(file, path,
+			       "replaced\nreplaced\nreplaced\nreplaced\n"
+			       "replaced\nreplaced\nreplaced\nreplaced") ==
+		State::MODIFIED);
+
+	// Truncated files as well
+	writeFile(path, "first line\r\n");
+	waitForContent(file, path, "first line\n");
+	REQUIRE(file.GetContent() == "first line\n");
+	REQUIRE(file.GetHash() == hash);
+
+	std::remove(path.c_str());
+	auto state = file.Update(path);
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (state != State::UNAVAILABLE &&
+	       std::chrono::steady_clock::now() < timeout) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		state = file.Update(path);
+	}
+	REQUIRE(state == State::UNAVAILABLE);
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Large files are read in chunks", "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	const std::string line(999, 'x');
+	std::string content;
+	for (int i = 0; i < 200; ++i) {
+		content += line + "\r\n";
+	}
+	writeFile(path, content);
+
+	advss::WatchedFile file(advss::WatchedFile::LineEndings::CONVERT);
+	REQUIRE(file.Update(path) == State::MODIFIED);
+	REQUIRE(file.GetContent().size() == 200 * 1000);
+	REQUIRE(file.GetContent().find('\r') == std::string::npos);
+
+	std::remove(path.c_str());
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Line endings are only converted if requested", "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	writeFile(path, "first\r\nsecond\r\n");
+
+	advss::WatchedFile file;
+	REQUIRE(file.Update(path) == State::MODIFIED);
+	REQUIRE(file.GetContent() == "first\r\nsecond\r\n");
+
+	std::remove(path.c_str());
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Byte order marks are removed from the content", "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	writeFile(path, "\xEF\xBB\xBFutf-8");
+
+	advss::WatchedFile file(advss::WatchedFile::LineEndings::CONVERT);
+	REQUIRE(file.Update(path) == State::MODIFIED);
+	REQUIRE(file.GetContent() == "utf-8");
+
+	// UTF-16 is converted to UTF-8 including characters split across
+	// reads, e.g. "\xC3\xA4" is U+00E4 and "\xF0\x9F\x98\x80" is U+1F600
+	const std::string utf16LE("\xFF\xFEx\0\r\0\n\0\xE4\0\x3D\xD8", 12);
+	replaceFile(path, utf16LE);
+	REQUIRE(waitForContent(file, path, "x\n\xC3\xA4") == State::MODIFIED);
+	writeFile(path, std::string("\x00\xDE", 2), true);
+	REQUIRE(waitForContent(file, path, "x\n\xC3\xA4\xF0\x9F\x98\x80") ==
+		State::APPENDED);
+
+	const std::string utf16BE("\xFE\xFF\0a\0b", 6);
+	replaceFile(path, utf16BE);
+	REQUIRE(waitForContent(file, path, "ab") == State::MODIFIED);
+
+	std::remove(path.c_str());
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Copies of watched files are notified independently",
+	  "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	writeFile(path, "content");
+
+	advss::WatchedFile file;
+	REQUIRE(file.Update(path) == State::MODIFIED);
+	auto copy = file;
+	REQUIRE(copy.GetContent().empty());
+	REQUIRE(copy.Update(path) == State::MODIFIED);
+	REQUIRE(copy.GetContent() == "content");
+
+	writeFile(path, " appended", true);
+	REQUIRE(waitForContent(file, path, "content appended") ==
+		State::APPENDED);
+	REQUIRE(waitForContent(copy, path, "content appended") ==
+		State::APPENDED);
+
+	std::remove(path.c_str());
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Watches of the same file are notified independently",
+	  "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	writeFile(path, "content");
+
+	advss::WatchedFile first;
+	advss::WatchedFile second;
+	REQUIRE(first.Update(path) == State::MODIFIED);
+	REQUIRE(second.Update(path) == State::MODIFIED);
+
+	writeFile(path, " appended", true);
+	REQUIRE(waitForContent(first, path, "content appended") ==
+		State::APPENDED);
+	REQUIRE(waitForContent(second, path, "content appended") ==
+		State::APPENDED);
+
+	std::remove(path.c_str());
+	advss::FileWatcher::Stop();
+}
+
+// Collects the new lines until the given line was found
+static std::vector<std::string> waitForLine(advss::FileTail &tail,
+					    const std::string &path,
+					    const std::string &line)
+{
+	std::vector<std::string> lines;
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < timeout) {
+		const bool found =
+			tail.FindLine(path, [&](std::string_view newLine) {
+				lines.emplace_back(newLine);
+				return newLine == line;
+			});
+		if (found) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return lines;
+}
+
+TEST_CASE("Only new lines of followed files are read", "[file-watcher]")
+{
+	const auto path = getTempFilePath();
+	writeFile(path, "old line\n");
+
+	advss::FileTail tail;
+	auto noMatch = [](std::string_view) { return false; };
+	REQUIRE_FALSE(tail.FindLine(path, noMatch));
+
+	// Incomplete lines are only passed on once they are complete
+	writeFile(path, "first\nsecond\r\nthi", true);
+	REQUIRE(waitForLine(tail, path, "second") ==
+		std::vector<std::string>{"first", "second"});
+	writeFile(path, "rd\nmatch\nafter\n", true);
+	REQUIRE(waitForLine(tail, path, "match") ==
+		std::vector<std::string>{"third", "match"});
+
+	// Lines following the matching line are kept for the next call
+	std::vector<std::string> lines;
+	REQUIRE_FALSE(tail.FindLine(path, [&](std::string_view line) {
+		lines.emplace_back(line);
+		return false;
+	}));
+	REQUIRE(lines == std::vector<std::string>{"after"});
+
+	// Replaced files are followed from their start
+	replaceFile(path, "rotated\n");
+	REQUIRE(waitForLine(tail, path, "rotated") ==
+		std::vector<std::string>{"rotated"});
+
+	// Truncated files as well
+	writeFile(path, "new\n");
+	REQUIRE(waitForLine(tail, path, "new") ==
+		std::vector<std::string>{"new"});
+
+	// Even if the new file starts with the same data
+	replaceFile(path, "new\nrotated again\n");
+	REQUIRE(waitForLine(tail, path, "rotated again") ==
+		std::vector<std::string>{"new", "rotated again"});
+
+	std::remove(path.c_str());
+	advss::FileWatcher::Stop();
+}
+
+using Changes = advss::FileWatcher::FolderWatch::Changes;
+
+// Collects the changes until the given condition is met
+static Changes waitForChanges(advss::FileWatcher::FolderWatch &watch,
+			      const std::function<bool(const Changes &)> &done)
+{
+	Changes changes;
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < timeout) {
+		auto newChanges = watch.TakeChanges();
+		for (auto [list, newList] :
+		     {std::make_pair(&changes.newFiles, &newChanges.newFiles),
+		      std::make_pair(&changes.changedFiles,
+				     &newChanges.changedFiles),
+		      std::make_pair(&changes.removedFiles,
+				     &newChanges.removedFiles),
+		      std::make_pair(&changes.newDirs, &newChanges.newDirs),
+		      std::make_pair(&changes.removedDirs,
+				     &newChanges.removedDirs)}) {
+			list->insert(list->end(), newList->begin(),
+				     newList->end());
+		}
+		changes.overflow = changes.overflow || newChanges.overflow;
+		if (done(changes)) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return changes;
+}
+
+TEST_CASE("Changes of folders are collected", "[file-watcher]")
+{
+	const auto dir = getTempFilePath();
+	std::filesystem::create_directory(dir);
+	writeFile(dir + "/existing", "content");
+
+	auto watch = advss::FileWatcher::RegisterFolder(dir, false);
+	REQUIRE(watch->TakeChanges().newFiles.empty());
+
+	writeFile(dir + "/new", "content");
+	auto changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.newFiles.empty();
+	});
+	REQUIRE(changes.newFiles == std::vector<std::string>{"new"});
+
+	writeFile(dir + "/existing", " appended", true);
+	changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.changedFiles.empty();
+	});
+	REQUIRE(changes.changedFiles == std::vector<std::string>{"existing"});
+	REQUIRE(changes.newFiles.empty());
+
+	std::filesystem::create_directory(dir + "/folder");
+	std::filesystem::remove(dir + "/new");
+	changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.newDirs.empty() && !c.removedFiles.empty();
+	});
+	REQUIRE(changes.newDirs == std::vector<std::string>{"folder"});
+	REQUIRE(changes.removedFiles == std::vector<std::string>{"new"});
+
+	// Subfolders are not watched unless requested
+	writeFile(dir + "/folder/nested", "content");
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	REQUIRE(watch->TakeChanges().newFiles.empty());
+
+	std::filesystem::remove_all(dir);
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Content of moved folders is reported as removed", "[file-watcher]")
+{
+	const auto dir = getTempFilePath();
+	std::filesystem::create_directory(dir);
+	writeFile(dir + "/existing", "content");
+	auto watch = advss::FileWatcher::RegisterFolder(dir, false);
+
+	writeFile(dir + "/new", "content");
+	auto changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.newFiles.empty();
+	});
+	REQUIRE(changes.newFiles == std::vector<std::string>{"new"});
+
+	// No notifications are received for the content of the folder itself
+	std::filesystem::rename(dir, dir + ".moved");
+	changes = waitForChanges(*watch, [](const Changes &c) {
+		return c.removedFiles.size() == 2;
+	});
+	REQUIRE(changes.removedFiles ==
+		std::vector<std::string>{"existing", "new"});
+
+	std::filesystem::remove_all(dir + ".moved");
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Bursts of folder changes are combined", "[file-watcher]")
+{
+	const auto dir = getTempFilePath();
+	std::filesystem::create_directory(dir);
+	auto watch = advss::FileWatcher::RegisterFolder(dir, false);
+
+	for (int i = 0; i < 100; ++i) {
+		writeFile(dir + "/file", std::to_string(i), true);
+	}
+	writeFile(dir + "/temporary", "content");
+	std::filesystem::remove(dir + "/temporary");
+	writeFile(dir + "/last", "content");
+	// Give the notifications time to arrive, so they are combined
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	auto changes = waitForChanges(*watch, [](const Changes &c) {
+		return std::find(c.newFiles.begin(), c.newFiles.end(),
+				 "last") != c.newFiles.end();
+	});
+	REQUIRE(changes.newFiles == std::vector<std::string>{"file", "last"});
+	REQUIRE(changes.changedFiles.empty());
+	REQUIRE(changes.removedFiles.empty());
+
+	std::filesystem::remove_all(dir);
+	advss::FileWatcher::Stop();
+}
+
+TEST_CASE("Folders can be watched recursively", "[file-watcher]")
+{
+	const auto dir = getTempFilePath();
+	std::filesystem::create_directories(dir + "/a/b");
+	auto watch = advss::FileWatcher::RegisterFolder(dir, true);
+
+	writeFile(dir + "/a/b/file", "content");
+	auto changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.newFiles.empty();
+	});
+	REQUIRE(changes.newFiles == std::vector<std::string>{"a/b/file"});
+
+	// Content of new folders is reported as well
+	std::filesystem::create_directories(dir + "/new/nested");
+	writeFile(dir + "/new/nested/file", "content");
+	changes = waitForChanges(*watch, [](const Changes &c) {
+		return std::find(c.newFiles.begin(), c.newFiles.end(),
+				 "new/nested/file") != c.newFiles.end();
+	});
+	REQUIRE(changes.newDirs ==
+		std::vector<std::string>{"new", "new/nested"});
+
+	std::filesystem::rename(dir + "/a", dir + "/renamed");
+	changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.newDirs.empty() && !c.removedDirs.empty();
+	});
+	REQUIRE(changes.removedDirs[0] == "a");
+	REQUIRE(changes.newDirs[0] == "renamed");
+
+	writeFile(dir + "/renamed/b/moved", "content");
+	changes = waitForChanges(*watch, [](const Changes &c) {
+		return !c.newFiles.empty();
+	});
+	REQUIRE(changes.newFiles ==
+		std::vector<std::string>{"renamed/b/moved"});
+
+	std::filesystem::remove_all(dir);
+	advss::FileWatcher::Stop();
+}
@@ -0,0 +1,122 @@
+#include "catch.hpp"
+
+#include <file-writer.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+static std::string getTempFilePath()
+{
+	return (std::filesystem::temp_directory_path() /
+		("advss-file-writer-test-" +
+		 std::to_string(std::chrono::steady_clock::now()
+					.time_since_epoch()
+					.count())))
+		.string();
+}
+
+static std::string readFile(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+TEST_CASE("Files are written and appended to", "[file-writer]")
+{
+	const auto path = getTempFilePath();
+	advss::FileWriter::Write(path, "first");
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == "first");
+
+	advss::FileWriter::Append(path, " second");
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == "first second");
+
+	// Appended files are kept open, but must still be rewritten
+	advss::FileWriter::Write(path, "replaced",
+				 advss::FileWriter::SyncPolicy::ON_FLUSH);
+	advss::FileWriter::Append(path, " appended");
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == "replaced appended");
+
+	advss::FileWriter::Stop();
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Queued requests are combined", "[file-writer]")
+{
+	const auto path = getTempFilePath();
+	std::string expected;
+	for (int i = 0; i < 1000; ++i) {
+		advss::FileWriter::Append(path, std::to_string(i) + "\n");
+		expected += std::to_string(i) + "\n";
+	}
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == expected);
+
+	for (int i = 0; i < 1000; ++i) {
+		advss::FileWriter::Write(path, std::to_string(i));
+	}
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == "999");
+
+	advss::FileWriter::Stop();
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Files are replaced", "[file-writer]")
+{
+	const auto path = getTempFilePath();
+	advss::FileWriter::Write(path, "original content");
+	advss::FileWriter::Replace(path, "first");
+	advss::FileWriter::Append(path, " second");
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == "first second");
+	REQUIRE_FALSE(std::filesystem::exists(path + ".tmp"));
+
+	advss::FileWriter::Replace(path, "replaced",
+				   advss::FileWriter::SyncPolicy::ON_FLUSH);
+	advss::FileWriter::Flush();
+	REQUIRE(readFile(path) == "replaced");
+
+	advss::FileWriter::Stop();
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Remaining data is written when stopping", "[file-writer]")
+{
+	std::vector<std::string> paths;
+	for (int i = 0; i < 10; ++i) {
+		paths.emplace_back(getTempFilePath() + "-" + std::to_string(i));
+		advss::FileWriter::Append(paths.back(), "data");
+	}
+	advss::FileWriter::Stop();
+	for (const auto &path : paths) {
+		REQUIRE(readFile(path) == "data");
+		std::remove(path.c_str());
+	}
+
+	// Writing is possible again after stopping
+	advss::FileWriter::Write(paths[0], "restarted");
+	advss::FileWriter::Stop();
+	REQUIRE(readFile(paths[0]) == "restarted");
+	std::remove(paths[0].c_str());
+}
+
+TEST_CASE("Failed writes are ignored", "[file-writer]")
+{
+	const auto path = (std::filesystem::temp_directory_path() /
+			   "advss-file-writer-test-missing-directory" / "file")
+				  .string();
+	advss::FileWriter::Write(path, "data");
+	advss::FileWriter::Flush();
+	REQUIRE_FALSE(std::filesystem::exists(path));
+	advss::FileWriter::Stop();
+}
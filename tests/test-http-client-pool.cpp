@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "test-server.hpp"
+
+#include <http-client-pool.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Records the client port of each request to tell connections apart
+class ConnectionTestServer {
+public:
+	ConnectionTestServer()
+		: _server([this](httplib::Server &server) {
+			  server.Get("/test", [this](const httplib::Request &req,
+						     httplib::Response &res) {
+				  std::lock_guard<std::mutex> lock(_mutex);
+				  _ports.emplace_back(req.remote_port);
+				  res.set_content("ok", "text/plain");
+			  });
+		  })
+	{
+	}
+
+	std::string GetUri() const { return _server.GetUrl(); }
+	std::vector<int> GetClientPorts()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _ports;
+	}
+
+private:
+	std::mutex _mutex;
+	std::vector<int> _ports;
+	// Declared last, so the server is stopped before the state its
+	// routes use is destroyed
+	TestServer _server;
+};
+
+} // namespace
+
+TEST_CASE("Connections are kept alive", "[http-client-pool]")
+{
+	ConnectionTestServer server;
+	const auto uri = server.GetUri();
+	advss::HttpClientPool pool;
+
+	for (int i = 0; i < 3; i++) {
+		auto client = pool.Acquire(uri);
+		auto result = client->Get("/test");
+		REQUIRE(result);
+		REQUIRE(result->body == "ok");
+	}
+	REQUIRE(pool.CreatedCount() == 1);
+	REQUIRE(pool.IdleCount(uri) == 1);
+
+	// All requests should have been sent using the same connection
+	auto ports = server.GetClientPorts();
+	REQUIRE(ports.size() == 3);
+	REQUIRE(ports[0] == ports[1]);
+	REQUIRE(ports[1] == ports[2]);
+
+	// Close the connections before the server is stopped
+	pool.Clear();
+}
+
+TEST_CASE("Clients are used exclusively", "[http-client-pool]")
+{
+	ConnectionTestServer server;
+	const auto uri = server.GetUri();
+	advss::HttpClientPool pool(1);
+
+	{
+		auto first = pool.Acquire(uri);
+		auto second = pool.Acquire(uri);
+		REQUIRE(pool.CreatedCount() == 2);
+		REQUIRE(first->Get("/test"));
+		REQUIRE(second->Get("/test"));
+	}
+
+	// Only one idle client should be kept
+	REQUIRE(pool.IdleCount(uri) == 1);
+	auto client = pool.Acquire(uri);
+	REQUIRE(pool.IdleCount(uri) == 0);
+	REQUIRE(pool.CreatedCount() == 2);
+
+	pool.Clear();
+}
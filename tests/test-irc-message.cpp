@@ -0,0 +1,259 @@
+#include "catch.hpp"
+
+#include <irc-message.hpp>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+static const std::string chatMessage =
+	"@badge-info=subscriber/8;badges=subscriber/6,premium/1;"
+	"client-nonce=abc;color=#0D4200;display-name=ronni;"
+	"emotes=25:0-4,12-16/1902:6-10;flags=;id=b34ccfc7;mod=0;"
+	"subscriber=1;user-type= "
+	":ronni!ronni@ronni.tmi.twitch.tv PRIVMSG #ronni :Kappa Keepo Kappa";
+
+TEST_CASE("Parse chat message", "[irc-message]")
+{
+	auto messages = advss::ParseIRCMessages(std::string(chatMessage));
+	REQUIRE(messages.size() == 1);
+
+	const auto &message = *messages[0];
+	REQUIRE(message.GetCommand() == "PRIVMSG");
+	REQUIRE(message.GetParameter() == "#ronni");
+	REQUIRE(message.GetNick() == "ronni");
+	REQUIRE(message.GetHost() == "ronni@ronni.tmi.twitch.tv");
+	REQUIRE(message.GetMessage() == "Kappa Keepo Kappa");
+}
+
+TEST_CASE("Parse multiple messages in one frame", "[irc-message]")
+{
+	auto messages = advss::ParseIRCMessages(
+		":tmi.twitch.tv 001 user :Welcome, GLHF!\r\n"
+		"\r\n"
+		"PING :tmi.twitch.tv\r\n"
+		":user!user@user.tmi.twitch.tv JOIN #channel\r\n");
+	REQUIRE(messages.size() == 3);
+
+	REQUIRE(messages[0]->GetCommand() == "001");
+	REQUIRE(messages[0]->GetNick().empty());
+	REQUIRE(messages[0]->GetHost() == "tmi.twitch.tv");
+	REQUIRE(messages[0]->GetMessage() == "Welcome, GLHF!");
+	REQUIRE(messages[1]->GetCommand() == "PING");
+	REQUIRE(messages[1]->GetMessage() == "tmi.twitch.tv");
+	REQUIRE(messages[2]->GetCommand() == "JOIN");
+	REQUIRE(messages[2]->GetParameter() == "#channel");
+
+	// Messages keep the frame alive on their own
+	auto message = messages[2];
+	messages.clear();
+	REQUIRE(message->GetParameter() == "#channel");
+}
+
+TEST_CASE("Discard invalid lines", "[irc-message]")
+{
+	REQUIRE(advss::ParseIRCMessages("").empty());
+	REQUIRE(advss::ParseIRCMessages(" \r\n\t").empty());
+	REQUIRE(advss::ParseIRCMessages("@a=b").empty());
+	REQUIRE(advss::ParseIRCMessages(":source").empty());
+}
+
+TEST_CASE("Look up single tags", "[irc-message]")
+{
+	auto messages = advss::ParseIRCMessages(std::string(chatMessage));
+	REQUIRE(messages.size() == 1);
+
+	const auto &message = *messages[0];
+	REQUIRE(message.GetTag("display-name") == "ronni");
+	REQUIRE(message.GetTag("user-type") == "");
+	REQUIRE_FALSE(message.GetTag("does-not-exist"));
+}
+
+TEST_CASE("Decode tags", "[irc-message]")
+{
+	auto messages = advss::ParseIRCMessages(std::string(chatMessage));
+	REQUIRE(messages.size() == 1);
+
+	const auto &tags = messages[0]->GetTags().tagMap;
+	REQUIRE(tags.count("client-nonce") == 0);
+	REQUIRE(tags.count("flags") == 0);
+	REQUIRE(std::get<std::string>(tags.at("color")) == "#0D4200");
+	REQUIRE(std::get<std::string>(tags.at("user-type")).empty());
+
+	const auto &badges =
+		std::get<advss::ParsedTags::BadgeMap>(tags.at("badges"));
+	REQUIRE(badges.size() == 2);
+	REQUIRE(badges.at("subscriber") == "6");
+	REQUIRE(badges.at("premium") == "1");
+
+	const auto &emotes =
+		std::get<advss::ParsedTags::EmoteMap>(tags.at("emotes"));
+	REQUIRE(emotes.size() == 2);
+	REQUIRE(emotes.at("25").size() == 2);
+	REQUIRE(emotes.at("25")[0] == std::make_pair(0, 4));
+	REQUIRE(emotes.at("25")[1] == std::make_pair(12, 16));
+	REQUIRE(emotes.at("1902")[0] == std::make_pair(6, 10));
+
+	// Tags are only decoded once
+	REQUIRE(&messages[0]->GetTags() == &messages[0]->GetTags());
+}
+
+// Stand-in for a recorded chat log of a busy channel, as there is none in the
+// tree. The lines vary in their command, tags, badges, emotes, nicks and length
+// and are split into websocket frames of up to 20 lines.
+static std::vector<std::string> generateChatFrames(size_t lineCount)
+{
+	// Pairs of words and the ID of the emote they represent, if any
+	static const std::array<std::pair<std::string_view, std::string_view>,
+				10>
+		words = {{{"Kappa", "25"},
+			  {"hello", ""},
+			  {"PogChamp", "305954156"},
+			  {"what", ""},
+			  {"is", ""},
+			  {"LUL", "425618"},
+			  {"going", ""},
+			  {"on", ""},
+			  {"chat", ""},
+			  {"gg", ""}}};
+	static const std::array<std::string_view, 5> badges = {
+		"", "subscriber/12,premium/1", "moderator/1,subscriber/3012",
+		"vip/1,bits/1000", "broadcaster/1,subscriber/0,partner/1"};
+	static const std::array<std::string_view, 6> otherLines = {
+		"PING :tmi.twitch.tv",
+		"@emote-only=0;followers-only=-1;r9k=0;room-id=12345;slow=0;"
+		"subs-only=0 :tmi.twitch.tv ROOMSTATE #channel",
+		"@ban-duration=600;room-id=12345;target-user-id=67890;"
+		"tmi-sent-ts=1642719320727 :tmi.twitch.tv CLEARCHAT #channel "
+		":spammer",
+		"@login=spammer;room-id=;target-msg-id=abc-123;"
+		"tmi-sent-ts=1642720582342 :tmi.twitch.tv CLEARMSG #channel "
+		":spam spam spam",
+		"@badge-info=;badges=moderator/1;color=;display-name=bot;"
+		"emote-sets=0,33,50,237,793,2126,3517,4578,5569,9400,10337;"
+		"mod=1;subscriber=0;user-type=mod :tmi.twitch.tv USERSTATE "
+		"#channel",
+		"@msg-id=slow_on :tmi.twitch.tv NOTICE #channel :This room is "
+		"now in slow mode. You may send messages every 30 seconds."};
+
+	std::mt19937 random(42);
+	const auto pick = [&random](size_t count) {
+		return std::uniform_int_distribution<size_t>(0, count - 1)(
+			random);
+	};
+
+	std::vector<std::string> lines;
+	lines.reserve(lineCount);
+	while (lines.size() < lineCount) {
+		const auto nick = "viewer" + std::to_string(pick(5000));
+		switch (pick(20)) {
+		case 0:
+			lines.emplace_back(otherLines[pick(otherLines.size())]);
+			continue;
+		case 1:
+			lines.emplace_back(":" + nick + "!" + nick + "@" +
+					   nick + ".tmi.twitch.tv " +
+					   (pick(2) ? "JOIN" : "PART") +
+					   " #channel");
+			continue;
+		default:
+			break;
+		}
+
+		std::string text;
+		std::map<std::string_view, std::string> emotePositions;
+		const auto wordCount = 1 + pick(pick(5) ? 8 : 60);
+		for (size_t i = 0; i < wordCount; i++) {
+			if (!text.empty()) {
+				text += ' ';
+			}
+			const auto &[word, emote] = words[pick(words.size())];
+			if (!emote.empty()) {
+				auto &positions = emotePositions[emote];
+				if (!positions.empty()) {
+					positions += ',';
+				}
+				positions += std::to_string(text.size()) + "-" +
+					     std::to_string(text.size() +
+							    word.size() - 1);
+			}
+			text += word;
+		}
+		std::string emoteTag;
+		for (const auto &[id, positions] : emotePositions) {
+			if (!emoteTag.empty()) {
+				emoteTag += '/';
+			}
+			emoteTag += std::string(id) + ":" + positions;
+		}
+
+		const auto badge = badges[pick(badges.size())];
+		std::string line =
+			"@badge-info=" +
+			std::string(badge.substr(0, badge.find(','))) +
+			";badges=" + std::string(badge) +
+			";client-nonce=" + std::to_string(random()) +
+			";color=#" + std::to_string(100000 + pick(800000)) +
+			";display-name=" + nick + ";emotes=" + emoteTag +
+			";first-msg=0;flags=;id=" + std::to_string(random()) +
+			";mod=" + (badge.find("moderator") == 0 ? "1" : "0") +
+			";room-id=12345;subscriber=" +
+			(badge.find("subscriber") != std::string_view::npos
+				 ? "1"
+				 : "0") +
+			";tmi-sent-ts=" +
+			std::to_string(1642696567751 + lines.size()) +
+			";turbo=0;user-id=" + std::to_string(random()) +
+			";user-type= :" + nick + "!" + nick + "@" + nick +
+			".tmi.twitch.tv PRIVMSG #channel :" + text;
+		lines.emplace_back(std::move(line));
+	}
+
+	std::vector<std::string> frames;
+	for (size_t i = 0; i < lines.size();) {
+		std::string frame;
+		const auto end = std::min(lines.size(), i + 1 + pick(20));
+		for (; i < end; i++) {
+			frame += lines[i] + "\r\n";
+		}
+		frames.emplace_back(std::move(frame));
+	}
+	return frames;
+}
+
+TEST_CASE("Parse synthetic chat log", "[.][benchmark][irc-message]")
+{
+	const auto frames = generateChatFrames(20000);
+
+	size_t lines = 0;
+	for (const auto &frame : frames) {
+		lines += advss::ParseIRCMessages(std::string(frame)).size();
+	}
+	REQUIRE(lines == 20000);
+
+	BENCHMARK("Parse chat log")
+	{
+		size_t count = 0;
+		for (const auto &frame : frames) {
+			count += advss::ParseIRCMessages(std::string(frame))
+					 .size();
+		}
+		return count;
+	};
+
+	BENCHMARK("Parse chat log and decode tags")
+	{
+		size_t count = 0;
+		for (const auto &frame : frames) {
+			auto messages =
+				advss::ParseIRCMessages(std::string(frame));
+			for (const auto &message : messages) {
+				count += message->GetTags().tagMap.size();
+			}
+		}
+		return count;
+	};
+}
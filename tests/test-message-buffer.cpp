@@ -0,0 +1,128 @@
+#include "catch.hpp"
+
+#include <message-dispatcher.hpp>
+
+#include <string>
+#include <thread>
+
+TEST_CASE("Messages are consumed in order", "[message-buffer]")
+{
+	advss::MessageBuffer<int> buffer;
+	REQUIRE(buffer.Empty());
+	REQUIRE_FALSE(buffer.ConsumeMessage());
+
+	buffer.AppendMessage(1);
+	buffer.AppendMessage(2);
+	buffer.AppendMessage(3);
+	REQUIRE(buffer.Size() == 3);
+
+	REQUIRE(*buffer.ConsumeMessage() == 1);
+	auto messages = buffer.ConsumeMessages();
+	REQUIRE(messages.size() == 2);
+	REQUIRE(*messages[0] == 2);
+	REQUIRE(*messages[1] == 3);
+	REQUIRE(buffer.Empty());
+}
+
+TEST_CASE("Overflow policies", "[message-buffer]")
+{
+	SECTION("Drop oldest")
+	{
+		advss::MessageBuffer<int> buffer(
+			4, advss::MessageBufferOverflowPolicy::DROP_OLDEST);
+		for (int i = 0; i < 6; i++) {
+			REQUIRE(buffer.AppendMessage(i));
+		}
+		REQUIRE(buffer.GetDroppedCount() == 2);
+		auto messages = buffer.ConsumeMessages();
+		REQUIRE(messages.size() == 4);
+		REQUIRE(*messages.front() == 2);
+		REQUIRE(*messages.back() == 5);
+	}
+	SECTION("Drop newest")
+	{
+		advss::MessageBuffer<int> buffer(
+			4, advss::MessageBufferOverflowPolicy::DROP_NEWEST);
+		for (int i = 0; i < 4; i++) {
+			REQUIRE(buffer.AppendMessage(i));
+		}
+		REQUIRE_FALSE(buffer.AppendMessage(4));
+		REQUIRE(buffer.GetDroppedCount() == 1);
+		auto messages = buffer.ConsumeMessages();
+		REQUIRE(messages.size() == 4);
+		REQUIRE(*messages.front() == 0);
+		REQUIRE(*messages.back() == 3);
+	}
+}
+
+TEST_CASE("Dispatched messages are shared", "[message-buffer]")
+{
+	advss::MessageDispatcher<std::string> dispatcher;
+	auto client1 = dispatcher.RegisterClient();
+	auto client2 = dispatcher.RegisterClient(2);
+	dispatcher.DispatchMessage("test");
+
+	auto message1 = client1->ConsumeMessage();
+	auto message2 = client2->ConsumeMessage();
+	REQUIRE(*message1 == "test");
+	REQUIRE(message1 == message2);
+
+	client1.reset();
+	for (int i = 0; i < 3; i++) {
+		dispatcher.DispatchMessage(std::to_string(i));
+	}
+	REQUIRE(dispatcher.GetDroppedCount() == 1);
+
+	REQUIRE(dispatcher.HasClients());
+	client2.reset();
+	REQUIRE_FALSE(dispatcher.HasClients());
+}
+
+TEST_CASE("Append callback", "[message-buffer]")
+{
+	advss::MessageBuffer<int> buffer(
+		2, advss::MessageBufferOverflowPolicy::DROP_NEWEST);
+	int calls = 0;
+	buffer.SetAppendCallback([&calls]() { calls++; });
+
+	buffer.AppendMessage(1);
+	buffer.AppendMessage(2);
+	REQUIRE(calls == 2);
+
+	// Dropped messages should not trigger the callback
+	REQUIRE_FALSE(buffer.AppendMessage(3));
+	REQUIRE(calls == 2);
+
+	buffer.SetAppendCallback({});
+	buffer.Clear();
+	buffer.AppendMessage(4);
+	REQUIRE(calls == 2);
+}
+
+TEST_CASE("Concurrent producer and consumer", "[message-buffer]")
+{
+	advss::MessageBuffer<int> buffer(64);
+	constexpr int count = 100000;
+	std::thread producer([&buffer]() {
+		for (int i = 0; i < count; i++) {
+			buffer.AppendMessage(i);
+		}
+	});
+
+	int last = -1;
+	bool ordered = true;
+	while (last < count - 1) {
+		auto message = buffer.ConsumeMessage();
+		if (!message) {
+			if (buffer.GetDroppedCount() + last + 1 >= count &&
+			    buffer.Empty()) {
+				break;
+			}
+			continue;
+		}
+		ordered = ordered && *message > last;
+		last = *message;
+	}
+	producer.join();
+	REQUIRE(ordered);
+}
@@ -0,0 +1,85 @@
+#include "catch.hpp"
+
+#include <osc-encoder.hpp>
+#include <osc-parser.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+static std::string toString(const std::vector<char> &buffer)
+{
+	return std::string(buffer.begin(), buffer.end());
+}
+
+static std::vector<char> encodeMessage()
+{
+	std::vector<char> buffer;
+	advss::AppendOSCString(buffer, "/mixer/fader");
+	advss::AppendOSCString(buffer, ",ifsbTN");
+	advss::AppendOSCInt32(buffer, 42);
+	advss::AppendOSCFloat(buffer, 1.0f);
+	advss::AppendOSCString(buffer, "on");
+	advss::AppendOSCBlob(buffer, {1, 2, 3});
+	return buffer;
+}
+
+static std::vector<std::string> parse(const std::vector<char> &packet)
+{
+	std::vector<std::string> messages;
+	if (!advss::ParseOSCPacket(
+		    std::string_view(packet.data(), packet.size()),
+		    [&messages](const advss::OSCMessageView &m) {
+			    messages.emplace_back(m.ToString());
+		    })) {
+		messages.emplace_back("invalid");
+	}
+	return messages;
+}
+
+TEST_CASE("Encode OSC message", "[osc-encoder]")
+{
+	REQUIRE(toString(encodeMessage()) == "/mixer/fader\0\0\0\0"
+					     ",ifsbTN\0"
+					     "\0\0\0\x2a"
+					     "\x3f\x80\0\0"
+					     "on\0\0"
+					     "\0\0\0\x03\x01\x02\x03\0"s);
+	REQUIRE(parse(encodeMessage()) ==
+		std::vector<std::string>{"/mixer/fader 42 1.000000 on "
+					 "\\x01\\x02\\x03 true null"});
+
+	std::vector<char> buffer;
+	advss::AppendOSCInt32(buffer, -1);
+	advss::AppendOSCString(buffer, "");
+	advss::AppendOSCString(buffer, "abcd");
+	advss::AppendOSCBlob(buffer, {});
+	advss::AppendOSCBlob(buffer, {1, 2, 3, 4});
+	REQUIRE(toString(buffer) == "\xff\xff\xff\xff"
+				    "\0\0\0\0"
+				    "abcd\0\0\0\0"
+				    "\0\0\0\0"
+				    "\0\0\0\x04\x01\x02\x03\x04"s);
+}
+
+TEST_CASE("Encode OSC bundle", "[osc-encoder]")
+{
+	std::vector<char> ping;
+	advss::AppendOSCString(ping, "/ping");
+	advss::AppendOSCString(ping, ",");
+
+	std::vector<char> bundle;
+	advss::EncodeOSCBundle({ping, encodeMessage()}, bundle);
+	REQUIRE(toString(bundle).substr(0, 32) ==
+		"#bundle\0\0\0\0\0\0\0\0\x01\0\0\0\x0c/ping\0\0\0,\0\0\0"s);
+	REQUIRE(parse(bundle) ==
+		std::vector<std::string>{
+			"/ping", "/mixer/fader 42 1.000000 on "
+				 "\\x01\\x02\\x03 true null"});
+
+	// The buffer is replaced
+	advss::EncodeOSCBundle({}, bundle);
+	REQUIRE(toString(bundle) == "#bundle\0\0\0\0\0\0\0\0\x01"s);
+	REQUIRE(parse(bundle).empty());
+}
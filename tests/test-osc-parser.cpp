@@ -0,0 +1,183 @@
+#include "catch.hpp"
+
+#include <osc-address-trie.hpp>
+#include <osc-parser.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+static const std::string message =
+	"/mixer/fader\0\0\0\0"
+	",ifsbTN\0"
+	"\0\0\0\x2a"
+	"\x3f\x80\0\0"
+	"on\0\0"
+	"\0\0\0\x03\x01\x02\x03\0"s;
+
+static std::vector<std::string> parse(const std::string &packet)
+{
+	std::vector<std::string> messages;
+	if (!advss::ParseOSCPacket(packet,
+				   [&messages](const advss::OSCMessageView &m) {
+					   messages.emplace_back(m.ToString());
+				   })) {
+		messages.emplace_back("invalid");
+	}
+	return messages;
+}
+
+static std::string bundle(const std::vector<std::string> &elements)
+{
+	std::string result = "#bundle\0\0\0\0\0\0\0\0\x01"s;
+	for (const auto &element : elements) {
+		const auto size = static_cast<uint32_t>(element.size());
+		result += static_cast<char>(size >> 24);
+		result += static_cast<char>(size >> 16);
+		result += static_cast<char>(size >> 8);
+		result += static_cast<char>(size);
+		result += element;
+	}
+	return result;
+}
+
+TEST_CASE("Parse OSC message", "[osc-parser]")
+{
+	advss::OSCMessageView view;
+	REQUIRE(advss::ParseOSCMessage(message, view));
+	REQUIRE(view.GetAddress() == "/mixer/fader");
+	REQUIRE(view.GetTypeTags() == "ifsbTN");
+	REQUIRE(view.GetArgumentCount() == 6);
+	REQUIRE(view.GetArgumentsString() ==
+		"42 1.000000 on \\x01\\x02\\x03 true null");
+
+	std::vector<char> types;
+	view.ForEachArgument([&types](const advss::OSCArgument &argument) {
+		types.emplace_back(argument.type);
+	});
+	REQUIRE(types == std::vector<char>{'i', 'f', 's', 'b', 'T', 'N'});
+
+	REQUIRE(parse("/ping\0\0\0"s) == std::vector<std::string>{"/ping"});
+	REQUIRE(parse("/ping\0\0\0,\0\0\0"s) ==
+		std::vector<std::string>{"/ping"});
+}
+
+TEST_CASE("Parse OSC bundles", "[osc-parser]")
+{
+	const auto ping = "/ping\0\0\0"s;
+	REQUIRE(parse(bundle({ping, message})) ==
+		std::vector<std::string>{
+			"/ping", "/mixer/fader 42 1.000000 on "
+				 "\\x01\\x02\\x03 true null"});
+	REQUIRE(parse(bundle({bundle({ping}), ping})) ==
+		std::vector<std::string>{"/ping", "/ping"});
+	REQUIRE(parse(bundle({})).empty());
+
+	std::string nested = ping;
+	for (int i = 0; i < 10; i++) {
+		nested = bundle({nested});
+	}
+	REQUIRE(parse(nested) == std::vector<std::string>{"invalid"});
+}
+
+TEST_CASE("Reject malformed OSC packets", "[osc-parser]")
+{
+	const std::vector<std::string> invalid = {
+		"",
+		"/ping"s,
+		"ping\0\0\0\0"s,
+		"/ping\0\0\0i\0\0\0"s,
+		"/ping\0\0\0,i\0\0"s,
+		"/ping\0\0\0,s\0\0abcd"s,
+		"/ping\0\0\0,b\0\0\0\0\0\x10\0\0\0\0"s,
+		"/ping\0\0\0,x\0\0"s,
+		"#bundle\0\0\0\0\0"s,
+		"#bundle\0\0\0\0\0\0\0\0\0\0\0\0\x10/a\0\0"s,
+	};
+	for (const auto &packet : invalid) {
+		REQUIRE(parse(packet) == std::vector<std::string>{"invalid"});
+	}
+}
+
+TEST_CASE("Copy received OSC messages", "[osc-parser]")
+{
+	auto packet = std::make_unique<std::string>(message);
+	advss::OSCMessageView view;
+	REQUIRE(advss::ParseOSCMessage(*packet, view));
+
+	advss::OSCReceivedMessage received(view);
+	packet.reset();
+	auto copy = received;
+	received = advss::OSCReceivedMessage(view.Rebase(
+		view.GetAddress().data(), copy.GetView().GetAddress().data()));
+	REQUIRE(copy.GetView().GetAddress() == "/mixer/fader");
+	REQUIRE(copy.GetView().GetArgumentsString() ==
+		received.GetView().GetArgumentsString());
+}
+
+TEST_CASE("Match OSC address patterns", "[osc-parser]")
+{
+	using advss::MatchOSCAddressPart;
+	REQUIRE(MatchOSCAddressPart("fader", "fader"));
+	REQUIRE_FALSE(MatchOSCAddressPart("fader", "fader1"));
+	REQUIRE(MatchOSCAddressPart("fader?", "fader1"));
+	REQUIRE_FALSE(MatchOSCAddressPart("fader?", "fader"));
+	REQUIRE(MatchOSCAddressPart("*", ""));
+	REQUIRE(MatchOSCAddressPart("f*r", "fader"));
+	REQUIRE(MatchOSCAddressPart("f**r*", "fader"));
+	REQUIRE_FALSE(MatchOSCAddressPart("f*x", "fader"));
+	REQUIRE(MatchOSCAddressPart("ch[1-3]", "ch2"));
+	REQUIRE_FALSE(MatchOSCAddressPart("ch[1-3]", "ch4"));
+	REQUIRE(MatchOSCAddressPart("ch[!1-3]", "ch4"));
+	REQUIRE(MatchOSCAddressPart("ch[13]", "ch3"));
+	REQUIRE(MatchOSCAddressPart("{fader,mute}", "mute"));
+	REQUIRE(MatchOSCAddressPart("{fader,mute}*", "fader1"));
+	REQUIRE_FALSE(MatchOSCAddressPart("{fader,mute}", "solo"));
+	REQUIRE_FALSE(MatchOSCAddressPart("[abc", "a"));
+}
+
+TEST_CASE("Look up OSC address patterns", "[osc-parser]")
+{
+	advss::OSCAddressTrie<std::vector<std::string>> trie;
+	const std::vector<std::string> patterns = {
+		"/mixer/ch1/fader", "/mixer/ch*/fader", "/mixer/ch?/mute",
+		"/mixer//fader",    "/mixer/{ch1,ch2}", "/transport/play",
+	};
+	for (const auto &pattern : patterns) {
+		trie.Get(pattern).emplace_back(pattern);
+	}
+
+	auto match = [&trie](const std::string &address) {
+		std::vector<std::string> result;
+		trie.Match(address,
+			   [&result](std::vector<std::string> &patterns) {
+				   result.insert(result.end(), patterns.begin(),
+						 patterns.end());
+			   });
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+
+	REQUIRE(match("/mixer/ch1/fader") ==
+		std::vector<std::string>{"/mixer//fader", "/mixer/ch*/fader",
+					 "/mixer/ch1/fader"});
+	REQUIRE(match("/mixer/ch10/fader") ==
+		std::vector<std::string>{"/mixer//fader", "/mixer/ch*/fader"});
+	REQUIRE(match("/mixer/bus/1/fader") ==
+		std::vector<std::string>{"/mixer//fader"});
+	REQUIRE(match("/mixer/ch2/mute") ==
+		std::vector<std::string>{"/mixer/ch?/mute"});
+	REQUIRE(match("/mixer/ch2") ==
+		std::vector<std::string>{"/mixer/{ch1,ch2}"});
+	REQUIRE(match("/mixer").empty());
+	REQUIRE(match("/transport/stop").empty());
+
+	trie.Remove("/mixer/ch*/fader");
+	REQUIRE(match("/mixer/ch10/fader") ==
+		std::vector<std::string>{"/mixer//fader"});
+	trie.RemoveIf([](std::vector<std::string> &) { return true; });
+	REQUIRE(trie.Empty());
+}
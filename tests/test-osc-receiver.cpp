@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include <osc-receiver.hpp>
+
+#include <asio.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::string_literals;
+using Protocol = advss::OSCReceiver::Protocol;
+
+static const std::string ping = "/test/ping\0\0,i\0\0\0\0\0\x2a"s;
+static const std::string other = "/other\0\0"s;
+
+static int getFreePort()
+{
+	asio::io_context context;
+	asio::ip::udp::socket socket(context, {asio::ip::udp::v4(), 0});
+	return socket.local_endpoint().port();
+}
+
+static advss::MessageBuffer<advss::OSCReceivedMessage>::Message
+waitForMessage(const advss::OSCMessageBuffer &buffer)
+{
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < timeout) {
+		if (auto message = buffer->ConsumeMessage()) {
+			return message;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return {};
+}
+
+static std::string bundle(const std::vector<std::string> &elements)
+{
+	std::string result = "#bundle\0\0\0\0\0\0\0\0\x01"s;
+	for (const auto &element : elements) {
+		const auto size = static_cast<uint32_t>(element.size());
+		result += std::string{static_cast<char>(size >> 24),
+				      static_cast<char>(size >> 16),
+				      static_cast<char>(size >> 8),
+				      static_cast<char>(size)};
+		result += element;
+	}
+	return result;
+}
+
+TEST_CASE("Receive OSC messages via UDP", "[osc-receiver]")
+{
+	const int port = getFreePort();
+	auto buffer = advss::OSCReceiver::Register(Protocol::UDP, port,
+						   "/test/*");
+	auto pingBuffer = advss::OSCReceiver::Register(Protocol::UDP, port,
+						       "/test/ping");
+	auto otherBuffer = advss::OSCReceiver::Register(Protocol::UDP, port,
+							"/other");
+
+	asio::io_context context;
+	asio::ip::udp::socket socket(context, asio::ip::udp::v4());
+	const asio::ip::udp::endpoint endpoint(
+		asio::ip::make_address("127.0.0.1"), port);
+	socket.send_to(asio::buffer(ping), endpoint);
+
+	auto message = waitForMessage(buffer);
+	REQUIRE(message);
+	REQUIRE(message->GetView().ToString() == "/test/ping 42");
+	// Messages matching multiple patterns are only copied once
+	REQUIRE(waitForMessage(pingBuffer) == message);
+	REQUIRE(otherBuffer->Empty());
+
+	socket.send_to(asio::buffer(bundle({other, ping})), endpoint);
+	REQUIRE(waitForMessage(otherBuffer)->GetView().ToString() ==
+		"/other");
+	REQUIRE(waitForMessage(buffer)->GetView().ToString() ==
+		"/test/ping 42");
+
+	advss::OSCReceiver::Stop();
+}
+
+TEST_CASE("Receive OSC messages via TCP", "[osc-receiver]")
+{
+	const int port = getFreePort();
+	auto buffer =
+		advss::OSCReceiver::Register(Protocol::TCP, port, "/test/*");
+
+	asio::io_context context;
+	asio::ip::tcp::socket socket(context);
+	socket.connect({asio::ip::make_address("127.0.0.1"),
+			static_cast<unsigned short>(port)});
+
+	// Packets prefixed with their size might be split across reads
+	const auto framed = "\0\0\0"s + static_cast<char>(ping.size()) + ping;
+	asio::write(socket, asio::buffer(framed.substr(0, 6)));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	REQUIRE(buffer->Empty());
+	asio::write(socket, asio::buffer(framed.substr(6) + framed));
+	REQUIRE(waitForMessage(buffer)->GetView().ToString() ==
+		"/test/ping 42");
+	REQUIRE(waitForMessage(buffer)->GetView().ToString() ==
+		"/test/ping 42");
+
+	// Packets sent without size prefix by the OSC action
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	asio::write(socket, asio::buffer(ping));
+	REQUIRE(waitForMessage(buffer)->GetView().ToString() ==
+		"/test/ping 42");
+
+	advss::OSCReceiver::Stop();
+}
+
+TEST_CASE("Close OSC ports once they are no longer used", "[osc-receiver]")
+{
+	const int port = getFreePort();
+	auto buffer =
+		advss::OSCReceiver::Register(Protocol::UDP, port, "/test/*");
+	auto otherBuffer =
+		advss::OSCReceiver::Register(Protocol::UDP, port, "/other");
+
+	asio::io_context context;
+	asio::ip::udp::socket socket(context, asio::ip::udp::v4());
+	asio::error_code ec;
+	socket.bind({asio::ip::udp::v4(), static_cast<unsigned short>(port)},
+		    ec);
+	REQUIRE(ec);
+
+	buffer.reset();
+	socket.bind({asio::ip::udp::v4(), static_cast<unsigned short>(port)},
+		    ec);
+	REQUIRE(ec);
+
+	otherBuffer.reset();
+	socket.bind({asio::ip::udp::v4(), static_cast<unsigned short>(port)},
+		    ec);
+	REQUIRE_FALSE(ec);
+	socket.close();
+
+	// The port can be opened again
+	buffer = advss::OSCReceiver::Register(Protocol::UDP, port, "/test/*");
+	asio::ip::udp::socket sender(context, asio::ip::udp::v4());
+	sender.send_to(asio::buffer(ping),
+		       {asio::ip::make_address("127.0.0.1"),
+			static_cast<unsigned short>(port)});
+	REQUIRE(waitForMessage(buffer));
+
+	advss::OSCReceiver::Stop();
+}
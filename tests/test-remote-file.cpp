@@ -0,0 +1,169 @@
+#include "catch.hpp"
+#include "test-server.hpp"
+
+#include <curl-helper.hpp>
+#include <remote-file.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Stand-in for a web server providing a file, which supports conditional
+// requests
+class FileServer {
+public:
+	FileServer()
+		: _server([this](httplib::Server &server) {
+			  AddRoutes(server);
+		  })
+	{
+	}
+
+	std::string GetUrl(const std::string &path) const
+	{
+		return _server.GetUrl(path);
+	}
+	void SetContent(const std::string &content)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_content = content;
+	}
+	int GetNotModifiedCount()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _notModifiedCount;
+	}
+
+private:
+	void AddRoutes(httplib::Server &server)
+	{
+		server.Get("/etag", [this](const httplib::Request &req,
+					   httplib::Response &res) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			const auto etag = "\"" + _content + "\"";
+			res.set_header("ETag", etag);
+			if (req.get_header_value("If-None-Match") == etag) {
+				++_notModifiedCount;
+				res.status = 304;
+				return;
+			}
+			res.set_content(_content, "text/plain");
+		});
+		server.Get("/date", [this](const httplib::Request &req,
+					   httplib::Response &res) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			const auto date = "Wed, 21 Oct 2015 07:28:00 GMT";
+			if (req.get_header_value("If-Modified-Since") == date) {
+				++_notModifiedCount;
+				res.status = 304;
+				return;
+			}
+			res.set_header("Last-Modified", date);
+			res.set_content(_content, "text/plain");
+		});
+	}
+
+	std::mutex _mutex;
+	std::string _content = "first";
+	int _notModifiedCount = 0;
+	// Declared last, so the server is stopped before the state its
+	// routes use is destroyed
+	TestServer _server;
+};
+
+} // namespace
+
+static constexpr auto interval = std::chrono::milliseconds(10);
+
+static bool waitForContent(advss::RemoteFile &file, const std::string &url,
+			   const std::string &content)
+{
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < timeout) {
+		if (file.Update(url, interval) &&
+		    file.GetContent() == content) {
+			return true;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+static bool waitForNotModified(FileServer &server)
+{
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (server.GetNotModifiedCount() == 0 &&
+	       std::chrono::steady_clock::now() < timeout) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return server.GetNotModifiedCount() > 0;
+}
+
+TEST_CASE("Remote files are polled in the background", "[remote-file]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl library not found");
+		return;
+	}
+
+	FileServer server;
+	const auto url = server.GetUrl("/etag");
+	advss::RemoteFile file;
+	REQUIRE(waitForContent(file, url, "first"));
+	const auto hash = file.GetHash();
+
+	// Unchanged files are not transferred again
+	REQUIRE(waitForNotModified(server));
+	REQUIRE(file.Update(url, interval));
+	REQUIRE(file.GetContent() == "first");
+	REQUIRE(file.GetHash() == hash);
+
+	server.SetContent("second");
+	REQUIRE(waitForContent(file, url, "second"));
+	REQUIRE(file.GetHash() != hash);
+
+	// The content is kept until it was received again if only the
+	// interval changed
+	REQUIRE(file.Update(url, interval * 2));
+	REQUIRE(file.GetContent() == "second");
+
+	advss::RemoteFilePoller::Stop();
+}
+
+TEST_CASE("Remote files are requested if modified since", "[remote-file]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl library not found");
+		return;
+	}
+
+	FileServer server;
+	const auto url = server.GetUrl("/date");
+	advss::RemoteFile file;
+	REQUIRE(waitForContent(file, url, "first"));
+	REQUIRE(waitForNotModified(server));
+	REQUIRE(file.GetContent() == "first");
+
+	advss::RemoteFilePoller::Stop();
+}
+
+TEST_CASE("Unavailable remote files have no content", "[remote-file]")
+{
+	if (!advss::CurlHelper::Initialized()) {
+		WARN("curl library not found");
+		return;
+	}
+
+	advss::RemoteFile file;
+	for (int i = 0; i < 10; ++i) {
+		REQUIRE_FALSE(file.Update("http://127.0.0.1:1/file", interval));
+		REQUIRE(file.GetContent().empty());
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	advss::RemoteFilePoller::Stop();
+}
@@ -0,0 +1,98 @@
+#include "catch.hpp"
+
+#include <request-cache.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Cached values are returned until they expire", "[request-cache]")
+{
+	advss::RequestCache<int> cache;
+	int fetchCount = 0;
+	auto fetch = [&fetchCount]() { return ++fetchCount; };
+
+	REQUIRE(cache.Get("a", 1h, fetch) == 1);
+	REQUIRE(cache.Get("a", 1h, fetch) == 1);
+	REQUIRE(cache.Get("b", 1h, fetch) == 2);
+
+	// Different TTLs can be used for the same cache
+	REQUIRE(cache.Get("a", 0s, fetch) == 3);
+	REQUIRE(cache.Get("a", 1h, fetch) == 3);
+
+	auto stats = cache.GetStats();
+	REQUIRE(stats.hits == 2);
+	REQUIRE(stats.misses == 3);
+}
+
+TEST_CASE("Values which are not cacheable", "[request-cache]")
+{
+	advss::RequestCache<int> cache;
+	int fetchCount = 0;
+	auto fetch = [&fetchCount]() { return ++fetchCount; };
+	auto isEven = [](int value) { return value % 2 == 0; };
+
+	REQUIRE(cache.Get("a", 1h, fetch, isEven) == 1);
+	REQUIRE(cache.Size() == 0);
+	REQUIRE(cache.Get("a", 1h, fetch, isEven) == 2);
+	REQUIRE(cache.Get("a", 1h, fetch, isEven) == 2);
+	REQUIRE(cache.Size() == 1);
+
+	REQUIRE_THROWS(cache.Get("b", 1h, []() -> int { throw 42; }));
+	REQUIRE(cache.Size() == 1);
+}
+
+TEST_CASE("Least recently used entries are evicted", "[request-cache]")
+{
+	advss::RequestCache<std::string> cache(2);
+	auto fetch = [](const std::string &value) {
+		return [value]() { return value; };
+	};
+
+	cache.Get("a", 1h, fetch("a"));
+	cache.Get("b", 1h, fetch("b"));
+	// Mark "a" as used more recently than "b"
+	cache.Get("a", 1h, fetch("new a"));
+	cache.Get("c", 1h, fetch("c"));
+
+	REQUIRE(cache.Size() == 2);
+	REQUIRE(cache.GetStats().evictions == 1);
+	REQUIRE(cache.Get("a", 1h, fetch("new a")) == "a");
+	REQUIRE(cache.Get("b", 1h, fetch("new b")) == "new b");
+}
+
+TEST_CASE("Concurrent lookups share one request", "[request-cache]")
+{
+	advss::RequestCache<int> cache;
+	std::atomic_int fetchCount = {0};
+	std::atomic_bool release = {false};
+	auto fetch = [&]() {
+		++fetchCount;
+		while (!release) {
+			std::this_thread::sleep_for(1ms);
+		}
+		return 7;
+	};
+
+	std::vector<std::thread> threads;
+	std::atomic_int sum = {0};
+	for (int i = 0; i < 4; i++) {
+		threads.emplace_back(
+			[&]() { sum += cache.Get("key", 1h, fetch); });
+	}
+	while (cache.GetStats().misses + cache.GetStats().coalesced < 4) {
+		std::this_thread::sleep_for(1ms);
+	}
+	release = true;
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(fetchCount == 1);
+	REQUIRE(sum == 28);
+	auto stats = cache.GetStats();
+	REQUIRE(stats.misses == 1);
+	REQUIRE(stats.coalesced == 3);
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <httplib.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Runs an HTTP server on a random local port until it is destroyed.
+// The routes are added by the given function before the server is started.
+class TestServer {
+public:
+	explicit TestServer(
+		const std::function<void(httplib::Server &)> &addRoutes)
+	{
+		addRoutes(_server);
+		_port = _server.bind_to_any_port("127.0.0.1");
+		_thread = std::thread(
+			[this]() { _server.listen_after_bind(); });
+		while (!_server.is_running()) {
+			std::this_thread::sleep_for(
+				std::chrono::milliseconds(1));
+		}
+	}
+	~TestServer()
+	{
+		_server.stop();
+		_thread.join();
+	}
+
+	std::string GetUrl(const std::string &path = "") const
+	{
+		return "http://127.0.0.1:" + std::to_string(_port) + path;
+	}
+
+private:
+	httplib::Server _server;
+	int _port = 0;
+	std::thread _thread;
+};
@@ -0,0 +1,64 @@
+#include "catch.hpp"
+
+#include <time-series.hpp>
+
+using Clock = advss::TimeSeries::Clock;
+
+TEST_CASE("Empty time series", "[time-series]")
+{
+	advss::TimeSeries series;
+	REQUIRE(series.Empty());
+	REQUIRE(series.GetLatest() == 0.0);
+	REQUIRE(series.GetAverage() == 0.0);
+	REQUIRE(series.GetMinimum(std::chrono::seconds(1)) == 0.0);
+	REQUIRE(series.GetPercentile(50.0, std::chrono::seconds(1)) == 0.0);
+}
+
+TEST_CASE("Ring buffer keeps the newest values", "[time-series]")
+{
+	using namespace std::chrono_literals;
+	advss::TimeSeries series(3);
+	const auto start = Clock::now();
+	for (int i = 1; i <= 5; i++) {
+		series.Add(i, start + i * 1ms);
+	}
+	REQUIRE(series.Size() == 3);
+	REQUIRE(series.GetLatest() == 5.0);
+	REQUIRE(series.GetMinimum(1s, start + 5ms) == 3.0);
+	REQUIRE(series.GetMaximum(1s, start + 5ms) == 5.0);
+}
+
+TEST_CASE("Window aggregates ignore old values", "[time-series]")
+{
+	using namespace std::chrono_literals;
+	advss::TimeSeries series;
+	const auto start = Clock::now();
+	series.Add(100.0, start);
+	for (int i = 1; i <= 10; i++) {
+		series.Add(i, start + i * 100ms);
+	}
+
+	const auto now = start + 1000ms;
+	REQUIRE(series.GetMaximum(2s, now) == 100.0);
+	REQUIRE(series.GetMaximum(500ms, now) == 10.0);
+	REQUIRE(series.GetMinimum(500ms, now) == 5.0);
+	REQUIRE(series.GetPercentile(50.0, 950ms, now) == 5.0);
+	REQUIRE(series.GetPercentile(90.0, 950ms, now) == 9.0);
+	REQUIRE(series.GetPercentile(100.0, 950ms, now) == 10.0);
+	REQUIRE(series.GetPercentile(0.0, 950ms, now) == 1.0);
+}
+
+TEST_CASE("Average is smoothed", "[time-series]")
+{
+	advss::TimeSeries series(16, 0.5);
+	series.Add(10.0);
+	REQUIRE(series.GetAverage() == 10.0);
+	series.Add(20.0);
+	REQUIRE(series.GetAverage() == 15.0);
+	series.Add(20.0);
+	REQUIRE(series.GetAverage() == 17.5);
+
+	series.Clear();
+	REQUIRE(series.Empty());
+	REQUIRE(series.GetAverage() == 0.0);
+}
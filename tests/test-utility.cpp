@@ -52,6 +52,23 @@ TEST_CASE("CompareIgnoringLineEnding", "[utility]")
 	s1 = "test\r\nwith line ending";
 	s2 = "test\nwith line ending";
 	REQUIRE(advss::CompareIgnoringLineEnding(s1, s2));
+
+	std::string_view v1 = "";
+	std::string_view v2 = "";
+	REQUIRE(advss::CompareIgnoringLineEnding(v1, v2));
+
+	v1 = "test\r\nwith line ending\n";
+	v2 = "test\nwith line ending";
+	REQUIRE(advss::CompareIgnoringLineEnding(v1, v2));
+
+	v1 = "test\rwith line ending";
+	REQUIRE(advss::CompareIgnoringLineEnding(v1, v2));
+
+	v1 = "test\n\nwith line ending";
+	REQUIRE_FALSE(advss::CompareIgnoringLineEnding(v1, v2));
+
+	v1 = "test";
+	REQUIRE_FALSE(advss::CompareIgnoringLineEnding(v1, v2));
 }
 
 TEST_CASE("ToString", "[utility]")
@@ -0,0 +1,228 @@
+#include "catch.hpp"
+
+#include <video-asset-cache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <thread>
+
+using advss::VideoAssetCache;
+
+static std::string getTempFilePath()
+{
+	return (std::filesystem::temp_directory_path() /
+		("advss-video-asset-cache-test-" +
+		 std::to_string(std::chrono::steady_clock::now()
+					.time_since_epoch()
+					.count())))
+		.string();
+}
+
+static void writeFile(const std::string &path, const std::string &content)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << content;
+}
+
+static VideoAssetCache::Loader countingLoader(std::atomic_int &loads)
+{
+	return [&loads](const std::string &, const std::string &content) {
+		++loads;
+		return std::static_pointer_cast<void>(
+			std::make_shared<std::string>(content));
+	};
+}
+
+static std::string getContent(const std::shared_ptr<void> &asset)
+{
+	return asset ? *std::static_pointer_cast<std::string>(asset) : "";
+}
+
+// Stops the loading thread at the end of each test, so the tests do not depend
+// on the order they are run in
+struct LoadingThreadGuard {
+	~LoadingThreadGuard() { VideoAssetCache::Reset(); }
+};
+
+// Blocks loaders until released, which happens at the latest when leaving the
+// test, so the loading thread can always be stopped
+class LoaderRelease {
+public:
+	~LoaderRelease() { Release(); }
+
+	void Wait() const { _released.wait(); }
+	void Release()
+	{
+		if (!_done) {
+			_done = true;
+			_promise.set_value();
+		}
+	}
+
+private:
+	std::promise<void> _promise;
+	std::shared_future<void> _released = _promise.get_future().share();
+	bool _done = false;
+};
+
+TEST_CASE("Assets of files with the same content are shared",
+	  "[video-asset-cache]")
+{
+	LoadingThreadGuard guard;
+	const auto path = getTempFilePath();
+	const auto copy = path + "-copy";
+	writeFile(path, "content");
+	writeFile(copy, "content");
+
+	std::atomic_int loads{0};
+	const auto load = countingLoader(loads);
+	auto entry = VideoAssetCache::Register("shared", path, load);
+	REQUIRE(VideoAssetCache::Register("shared", path, load) == entry);
+	auto copyEntry = VideoAssetCache::Register("shared", copy, load);
+	REQUIRE(copyEntry != entry);
+
+	auto asset = VideoAssetCache::Get(entry, true);
+	REQUIRE(getContent(asset) == "content");
+	REQUIRE(VideoAssetCache::Get(copyEntry, true) == asset);
+	REQUIRE(loads == 1);
+
+	// Assets of different types are loaded separately
+	auto otherEntry = VideoAssetCache::Register("other", path, load);
+	auto otherAsset = VideoAssetCache::Get(otherEntry, true);
+	REQUIRE(getContent(otherAsset) == "content");
+	REQUIRE(otherAsset != asset);
+	REQUIRE(loads == 2);
+
+	std::remove(path.c_str());
+	std::remove(copy.c_str());
+}
+
+TEST_CASE("Modified files are loaded again", "[video-asset-cache]")
+{
+	LoadingThreadGuard guard;
+	const auto path = getTempFilePath();
+	writeFile(path, "first");
+
+	std::atomic_int loads{0};
+	auto entry = VideoAssetCache::Register("modified", path,
+					       countingLoader(loads));
+	REQUIRE(getContent(VideoAssetCache::Get(entry, true)) == "first");
+
+	writeFile(path, "second");
+	// The resolution of the modification time might be too coarse
+	const auto filePath = std::filesystem::u8path(path);
+	std::filesystem::last_write_time(
+		filePath, std::filesystem::last_write_time(filePath) +
+				  std::chrono::seconds(1));
+
+	// Files are only checked for modifications once per second
+	std::shared_ptr<void> asset;
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (std::chrono::steady_clock::now() < timeout) {
+		asset = VideoAssetCache::Get(entry, true);
+		if (getContent(asset) == "second") {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	REQUIRE(getContent(asset) == "second");
+	REQUIRE(loads == 2);
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Unused assets are unloaded", "[video-asset-cache]")
+{
+	LoadingThreadGuard guard;
+	const auto path = getTempFilePath();
+	writeFile(path, "content");
+
+	std::atomic_int loads{0};
+	auto entry = VideoAssetCache::Register("unused", path,
+					       countingLoader(loads));
+	auto asset = VideoAssetCache::Get(entry, true);
+	REQUIRE(asset);
+
+	// Assets which were used recently are kept
+	VideoAssetCache::UnloadUnusedAssets(std::chrono::steady_clock::now());
+	REQUIRE(VideoAssetCache::Get(entry, false) == asset);
+
+	asset.reset();
+	VideoAssetCache::UnloadUnusedAssets(std::chrono::steady_clock::now() +
+					    std::chrono::hours(1));
+	REQUIRE_FALSE(VideoAssetCache::Get(entry, false));
+	REQUIRE(getContent(VideoAssetCache::Get(entry, true)) == "content");
+	REQUIRE(loads == 2);
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Assets loaded in the background can be waited for",
+	  "[video-asset-cache]")
+{
+	const auto path = getTempFilePath();
+	writeFile(path, "content");
+
+	LoadingThreadGuard guard;
+	// Declared before the release, so it is only waited for once the
+	// loader was released
+	std::future<std::shared_ptr<void>> waiting;
+	LoaderRelease release;
+	std::atomic_int loads{0};
+	std::atomic_bool loading{false};
+	auto entry = VideoAssetCache::Register(
+		"background", path,
+		[&](const std::string &, const std::string &content) {
+			loading = true;
+			release.Wait();
+			++loads;
+			return std::static_pointer_cast<void>(
+				std::make_shared<std::string>(content));
+		});
+
+	REQUIRE_FALSE(VideoAssetCache::Get(entry, false));
+	const auto timeout =
+		std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!loading && std::chrono::steady_clock::now() < timeout) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	REQUIRE(loading);
+
+	waiting = std::async(std::launch::async, [&entry]() {
+		return VideoAssetCache::Get(entry, true);
+	});
+	REQUIRE(waiting.wait_for(std::chrono::milliseconds(100)) ==
+		std::future_status::timeout);
+	release.Release();
+	REQUIRE(getContent(waiting.get()) == "content");
+	REQUIRE(loads == 1);
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("Assets are only loaded if waited for once stopped",
+	  "[video-asset-cache]")
+{
+	LoadingThreadGuard guard;
+	const auto path = getTempFilePath();
+	writeFile(path, "content");
+	VideoAssetCache::Stop();
+
+	std::atomic_int loads{0};
+	auto entry = VideoAssetCache::Register("stopped", path,
+					       countingLoader(loads));
+	REQUIRE_FALSE(VideoAssetCache::Get(entry, false));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	REQUIRE_FALSE(VideoAssetCache::Get(entry, false));
+	REQUIRE(loads == 0);
+
+	REQUIRE(getContent(VideoAssetCache::Get(entry, true)) == "content");
+	REQUIRE(loads == 1);
+
+	std::remove(path.c_str());
+}